@@ -0,0 +1,550 @@
+#include "adaptive_radix_tree.hpp"
+#include "value.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+namespace {
+
+enum NodeType : uint8_t {
+	kNode4 = 0,
+	kNode16 = 1,
+	kNode48 = 2,
+	kNode256 = 3,
+};
+
+constexpr uintptr_t kLeafTag = 1;
+
+inline const uint8_t* KeyBytes(const Slice& key) {
+	return reinterpret_cast<const uint8_t*>(key.data());
+}
+
+} // namespace
+
+
+// A key and its latest value. The key bytes follow the header. Inner node
+// prefixes point into leaf keys, which never move or change.
+struct AdaptiveRadixTree::Leaf {
+	ValueEntry value; // Overwritten in place when the key is written again
+	uint32_t key_size;
+
+	const uint8_t* key_bytes() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+	uint8_t* key_bytes() { return reinterpret_cast<uint8_t*>(this + 1); }
+	Slice key() const { return Slice(reinterpret_cast<const std::byte*>(this + 1), key_size); }
+};
+
+// Header shared by the four node types. The type-specific arrays follow it:
+//   Node4   [4 sorted key bytes, padded to 8][4 children]
+//   Node16  [16 sorted key bytes][16 children]
+//   Node48  [256-entry index: child slot + 1, 0 if none][48 children]
+//   Node256 [256 children, indexed by byte]
+struct AdaptiveRadixTree::Node {
+	uint8_t type;
+	uint16_t num_children;
+	// Bytes every key below shares after the byte that led here.
+	uint32_t prefix_len;
+	const uint8_t* prefix;
+	// The leaf whose key ends right after the prefix, if any.
+	Leaf* terminal;
+
+	static size_t Capacity(uint8_t type) {
+		static constexpr size_t kCapacity[] = {4, 16, 48, 256};
+		return kCapacity[type];
+	}
+	static size_t KeyArrayBytes(uint8_t type) {
+		static constexpr size_t kBytes[] = {8, 16, 256, 0};
+		return kBytes[type];
+	}
+	static size_t SizeFor(uint8_t type) {
+		return sizeof(Node) + KeyArrayBytes(type) + Capacity(type) * sizeof(Ref);
+	}
+
+	uint8_t* keys() { return reinterpret_cast<uint8_t*>(this + 1); }
+	const uint8_t* keys() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+	Ref* children() { return reinterpret_cast<Ref*>(keys() + KeyArrayBytes(type)); }
+	const Ref* children() const { return reinterpret_cast<const Ref*>(keys() + KeyArrayBytes(type)); }
+
+	bool IsFull() const { return num_children == Capacity(type); }
+
+	// The slot holding the child under `byte`, or nullptr.
+	const Ref* FindChild(uint8_t byte) const {
+		switch (type) {
+			case kNode4:
+				for (uint16_t i = 0; i < num_children; ++i) {
+					if (keys()[i] == byte) {
+						return &children()[i];
+					}
+				}
+				return nullptr;
+			case kNode16: {
+#if defined(__SSE2__)
+				__m128i needle = _mm_set1_epi8(static_cast<char>(byte));
+				__m128i haystack = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys()));
+				auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(needle, haystack)));
+				mask &= (1u << num_children) - 1;
+				return mask != 0 ? &children()[__builtin_ctz(mask)] : nullptr;
+#else
+				const uint8_t* end = keys() + num_children;
+				const uint8_t* pos = std::lower_bound(keys(), end, byte);
+				return pos != end && *pos == byte ? &children()[pos - keys()] : nullptr;
+#endif
+			}
+			case kNode48: {
+				uint8_t slot = keys()[byte];
+				return slot != 0 ? &children()[slot - 1] : nullptr;
+			}
+			default:
+				return children()[byte] != 0 ? &children()[byte] : nullptr;
+		}
+	}
+	Ref* FindChild(uint8_t byte) {
+		return const_cast<Ref*>(static_cast<const Node*>(this)->FindChild(byte));
+	}
+
+	// Smallest child byte greater than `after` (-1 for the first child),
+	// with its child in *child_out; -1 if there is none.
+	int NextChild(int after, Ref* child_out) const {
+		switch (type) {
+			case kNode4:
+			case kNode16:
+				for (uint16_t i = 0; i < num_children; ++i) {
+					if (keys()[i] > after) {
+						*child_out = children()[i];
+						return keys()[i];
+					}
+				}
+				return -1;
+			case kNode48:
+				for (int b = after + 1; b < 256; ++b) {
+					if (uint8_t slot = keys()[b]; slot != 0) {
+						*child_out = children()[slot - 1];
+						return b;
+					}
+				}
+				return -1;
+			default:
+				for (int b = after + 1; b < 256; ++b) {
+					if (children()[b] != 0) {
+						*child_out = children()[b];
+						return b;
+					}
+				}
+				return -1;
+		}
+	}
+
+	// Adds a child under a byte not present yet. The node must not be full.
+	void InsertChild(uint8_t byte, Ref child) {
+		switch (type) {
+			case kNode4:
+			case kNode16: {
+				uint16_t pos = 0;
+				while (pos < num_children && keys()[pos] < byte) {
+					pos++;
+				}
+				size_t tail = num_children - pos;
+				std::memmove(keys() + pos + 1, keys() + pos, tail);
+				std::memmove(children() + pos + 1, children() + pos, tail * sizeof(Ref));
+				keys()[pos] = byte;
+				children()[pos] = child;
+				break;
+			}
+			case kNode48:
+				// Children are never removed, so slots fill in order.
+				children()[num_children] = child;
+				keys()[byte] = static_cast<uint8_t>(num_children + 1);
+				break;
+			default:
+				children()[byte] = child;
+				break;
+		}
+		num_children++;
+	}
+
+	// Hangs `leaf` below this node, whose keys all match its first `depth`
+	// bytes.
+	void AddLeaf(Leaf* leaf, size_t depth) {
+		if (leaf->key_size == depth) {
+			terminal = leaf;
+		} else {
+			InsertChild(leaf->key_bytes()[depth], reinterpret_cast<Ref>(leaf) | kLeafTag);
+		}
+	}
+};
+
+namespace {
+
+template <typename T>
+bool IsLeafRef(T ref) {
+	return (ref & kLeafTag) != 0;
+}
+
+} // namespace
+
+
+AdaptiveRadixTree::AdaptiveRadixTree(Arena& arena)
+	: arena_(arena), root_(0) {
+}
+
+AdaptiveRadixTree::~AdaptiveRadixTree() {
+	// Nodes, leaves and values are in arena_, managed externally.
+}
+
+AdaptiveRadixTree::Leaf* AdaptiveRadixTree::NewLeaf(const Slice& key, const ValueEntry& entry) {
+	void* mem = arena_.Allocate(sizeof(Leaf) + key.size(), alignof(Leaf));
+	if (mem == nullptr) {
+		return nullptr;
+	}
+	Leaf* leaf = new (mem) Leaf{entry, static_cast<uint32_t>(key.size())};
+	if (key.size() > 0) {
+		std::memcpy(leaf->key_bytes(), key.data(), key.size());
+	}
+	return leaf;
+}
+
+AdaptiveRadixTree::Node* AdaptiveRadixTree::NewNode(uint8_t type, const uint8_t* prefix, uint32_t prefix_len) {
+	static_assert(sizeof(Node) % alignof(Ref) == 0, "Child arrays must stay aligned after the node header.");
+	size_t bytes = Node::SizeFor(type);
+	void* mem = arena_.Allocate(bytes, alignof(Node));
+	if (mem == nullptr) {
+		return nullptr;
+	}
+	Node* node = new (mem) Node{type, 0, prefix_len, prefix, nullptr};
+	std::memset(node->keys(), 0, bytes - sizeof(Node));
+	return node;
+}
+
+AdaptiveRadixTree::Node* AdaptiveRadixTree::Grow(const Node* node) {
+	Node* bigger = NewNode(static_cast<uint8_t>(node->type + 1), node->prefix, node->prefix_len);
+	if (bigger == nullptr) {
+		return nullptr;
+	}
+	bigger->terminal = node->terminal;
+	Ref child = 0;
+	for (int b = node->NextChild(-1, &child); b >= 0; b = node->NextChild(b, &child)) {
+		bigger->InsertChild(static_cast<uint8_t>(b), child);
+	}
+	return bigger;
+}
+
+bool AdaptiveRadixTree::AddChild(Ref* ref, uint8_t byte, Ref child) {
+	auto* node = reinterpret_cast<Node*>(*ref);
+	if (node->IsFull()) {
+		// The outgrown node stays in the arena, unreachable.
+		node = Grow(node);
+		if (node == nullptr) {
+			return false;
+		}
+		*ref = reinterpret_cast<Ref>(node);
+	}
+	node->InsertChild(byte, child);
+	return true;
+}
+
+Result AdaptiveRadixTree::Upsert(const Slice& key, const ValueEntry& entry) {
+	const uint8_t* bytes = KeyBytes(key);
+	const size_t size = key.size();
+	Ref* ref = &root_;
+	size_t depth = 0; // Key bytes matched on the way to *ref
+
+	while (true) {
+		if (*ref == 0) {
+			Leaf* leaf = NewLeaf(key, entry);
+			if (leaf == nullptr) {
+				return Result::ArenaAllocationFail("Failed to allocate radix tree leaf.");
+			}
+			*ref = reinterpret_cast<Ref>(leaf) | kLeafTag;
+			return Result::OK();
+		}
+
+		if (IsLeafRef(*ref)) {
+			auto* existing = reinterpret_cast<Leaf*>(*ref & ~kLeafTag);
+			if (existing->key() == key) {
+				existing->value = entry;
+				return Result::OK();
+			}
+			// Lazy expansion ends here: split the leaf's slot into a node
+			// holding both keys, prefixed by the bytes they still share.
+			Leaf* leaf = NewLeaf(key, entry);
+			if (leaf == nullptr) {
+				return Result::ArenaAllocationFail("Failed to allocate radix tree leaf.");
+			}
+			size_t limit = std::min<size_t>(existing->key_size, size);
+			size_t split = depth;
+			while (split < limit && existing->key_bytes()[split] == bytes[split]) {
+				split++;
+			}
+			Node* node = NewNode(kNode4, leaf->key_bytes() + depth, static_cast<uint32_t>(split - depth));
+			if (node == nullptr) {
+				return Result::ArenaAllocationFail("Failed to allocate radix tree node.");
+			}
+			node->AddLeaf(existing, split);
+			node->AddLeaf(leaf, split);
+			*ref = reinterpret_cast<Ref>(node);
+			return Result::OK();
+		}
+
+		auto* node = reinterpret_cast<Node*>(*ref);
+		uint32_t matched = 0;
+		while (matched < node->prefix_len && depth + matched < size && node->prefix[matched] == bytes[depth + matched]) {
+			matched++;
+		}
+		if (matched < node->prefix_len) {
+			// The key leaves the prefix part way: put a node above this one
+			// holding the matched part, and shorten this node's prefix.
+			Leaf* leaf = NewLeaf(key, entry);
+			if (leaf == nullptr) {
+				return Result::ArenaAllocationFail("Failed to allocate radix tree leaf.");
+			}
+			Node* parent = NewNode(kNode4, node->prefix, matched);
+			if (parent == nullptr) {
+				return Result::ArenaAllocationFail("Failed to allocate radix tree node.");
+			}
+			uint8_t node_byte = node->prefix[matched];
+			node->prefix += matched + 1;
+			node->prefix_len -= matched + 1;
+			parent->InsertChild(node_byte, reinterpret_cast<Ref>(node));
+			parent->AddLeaf(leaf, depth + matched);
+			*ref = reinterpret_cast<Ref>(parent);
+			return Result::OK();
+		}
+		depth += node->prefix_len;
+
+		if (depth == size) {
+			if (node->terminal != nullptr) {
+				node->terminal->value = entry;
+				return Result::OK();
+			}
+			Leaf* leaf = NewLeaf(key, entry);
+			if (leaf == nullptr) {
+				return Result::ArenaAllocationFail("Failed to allocate radix tree leaf.");
+			}
+			node->terminal = leaf;
+			return Result::OK();
+		}
+
+		if (Ref* child = node->FindChild(bytes[depth]); child != nullptr) {
+			ref = child;
+			depth++;
+			continue;
+		}
+		Leaf* leaf = NewLeaf(key, entry);
+		if (leaf == nullptr || !AddChild(ref, bytes[depth], reinterpret_cast<Ref>(leaf) | kLeafTag)) {
+			return Result::ArenaAllocationFail("Failed to allocate radix tree node.");
+		}
+		return Result::OK();
+	}
+}
+
+Result AdaptiveRadixTree::Put(const Slice& key_input, const Slice& value_input) {
+	if (key_input.empty()) {
+		return Result::InvalidArgument("Key cannot be empty for Put.");
+	}
+
+	// The key is copied into its leaf; the value gets its own arena copy.
+	std::byte* value_arena_ptr = nullptr;
+	if (value_input.size() > 0) {
+		void* value_mem_raw = arena_.Allocate(value_input.size(), alignof(std::byte));
+		if (!value_mem_raw) {
+			return Result::ArenaAllocationFail("Failed to allocate for value in Put.");
+		}
+		value_arena_ptr = static_cast<std::byte*>(value_mem_raw);
+		std::memcpy(value_arena_ptr, value_input.data(), value_input.size());
+	}
+	Slice arena_value_slice(value_arena_ptr, value_input.size());
+
+	return Upsert(key_input, ValueEntry(arena_value_slice, ValueTag::kData));
+}
+
+Result AdaptiveRadixTree::Get(const Slice& key, Slice* value_out) const {
+	// Hot path: a miss or hit must not allocate, so no debug output here.
+	const uint8_t* bytes = KeyBytes(key);
+	const size_t size = key.size();
+	Ref current = root_;
+	size_t depth = 0;
+	const Leaf* leaf = nullptr;
+
+	while (current != 0) {
+		if (IsLeafRef(current)) {
+			leaf = reinterpret_cast<const Leaf*>(current & ~kLeafTag);
+			break;
+		}
+		const auto* node = reinterpret_cast<const Node*>(current);
+		if (node->prefix_len > 0) {
+			if (depth + node->prefix_len > size || std::memcmp(node->prefix, bytes + depth, node->prefix_len) != 0) {
+				return Result::NotFound();
+			}
+			depth += node->prefix_len;
+		}
+		if (depth == size) {
+			leaf = node->terminal;
+			break;
+		}
+		const Ref* child = node->FindChild(bytes[depth]);
+		if (child == nullptr) {
+			return Result::NotFound();
+		}
+		current = *child;
+		depth++;
+	}
+
+	// Only bytes at branch points were checked on the way down.
+	if (leaf == nullptr || leaf->key() != key) {
+		return Result::NotFound();
+	}
+	if (leaf->value.IsTombstone()) {
+		return Result::FoundTombstone();
+	}
+	*value_out = leaf->value.value_slice;
+	return Result::OK();
+}
+
+Result AdaptiveRadixTree::Delete(const Slice& key_input) {
+	if (key_input.empty()) {
+		return Result::InvalidArgument("Key cannot be empty for Delete.");
+	}
+	// The key stays, marked by a tombstone, so the delete reaches SSTables.
+	return Upsert(key_input, ValueEntry(ValueTag::kTombstone));
+}
+
+
+SortedTableIterator* AdaptiveRadixTree::NewIterator() const {
+	return new AdaptiveRadixTreeIterator(this); // Caller owns this for now
+}
+
+size_t AdaptiveRadixTree::ApproximateMemoryUsage() const {
+	return arena_.GetTotalBytesUsed() + sizeof(*this);
+}
+
+AdaptiveRadixTreeIterator::AdaptiveRadixTreeIterator(const AdaptiveRadixTree* tree)
+	: tree_(tree), leaf_(nullptr) {}
+
+bool AdaptiveRadixTreeIterator::Valid() const {
+	return leaf_ != nullptr;
+}
+
+void AdaptiveRadixTreeIterator::AdvanceToLeaf() {
+	using Ref = AdaptiveRadixTree::Ref;
+	leaf_ = nullptr;
+	while (!stack_.empty()) {
+		Frame& frame = stack_.back();
+		if (frame.last_byte == kTerminalPending) {
+			frame.last_byte = kBeforeChildren;
+			if (frame.node->terminal != nullptr) {
+				leaf_ = frame.node->terminal;
+				return;
+			}
+		}
+		Ref child = 0;
+		int byte = frame.node->NextChild(frame.last_byte, &child);
+		if (byte < 0) {
+			stack_.pop_back();
+			continue;
+		}
+		frame.last_byte = byte;
+		if (IsLeafRef(child)) {
+			leaf_ = reinterpret_cast<const AdaptiveRadixTree::Leaf*>(child & ~kLeafTag);
+			return;
+		}
+		stack_.push_back({reinterpret_cast<const AdaptiveRadixTree::Node*>(child), kTerminalPending});
+	}
+}
+
+void AdaptiveRadixTreeIterator::SeekToFirst() {
+	stack_.clear();
+	leaf_ = nullptr;
+	AdaptiveRadixTree::Ref root = tree_->root_;
+	if (root == 0) {
+		return;
+	}
+	if (IsLeafRef(root)) {
+		leaf_ = reinterpret_cast<const AdaptiveRadixTree::Leaf*>(root & ~kLeafTag);
+		return;
+	}
+	stack_.push_back({reinterpret_cast<const AdaptiveRadixTree::Node*>(root), kTerminalPending});
+	AdvanceToLeaf();
+}
+
+void AdaptiveRadixTreeIterator::Seek(const Slice& target) {
+	// Lower-bound descent: at each node, decide whether the whole subtree
+	// sorts before the target (skip it), after it (take its first leaf), or
+	// the target continues into one child.
+	const uint8_t* bytes = KeyBytes(target);
+	const size_t size = target.size();
+	stack_.clear();
+	leaf_ = nullptr;
+	AdaptiveRadixTree::Ref current = tree_->root_;
+	size_t depth = 0;
+
+	while (current != 0) {
+		if (IsLeafRef(current)) {
+			const auto* leaf = reinterpret_cast<const AdaptiveRadixTree::Leaf*>(current & ~kLeafTag);
+			if (leaf->key().compare(target) >= 0) {
+				leaf_ = leaf;
+			} else {
+				AdvanceToLeaf();
+			}
+			return;
+		}
+		const auto* node = reinterpret_cast<const AdaptiveRadixTree::Node*>(current);
+		for (uint32_t i = 0; i < node->prefix_len; ++i) {
+			if (depth + i == size || node->prefix[i] > bytes[depth + i]) {
+				// Every key below is greater than the target.
+				stack_.push_back({node, kTerminalPending});
+				AdvanceToLeaf();
+				return;
+			}
+			if (node->prefix[i] < bytes[depth + i]) {
+				AdvanceToLeaf();
+				return;
+			}
+		}
+		depth += node->prefix_len;
+		if (depth == size) {
+			// The terminal, if any, equals the target; all else is greater.
+			stack_.push_back({node, kTerminalPending});
+			AdvanceToLeaf();
+			return;
+		}
+		// The terminal sorts before the target; resume after the children
+		// below its next byte, then look inside the child for that byte.
+		uint8_t byte = bytes[depth];
+		const AdaptiveRadixTree::Ref* child = node->FindChild(byte);
+		stack_.push_back({node, child != nullptr ? byte : byte - 1});
+		if (child == nullptr) {
+			AdvanceToLeaf();
+			return;
+		}
+		current = *child;
+		depth++;
+	}
+	AdvanceToLeaf();
+}
+
+void AdaptiveRadixTreeIterator::Next() {
+	if (Valid()) {
+		AdvanceToLeaf();
+	}
+}
+
+Slice AdaptiveRadixTreeIterator::key() const {
+	if (!Valid()) return Slice();
+	return leaf_->key();
+}
+
+ValueEntry AdaptiveRadixTreeIterator::value() const {
+	if (!Valid()) {
+		return ValueEntry(ValueTag::kTombstone);
+	}
+	return leaf_->value;
+}
+
+Result AdaptiveRadixTreeIterator::status() const {
+	return Result::OK();
+}
@@ -0,0 +1,99 @@
+#ifndef ADAPTIVE_RADIX_TREE_HPP
+#define ADAPTIVE_RADIX_TREE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "sorted_table.hpp"
+#include "arena.hpp"
+#include "result.hpp"
+#include "value.hpp"
+
+
+class AdaptiveRadixTreeIterator; // Forward declaration
+
+// Memtable table for point-lookup-heavy workloads: an adaptive radix tree
+// (Leis et al., ICDE 2013). A lookup walks one node per distinct key byte
+// instead of comparing whole keys O(log n) times, and inner nodes grow from
+// 4 to 16, 48 and 256 children as they fill, so sparse levels stay small.
+// Common key prefixes are stored once, in the node where paths split.
+//
+// Keys are ordered by their bytes, so this table only serves the bytewise
+// comparator. A key that is a prefix of another is kept as the "terminal"
+// leaf of the node where the longer key continues, which sorts it first.
+//
+// Nodes, leaves and values live in the arena; nodes outgrown are left
+// there. Unlike SkipList, reads must not run concurrently with writes.
+class AdaptiveRadixTree : public SortedTable {
+ public:
+  explicit AdaptiveRadixTree(Arena& arena);
+  ~AdaptiveRadixTree() override;
+
+  AdaptiveRadixTree(const AdaptiveRadixTree&) = delete;
+  AdaptiveRadixTree& operator=(const AdaptiveRadixTree&) = delete;
+
+  // --- SortedTable Interface Implementation ---
+  Result Put(const Slice& key, const Slice& value) override;
+  Result Get(const Slice& key, Slice* value_out) const override;
+  Result Delete(const Slice& key) override;
+  SortedTableIterator* NewIterator() const override;
+  size_t ApproximateMemoryUsage() const override;
+
+ private:
+  friend class AdaptiveRadixTreeIterator;
+
+  struct Node;
+  struct Leaf;
+
+  // A child slot: nullptr (0), a Node*, or a Leaf* with the low bit set.
+  using Ref = uintptr_t;
+
+  Result Upsert(const Slice& key, const ValueEntry& entry);
+  Leaf* NewLeaf(const Slice& key, const ValueEntry& entry);
+  Node* NewNode(uint8_t type, const uint8_t* prefix, uint32_t prefix_len);
+  // Adds `child` under `byte` to the node in `*ref`, replacing it with a
+  // larger node first if it is full. Returns false if out of memory.
+  bool AddChild(Ref* ref, uint8_t byte, Ref child);
+  Node* Grow(const Node* node);
+
+  Arena& arena_; // Holds nodes, leaves, keys and values
+  Ref root_;
+};
+
+
+// In-order walk with an explicit stack of the inner nodes above the current
+// leaf. Valid while the tree and its arena live and no write happens.
+class AdaptiveRadixTreeIterator : public SortedTableIterator {
+ public:
+  explicit AdaptiveRadixTreeIterator(const AdaptiveRadixTree* tree);
+  ~AdaptiveRadixTreeIterator() override = default;
+
+  bool Valid() const override;
+  void SeekToFirst() override;
+  void Seek(const Slice& target) override;
+  void Next() override;
+
+  Slice key() const override;
+  ValueEntry value() const override;
+  Result status() const override;
+
+ private:
+  struct Frame {
+    const AdaptiveRadixTree::Node* node;
+    // Last child byte visited; kTerminalPending before the node's own
+    // terminal leaf, kBeforeChildren after it.
+    int last_byte;
+  };
+  static constexpr int kTerminalPending = -2;
+  static constexpr int kBeforeChildren = -1;
+
+  // Moves to the next leaf in order after the stack's current position.
+  void AdvanceToLeaf();
+
+  const AdaptiveRadixTree* tree_;
+  std::vector<Frame> stack_;
+  const AdaptiveRadixTree::Leaf* leaf_;
+};
+
+
+#endif // ADAPTIVE_RADIX_TREE_HPP
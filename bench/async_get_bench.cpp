@@ -0,0 +1,198 @@
+// Compares point lookups that have to read SSTables when issued as
+//   - one std::thread per request, each calling the blocking DB::Get, and
+//   - coroutines on a single thread, each awaiting DB::AsyncGet and resumed
+//     by that thread's own run loop.
+// Lookups are issued in rounds of `concurrency` requests in flight.
+//
+// Usage: async_get_bench [num_keys] [num_lookups] [concurrency] [read_threads]
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "db.hpp"
+#include "options.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+// A single-threaded executor: read threads post finished lookups and Run()
+// resumes them on the thread that issued them.
+struct RunLoop {
+  DB::ResumeFn Poster() {
+    return [this](std::coroutine_handle<> handle) {
+      std::lock_guard<std::mutex> lock(mu);
+      ready.push_back(handle);
+      cv.notify_one();
+    };
+  }
+  // Resumes posted coroutines until `*remaining` of them have finished.
+  void Run(int* remaining) {
+    while (*remaining > 0) {
+      std::coroutine_handle<> handle;
+      {
+        std::unique_lock<std::mutex> lock(mu);
+        cv.wait(lock, [this] { return !ready.empty(); });
+        handle = ready.front();
+        ready.pop_front();
+      }
+      handle.resume();
+    }
+  }
+  std::mutex mu;
+  std::condition_variable cv;
+  std::deque<std::coroutine_handle<>> ready;
+};
+
+std::string KeyFor(int i) {
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "key%08d", i);
+  return buf;
+}
+
+Slice AsSlice(const std::string& s) {
+  return Slice(reinterpret_cast<const std::byte*>(s.data()), s.size());
+}
+
+DetachedTask AsyncLookup(DB* db, const std::string* key, std::string* value, int* found, RunLoop* loop,
+                         int* remaining) {
+  Result res = co_await db->AsyncGet(AsSlice(*key), value, loop->Poster());
+  *found = res.ok() ? 1 : 0;
+  (*remaining)--;
+}
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int num_keys = argc > 1 ? std::atoi(argv[1]) : 5000;
+  int num_lookups = argc > 2 ? std::atoi(argv[2]) : 2000;
+  int concurrency = argc > 3 ? std::atoi(argv[3]) : 128;
+  int read_threads = argc > 4 ? std::atoi(argv[4]) : 8;
+  if (num_keys <= 0 || num_lookups <= 0 || concurrency <= 0 || read_threads <= 0) {
+    std::fprintf(stderr, "usage: %s [num_keys] [num_lookups] [concurrency] [read_threads]\n", argv[0]);
+    return 1;
+  }
+
+  // The library logs every operation; keep it out of the measurements.
+  std::cout.rdbuf(nullptr);
+
+  const std::string dir = "async_get_bench_db";
+  std::filesystem::remove_all(dir);
+  ThreadPoolOptions pool_options;
+  pool_options.user_priority_threads = read_threads;
+  DBOptions options;
+  options.thread_pool = std::make_shared<ThreadPool>(pool_options);
+  // Leave the flushed tables in L0 so every lookup searches several files.
+  options.disable_auto_compactions = true;
+  DB db(dir, 256 * 1024, options);
+  if (!db.Init().ok()) {
+    std::fprintf(stderr, "DB::Init failed\n");
+    return 1;
+  }
+  const std::string value(100, 'v');
+  for (int i = 0; i < num_keys; ++i) {
+    std::string key = KeyFor(i);
+    if (!db.Put(AsSlice(key), AsSlice(value)).ok()) {
+      std::fprintf(stderr, "DB::Put failed\n");
+      return 1;
+    }
+  }
+  // Push the tail of the data out of the memtable too, so every lookup reads SSTables.
+  for (int i = 0; db.NumFilesAtLevel(0) == 0 || i < num_keys / 4; ++i) {
+    std::string key = "zz_fill_" + std::to_string(i);
+    if (!db.Put(AsSlice(key), AsSlice(value)).ok()) {
+      std::fprintf(stderr, "DB::Put failed\n");
+      return 1;
+    }
+  }
+
+  std::mt19937 rng(42);
+  std::vector<std::string> keys(static_cast<size_t>(num_lookups));
+  for (std::string& key : keys) {
+    key = KeyFor(static_cast<int>(rng() % static_cast<unsigned>(num_keys)));
+  }
+  std::vector<std::string> values(static_cast<size_t>(concurrency));
+
+  // Thread per request.
+  int found_threads = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < num_lookups; round += concurrency) {
+    int in_flight = std::min(concurrency, num_lookups - round);
+    std::vector<int> found(static_cast<size_t>(in_flight), 0);
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(in_flight));
+    for (int i = 0; i < in_flight; ++i) {
+      threads.emplace_back([&, i]() {
+        size_t slot = static_cast<size_t>(i);
+        found[slot] = db.Get(AsSlice(keys[static_cast<size_t>(round + i)]), &values[slot]).ok() ? 1 : 0;
+      });
+    }
+    for (std::thread& t : threads) {
+      t.join();
+    }
+    for (int f : found) {
+      found_threads += f;
+    }
+  }
+  double thread_seconds = Seconds(start);
+
+  // Coroutines on this thread.
+  int found_coroutines = 0;
+  RunLoop loop;
+  start = std::chrono::steady_clock::now();
+  for (int round = 0; round < num_lookups; round += concurrency) {
+    int in_flight = std::min(concurrency, num_lookups - round);
+    std::vector<int> found(static_cast<size_t>(in_flight), 0);
+    int remaining = in_flight;
+    for (int i = 0; i < in_flight; ++i) {
+      size_t slot = static_cast<size_t>(i);
+      AsyncLookup(&db, &keys[static_cast<size_t>(round + i)], &values[slot], &found[slot], &loop, &remaining);
+    }
+    loop.Run(&remaining);
+    for (int f : found) {
+      found_coroutines += f;
+    }
+  }
+  double coroutine_seconds = Seconds(start);
+
+  ThreadPoolStats reads = db.GetThreadPoolStats(ThreadPriority::kUser);
+  std::printf("%d lookups over %d keys, %d in flight, %d read threads\n", num_lookups, num_keys, concurrency,
+              read_threads);
+  std::printf("thread per request : %8.3f s  %10.0f lookups/s  (%d found)\n", thread_seconds,
+              num_lookups / thread_seconds, found_threads);
+  std::printf("coroutines         : %8.3f s  %10.0f lookups/s  (%d found)\n", coroutine_seconds,
+              num_lookups / coroutine_seconds, found_coroutines);
+  std::printf("read queue         : max depth %zu, avg wait %.1f us, avg run %.1f us\n", reads.max_queue_depth,
+              reads.jobs_completed ? static_cast<double>(reads.total_queue_micros) / static_cast<double>(reads.jobs_completed) : 0.0,
+              reads.jobs_completed ? static_cast<double>(reads.total_run_micros) / static_cast<double>(reads.jobs_completed) : 0.0);
+
+  std::filesystem::remove_all(dir);
+  return 0;
+}
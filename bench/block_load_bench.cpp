@@ -0,0 +1,100 @@
+// Block-load throughput of SSTableReader::LoadBlockIntoBuffer: writes one
+// table with and one without zstd, then walks every data block of each
+// several times through a single reader, as an iterator scan does. The files
+// stay in the page cache, so this measures the reader's own work: the read
+// calls, buffer handling and decompression. Reader logging is silenced.
+//
+// Usage: block_load_bench [num_keys] [value_size] [rounds]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "table_builder.hpp"
+#include "sstable_reader.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void WriteTable(const std::string& path, bool compression, long num_keys, size_t value_size) {
+  TableBuilder builder(compression);
+  std::mt19937_64 rng(7);
+  std::string value(value_size, '\0');
+  char key[32];
+  if (!builder.Open(path).ok()) {
+    std::fprintf(stderr, "cannot create %s\n", path.c_str());
+    std::exit(1);
+  }
+  for (long i = 0; i < num_keys; ++i) {
+    std::snprintf(key, sizeof(key), "key%012ld", i);
+    for (char& c : value) {
+      c = static_cast<char>('a' + rng() % 4);
+    }
+    ValueEntry entry(Slice(reinterpret_cast<const std::byte*>(value.data()), value.size()));
+    if (!builder.Add(Slice(reinterpret_cast<const std::byte*>(key), std::strlen(key)), entry).ok()) {
+      std::fprintf(stderr, "add failed\n");
+      std::exit(1);
+    }
+  }
+  if (!builder.Finish().ok()) {
+    std::fprintf(stderr, "finish failed\n");
+    std::exit(1);
+  }
+}
+
+void RunLoads(const std::string& path, const char* name, long rounds) {
+  SSTableReader reader(path);
+  if (!reader.Init().ok()) {
+    std::fprintf(stderr, "cannot open %s\n", path.c_str());
+    std::exit(1);
+  }
+  size_t blocks = 0;
+  double block_bytes = 0;
+  Clock::time_point start = Clock::now();
+  for (long r = 0; r < rounds; ++r) {
+    uint64_t offset = 0;
+    uint64_t size_on_disk = 0;
+    while (reader.LoadBlockIntoBuffer(offset, &size_on_disk).ok()) {
+      offset += size_on_disk;
+      block_bytes += static_cast<double>(reader.GetBlockBuffer().size());
+      blocks++;
+    }
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  std::printf("%-5s %8zu blocks %7.3f s  %8.1f ns/block  %8.1f MiB/s uncompressed\n", name, blocks, seconds,
+              seconds * 1e9 / static_cast<double>(blocks), block_bytes / (1 << 20) / seconds);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  long num_keys = argc > 1 ? std::atol(argv[1]) : 200000;
+  long value_size = argc > 2 ? std::atol(argv[2]) : 100;
+  long rounds = argc > 3 ? std::atol(argv[3]) : 20;
+  if (num_keys <= 0 || value_size < 0 || rounds <= 0) {
+    std::fprintf(stderr, "usage: %s [num_keys] [value_size] [rounds]\n", argv[0]);
+    return 1;
+  }
+
+  std::filesystem::path dir = std::filesystem::temp_directory_path();
+  std::string plain = (dir / "block_load_bench_plain.sst").string();
+  std::string zstd = (dir / "block_load_bench_zstd.sst").string();
+  std::cout.setstate(std::ios::badbit);
+  WriteTable(plain, false, num_keys, static_cast<size_t>(value_size));
+  WriteTable(zstd, true, num_keys, static_cast<size_t>(value_size));
+
+  std::printf("%ld entries, %ld-byte values, 4 KiB blocks, %ld rounds\n", num_keys, value_size, rounds);
+  RunLoads(plain, "none", rounds);
+  RunLoads(zstd, "zstd", rounds);
+  std::cout.clear();
+
+  std::filesystem::remove(plain);
+  std::filesystem::remove(zstd);
+  return 0;
+}
@@ -0,0 +1,137 @@
+// File-selection cost of a point lookup in a deep tree: builds the metadata
+// of six sorted levels (no table files are written), then finds the files
+// that may hold random keys, once by binary-searching every level in full
+// and once with FilePicker and the FileIndexer's cascading hints. Reports
+// key comparisons and time per lookup. Both go through the same counting
+// comparator, so neither gets the inline bytewise path.
+//
+// Usage: file_picker_bench [l1_files] [fanout] [lookups]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "file_indexer.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class CountingComparator : public Comparator {
+ public:
+  int Compare(const Slice& a, const Slice& b) const override {
+    count_++;
+    return a.compare(b);
+  }
+  const char* Name() const override { return "bench.CountingComparator"; }
+
+  mutable long count_ = 0;
+};
+
+Slice AsSlice(const std::string& s) {
+  return Slice(reinterpret_cast<const std::byte*>(s.data()), s.size());
+}
+
+std::string KeyFor(uint64_t i) {
+  char buf[24];
+  std::snprintf(buf, sizeof(buf), "key%016llu", static_cast<unsigned long long>(i));
+  return buf;
+}
+
+// `num_files` files splitting [0, key_space) evenly, each leaving a gap
+// after itself, so some lookups fall between files.
+std::vector<FileMetaData> MakeLevel(uint64_t* next_number, long num_files, uint64_t key_space) {
+  std::vector<FileMetaData> files;
+  uint64_t width = key_space / static_cast<uint64_t>(num_files);
+  for (long i = 0; i < num_files; ++i) {
+    FileMetaData f;
+    f.number = (*next_number)++;
+    f.has_key_range = true;
+    f.smallest_key = KeyFor(static_cast<uint64_t>(i) * width);
+    f.largest_key = KeyFor(static_cast<uint64_t>(i) * width + width * 9 / 10);
+    files.push_back(std::move(f));
+  }
+  return files;
+}
+
+// The baseline: a from-scratch binary search of each sorted level.
+long FullSearch(const std::vector<std::vector<FileMetaData>>& levels, const KeyComparator& comparator,
+                const Slice& key) {
+  long found = 0;
+  for (size_t level = 1; level < levels.size(); ++level) {
+    const std::vector<FileMetaData>& files = levels[level];
+    auto it = std::lower_bound(files.begin(), files.end(), key, [&comparator](const FileMetaData& f, const Slice& k) {
+      return comparator.Compare(AsSlice(f.largest_key), k) < 0;
+    });
+    if (it != files.end() && comparator.Compare(key, AsSlice(it->smallest_key)) >= 0) {
+      found++;
+    }
+  }
+  return found;
+}
+
+long PickerSearch(const std::vector<std::vector<FileMetaData>>& levels, const FileIndexer& indexer,
+                  const KeyComparator& comparator, const Slice& key) {
+  long found = 0;
+  FilePicker picker(levels, indexer, comparator, key);
+  while (picker.GetNextFile() != nullptr) {
+    found++;
+  }
+  return found;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  long l1_files = argc > 1 ? std::atol(argv[1]) : 4;
+  long fanout = argc > 2 ? std::atol(argv[2]) : 8;
+  long lookups = argc > 3 ? std::atol(argv[3]) : 1000000;
+  if (l1_files <= 0 || fanout <= 0 || lookups <= 0) {
+    std::fprintf(stderr, "usage: %s [l1_files] [fanout] [lookups]\n", argv[0]);
+    return 1;
+  }
+
+  const uint64_t kKeySpace = 1ULL << 40;
+  uint64_t next_number = 1;
+  std::vector<std::vector<FileMetaData>> levels(kNumLevels);
+  long files_at_level = l1_files;
+  long total_files = 0;
+  for (size_t level = 1; level < levels.size(); ++level) {
+    levels[level] = MakeLevel(&next_number, files_at_level, kKeySpace);
+    total_files += files_at_level;
+    files_at_level *= fanout;
+  }
+  CountingComparator counting;
+  KeyComparator comparator(&counting);
+  FileIndexer indexer;
+  indexer.Update(comparator, levels);
+  std::printf("%zu sorted levels, %ld files (largest level %zu), %ld lookups\n", levels.size() - 1, total_files,
+              levels.back().size(), lookups);
+
+  std::mt19937_64 rng(75);
+  std::vector<std::string> keys;
+  keys.reserve(static_cast<size_t>(lookups));
+  for (long i = 0; i < lookups; ++i) {
+    keys.push_back(KeyFor(rng() % kKeySpace));
+  }
+
+  for (int mode = 0; mode < 2; ++mode) {
+    counting.count_ = 0;
+    long found = 0;
+    Clock::time_point start = Clock::now();
+    for (const std::string& key : keys) {
+      found += mode == 0 ? FullSearch(levels, comparator, AsSlice(key))
+                         : PickerSearch(levels, indexer, comparator, AsSlice(key));
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::printf("%-9s %6.2f comparisons/lookup  %7.1f ns/lookup  %5.2f files/lookup\n",
+                mode == 0 ? "full" : "cascading", static_cast<double>(counting.count_) / static_cast<double>(lookups),
+                seconds * 1e9 / static_cast<double>(lookups),
+                static_cast<double>(found) / static_cast<double>(lookups));
+  }
+  return 0;
+}
@@ -0,0 +1,91 @@
+// Memtable-to-SSTable flush cost: fills a MemTable once, then writes it to a
+// file with SSTableWriter::WriteMemTableToFile several times and reports
+// wall and CPU time per MiB of key and value bytes, with and without zstd.
+// Builder logging is silenced while timing.
+//
+// Usage: flush_bench [num_keys] [value_size] [rounds]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "arena.hpp"
+#include "mem_table.hpp"
+#include "sstable_writer.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kKeySize = 16;
+
+Slice AsSlice(const std::string& s) {
+  return Slice(reinterpret_cast<const std::byte*>(s.data()), s.size());
+}
+
+void RunFlushes(const MemTable& memtable, bool compression, int rounds, double mib, const std::string& path) {
+  SSTableWriter writer(compression);
+  std::cout.setstate(std::ios::badbit);
+  Clock::time_point start = Clock::now();
+  std::clock_t cpu_start = std::clock();
+  for (int i = 0; i < rounds; ++i) {
+    if (!writer.WriteMemTableToFile(memtable, path).ok()) {
+      std::cout.clear();
+      std::fprintf(stderr, "flush to %s failed\n", path.c_str());
+      std::exit(1);
+    }
+  }
+  double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  double wall = std::chrono::duration<double>(Clock::now() - start).count();
+  std::cout.clear();
+
+  double total_mib = mib * rounds;
+  std::printf("%-5s %7.3f s  %8.1f MiB/s   cpu %7.2f ms/MiB   file %7.1f MiB\n", compression ? "zstd" : "none",
+              wall, total_mib / wall, cpu * 1000 / total_mib,
+              static_cast<double>(std::filesystem::file_size(path)) / (1 << 20));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  long num_keys = argc > 1 ? std::atol(argv[1]) : 500000;
+  long value_size = argc > 2 ? std::atol(argv[2]) : 100;
+  long rounds = argc > 3 ? std::atol(argv[3]) : 5;
+  if (num_keys <= 0 || value_size < 0 || rounds <= 0) {
+    std::fprintf(stderr, "usage: %s [num_keys] [value_size] [rounds]\n", argv[0]);
+    return 1;
+  }
+
+  Arena arena;
+  MemTable memtable(arena);
+  std::mt19937_64 rng(42);
+  std::string key(kKeySize, '\0');
+  std::string value(static_cast<size_t>(value_size), '\0');
+  for (long i = 0; i < num_keys; ++i) {
+    for (char& c : key) {
+      c = static_cast<char>('a' + rng() % 26);
+    }
+    for (char& c : value) {
+      c = static_cast<char>('a' + rng() % 4); // Compressible, like most values
+    }
+    if (!memtable.Put(AsSlice(key), AsSlice(value)).ok()) {
+      std::fprintf(stderr, "memtable put failed\n");
+      return 1;
+    }
+  }
+  double mib = static_cast<double>(static_cast<size_t>(num_keys) * (kKeySize + static_cast<size_t>(value_size))) /
+               (1 << 20);
+  std::printf("%ld entries, %zu-byte keys, %ld-byte values, %.1f MiB per flush, %ld rounds\n", num_keys, kKeySize,
+              value_size, mib, rounds);
+
+  std::string path = (std::filesystem::temp_directory_path() / "flush_bench.sst").string();
+  RunFlushes(memtable, false, static_cast<int>(rounds), mib, path);
+  RunFlushes(memtable, true, static_cast<int>(rounds), mib, path);
+  std::filesystem::remove(path);
+  return 0;
+}
@@ -0,0 +1,389 @@
+// Insert and point-lookup throughput of the memtable's SkipList against
+//   - a bare std::map keyed by arena-copied Slices, copying the key on
+//     every write, as the memtable once did, and
+//   - the same skip list algorithm with Slice keys pointing at separate
+//     arena copies, so every comparison chases a second pointer,
+// and the MapTable (the default) and AdaptiveRadixTree memtable options.
+// A second section times a bulk load: filling the table, then one sorted
+// scan as a flush does, against the VectorTable option. A third times lookups of absent keys in a
+// MemTable with and without its Bloom filter. The last rewrites a tenth of
+// the keys over and over and reports the memory each write costs.
+//
+// Keys are random, fixed-size and inserted in random order; lookups hit
+// existing keys, also in random order.
+//
+// Usage: memtable_bench [num_keys] [key_size]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "adaptive_radix_tree.hpp"
+#include "arena.hpp"
+#include "map_table.hpp"
+#include "comparator.hpp"
+#include "mem_table.hpp"
+#include "skip_list.hpp"
+#include "value.hpp"
+#include "vector_table.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+Slice CopyToArena(Arena& arena, const std::string& s) {
+  auto* mem = static_cast<std::byte*>(arena.Allocate(s.size(), alignof(std::byte)));
+  std::memcpy(mem, s.data(), s.size());
+  return Slice(mem, s.size());
+}
+
+Slice AsSlice(const std::string& s) {
+  return Slice(reinterpret_cast<const std::byte*>(s.data()), s.size());
+}
+
+class PointerKeySkipList {
+ public:
+  explicit PointerKeySkipList(Arena& arena) : arena_(arena), head_(NewNode(Slice(), kMaxHeight)) {}
+
+  void Put(const Slice& key, const Slice& value) {
+    Node* prev[kMaxHeight];
+    Node* x = FindGreaterOrEqual(key, prev);
+    auto* cell = new (arena_.Allocate(sizeof(ValueEntry), alignof(ValueEntry)))
+        ValueEntry(CopyToArena(arena_, value.ToString()));
+    if (x != nullptr && x->key.compare(key) == 0) {
+      x->value = cell;
+      return;
+    }
+    int height = 1;
+    while (height < kMaxHeight && rng_() % 4 == 0) {
+      height++;
+    }
+    for (int level = height_; level < height; ++level) {
+      prev[level] = head_;
+    }
+    height_ = std::max(height_, height);
+    Node* node = NewNode(CopyToArena(arena_, key.ToString()), height);
+    node->value = cell;
+    for (int level = 0; level < height; ++level) {
+      node->next[level] = prev[level]->next[level];
+      prev[level]->next[level] = node;
+    }
+  }
+
+  bool Get(const Slice& key, Slice* value_out) const {
+    Node* x = FindGreaterOrEqual(key, nullptr);
+    if (x == nullptr || x->key.compare(key) != 0) {
+      return false;
+    }
+    *value_out = x->value->value_slice;
+    return true;
+  }
+
+ private:
+  static constexpr int kMaxHeight = SkipList::kDefaultMaxHeight;
+
+  struct Node {
+    Slice key;
+    const ValueEntry* value;
+    Node* next[1];
+  };
+
+  Node* NewNode(const Slice& key, int height) {
+    void* mem = arena_.Allocate(sizeof(Node) + sizeof(Node*) * static_cast<size_t>(height - 1), alignof(Node));
+    auto* node = new (mem) Node{key, nullptr, {nullptr}};
+    for (int level = 0; level < height; ++level) {
+      node->next[level] = nullptr;
+    }
+    return node;
+  }
+
+  Node* FindGreaterOrEqual(const Slice& key, Node** prev) const {
+    Node* x = head_;
+    int level = height_ - 1;
+    while (true) {
+      Node* next = x->next[level];
+      if (next != nullptr && next->key.compare(key) < 0) {
+        x = next;
+      } else {
+        if (prev != nullptr) {
+          prev[level] = x;
+        }
+        if (level == 0) {
+          return next;
+        }
+        level--;
+      }
+    }
+  }
+
+  Arena& arena_;
+  Node* head_;
+  int height_ = 1;
+  std::mt19937 rng_{5};
+};
+
+struct Timings {
+  double insert_seconds = 0;
+  double lookup_seconds = 0;
+  size_t memory_bytes = 0;
+  size_t found = 0;
+};
+
+template <typename Table>
+Timings RunTable(const std::vector<std::string>& keys, const std::vector<size_t>& lookup_order) {
+  Timings t;
+  auto arena = std::make_unique<Arena>(1 << 20);
+  Table table(*arena);
+  std::string value(16, 'v');
+
+  Clock::time_point start = Clock::now();
+  for (const std::string& key : keys) {
+    table.Put(AsSlice(key), AsSlice(value));
+  }
+  t.insert_seconds = Seconds(start);
+
+  start = Clock::now();
+  for (size_t i : lookup_order) {
+    Slice out;
+    if (table.Get(AsSlice(keys[i]), &out).ok()) {
+      t.found++;
+    }
+  }
+  t.lookup_seconds = Seconds(start);
+  t.memory_bytes = table.ApproximateMemoryUsage();
+  return t;
+}
+
+Timings RunPointerKeySkipList(const std::vector<std::string>& keys, const std::vector<size_t>& lookup_order) {
+  Timings t;
+  auto arena = std::make_unique<Arena>(1 << 20);
+  PointerKeySkipList list(*arena);
+  std::string value(16, 'v');
+
+  Clock::time_point start = Clock::now();
+  for (const std::string& key : keys) {
+    list.Put(AsSlice(key), AsSlice(value));
+  }
+  t.insert_seconds = Seconds(start);
+
+  start = Clock::now();
+  for (size_t i : lookup_order) {
+    Slice out;
+    if (list.Get(AsSlice(keys[i]), &out)) {
+      t.found++;
+    }
+  }
+  t.lookup_seconds = Seconds(start);
+  t.memory_bytes = arena->GetTotalBytesUsed();
+  return t;
+}
+
+Timings RunMap(const std::vector<std::string>& keys, const std::vector<size_t>& lookup_order) {
+  Timings t;
+  auto arena = std::make_unique<Arena>(1 << 20);
+  std::map<Slice, ValueEntry, KeyComparator> map;
+  std::string value(16, 'v');
+
+  Clock::time_point start = Clock::now();
+  for (const std::string& key : keys) {
+    map.insert_or_assign(CopyToArena(*arena, key), ValueEntry(CopyToArena(*arena, value)));
+  }
+  t.insert_seconds = Seconds(start);
+
+  start = Clock::now();
+  for (size_t i : lookup_order) {
+    auto it = map.find(AsSlice(keys[i]));
+    if (it != map.end() && !it->second.IsTombstone()) {
+      t.found++;
+    }
+  }
+  t.lookup_seconds = Seconds(start);
+  // Arena bytes plus, per entry, a red-black tree node (three pointers and a
+  // colour word around the Slice key and ValueEntry).
+  t.memory_bytes = arena->GetTotalBytesUsed() +
+                   map.size() * (4 * sizeof(void*) + sizeof(Slice) + sizeof(ValueEntry));
+  return t;
+}
+
+struct BulkTimings {
+  double fill_seconds = 0;
+  double scan_seconds = 0;
+  size_t scanned = 0;
+};
+
+template <typename Table>
+BulkTimings RunBulkLoad(const std::vector<std::string>& keys) {
+  BulkTimings t;
+  auto arena = std::make_unique<Arena>(1 << 20);
+  Table table(*arena);
+  std::string value(16, 'v');
+
+  Clock::time_point start = Clock::now();
+  for (const std::string& key : keys) {
+    table.Put(AsSlice(key), AsSlice(value));
+  }
+  t.fill_seconds = Seconds(start);
+
+  start = Clock::now();
+  std::unique_ptr<SortedTableIterator> it(table.NewIterator());
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    t.scanned++;
+  }
+  t.scan_seconds = Seconds(start);
+  return t;
+}
+
+void PrintBulk(const char* name, const BulkTimings& t, size_t n) {
+  std::printf("%-9s fill %7.3f s %8.2f Mops/s   sorted scan %7.3f s   total %7.3f s  (%zu scanned)\n", name,
+              t.fill_seconds, static_cast<double>(n) / t.fill_seconds / 1e6, t.scan_seconds,
+              t.fill_seconds + t.scan_seconds, t.scanned);
+}
+
+// Seconds to look up every key of `misses` in a MemTable holding `keys`.
+double RunMisses(const std::vector<std::string>& keys, const std::vector<std::string>& misses, size_t bloom_bytes,
+                 size_t* found) {
+  auto arena = std::make_unique<Arena>(1 << 20);
+  MemTable memtable(*arena, BytewiseComparator(), SkipListMemTableFactory(), bloom_bytes);
+  std::string value(16, 'v');
+  for (const std::string& key : keys) {
+    memtable.Put(AsSlice(key), AsSlice(value));
+  }
+  Clock::time_point start = Clock::now();
+  for (const std::string& key : misses) {
+    Slice out;
+    if (memtable.Get(AsSlice(key), &out).ok()) {
+      (*found)++;
+    }
+  }
+  return Seconds(start);
+}
+
+struct OverwriteTimings {
+  double seconds = 0;
+  size_t memory_bytes = 0;
+};
+
+// `writes` Puts spread over `distinct` keys, values of 8 bytes.
+template <typename Table>
+OverwriteTimings RunOverwrites(const std::vector<std::string>& keys, size_t distinct, size_t writes,
+                               bool inplace_update) {
+  OverwriteTimings t;
+  auto arena = std::make_unique<Arena>(1 << 20);
+  Table table(*arena, SkipList::kDefaultMaxHeight, SkipList::kDefaultProbability, BytewiseComparator(),
+              inplace_update);
+  std::mt19937_64 rng(3);
+  char value[16];
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < writes; ++i) {
+    std::snprintf(value, sizeof(value), "%08zu", i % 100000000);
+    table.Put(AsSlice(keys[rng() % distinct]), Slice(reinterpret_cast<const std::byte*>(value), 8));
+  }
+  t.seconds = Seconds(start);
+  t.memory_bytes = table.ApproximateMemoryUsage();
+  return t;
+}
+
+OverwriteTimings RunMapOverwrites(const std::vector<std::string>& keys, size_t distinct, size_t writes) {
+  OverwriteTimings t;
+  auto arena = std::make_unique<Arena>(1 << 20);
+  std::map<Slice, ValueEntry, KeyComparator> map;
+  std::mt19937_64 rng(3);
+  char value[16];
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < writes; ++i) {
+    std::snprintf(value, sizeof(value), "%08zu", i % 100000000);
+    // As the old memtable did: key and value copied on every write.
+    map.insert_or_assign(CopyToArena(*arena, keys[rng() % distinct]),
+                         ValueEntry(CopyToArena(*arena, std::string(value, 8))));
+  }
+  t.seconds = Seconds(start);
+  t.memory_bytes = arena->GetTotalBytesUsed() +
+                   map.size() * (4 * sizeof(void*) + sizeof(Slice) + sizeof(ValueEntry));
+  return t;
+}
+
+void PrintOverwrites(const char* name, const OverwriteTimings& t, size_t writes) {
+  std::printf("%-9s write %7.3f s %8.2f Mops/s   %7.1f MiB  %6.1f bytes/write\n", name, t.seconds,
+              static_cast<double>(writes) / t.seconds / 1e6, static_cast<double>(t.memory_bytes) / (1 << 20),
+              static_cast<double>(t.memory_bytes) / static_cast<double>(writes));
+}
+
+void Print(const char* name, const Timings& t, size_t n) {
+  std::printf("%-9s insert %7.3f s %8.2f Mops/s   lookup %7.3f s %8.2f Mops/s   %7.1f MiB  (%zu found)\n", name,
+              t.insert_seconds, static_cast<double>(n) / t.insert_seconds / 1e6, t.lookup_seconds,
+              static_cast<double>(n) / t.lookup_seconds / 1e6, static_cast<double>(t.memory_bytes) / (1 << 20),
+              t.found);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  long num_keys = argc > 1 ? std::atol(argv[1]) : 1000000;
+  long key_size = argc > 2 ? std::atol(argv[2]) : 16;
+  if (num_keys <= 0 || key_size < 8) {
+    std::fprintf(stderr, "usage: %s [num_keys] [key_size >= 8]\n", argv[0]);
+    return 1;
+  }
+  auto n = static_cast<size_t>(num_keys);
+
+  std::mt19937_64 rng(11);
+  std::vector<std::string> keys;
+  keys.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    std::string key(static_cast<size_t>(key_size), '\0');
+    for (char& c : key) {
+      c = static_cast<char>('a' + rng() % 26);
+    }
+    keys.push_back(std::move(key));
+  }
+  std::vector<size_t> lookup_order(n);
+  for (size_t i = 0; i < n; ++i) {
+    lookup_order[i] = i;
+  }
+  std::shuffle(lookup_order.begin(), lookup_order.end(), rng);
+
+  std::printf("%zu keys of %ld bytes\n", n, key_size);
+  Print("std::map", RunMap(keys, lookup_order), n);
+  Print("ptr keys", RunPointerKeySkipList(keys, lookup_order), n);
+  Print("MapTable", RunTable<MapTable>(keys, lookup_order), n);
+  Print("SkipList", RunTable<SkipList>(keys, lookup_order), n);
+  Print("ART", RunTable<AdaptiveRadixTree>(keys, lookup_order), n);
+
+  std::printf("bulk load\n");
+  PrintBulk("SkipList", RunBulkLoad<SkipList>(keys), n);
+  PrintBulk("Vector", RunBulkLoad<VectorTable>(keys), n);
+
+  std::vector<std::string> misses = keys;
+  for (std::string& key : misses) {
+    // Sorts among the present keys, so a search goes all the way down.
+    key.back() = static_cast<char>(key.back() - 'a' + 'A');
+  }
+  size_t found_without = 0;
+  size_t found_with = 0;
+  double without_bloom = RunMisses(keys, misses, 0, &found_without);
+  double with_bloom = RunMisses(keys, misses, n * 10 / 8, &found_with);
+  std::printf("misses\n");
+  std::printf("no bloom  lookup %7.3f s %8.2f Mops/s  (%zu found)\n", without_bloom,
+              static_cast<double>(n) / without_bloom / 1e6, found_without);
+  std::printf("bloom     lookup %7.3f s %8.2f Mops/s  (%zu found, 10 bits/key)\n", with_bloom,
+              static_cast<double>(n) / with_bloom / 1e6, found_with);
+
+  size_t distinct = std::max<size_t>(n / 10, 1);
+  std::printf("overwrites (%zu writes over %zu keys)\n", n, distinct);
+  PrintOverwrites("std::map", RunMapOverwrites(keys, distinct, n), n);
+  PrintOverwrites("SkipList", RunOverwrites<SkipList>(keys, distinct, n, false), n);
+  PrintOverwrites("in-place", RunOverwrites<SkipList>(keys, distinct, n, true), n);
+  return 0;
+}
@@ -0,0 +1,172 @@
+#include "blob_file.hpp"
+
+#include <filesystem>
+#include <iostream>
+
+#include "coding.hpp"
+#include "file_sync.hpp"
+
+void BlobIndex::EncodeTo(std::string* dst) const {
+  PutFixed64(dst, file_number);
+  PutFixed64(dst, offset);
+  PutFixed64(dst, size);
+}
+
+Result BlobIndex::DecodeFrom(const Slice& input, BlobIndex* index) {
+  if (input.size() != kEncodedSize) {
+    return Result::Corruption("Blob index has size " + std::to_string(input.size()) + ", expected " +
+                              std::to_string(kEncodedSize));
+  }
+  const char* p = reinterpret_cast<const char*>(input.data());
+  index->file_number = ReadLittleEndian64(p);
+  index->offset = ReadLittleEndian64(p + 8);
+  index->size = ReadLittleEndian64(p + 16);
+  return Result::OK();
+}
+
+BlobFileBuilder::BlobFileBuilder(size_t min_blob_size, uint64_t blob_file_size,
+                                 std::function<BlobFileMetaData()> new_blob_file)
+    : min_blob_size_(min_blob_size),
+      blob_file_size_(blob_file_size > 0 ? blob_file_size : 1),
+      new_blob_file_(std::move(new_blob_file)),
+      rate_limiter_(nullptr),
+      io_priority_(IOPriority::kHigh),
+      is_open_(false),
+      current_file_size_(0) {}
+
+BlobFileBuilder::~BlobFileBuilder() {
+  if (is_open_) {
+    // Unfinished; nothing can reference it yet.
+    out_file_.close();
+    std::error_code ec;
+    std::filesystem::remove(current_.path, ec);
+  }
+}
+
+void BlobFileBuilder::SetRateLimiter(RateLimiter* rate_limiter, IOPriority io_priority) {
+  rate_limiter_ = rate_limiter;
+  io_priority_ = io_priority;
+}
+
+Result BlobFileBuilder::OpenNewFile() {
+  current_ = new_blob_file_();
+  out_file_.open(current_.path, std::ios::binary | std::ios::trunc);
+  if (!out_file_.is_open()) {
+    return Result::IOError("BlobFileBuilder: Failed to open blob file for writing: " + current_.path);
+  }
+  out_file_.write(kBlobFileMagic, kBlobFileMagicSize);
+  if (!out_file_) {
+    return Result::IOError("BlobFileBuilder: Failed to write blob file header: " + current_.path);
+  }
+  is_open_ = true;
+  current_file_size_ = kBlobFileMagicSize;
+  std::cout << "[BlobFileBuilder::OpenNewFile] Writing blob file " << current_.path << std::endl;
+  return Result::OK();
+}
+
+Result BlobFileBuilder::AddBlob(const Slice& key, const Slice& value, std::string* blob_index_out) {
+  if (!is_open_) {
+    Result open_res = OpenNewFile();
+    if (!open_res.ok()) {
+      return open_res;
+    }
+  }
+
+  record_buffer_.clear();
+  PutFixed32(&record_buffer_, static_cast<uint32_t>(key.size()));
+  record_buffer_.append(reinterpret_cast<const char*>(key.data()), key.size());
+  PutFixed32(&record_buffer_, static_cast<uint32_t>(value.size()));
+
+  BlobIndex index;
+  index.file_number = current_.number;
+  index.offset = current_file_size_ + record_buffer_.size();
+  index.size = value.size();
+
+  if (rate_limiter_ != nullptr) {
+    rate_limiter_->Request(static_cast<int64_t>(record_buffer_.size() + value.size()), io_priority_);
+  }
+  out_file_.write(record_buffer_.data(), static_cast<std::streamsize>(record_buffer_.size()));
+  out_file_.write(reinterpret_cast<const char*>(value.data()), static_cast<std::streamsize>(value.size()));
+  if (!out_file_) {
+    return Result::IOError("BlobFileBuilder: Failed to append blob to " + current_.path);
+  }
+  current_file_size_ += record_buffer_.size() + value.size();
+  current_.total_blob_count++;
+  current_.total_blob_bytes += value.size();
+
+  blob_index_out->clear();
+  index.EncodeTo(blob_index_out);
+
+  if (current_file_size_ >= blob_file_size_) {
+    return FinishCurrentFile();
+  }
+  return Result::OK();
+}
+
+Result BlobFileBuilder::FinishCurrentFile() {
+  out_file_.close();
+  is_open_ = false;
+  if (out_file_.fail()) {
+    out_file_.clear();
+    std::error_code ec;
+    std::filesystem::remove(current_.path, ec);
+    return Result::IOError("BlobFileBuilder: Error reported after closing blob file: " + current_.path);
+  }
+  Result sync_res = SyncFile(current_.path);
+  if (!sync_res.ok()) {
+    std::error_code ec;
+    std::filesystem::remove(current_.path, ec);
+    return sync_res;
+  }
+  std::cout << "[BlobFileBuilder::FinishCurrentFile] " << current_.path << ": " << current_.total_blob_count
+            << " blobs, " << current_file_size_ << " bytes." << std::endl;
+  blob_files_.push_back(std::move(current_));
+  current_ = BlobFileMetaData();
+  return Result::OK();
+}
+
+Result BlobFileBuilder::Finish() {
+  if (!is_open_) {
+    return Result::OK();
+  }
+  return FinishCurrentFile();
+}
+
+void BlobFileBuilder::Abandon() {
+  std::error_code ec;
+  if (is_open_) {
+    out_file_.close();
+    out_file_.clear();
+    is_open_ = false;
+    std::filesystem::remove(current_.path, ec);
+  }
+  for (const BlobFileMetaData& blob_file : blob_files_) {
+    std::filesystem::remove(blob_file.path, ec);
+  }
+  blob_files_.clear();
+}
+
+Result ReadBlob(const std::string& path, const BlobIndex& index, char* dst) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    return Result::IOError("Failed to open blob file: " + path);
+  }
+  // The value length stored just before the value doubles as a sanity check
+  // that the index points at a record boundary.
+  if (index.offset < kBlobFileMagicSize + sizeof(uint32_t)) {
+    return Result::Corruption("Blob index offset " + std::to_string(index.offset) + " is inside the header of " + path);
+  }
+  char length_buf[sizeof(uint32_t)];
+  in.seekg(static_cast<std::streamoff>(index.offset - sizeof(uint32_t)));
+  in.read(length_buf, sizeof(length_buf));
+  if (!in || ReadLittleEndian32(length_buf) != index.size) {
+    return Result::Corruption("Blob index does not match a record in " + path);
+  }
+  if (index.size > 0) {
+    in.read(dst, static_cast<std::streamsize>(index.size));
+    if (static_cast<uint64_t>(in.gcount()) != index.size) {
+      return Result::Corruption("Blob at offset " + std::to_string(index.offset) + " extends past the end of " + path);
+    }
+  }
+  return Result::OK();
+}
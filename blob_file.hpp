@@ -0,0 +1,87 @@
+#ifndef BLOB_FILE_HPP
+#define BLOB_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "rate_limiter.hpp"
+#include "result.hpp"
+#include "slice.hpp"
+#include "version_edit.hpp"
+
+// Location of a value that was moved out of an SSTable into a blob file. It is
+// stored in the SSTable, encoded, as the value of a ValueTag::kBlobIndex entry.
+struct BlobIndex {
+  static constexpr size_t kEncodedSize = 24;
+
+  uint64_t file_number = 0;
+  uint64_t offset = 0; // Of the value bytes within the blob file
+  uint64_t size = 0;
+
+  void EncodeTo(std::string* dst) const;
+  static Result DecodeFrom(const Slice& input, BlobIndex* index);
+};
+
+// Blob files start with a magic string followed by records of
+//   key_len (LE32) | key | value_len (LE32) | value
+// The key is kept only so a blob file can be inspected on its own; readers go
+// straight to the value via BlobIndex.
+inline constexpr char kBlobFileMagic[] = "LSMBLOB1";
+inline constexpr size_t kBlobFileMagicSize = sizeof(kBlobFileMagic) - 1;
+
+// Moves large values out of the table being written. Values of at least
+// `min_blob_size` bytes are appended to the current blob file, which is rolled
+// over once it reaches `blob_file_size`. `new_blob_file` supplies the number
+// and path of each new blob file.
+struct BlobFileBuilder {
+ public:
+  BlobFileBuilder(size_t min_blob_size, uint64_t blob_file_size,
+                  std::function<BlobFileMetaData()> new_blob_file);
+  ~BlobFileBuilder();
+
+  BlobFileBuilder(const BlobFileBuilder&) = delete;
+  BlobFileBuilder& operator=(const BlobFileBuilder&) = delete;
+
+  void SetRateLimiter(RateLimiter* rate_limiter, IOPriority io_priority);
+
+  bool ShouldSeparate(size_t value_size) const { return value_size >= min_blob_size_; }
+
+  // Appends `value` and sets `*blob_index_out` to its encoded BlobIndex.
+  Result AddBlob(const Slice& key, const Slice& value, std::string* blob_index_out);
+
+  // Closes the current blob file, if any.
+  Result Finish();
+
+  // Closes and removes every blob file written so far.
+  void Abandon();
+
+  // Finished blob files with their blob counts filled in.
+  const std::vector<BlobFileMetaData>& blob_files() const { return blob_files_; }
+
+ private:
+  Result OpenNewFile();
+  Result FinishCurrentFile();
+
+  size_t min_blob_size_;
+  uint64_t blob_file_size_;
+  std::function<BlobFileMetaData()> new_blob_file_;
+  RateLimiter* rate_limiter_;
+  IOPriority io_priority_;
+
+  std::ofstream out_file_;
+  bool is_open_;
+  BlobFileMetaData current_;
+  uint64_t current_file_size_;
+  std::string record_buffer_;
+  std::vector<BlobFileMetaData> blob_files_;
+};
+
+// Reads the value referenced by `index` from the blob file at `path` into
+// `dst`, which must have room for index.size bytes.
+Result ReadBlob(const std::string& path, const BlobIndex& index, char* dst);
+
+#endif // BLOB_FILE_HPP
@@ -0,0 +1,46 @@
+#ifndef CODING_HPP
+#define CODING_HPP
+
+#include <cstdint>
+#include <string>
+
+// Little-endian fixed-width encoding shared by the on-disk formats.
+
+inline uint32_t ReadLittleEndian32(const char* buffer) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(buffer[0])) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(buffer[1])) << 8) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(buffer[2])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(buffer[3])) << 24);
+}
+
+inline uint64_t ReadLittleEndian64(const char* buffer) {
+    return static_cast<uint64_t>(ReadLittleEndian32(buffer)) |
+           (static_cast<uint64_t>(ReadLittleEndian32(buffer + 4)) << 32);
+}
+
+// Writes `value` to the 4 bytes at `dst`.
+inline void EncodeFixed32(char* dst, uint32_t value) {
+  dst[0] = static_cast<char>(value & 0xFF);
+  dst[1] = static_cast<char>((value >> 8) & 0xFF);
+  dst[2] = static_cast<char>((value >> 16) & 0xFF);
+  dst[3] = static_cast<char>((value >> 24) & 0xFF);
+}
+
+// Writes `value` to the 8 bytes at `dst`.
+inline void EncodeFixed64(char* dst, uint64_t value) {
+  EncodeFixed32(dst, static_cast<uint32_t>(value & 0xFFFFFFFFu));
+  EncodeFixed32(dst + 4, static_cast<uint32_t>(value >> 32));
+}
+
+inline void PutFixed32(std::string* dst, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    dst->push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+inline void PutFixed64(std::string* dst, uint64_t value) {
+  PutFixed32(dst, static_cast<uint32_t>(value & 0xFFFFFFFFu));
+  PutFixed32(dst, static_cast<uint32_t>(value >> 32));
+}
+
+#endif // CODING_HPP
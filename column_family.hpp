@@ -0,0 +1,65 @@
+#ifndef COLUMN_FAMILY_HPP
+#define COLUMN_FAMILY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "arena.hpp"
+#include "file_indexer.hpp"
+#include "mem_table.hpp"
+#include "options.hpp"
+#include "version_edit.hpp"
+
+// Names a column family in DB calls. Handles are owned by the DB and stay
+// valid for as long as it is open.
+struct ColumnFamilyHandle {
+ public:
+  ColumnFamilyHandle(uint32_t id, std::string name) : id_(id), name_(std::move(name)) {}
+
+  uint32_t GetID() const { return id_; }
+  const std::string& GetName() const { return name_; }
+
+ private:
+  uint32_t id_;
+  std::string name_;
+};
+
+// Everything one column family owns: its memtables, options, SSTables and
+// blob files. The families of a DB share its directory, file numbers and
+// write-ahead log.
+struct ColumnFamilyData {
+  ColumnFamilyData(uint32_t id, std::string name, size_t flush_threshold, DBOptions family_options)
+      : handle(id, std::move(name)), threshold(flush_threshold), options(std::move(family_options)) {}
+
+  ColumnFamilyData(const ColumnFamilyData&) = delete;
+  ColumnFamilyData& operator=(const ColumnFamilyData&) = delete;
+
+  uint32_t id() const { return handle.GetID(); }
+  const std::string& name() const { return handle.GetName(); }
+
+  ColumnFamilyHandle handle;
+  // Memtable flush threshold, in bytes.
+  size_t threshold;
+  DBOptions options;
+
+  std::unique_ptr<Arena> active_memtable_arena;
+  std::unique_ptr<MemTable> active_memtable;
+  std::unique_ptr<Arena> immutable_memtable_arena;
+  std::unique_ptr<MemTable> immutable_memtable;
+
+  // levels[0] is newest first; files within levels[1..] never overlap.
+  std::vector<std::vector<FileMetaData>> levels = std::vector<std::vector<FileMetaData>>(kNumLevels);
+  // Search hints for `levels`; updated whenever they change.
+  FileIndexer file_indexer;
+  // Ordered by file number, i.e. oldest first.
+  std::vector<BlobFileMetaData> blob_files;
+
+  // Writes of this family in logs numbered below this are all flushed, so
+  // recovery skips them.
+  uint64_t log_number = 0;
+};
+
+#endif // COLUMN_FAMILY_HPP
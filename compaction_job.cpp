@@ -0,0 +1,349 @@
+#include "compaction_job.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <future>
+#include <thread>
+
+#include "blob_file.hpp"
+#include "make_unique_nothrow.hpp"
+#include "sstable_iterator.hpp"
+#include "sstable_reader.hpp"
+#include "table_builder.hpp"
+
+namespace {
+
+Slice StringAsSlice(const std::string& s) {
+  return Slice(reinterpret_cast<const std::byte*>(s.data()), s.size());
+}
+
+// An input file opened for sequential merging.
+struct InputCursor {
+  std::unique_ptr<SSTableReader> reader;
+  std::unique_ptr<SSTableIterator> iter;
+};
+
+} // namespace
+
+CompactionJob::CompactionJob(std::vector<FileMetaData> inputs, bool bottommost,
+                             const DBOptions& options,
+                             std::function<uint64_t()> new_file_number,
+                             std::function<std::string(uint64_t)> file_path_for_number)
+    : inputs_(std::move(inputs)),
+      bottommost_(bottommost),
+      options_(options),
+      new_file_number_(std::move(new_file_number)),
+      file_path_for_number_(std::move(file_path_for_number)) {}
+
+void CompactionJob::SetBlobOptions(std::function<std::string(uint64_t)> blob_path_for_number,
+                                   std::set<uint64_t> blob_files_to_gc) {
+  blob_path_for_number_ = std::move(blob_path_for_number);
+  blob_files_to_gc_ = std::move(blob_files_to_gc);
+}
+
+Result CompactionJob::GenerateSubcompactions() {
+  subcompactions_.clear();
+  size_t max_subcompactions = options_.max_subcompactions > 1 ? static_cast<size_t>(options_.max_subcompactions) : 1;
+
+  std::vector<std::string> boundaries;
+  if (max_subcompactions > 1) {
+    for (const FileMetaData& input : inputs_) {
+      SSTableReader reader(input.path, options_.comparator);
+      Result init_res = reader.Init();
+      if (!init_res.ok()) {
+        return init_res;
+      }
+      Result keys_res = reader.GetBlockBoundaryKeys(&boundaries);
+      if (!keys_res.ok()) {
+        return keys_res;
+      }
+    }
+    KeyComparator comparator(options_.comparator);
+    std::sort(boundaries.begin(), boundaries.end(), [&comparator](const std::string& a, const std::string& b) {
+      return comparator.Compare(StringAsSlice(a), StringAsSlice(b)) < 0;
+    });
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end(),
+                                 [&comparator](const std::string& a, const std::string& b) {
+                                   return comparator.Compare(StringAsSlice(a), StringAsSlice(b)) == 0;
+                                 }),
+                     boundaries.end());
+    // The smallest boundary is the first key of the whole input; splitting there
+    // would only produce an empty leading range.
+    if (!boundaries.empty()) {
+      boundaries.erase(boundaries.begin());
+    }
+  }
+
+  size_t num_ranges = std::min(max_subcompactions, boundaries.size() + 1);
+  std::vector<std::string> split_keys;
+  for (size_t i = 1; i < num_ranges; ++i) {
+    const std::string& candidate = boundaries[i * boundaries.size() / num_ranges];
+    if (split_keys.empty() || split_keys.back() != candidate) {
+      split_keys.push_back(candidate);
+    }
+  }
+
+  subcompactions_.resize(split_keys.size() + 1);
+  for (size_t i = 0; i < subcompactions_.size(); ++i) {
+    if (i > 0) {
+      subcompactions_[i].start = split_keys[i - 1];
+    }
+    if (i < split_keys.size()) {
+      subcompactions_[i].end = split_keys[i];
+    }
+  }
+  std::cout << "[CompactionJob::GenerateSubcompactions] " << inputs_.size() << " inputs, "
+            << boundaries.size() << " candidate boundaries, " << subcompactions_.size()
+            << " subcompactions." << std::endl;
+  return Result::OK();
+}
+
+void CompactionJob::ProcessSubcompaction(Subcompaction* sub) {
+  KeyComparator comparator(options_.comparator);
+  std::vector<InputCursor> cursors;
+  cursors.reserve(inputs_.size());
+  for (const FileMetaData& input : inputs_) {
+    // An input entirely outside the range contributes nothing; skip opening it.
+    if (input.has_key_range &&
+        ((sub->start.has_value() &&
+          comparator.Compare(StringAsSlice(input.largest_key), StringAsSlice(*sub->start)) < 0) ||
+         (sub->end.has_value() &&
+          comparator.Compare(StringAsSlice(input.smallest_key), StringAsSlice(*sub->end)) >= 0))) {
+      continue;
+    }
+    InputCursor cursor;
+    cursor.reader = make_unique_nothrow<SSTableReader>(input.path, options_.comparator);
+    if (!cursor.reader) {
+      sub->status = Result::ArenaAllocationFail("Failed to allocate SSTableReader for compaction input.");
+      return;
+    }
+    Result init_res = cursor.reader->Init();
+    if (!init_res.ok()) {
+      sub->status = init_res;
+      return;
+    }
+    cursor.iter = make_unique_nothrow<SSTableIterator>(cursor.reader.get());
+    if (!cursor.iter) {
+      sub->status = Result::ArenaAllocationFail("Failed to allocate SSTableIterator for compaction input.");
+      return;
+    }
+    if (sub->start.has_value()) {
+      cursor.iter->Seek(StringAsSlice(*sub->start));
+    } else {
+      cursor.iter->SeekToFirst();
+    }
+    if (!cursor.iter->status().ok()) {
+      sub->status = cursor.iter->status();
+      return;
+    }
+    cursors.push_back(std::move(cursor));
+  }
+
+  // Outputs are streamed straight to disk and rolled over at target_file_size.
+  RollingTableBuilder output(true /* compression_enabled */, options_.target_file_size, [this]() {
+    FileMetaData meta;
+    meta.number = new_file_number_();
+    meta.path = file_path_for_number_(meta.number);
+    return meta;
+  });
+  output.SetRateLimiter(options_.rate_limiter.get(), IOPriority::kLow);
+  output.SetComparator(options_.comparator);
+  std::unique_ptr<BlobFileBuilder> blob_builder;
+  if (options_.enable_blob_files && blob_path_for_number_) {
+    blob_builder = make_unique_nothrow<BlobFileBuilder>(
+        options_.min_blob_size, options_.blob_file_size, [this]() {
+          BlobFileMetaData meta;
+          meta.number = new_file_number_();
+          meta.path = blob_path_for_number_(meta.number);
+          return meta;
+        });
+    if (!blob_builder) {
+      sub->status = Result::ArenaAllocationFail("Failed to allocate BlobFileBuilder for compaction.");
+      return;
+    }
+    blob_builder->SetRateLimiter(options_.rate_limiter.get(), IOPriority::kLow);
+  }
+  auto fail = [&](Result status) {
+    output.Abandon();
+    if (blob_builder) {
+      blob_builder->Abandon();
+    }
+    sub->status = std::move(status);
+  };
+  // A blob reference that does not make it into the output is garbage in its blob file.
+  auto add_blob_garbage = [&](const BlobIndex& index) {
+    VersionEdit::BlobGarbage& garbage = sub->blob_garbage[index.file_number];
+    garbage.blob_file_number = index.file_number;
+    garbage.count++;
+    garbage.bytes += index.size;
+  };
+  std::string blob_index_buffer;
+  std::string relocated_value;
+
+  std::string current_key;
+  while (true) {
+    // Pick the smallest key across inputs; the newest input holding it wins.
+    InputCursor* winner = nullptr;
+    for (InputCursor& cursor : cursors) {
+      if (!cursor.iter->Valid()) {
+        continue;
+      }
+      if (winner == nullptr || comparator.Compare(cursor.iter->key(), winner->iter->key()) < 0) {
+        winner = &cursor;
+      }
+    }
+    if (winner == nullptr) {
+      break;
+    }
+    Slice winner_key = winner->iter->key();
+    if (sub->end.has_value() && comparator.Compare(winner_key, StringAsSlice(*sub->end)) >= 0) {
+      break;
+    }
+
+    current_key = winner_key.ToString();
+    ValueEntry winner_value = winner->iter->value();
+    bool drop = winner_value.IsTombstone() && bottommost_;
+
+    if (!drop) {
+      ValueEntry output_value = winner_value;
+      if (winner_value.IsBlobIndex() && !blob_files_to_gc_.empty()) {
+        BlobIndex index;
+        Result decode_res = BlobIndex::DecodeFrom(winner_value.value_slice, &index);
+        if (!decode_res.ok()) {
+          fail(decode_res);
+          return;
+        }
+        if (blob_files_to_gc_.count(index.file_number) > 0) {
+          // Relocate the blob out of a file that is being garbage collected.
+          relocated_value.resize(index.size);
+          Result read_res = ReadBlob(blob_path_for_number_(index.file_number), index, relocated_value.data());
+          if (!read_res.ok()) {
+            fail(read_res);
+            return;
+          }
+          add_blob_garbage(index);
+          output_value = ValueEntry(StringAsSlice(relocated_value), ValueTag::kData);
+        }
+      }
+      if (blob_builder && output_value.IsValue() && blob_builder->ShouldSeparate(output_value.value_slice.size())) {
+        Result blob_res = blob_builder->AddBlob(winner_key, output_value.value_slice, &blob_index_buffer);
+        if (!blob_res.ok()) {
+          fail(blob_res);
+          return;
+        }
+        output_value = ValueEntry(StringAsSlice(blob_index_buffer), ValueTag::kBlobIndex);
+      }
+      Result add_res = output.Add(winner_key, output_value);
+      if (!add_res.ok()) {
+        fail(add_res);
+        return;
+      }
+    }
+
+    // Skip every older version of this key.
+    Slice key_slice = StringAsSlice(current_key);
+    for (InputCursor& cursor : cursors) {
+      bool at_winner = (&cursor == winner);
+      while (cursor.iter->Valid() && comparator.Compare(cursor.iter->key(), key_slice) == 0) {
+        ValueEntry shadowed = cursor.iter->value();
+        if (!at_winner && shadowed.IsBlobIndex()) {
+          BlobIndex index;
+          Result decode_res = BlobIndex::DecodeFrom(shadowed.value_slice, &index);
+          if (!decode_res.ok()) {
+            fail(decode_res);
+            return;
+          }
+          add_blob_garbage(index);
+        }
+        at_winner = false;
+        cursor.iter->Next();
+      }
+      if (!cursor.iter->status().ok()) {
+        fail(cursor.iter->status());
+        return;
+      }
+    }
+  }
+
+  Result finish_res = output.Finish();
+  if (finish_res.ok() && blob_builder) {
+    finish_res = blob_builder->Finish();
+  }
+  if (!finish_res.ok()) {
+    fail(finish_res);
+    return;
+  }
+  sub->outputs = output.outputs();
+  if (blob_builder) {
+    sub->blob_outputs = blob_builder->blob_files();
+  }
+  sub->status = Result::OK();
+}
+
+Result CompactionJob::Run() {
+  Result gen_res = GenerateSubcompactions();
+  if (!gen_res.ok()) {
+    return gen_res;
+  }
+
+  // Subcompaction 0 runs on the calling thread, the rest as compaction jobs of
+  // the thread pool, or on threads of their own when there is no pool.
+  std::vector<std::future<void>> pool_jobs;
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < subcompactions_.size(); ++i) {
+    Subcompaction* sub = &subcompactions_[i];
+    if (options_.thread_pool) {
+      pool_jobs.push_back(options_.thread_pool->Schedule([this, sub]() { ProcessSubcompaction(sub); },
+                                                         ThreadPriority::kLow));
+    } else {
+      threads.emplace_back(&CompactionJob::ProcessSubcompaction, this, sub);
+    }
+  }
+  ProcessSubcompaction(&subcompactions_[0]);
+  for (std::future<void>& job : pool_jobs) {
+    job.wait();
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+
+  outputs_.clear();
+  blob_outputs_.clear();
+  blob_garbage_.clear();
+  for (Subcompaction& sub : subcompactions_) {
+    if (!sub.status.ok()) {
+      std::cout << "[CompactionJob::Run] Subcompaction failed: " << sub.status.message() << std::endl;
+      return sub.status;
+    }
+    outputs_.insert(outputs_.end(), sub.outputs.begin(), sub.outputs.end());
+    blob_outputs_.insert(blob_outputs_.end(), sub.blob_outputs.begin(), sub.blob_outputs.end());
+    for (const auto& [blob_file_number, garbage] : sub.blob_garbage) {
+      VersionEdit::BlobGarbage& total = blob_garbage_[blob_file_number];
+      total.blob_file_number = blob_file_number;
+      total.count += garbage.count;
+      total.bytes += garbage.bytes;
+    }
+  }
+  std::cout << "[CompactionJob::Run] Done. " << inputs_.size() << " inputs -> "
+            << outputs_.size() << " outputs." << std::endl;
+  return Result::OK();
+}
+
+void CompactionJob::DeleteOutputFiles() {
+  for (Subcompaction& sub : subcompactions_) {
+    for (const FileMetaData& output : sub.outputs) {
+      std::error_code ec;
+      std::filesystem::remove(output.path, ec);
+    }
+    for (const BlobFileMetaData& blob_output : sub.blob_outputs) {
+      std::error_code ec;
+      std::filesystem::remove(blob_output.path, ec);
+    }
+    sub.outputs.clear();
+    sub.blob_outputs.clear();
+  }
+  outputs_.clear();
+  blob_outputs_.clear();
+}
@@ -0,0 +1,88 @@
+#ifndef COMPACTION_JOB_HPP
+#define COMPACTION_JOB_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "options.hpp"
+#include "result.hpp"
+#include "slice.hpp"
+#include "version_edit.hpp"
+
+// Merges a set of input SSTables into new, non-overlapping output files.
+//
+// The input key space is split into up to DBOptions::max_subcompactions
+// disjoint ranges, using the first keys of the inputs' data blocks as split
+// points. Each range is merged into its own output files, in parallel on the
+// calling thread and the compaction threads of DBOptions::thread_pool.
+// The job never touches DB state; the caller installs outputs() with a single
+// VersionEdit once Run() succeeds.
+struct CompactionJob {
+ public:
+  // inputs must be ordered newest first: when several inputs hold the same key,
+  // the entry from the input with the lowest index wins.
+  // When bottommost is true no older data exists below the output level, so
+  // tombstones are dropped instead of being written out.
+  CompactionJob(std::vector<FileMetaData> inputs, bool bottommost,
+                const DBOptions& options,
+                std::function<uint64_t()> new_file_number,
+                std::function<std::string(uint64_t)> file_path_for_number);
+
+  CompactionJob(const CompactionJob&) = delete;
+  CompactionJob& operator=(const CompactionJob&) = delete;
+
+  // Enables blob handling when DBOptions::enable_blob_files is set or input
+  // files may hold blob references. Blob files are named by
+  // `blob_path_for_number`; blobs still referenced from `blob_files_to_gc`
+  // are copied into new blob files so the old ones can be dropped.
+  void SetBlobOptions(std::function<std::string(uint64_t)> blob_path_for_number,
+                      std::set<uint64_t> blob_files_to_gc);
+
+  Result Run();
+
+  // Output files of all subcompactions, in key order. Valid after Run() succeeds.
+  const std::vector<FileMetaData>& outputs() const { return outputs_; }
+  size_t NumSubcompactions() const { return subcompactions_.size(); }
+
+  // Blob files written by the job, and blobs its inputs referenced that the
+  // outputs no longer do, per blob file. Valid after Run() succeeds.
+  const std::vector<BlobFileMetaData>& blob_outputs() const { return blob_outputs_; }
+  const std::map<uint64_t, VersionEdit::BlobGarbage>& blob_garbage() const { return blob_garbage_; }
+
+  // Removes any output files written so far. Used when Run() fails.
+  void DeleteOutputFiles();
+
+ private:
+  struct Subcompaction {
+    std::optional<std::string> start; // Inclusive; unset means unbounded
+    std::optional<std::string> end;   // Exclusive; unset means unbounded
+    std::vector<FileMetaData> outputs;
+    std::vector<BlobFileMetaData> blob_outputs;
+    std::map<uint64_t, VersionEdit::BlobGarbage> blob_garbage;
+    Result status;
+  };
+
+  Result GenerateSubcompactions();
+  void ProcessSubcompaction(Subcompaction* sub);
+
+  std::vector<FileMetaData> inputs_;
+  bool bottommost_;
+  DBOptions options_;
+  std::function<uint64_t()> new_file_number_;
+  std::function<std::string(uint64_t)> file_path_for_number_;
+
+  std::function<std::string(uint64_t)> blob_path_for_number_;
+  std::set<uint64_t> blob_files_to_gc_;
+
+  std::vector<Subcompaction> subcompactions_;
+  std::vector<FileMetaData> outputs_;
+  std::vector<BlobFileMetaData> blob_outputs_;
+  std::map<uint64_t, VersionEdit::BlobGarbage> blob_garbage_;
+};
+
+#endif // COMPACTION_JOB_HPP
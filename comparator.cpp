@@ -0,0 +1,16 @@
+#include "comparator.hpp"
+
+namespace {
+
+class BytewiseComparatorImpl : public Comparator {
+ public:
+  int Compare(const Slice& a, const Slice& b) const override { return a.compare(b); }
+  const char* Name() const override { return "lsm.BytewiseComparator"; }
+};
+
+} // namespace
+
+const Comparator* BytewiseComparator() {
+  static const BytewiseComparatorImpl bytewise;
+  return &bytewise;
+}
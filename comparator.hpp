@@ -0,0 +1,53 @@
+#ifndef COMPARATOR_HPP
+#define COMPARATOR_HPP
+
+#include "slice.hpp"
+
+// Defines the order of keys in memtables, SSTables and compaction output.
+// A comparator must be a total order and must not change for the lifetime
+// of the data: its Name() is recorded in every SSTable and in the manifest,
+// and a DB refuses to open with a comparator of a different name.
+class Comparator {
+ public:
+  virtual ~Comparator() = default;
+
+  // Negative if a < b, 0 if equal, positive if a > b.
+  virtual int Compare(const Slice& a, const Slice& b) const = 0;
+
+  // Identifies the ordering. Change it whenever Compare changes.
+  virtual const char* Name() const = 0;
+};
+
+// Orders keys by their bytes, as memcmp does, with a shorter key before any
+// longer key it is a prefix of. This is the default.
+const Comparator* BytewiseComparator();
+
+// The form a Comparator takes inside the engine's hot loops. The bytewise
+// comparator is recognised once, when this is built, and is then compared
+// inline instead of through a virtual call. Also usable as a std::map
+// "less than".
+struct KeyComparator {
+ public:
+  explicit KeyComparator(const Comparator* comparator = BytewiseComparator())
+      : comparator_(comparator != nullptr ? comparator : BytewiseComparator()),
+        bytewise_(comparator_ == BytewiseComparator()) {}
+
+  int Compare(const Slice& a, const Slice& b) const {
+    return bytewise_ ? a.compare(b) : comparator_->Compare(a, b);
+  }
+
+  bool operator()(const Slice& a, const Slice& b) const { return Compare(a, b) < 0; }
+
+  // True when keys are ordered by their bytes, so byte-level shortcuts
+  // such as KeyPrefix apply.
+  bool IsBytewise() const { return bytewise_; }
+
+  const Comparator* comparator() const { return comparator_; }
+  const char* Name() const { return comparator_->Name(); }
+
+ private:
+  const Comparator* comparator_;
+  bool bytewise_;
+};
+
+#endif // COMPARATOR_HPP
@@ -0,0 +1,45 @@
+#include "crc32.hpp"
+
+#include <array>
+
+namespace {
+
+constexpr uint32_t kCRC32Polynomial = 0xEDB88320u; // Reflected 0x04C11DB7
+
+constexpr std::array<uint32_t, 256> MakeCRC32Table() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1) ? (crc >> 1) ^ kCRC32Polynomial : crc >> 1;
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+constexpr std::array<uint32_t, 256> kCRC32Table = MakeCRC32Table();
+
+// `crc` is the running value before the final inversion.
+uint32_t ExtendCRC32(uint32_t crc, const unsigned char* data, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    crc = kCRC32Table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+} // namespace
+
+uint32_t CalculateCRC32(const char* data, size_t length) {
+  return ExtendCRC32(0xFFFFFFFFu, reinterpret_cast<const unsigned char*>(data), length) ^ 0xFFFFFFFFu;
+}
+
+uint32_t CalculateCRC32(const Slice& data1, const Slice& data2, const Slice& data3) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (const Slice* piece : {&data1, &data2, &data3}) {
+    if (!piece->empty()) {
+      crc = ExtendCRC32(crc, reinterpret_cast<const unsigned char*>(piece->data()), piece->size());
+    }
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
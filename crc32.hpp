@@ -1,6 +1,13 @@
+#ifndef CRC32_HPP
+#define CRC32_HPP
+
 #include "slice.hpp"
 
 #include <cstdint>
 
+// CRC-32 (IEEE 802.3 polynomial). The Slice overload checksums the
+// concatenation of up to three pieces without copying them together.
 uint32_t CalculateCRC32(const char* data, size_t length);
-uint32_t CalculateCRC32(const Slice& data1, const Slice& data2 = Slice(), const Slice& data3 = Slice());
\ No newline at end of file
+uint32_t CalculateCRC32(const Slice& data1, const Slice& data2 = Slice(), const Slice& data3 = Slice());
+
+#endif // CRC32_HPP
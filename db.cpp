@@ -4,33 +4,399 @@
 #include <filesystem>   // For directory operations
 #include <iomanip>      // For std::setw, std::setfill
 #include <iostream>     // For std::cout debug prints
+#include <limits>
 #include <sstream>      // For std::ostringstream
 #include <cstring>      // For std::memcpy
+#include <chrono>
+#include <thread>
 
+#include "blob_file.hpp"
+#include "compaction_job.hpp"
+#include "file_sync.hpp"
 #include "make_unique_nothrow.hpp"
+#include "manifest.hpp"
 #include "sstable_reader.hpp"
 #include "sstable_writer.hpp"
+#include "wal_reader.hpp"
 
-DB::DB(std::string db_directory, std::size_t threshold)
-    : db_dir_(std::move(db_directory)),
+DB::DB(std::string db_directory, std::size_t threshold, DBOptions options)
+    : default_cfd_(nullptr),
+      next_column_family_id_(kDefaultColumnFamilyId + 1),
       threshold_(threshold),
-      next_sstable_id_(1), // Start SSTable IDs from 1
-      active_memtable_arena_(nullptr),
-      active_memtable_(nullptr),
-      immutable_memtable_arena_(nullptr),
-      immutable_memtable_(nullptr) {
+      db_dir_(std::move(db_directory)),
+      options_(std::move(options)),
+      write_controller_(options_),
+      next_sstable_id_(1) { // Start SSTable IDs from 1
   std::cout << "[DB Constructor] Called. Dir: " << db_dir_ << ", Threshold: " << threshold_ << std::endl;
+  if (!options_.thread_pool) {
+    // The calling thread runs one subcompaction itself.
+    ThreadPoolOptions pool_options;
+    pool_options.low_priority_threads = std::max(options_.max_subcompactions - 1, 1);
+    options_.thread_pool = std::make_shared<ThreadPool>(std::move(pool_options));
+  }
+}
+
+DB::~DB() {
+  // Pool jobs of suspended lookups still call EndAsyncRead on this DB.
+  std::unique_lock<std::mutex> lock(async_reads_mutex_);
+  async_reads_done_.wait(lock, [this] { return async_reads_in_flight_ == 0; });
 }
 
-std::string DB::GenerateSSTableFilename() {
+std::string DB::GenerateSSTableFilename(uint64_t file_number) const {
   std::ostringstream filename_stream;
   // Format: 000001.sst, 000002.sst etc.
-  filename_stream << std::setw(6) << std::setfill('0') << next_sstable_id_
+  filename_stream << std::setw(6) << std::setfill('0') << file_number
                   << ".sst";
   return filename_stream.str();
 }
 
+std::string DB::GenerateBlobFilename(uint64_t file_number) const {
+  std::ostringstream filename_stream;
+  // Blob files share the SSTable number space: 000007.blob
+  filename_stream << std::setw(6) << std::setfill('0') << file_number
+                  << ".blob";
+  return filename_stream.str();
+}
+
+std::string DB::GenerateLogFilename(uint64_t file_number) const {
+  std::ostringstream filename_stream;
+  // Logs share the SSTable number space too: 000009.log
+  filename_stream << std::setw(6) << std::setfill('0') << file_number
+                  << ".log";
+  return filename_stream.str();
+}
+
+uint64_t DB::NewFileNumber() {
+  std::lock_guard<std::mutex> lock(file_number_mutex_);
+  return next_sstable_id_++;
+}
+
+ColumnFamilyData* DB::GetColumnFamilyData(ColumnFamilyHandle* column_family) const {
+  if (column_family == nullptr) {
+    return default_cfd_;
+  }
+  auto it = column_families_.find(column_family->GetID());
+  return it == column_families_.end() ? nullptr : it->second.get();
+}
+
+namespace {
+
+// Bytes of Bloom filter in each memtable of `cfd`; 0 when disabled.
+size_t MemTableBloomBytes(const ColumnFamilyData& cfd) {
+  double ratio = std::clamp(cfd.options.memtable_bloom_size_ratio, 0.0, 0.25);
+  return static_cast<size_t>(static_cast<double>(cfd.threshold) * ratio);
+}
+
+Slice StringAsSlice(const std::string& s) {
+  return Slice(reinterpret_cast<const std::byte*>(s.data()), s.size());
+}
+
+Result ReadFileKeyRange(const std::string& path, std::string* smallest, std::string* largest) {
+  SSTableReader reader(path);
+  Result init_res = reader.Init();
+  if (!init_res.ok()) {
+    return init_res;
+  }
+  return reader.GetKeyRange(smallest, largest);
+}
+
+bool RangesOverlap(const KeyComparator& comparator,
+                   const std::string& a_smallest, const std::string& a_largest,
+                   const std::string& b_smallest, const std::string& b_largest) {
+  return !(comparator.Compare(StringAsSlice(a_largest), StringAsSlice(b_smallest)) < 0 ||
+           comparator.Compare(StringAsSlice(b_largest), StringAsSlice(a_smallest)) < 0);
+}
+
+// Points *smallest and *largest at the files holding the smallest and largest
+// key of `files`. False if `files` is empty or one of them has no recorded
+// key range.
+bool KeyRangeOf(const KeyComparator& comparator, const std::vector<FileMetaData>& files,
+                const FileMetaData** smallest, const FileMetaData** largest) {
+  *smallest = nullptr;
+  *largest = nullptr;
+  for (const FileMetaData& f : files) {
+    if (!f.has_key_range) {
+      return false;
+    }
+    if (*smallest == nullptr ||
+        comparator.Compare(StringAsSlice(f.smallest_key), StringAsSlice((*smallest)->smallest_key)) < 0) {
+      *smallest = &f;
+    }
+    if (*largest == nullptr ||
+        comparator.Compare(StringAsSlice(f.largest_key), StringAsSlice((*largest)->largest_key)) > 0) {
+      *largest = &f;
+    }
+  }
+  return *smallest != nullptr;
+}
+
+// The L1 files an L0 compaction has to merge: those overlapping the key range
+// of L0. A file without a recorded range is assumed to overlap everything.
+std::vector<FileMetaData> L1FilesOverlappingL0(const ColumnFamilyData& cfd) {
+  KeyComparator comparator(cfd.options.comparator);
+  const FileMetaData* smallest;
+  const FileMetaData* largest;
+  if (!KeyRangeOf(comparator, cfd.levels[0], &smallest, &largest)) {
+    return cfd.levels[0].empty() ? std::vector<FileMetaData>() : cfd.levels[1];
+  }
+  std::vector<FileMetaData> overlapping;
+  for (const FileMetaData& f : cfd.levels[1]) {
+    if (!f.has_key_range ||
+        RangesOverlap(comparator, smallest->smallest_key, largest->largest_key, f.smallest_key, f.largest_key)) {
+      overlapping.push_back(f);
+    }
+  }
+  return overlapping;
+}
+
+// Whether a file in L2 or deeper may hold keys in the range of `inputs`.
+bool OverlapsBelowL1(const ColumnFamilyData& cfd, const std::vector<FileMetaData>& inputs) {
+  KeyComparator comparator(cfd.options.comparator);
+  const FileMetaData* smallest;
+  const FileMetaData* largest;
+  bool has_range = KeyRangeOf(comparator, inputs, &smallest, &largest);
+  for (size_t level = 2; level < cfd.levels.size(); ++level) {
+    for (const FileMetaData& f : cfd.levels[level]) {
+      if (!has_range || !f.has_key_range ||
+          RangesOverlap(comparator, smallest->smallest_key, largest->largest_key, f.smallest_key, f.largest_key)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+Result DB::NewColumnFamilyData(uint32_t id, const std::string& name, std::size_t threshold,
+                               DBOptions options, ColumnFamilyData** cfd_out) {
+  // The rate limiter paces the shared device and the thread pool bounds
+  // background threads, so every family uses the DB's.
+  options.rate_limiter = options_.rate_limiter;
+  options.thread_pool = options_.thread_pool;
+  if (options.memtable_factory == nullptr) {
+    options.memtable_factory = MapMemTableFactory();
+  }
+  if (!options.memtable_factory->SupportsComparator(options.comparator)) {
+    return Result::InvalidArgument(std::string("Memtable ") + options.memtable_factory->Name() +
+                                   " does not support comparator " + options.comparator->Name() +
+                                   " (column family '" + name + "').");
+  }
+  if (options.inplace_update_support && !options.memtable_factory->SupportsInplaceUpdate()) {
+    return Result::InvalidArgument(std::string("Memtable ") + options.memtable_factory->Name() +
+                                   " does not support in-place updates (column family '" + name + "').");
+  }
+  auto cfd = make_unique_nothrow<ColumnFamilyData>(id, name, threshold, std::move(options));
+  if (!cfd) {
+    return Result::ArenaAllocationFail("Failed to allocate column family '" + name + "'.");
+  }
+  cfd->active_memtable_arena = make_unique_nothrow<Arena>();
+  if (!cfd->active_memtable_arena) {
+    return Result::ArenaAllocationFail("Failed to allocate Arena for the memtable of column family '" + name + "'.");
+  }
+  cfd->active_memtable = make_unique_nothrow<MemTable>(*cfd->active_memtable_arena, cfd->options.comparator,
+                                                      cfd->options.memtable_factory, MemTableBloomBytes(*cfd),
+                                                      cfd->options.inplace_update_support);
+  if (!cfd->active_memtable) {
+    return Result::ArenaAllocationFail("Failed to allocate the memtable of column family '" + name + "'.");
+  }
+  *cfd_out = cfd.get();
+  column_families_[id] = std::move(cfd);
+  next_column_family_id_ = std::max(next_column_family_id_, id + 1);
+  std::cout << "[DB::NewColumnFamilyData] Column family '" << name << "' (id " << id << ") ready." << std::endl;
+  return Result::OK();
+}
+
+Result DB::ApplyVersionEdit(ColumnFamilyData* cfd, const VersionEdit& edit) {
+  std::vector<std::vector<FileMetaData>> new_levels = cfd->levels;
+  for (const auto& [level, file_number] : edit.deleted_files_) {
+    std::vector<FileMetaData>& files = new_levels[static_cast<size_t>(level)];
+    files.erase(std::remove_if(files.begin(), files.end(),
+                               [file_number = file_number](const FileMetaData& f) { return f.number == file_number; }),
+                files.end());
+  }
+  std::vector<FileMetaData> new_l0_files;
+  for (const auto& [level, file] : edit.new_files_) {
+    if (level == 0) {
+      new_l0_files.push_back(file);
+    } else {
+      new_levels[static_cast<size_t>(level)].push_back(file);
+    }
+  }
+  // L0 is kept newest first; files within one edit are listed oldest first.
+  new_levels[0].insert(new_levels[0].begin(), new_l0_files.rbegin(), new_l0_files.rend());
+  // Deeper levels are kept in key order. Files without a recorded range
+  // cannot be placed and go first.
+  KeyComparator comparator(cfd->options.comparator);
+  for (size_t level = 1; level < new_levels.size(); ++level) {
+    std::stable_sort(new_levels[level].begin(), new_levels[level].end(),
+                     [&comparator](const FileMetaData& a, const FileMetaData& b) {
+                       if (!a.has_key_range || !b.has_key_range) {
+                         return !a.has_key_range && b.has_key_range;
+                       }
+                       return comparator.Compare(StringAsSlice(a.smallest_key), StringAsSlice(b.smallest_key)) < 0;
+                     });
+  }
+
+  std::vector<BlobFileMetaData> new_blob_files = cfd->blob_files;
+  new_blob_files.insert(new_blob_files.end(), edit.new_blob_files_.begin(), edit.new_blob_files_.end());
+  for (const VersionEdit::BlobGarbage& garbage : edit.blob_garbage_) {
+    for (BlobFileMetaData& blob_file : new_blob_files) {
+      if (blob_file.number == garbage.blob_file_number) {
+        blob_file.garbage_blob_count += garbage.count;
+        blob_file.garbage_blob_bytes += garbage.bytes;
+        break;
+      }
+    }
+  }
+  std::vector<BlobFileMetaData> obsolete_blob_files;
+  auto obsolete_begin = std::stable_partition(new_blob_files.begin(), new_blob_files.end(),
+                                              [](const BlobFileMetaData& b) { return !b.IsObsolete(); });
+  obsolete_blob_files.assign(obsolete_begin, new_blob_files.end());
+  new_blob_files.erase(obsolete_begin, new_blob_files.end());
+  uint64_t new_log_number = edit.has_log_number_ ? edit.log_number_ : cfd->log_number;
+
+  // The edit only takes effect once it is durable in the manifest.
+  ManifestContents contents = BuildManifestContents();
+  for (ColumnFamilyManifest& cf : contents.column_families) {
+    if (cf.id == cfd->id()) {
+      cf.levels = new_levels;
+      cf.blob_files = new_blob_files;
+      cf.log_number = new_log_number;
+    }
+  }
+  Result persist_res = WriteManifest(db_dir_, contents);
+  if (!persist_res.ok()) {
+    std::cout << "[DB::ApplyVersionEdit] Failed to persist manifest: " << persist_res.message() << std::endl;
+    return persist_res;
+  }
+  cfd->levels = std::move(new_levels);
+  cfd->file_indexer.Update(comparator, cfd->levels);
+  cfd->blob_files = std::move(new_blob_files);
+  cfd->log_number = new_log_number;
+
+  // Nothing references these blob files any more.
+  for (const BlobFileMetaData& blob_file : obsolete_blob_files) {
+    RemoveObsoleteFile(blob_file.path);
+  }
+  TuneRateLimiter();
+  return Result::OK();
+}
+
+ManifestContents DB::BuildManifestContents() const {
+  ManifestContents contents;
+  {
+    std::lock_guard<std::mutex> lock(file_number_mutex_);
+    contents.next_file_number = next_sstable_id_;
+  }
+  contents.column_families.clear();
+  // std::map keeps the default family (id 0) first.
+  for (const auto& [id, cfd] : column_families_) {
+    ColumnFamilyManifest cf;
+    cf.id = id;
+    cf.name = cfd->name();
+    cf.log_number = cfd->log_number;
+    cf.comparator_name = cfd->options.comparator->Name();
+    cf.levels = cfd->levels;
+    cf.blob_files = cfd->blob_files;
+    contents.column_families.push_back(std::move(cf));
+  }
+  return contents;
+}
+
+std::set<uint64_t> DB::SelectBlobFilesForGC(const ColumnFamilyData& cfd) const {
+  std::set<uint64_t> selected;
+  if (!cfd.options.enable_blob_garbage_collection) {
+    return selected;
+  }
+  double cutoff = std::clamp(cfd.options.blob_garbage_collection_age_cutoff, 0.0, 1.0);
+  size_t count = static_cast<size_t>(cutoff * static_cast<double>(cfd.blob_files.size()));
+  for (size_t i = 0; i < count; ++i) {
+    selected.insert(cfd.blob_files[i].number);
+  }
+  return selected;
+}
+
+Result DB::ResolveBlobIndex(const std::vector<BlobFileMetaData>& blob_files, const Slice& blob_index,
+                            Arena* arena, Slice* value_out) {
+  BlobIndex index;
+  Result decode_res = BlobIndex::DecodeFrom(blob_index, &index);
+  if (!decode_res.ok()) {
+    return decode_res;
+  }
+  auto it = std::find_if(blob_files.begin(), blob_files.end(),
+                         [&index](const BlobFileMetaData& b) { return b.number == index.file_number; });
+  if (it == blob_files.end()) {
+    return Result::Corruption("Blob index refers to unknown blob file " + std::to_string(index.file_number));
+  }
+  char* dst = static_cast<char*>(arena->Allocate(index.size, alignof(std::byte)));
+  if (index.size > 0 && dst == nullptr) {
+    return Result::ArenaAllocationFail("Failed to allocate " + std::to_string(index.size) + " bytes for blob value.");
+  }
+  Result read_res = ReadBlob(it->path, index, dst);
+  if (!read_res.ok()) {
+    return read_res;
+  }
+  *value_out = Slice(reinterpret_cast<const std::byte*>(dst), index.size);
+  return Result::OK();
+}
+
+uint64_t DB::EstimatePendingCompactionBytes(const ColumnFamilyData& cfd) const {
+  if (cfd.levels[0].empty()) {
+    return 0;
+  }
+  uint64_t pending = 0;
+  for (const FileMetaData& f : cfd.levels[0]) {
+    pending += f.file_size;
+  }
+  for (const FileMetaData& f : L1FilesOverlappingL0(cfd)) {
+    pending += f.file_size;
+  }
+  return pending;
+}
+
+uint64_t DB::EstimatePendingCompactionBytes() const {
+  uint64_t pending = 0;
+  for (const auto& [id, cfd] : column_families_) {
+    pending += EstimatePendingCompactionBytes(*cfd);
+  }
+  return pending;
+}
+
+void DB::TuneRateLimiter() {
+  if (options_.rate_limiter && options_.rate_limiter->IsAutoTuned()) {
+    options_.rate_limiter->TuneForBacklog(EstimatePendingCompactionBytes());
+    std::cout << "[DB::TuneRateLimiter] Rate now " << options_.rate_limiter->GetBytesPerSecond() << " bytes/s." << std::endl;
+  }
+}
+
+size_t DB::NumFilesAtLevel(int level) const {
+  return NumFilesAtLevel(nullptr, level);
+}
+
+size_t DB::NumFilesAtLevel(ColumnFamilyHandle* column_family, int level) const {
+  ColumnFamilyData* cfd = GetColumnFamilyData(column_family);
+  if (cfd == nullptr || level < 0 || level >= kNumLevels) {
+    return 0;
+  }
+  return cfd->levels[static_cast<size_t>(level)].size();
+}
+
+const std::vector<BlobFileMetaData>& DB::GetLiveBlobFiles() const {
+  return GetLiveBlobFiles(nullptr);
+}
+
+const std::vector<BlobFileMetaData>& DB::GetLiveBlobFiles(ColumnFamilyHandle* column_family) const {
+  static const std::vector<BlobFileMetaData> kNoBlobFiles;
+  ColumnFamilyData* cfd = GetColumnFamilyData(column_family);
+  return cfd == nullptr ? kNoBlobFiles : cfd->blob_files;
+}
+
 Result DB::Init() {
+  return Init({});
+}
+
+Result DB::Init(const std::map<std::string, DBOptions>& column_family_options) {
   std::cout << "[DB::Init] Called." << std::endl;
   std::error_code ec;
   std::filesystem::path db_path = db_dir_;
@@ -58,255 +424,1062 @@ Result DB::Init() {
     std::cout << "[DB::Init] Directory '" << db_dir_ << "' created." << std::endl;
   }
 
-  std::cout << "[DB::Init] Directory OK. Creating active_memtable_arena_." << std::endl;
-  active_memtable_arena_ = make_unique_nothrow<Arena>();
-  if (!active_memtable_arena_) {
-    std::cout << "[DB::Init] Failed to allocate Arena object for active MemTable." << std::endl;
-    return Result::ArenaAllocationFail("Failed to allocate Arena object for active MemTable in Init.");
+  ManifestContents manifest;
+  Result manifest_res = ReadManifest(db_dir_, &manifest);
+  if (!manifest_res.ok() && manifest_res.code() != ResultCode::kNotFound) {
+    std::cout << "[DB::Init] Failed to read manifest: " << manifest_res.message() << std::endl;
+    return manifest_res;
   }
-  std::cout << "[DB::Init] active_memtable_arena_ CREATED. Ptr: " << active_memtable_arena_.get() << std::endl;
-  
-  std::cout << "[DB::Init] Creating active_memtable_." << std::endl;
-  active_memtable_ = make_unique_nothrow<MemTable>(*active_memtable_arena_);
-  if (!active_memtable_) {
-    std::cout << "[DB::Init] Failed to allocate MemTable object for active MemTable." << std::endl;
-    active_memtable_arena_.reset(); 
-    return Result::ArenaAllocationFail("Failed to allocate MemTable object for active MemTable in Init.");
+  // A fresh DB starts from the default-constructed contents: just the default family.
+  for (ColumnFamilyManifest& cf : manifest.column_families) {
+    bool is_default = (cf.id == kDefaultColumnFamilyId);
+    auto cf_options = column_family_options.find(cf.name);
+    const DBOptions& options = (is_default || cf_options == column_family_options.end()) ? options_ : cf_options->second;
+    // Manifests written before comparators were recorded name none.
+    if (!cf.comparator_name.empty() && cf.comparator_name != options.comparator->Name()) {
+      return Result::InvalidArgument("Column family '" + cf.name + "' was written with comparator '" +
+                                     cf.comparator_name + "', not '" + options.comparator->Name() + "'.");
+    }
+    ColumnFamilyData* cfd = nullptr;
+    Result cf_res = NewColumnFamilyData(cf.id, cf.name, threshold_, options, &cfd);
+    if (!cf_res.ok()) {
+      return cf_res;
+    }
+    cfd->levels = std::move(cf.levels);
+    // Manifests written before key ranges were recorded lack them; the
+    // tables' properties have them. A file that cannot be read keeps none
+    // and is simply never pruned.
+    for (std::vector<FileMetaData>& level_files : cfd->levels) {
+      for (FileMetaData& f : level_files) {
+        if (!f.has_key_range && ReadFileKeyRange(f.path, &f.smallest_key, &f.largest_key).ok()) {
+          f.has_key_range = true;
+        }
+      }
+    }
+    cfd->file_indexer.Update(KeyComparator(cfd->options.comparator), cfd->levels);
+    cfd->blob_files = std::move(cf.blob_files);
+    cfd->log_number = cf.log_number;
+    if (is_default) {
+      default_cfd_ = cfd;
+    }
   }
-  std::cout << "[DB::Init] active_memtable_ CREATED. Ptr: " << active_memtable_.get() << std::endl;
+  next_sstable_id_ = manifest.next_file_number;
+  std::cout << "[DB::Init] " << (manifest_res.ok() ? "Loaded manifest" : "New DB") << ". Column families: "
+            << column_families_.size() << ", default L0 files: " << default_cfd_->levels[0].size()
+            << ", next file number: " << next_sstable_id_ << std::endl;
 
-  // TODO(Persistence): In a real DB, scan db_dir_ for existing *.sst files here.
-  // Populate l0_sstables_ (sorted newest to oldest, or sort after scan).
-  // Update next_sstable_id_ to be max_existing_id + 1.
+  bool damaged = false;
+  Result recover_res = RecoverLogs(&damaged);
+  if (!recover_res.ok()) {
+    std::cout << "[DB::Init] Log recovery failed: " << recover_res.message() << std::endl;
+    return recover_res;
+  }
+  uint64_t log_number = 0;
+  Result log_res = SwitchLog(&log_number);
+  if (!log_res.ok()) {
+    return log_res;
+  }
+
+  if (damaged) {
+    // Replay stopped early, so the logs after the damage must not be replayed
+    // by a later Init either. Flush what was recovered and retire every old log.
+    for (auto& [id, cfd] : column_families_) {
+      if (!ActiveMemTableIsEmpty(*cfd)) {
+        Result flush_res = FlushMemTable(cfd.get());
+        if (!flush_res.ok()) {
+          return flush_res;
+        }
+      }
+    }
+    for (auto& [id, cfd] : column_families_) {
+      cfd->log_number = std::max(cfd->log_number, log_number);
+    }
+  }
+  if (!manifest_res.ok() || damaged) {
+    Result persist_res = WriteManifest(db_dir_, BuildManifestContents());
+    if (!persist_res.ok()) {
+      return persist_res;
+    }
+  }
+  DeleteObsoleteLogs();
+  TuneRateLimiter();
 
   std::cout << "[DB::Init] Returning OK." << std::endl;
   return Result::OK();
 }
 
-Result DB::FlushMemTable() {
-  std::cout << "[DB::FlushMemTable] Called."
-            << (immutable_memtable_ ? " immutable_memtable_ EXISTS!" : " immutable_memtable_ is null.")
+Result DB::CreateColumnFamily(const std::string& name, std::size_t threshold, DBOptions options,
+                              ColumnFamilyHandle** handle) {
+  std::cout << "[DB::CreateColumnFamily] ENTER. Name: " << name << std::endl;
+  if (default_cfd_ == nullptr) {
+    return Result::IOError("DB is not initialized.");
+  }
+  if (handle == nullptr) {
+    return Result::InvalidArgument("Output handle pointer is null.");
+  }
+  if (GetColumnFamily(name) != nullptr) {
+    return Result::InvalidArgument("Column family '" + name + "' already exists.");
+  }
+  uint32_t id = next_column_family_id_;
+  ColumnFamilyData* cfd = nullptr;
+  Result cf_res = NewColumnFamilyData(id, name, threshold, std::move(options), &cfd);
+  if (!cf_res.ok()) {
+    column_families_.erase(id);
+    return cf_res;
+  }
+  // The new family has nothing in any existing log.
+  cfd->log_number = alive_logs_.empty() ? 0 : alive_logs_.back();
+
+  Result persist_res = WriteManifest(db_dir_, BuildManifestContents());
+  if (!persist_res.ok()) {
+    column_families_.erase(id);
+    return persist_res;
+  }
+  *handle = &cfd->handle;
+  return Result::OK();
+}
+
+ColumnFamilyHandle* DB::GetColumnFamily(const std::string& name) const {
+  for (const auto& [id, cfd] : column_families_) {
+    if (cfd->name() == name) {
+      return &cfd->handle;
+    }
+  }
+  return nullptr;
+}
+
+ColumnFamilyHandle* DB::DefaultColumnFamily() const {
+  return default_cfd_ == nullptr ? nullptr : &default_cfd_->handle;
+}
+
+Result DB::SwitchLog(uint64_t* new_log_number) {
+  uint64_t number = NewFileNumber();
+  if (!options_.disable_wal) {
+    std::string path = (std::filesystem::path(db_dir_) / GenerateLogFilename(number)).string();
+    auto new_wal = make_unique_nothrow<WALWriter>(path);
+    if (!new_wal) {
+      return Result::ArenaAllocationFail("Failed to allocate WALWriter.");
+    }
+    Result open_res = new_wal->Open();
+    if (!open_res.ok()) {
+      return open_res;
+    }
+    if (wal_) {
+      Result close_res = wal_->Close();
+      if (!close_res.ok()) {
+        new_wal.reset();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return close_res;
+      }
+    }
+    wal_ = std::move(new_wal);
+    alive_logs_.push_back(number);
+  }
+  *new_log_number = number;
+  return Result::OK();
+}
+
+void DB::DeleteObsoleteLogs() {
+  uint64_t min_log_number = std::numeric_limits<uint64_t>::max();
+  for (const auto& [id, cfd] : column_families_) {
+    min_log_number = std::min(min_log_number, cfd->log_number);
+  }
+  // The current log is never below every family's log number.
+  while (!alive_logs_.empty() && alive_logs_.front() < min_log_number) {
+    std::string path = (std::filesystem::path(db_dir_) / GenerateLogFilename(alive_logs_.front())).string();
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    std::cout << "[DB::DeleteObsoleteLogs] Removed " << path << (ec ? " (failed: " + ec.message() + ")" : "") << std::endl;
+    alive_logs_.erase(alive_logs_.begin());
+  }
+}
+
+Result DB::InsertIntoMemTables(const WriteBatch& batch, uint64_t log_number) {
+  return batch.Iterate([&](WALRecordType type, uint32_t column_family_id, const Slice& key, const Slice& value) {
+    auto it = column_families_.find(column_family_id);
+    if (it == column_families_.end()) {
+      return Result::InvalidArgument("Unknown column family id " + std::to_string(column_family_id));
+    }
+    ColumnFamilyData* cfd = it->second.get();
+    if (log_number < cfd->log_number) {
+      return Result::OK(); // Already flushed to an SSTable.
+    }
+    if (type == WALRecordType::kWriteOp) {
+      return cfd->active_memtable->Put(key, value);
+    }
+    return cfd->active_memtable->Delete(key);
+  });
+}
+
+Result DB::RecoverLogs(bool* damaged) {
+  std::vector<uint64_t> log_numbers;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(db_dir_, ec)) {
+    const std::filesystem::path& path = entry.path();
+    std::string stem = path.stem().string();
+    if (path.extension() == ".log" && !stem.empty() &&
+        std::all_of(stem.begin(), stem.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+      log_numbers.push_back(std::stoull(stem));
+    }
+  }
+  if (ec) {
+    return Result::IOError("Failed to list '" + db_dir_ + "': " + ec.message());
+  }
+  std::sort(log_numbers.begin(), log_numbers.end());
+  if (!log_numbers.empty()) {
+    // Logs are numbered after the manifest was last written; never hand their numbers out again.
+    std::lock_guard<std::mutex> lock(file_number_mutex_);
+    next_sstable_id_ = std::max(next_sstable_id_, log_numbers.back() + 1);
+  }
+
+  uint64_t min_log_number = std::numeric_limits<uint64_t>::max();
+  for (const auto& [id, cfd] : column_families_) {
+    min_log_number = std::min(min_log_number, cfd->log_number);
+  }
+  for (uint64_t number : log_numbers) {
+    std::string path = (std::filesystem::path(db_dir_) / GenerateLogFilename(number)).string();
+    if (number < min_log_number) {
+      std::filesystem::remove(path, ec);
+      continue;
+    }
+    alive_logs_.push_back(number);
+    if (*damaged) {
+      continue;
+    }
+
+    WALReader reader(path);
+    Result open_res = reader.Open();
+    if (!open_res.ok()) {
+      return open_res;
+    }
+    Slice payload;
+    WALRecordType type = WALRecordType::kInvalid;
+    size_t records = 0;
+    while (reader.ReadRecord(&payload, &type)) {
+      if (type != WALRecordType::kFullRecord) {
+        return Result::Corruption("Unexpected record type " + std::to_string(static_cast<int>(type)) + " in " + path);
+      }
+      Result insert_res = InsertIntoMemTables(WriteBatch(payload.ToString()), number);
+      if (!insert_res.ok()) {
+        return insert_res;
+      }
+      records++;
+    }
+    std::cout << "[DB::RecoverLogs] Replayed " << records << " write batches from " << path << std::endl;
+    if (!reader.status().ok()) {
+      std::cout << "[DB::RecoverLogs] Stopping recovery: " << reader.status().message() << std::endl;
+      *damaged = true;
+    }
+  }
+  return Result::OK();
+}
+
+Result DB::FlushMemTable(ColumnFamilyData* cfd) {
+  std::cout << "[DB::FlushMemTable] Called for column family '" << cfd->name() << "'."
+            << (cfd->immutable_memtable ? " immutable_memtable EXISTS!" : " immutable_memtable is null.")
             << std::endl;
-  if (!active_memtable_) {
+  if (!cfd->active_memtable) {
     std::cout << "[DB::FlushMemTable] No active memtable exists. Nothing to flush." << std::endl;
     return Result::IOError("FlushMemTable called but no active memtable exists.");
   }
    // Check if active memtable is empty (after it's confirmed to exist)
-  if (active_memtable_->ApproximateMemoryUsage() == 0) {
+  if (cfd->active_memtable->ApproximateMemoryUsage() == 0) {
     std::cout << "[DB::FlushMemTable] Active memtable is empty. While a new active memtable will be created, no SSTable will be written for the current one." << std::endl;
     // No data to write, but we still cycle to a new active memtable.
     // If we don't want to cycle for an empty memtable, this logic would change.
     // For now, proceed with cycling.
   }
 
-  if (immutable_memtable_) {
+  if (cfd->immutable_memtable) {
     std::cout << "[DB::FlushMemTable] Error: An immutable memtable already exists." << std::endl;
     return Result::IOError("FlushMemTable: An immutable memtable already exists; cannot flush concurrently (in synchronous mode).");
   }
+  // Writes from here on go to a new log, so once the immutable memtable is
+  // in an SSTable, this family needs nothing from the older logs.
+  uint64_t new_log_number = 0;
+  Result log_res = SwitchLog(&new_log_number);
+  if (!log_res.ok()) {
+    std::cout << "[DB::FlushMemTable] Failed to switch to a new log: " << log_res.message() << std::endl;
+    return log_res;
+  }
+
   std::cout << "[DB::FlushMemTable] Moving active to immutable." << std::endl;
-  immutable_memtable_arena_ = std::move(active_memtable_arena_);
-  immutable_memtable_ = std::move(active_memtable_);
+  cfd->immutable_memtable_arena = std::move(cfd->active_memtable_arena);
+  cfd->immutable_memtable = std::move(cfd->active_memtable);
 
-  std::cout << "[DB::FlushMemTable] Creating new active_memtable_arena_." << std::endl;
-  active_memtable_arena_ = make_unique_nothrow<Arena>();
-  if (!active_memtable_arena_) {
+  std::cout << "[DB::FlushMemTable] Creating new active_memtable_arena." << std::endl;
+  cfd->active_memtable_arena = make_unique_nothrow<Arena>();
+  if (!cfd->active_memtable_arena) {
     std::cout << "[DB::FlushMemTable] Failed to allocate Arena for new active MemTable. Restoring state." << std::endl;
-    active_memtable_ = std::move(immutable_memtable_);
-    active_memtable_arena_ = std::move(immutable_memtable_arena_);
+    cfd->active_memtable = std::move(cfd->immutable_memtable);
+    cfd->active_memtable_arena = std::move(cfd->immutable_memtable_arena);
     return Result::ArenaAllocationFail("Failed to allocate Arena for new active MemTable during flush.");
   }
-  std::cout << "[DB::FlushMemTable] New active_memtable_arena_ CREATED. Ptr: " << active_memtable_arena_.get() << std::endl;
+  std::cout << "[DB::FlushMemTable] New active_memtable_arena CREATED. Ptr: " << cfd->active_memtable_arena.get() << std::endl;
 
-  std::cout << "[DB::FlushMemTable] Creating new active_memtable_." << std::endl;
-  active_memtable_ = make_unique_nothrow<MemTable>(*active_memtable_arena_);
-  if (!active_memtable_) {
+  std::cout << "[DB::FlushMemTable] Creating new active_memtable." << std::endl;
+  cfd->active_memtable = make_unique_nothrow<MemTable>(*cfd->active_memtable_arena, cfd->options.comparator,
+                                                      cfd->options.memtable_factory, MemTableBloomBytes(*cfd),
+                                                      cfd->options.inplace_update_support);
+  if (!cfd->active_memtable) {
     std::cout << "[DB::FlushMemTable] Failed to allocate new active MemTable. Restoring state." << std::endl;
-    active_memtable_arena_.reset();
-    active_memtable_ = std::move(immutable_memtable_);
-    active_memtable_arena_ = std::move(immutable_memtable_arena_);
+    cfd->active_memtable_arena.reset();
+    cfd->active_memtable = std::move(cfd->immutable_memtable);
+    cfd->active_memtable_arena = std::move(cfd->immutable_memtable_arena);
     return Result::ArenaAllocationFail("Failed to allocate new active MemTable during flush.");
   }
-  std::cout << "[DB::FlushMemTable] New active_memtable_ CREATED. Ptr: " << active_memtable_.get() << std::endl;
+  std::cout << "[DB::FlushMemTable] New active_memtable CREATED. Ptr: " << cfd->active_memtable.get() << std::endl;
 
   // Only write SSTable if immutable memtable has data
-  if (immutable_memtable_ && immutable_memtable_->ApproximateMemoryUsage() > 0) {
-    std::string sstable_basename = GenerateSSTableFilename();
+  if (cfd->immutable_memtable && cfd->immutable_memtable->ApproximateMemoryUsage() > 0) {
+    uint64_t file_number = NewFileNumber();
+    std::string sstable_basename = GenerateSSTableFilename(file_number);
     std::cout << "[DB::FlushMemTable] Generating SSTable filename: " << sstable_basename << std::endl;
     std::filesystem::path sstable_path = std::filesystem::path(db_dir_) / sstable_basename;
 
     SSTableWriter writer(true /* compression_enabled */);
+    writer.SetRateLimiter(options_.rate_limiter.get(), IOPriority::kHigh);
+    writer.SetComparator(cfd->options.comparator);
     Result writer_init_res = writer.Init();
     std::cout << "[DB::FlushMemTable] SSTableWriter.Init() result. ok(): " << (writer_init_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(writer_init_res.code()) << ", message(): '" << writer_init_res.message() << "'" << std::endl;
     if (!writer_init_res.ok()) {
       std::cout << "[DB::FlushMemTable] SSTableWriter::Init failed. Restoring state." << std::endl;
-      active_memtable_arena_.reset();
-      active_memtable_.reset();
-      active_memtable_ = std::move(immutable_memtable_);
-      active_memtable_arena_ = std::move(immutable_memtable_arena_);
+      cfd->active_memtable_arena.reset();
+      cfd->active_memtable.reset();
+      cfd->active_memtable = std::move(cfd->immutable_memtable);
+      cfd->active_memtable_arena = std::move(cfd->immutable_memtable_arena);
       return Result::IOError("SSTableWriter Init failed during flush: " + writer_init_res.message());
     }
 
-    Result write_result = writer.WriteMemTableToFile(*immutable_memtable_, sstable_path.string());
+    std::unique_ptr<BlobFileBuilder> blob_builder;
+    if (cfd->options.enable_blob_files) {
+      blob_builder = make_unique_nothrow<BlobFileBuilder>(
+          cfd->options.min_blob_size, cfd->options.blob_file_size, [this]() {
+            BlobFileMetaData blob_meta;
+            blob_meta.number = NewFileNumber();
+            blob_meta.path = (std::filesystem::path(db_dir_) / GenerateBlobFilename(blob_meta.number)).string();
+            return blob_meta;
+          });
+      if (!blob_builder) {
+        cfd->immutable_memtable.reset();
+        cfd->immutable_memtable_arena.reset();
+        return Result::ArenaAllocationFail("Failed to allocate BlobFileBuilder during flush.");
+      }
+      blob_builder->SetRateLimiter(options_.rate_limiter.get(), IOPriority::kHigh);
+      writer.SetBlobFileBuilder(blob_builder.get());
+    }
+
+    // The table is written on a flush thread of the pool; with a pool shared
+    // by several DBs that caps how many flushes run at once.
+    Result write_result;
+    options_.thread_pool->Schedule([&]() {
+      write_result = writer.WriteMemTableToFile(*cfd->immutable_memtable, sstable_path.string());
+      if (write_result.ok() && blob_builder) {
+        write_result = blob_builder->Finish();
+        if (!write_result.ok()) {
+          std::error_code remove_ec;
+          std::filesystem::remove(sstable_path, remove_ec);
+        }
+      }
+      if (!write_result.ok() && blob_builder) {
+        blob_builder->Abandon();
+      }
+    }, ThreadPriority::kHigh).wait();
     std::cout << "[DB::FlushMemTable] writer.WriteMemTableToFile result. ok(): " << (write_result.ok() ? "true" : "false") << ", code(): " << static_cast<int>(write_result.code()) << ", message(): '" << write_result.message() << "'" << std::endl;
 
     if (!write_result.ok()) {
       std::cout << "[DB::FlushMemTable] Failed to write SSTable file. Resetting immutable memtable (data loss for this flush)." << std::endl;
       // Note: The new active memtable is already in place. The flushed data is lost.
-      // For robustness, one might retry or keep immutable_memtable_ for recovery.
-      immutable_memtable_.reset();
-      immutable_memtable_arena_.reset();
+      // For robustness, one might retry or keep cfd->immutable_memtable for recovery.
+      cfd->immutable_memtable.reset();
+      cfd->immutable_memtable_arena.reset();
       return Result::IOError("Failed to write SSTable file: " + sstable_path.string() + " - " + write_result.message());
     }
 
     std::cout << "[DB::FlushMemTable] SSTable write successful. Path: " << sstable_path.string() << std::endl;
-    l0_sstables_.insert(l0_sstables_.begin(), sstable_path.string()); // Newest first
-    next_sstable_id_++;
-    std::cout << "[DB::FlushMemTable] Adding to L0: " << sstable_path.string() << ". Next ID: " << next_sstable_id_ << std::endl;
+    FileMetaData meta;
+    meta.number = file_number;
+    meta.path = sstable_path.string();
+    std::error_code size_ec;
+    meta.file_size = std::filesystem::file_size(sstable_path, size_ec);
+    if (writer.properties().num_entries > 0) {
+      meta.has_key_range = true;
+      meta.smallest_key = writer.properties().smallest_key;
+      meta.largest_key = writer.properties().largest_key;
+    }
+    VersionEdit edit;
+    edit.AddFile(0, std::move(meta));
+    edit.SetLogNumber(new_log_number);
+    if (blob_builder) {
+      for (const BlobFileMetaData& blob_file : blob_builder->blob_files()) {
+        edit.AddBlobFile(blob_file);
+      }
+    }
+    Result edit_res = ApplyVersionEdit(cfd, edit);
+    if (!edit_res.ok()) {
+      std::filesystem::remove(sstable_path, size_ec);
+      if (blob_builder) {
+        blob_builder->Abandon();
+      }
+      cfd->immutable_memtable.reset();
+      cfd->immutable_memtable_arena.reset();
+      return edit_res;
+    }
+    std::cout << "[DB::FlushMemTable] Adding to L0: " << sstable_path.string() << ". L0 files: " << cfd->levels[0].size() << std::endl;
   } else {
       std::cout << "[DB::FlushMemTable] Immutable memtable is null or empty, skipping SSTable write." << std::endl;
+      cfd->log_number = new_log_number;
   }
 
   std::cout << "[DB::FlushMemTable] Resetting (any remaining) immutable memtable." << std::endl;
-  immutable_memtable_.reset();
-  immutable_memtable_arena_.reset();
+  cfd->immutable_memtable.reset();
+  cfd->immutable_memtable_arena.reset();
+
+  // Families without unflushed writes have nothing in the old logs either,
+  // so they must not keep those logs alive.
+  for (auto& [id, other] : column_families_) {
+    if (other.get() != cfd && !other->immutable_memtable && ActiveMemTableIsEmpty(*other)) {
+      other->log_number = std::max(other->log_number, new_log_number);
+    }
+  }
+  DeleteObsoleteLogs();
+
+  Result compact_res = MaybeCompact(cfd);
+  if (!compact_res.ok()) {
+    std::cout << "[DB::FlushMemTable] Flush succeeded but the triggered compaction failed: " << compact_res.message() << std::endl;
+    return compact_res;
+  }
 
   Result final_ok_res = Result::OK();
   std::cout << "[DB::FlushMemTable] Returning OK. ok(): " << (final_ok_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(final_ok_res.code()) << ", message(): '" << final_ok_res.message() << "'" << std::endl;
   return final_ok_res;
 }
 
-Result DB::Put(const Slice& key, const Slice& value) {
-  std::cout << "[DB::Put] ENTER. Key: " << key.ToString() << std::endl;
-  if (!active_memtable_) {
-    Result err_res = Result::IOError("Active memtable not available; DB may not be initialized or in error state.");
-    std::cout << "[DB::Put] EXIT - Error: active_memtable_ is null!. ok(): " << (err_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(err_res.code()) << ", message(): '" << err_res.message() << "'" << std::endl;
-    return err_res;
+Result DB::MaybeCompact(ColumnFamilyData* cfd) {
+  if (cfd->options.disable_auto_compactions ||
+      cfd->levels[0].size() < static_cast<size_t>(std::max(cfd->options.level0_file_num_compaction_trigger, 1))) {
+    return Result::OK();
+  }
+  std::cout << "[DB::MaybeCompact] L0 has " << cfd->levels[0].size() << " files. Compacting into L1." << std::endl;
+  return CompactLevel0(cfd);
+}
+
+Result DB::CompactLevel0() {
+  return CompactLevel0(default_cfd_);
+}
+
+Result DB::CompactLevel0(ColumnFamilyHandle* column_family) {
+  ColumnFamilyData* cfd = GetColumnFamilyData(column_family);
+  if (cfd == nullptr) {
+    return Result::InvalidArgument("Unknown column family.");
+  }
+  return CompactLevel0(cfd);
+}
+
+Result DB::CompactLevel0(ColumnFamilyData* cfd) {
+  if (cfd == nullptr) {
+    return Result::IOError("DB is not initialized.");
+  }
+  if (cfd->levels[0].empty()) {
+    return Result::OK();
+  }
+
+  // Only the L1 files overlapping L0 are merged; the rest of L1 stays in
+  // place. Inputs are ordered newest first: L0 (already newest first), then L1.
+  std::vector<FileMetaData> l1_inputs = L1FilesOverlappingL0(*cfd);
+  std::vector<FileMetaData> inputs = cfd->levels[0];
+  inputs.insert(inputs.end(), l1_inputs.begin(), l1_inputs.end());
+
+  // Tombstones can be dropped unless a deeper level may hold keys they shadow.
+  bool bottommost = !OverlapsBelowL1(*cfd, inputs);
+
+  std::cout << "[DB::CompactLevel0] Compacting " << cfd->levels[0].size() << " L0 files and "
+            << l1_inputs.size() << " of " << cfd->levels[1].size() << " L1 files. Bottommost: " << bottommost << std::endl;
+
+  CompactionJob job(inputs, bottommost, cfd->options,
+                    [this]() { return NewFileNumber(); },
+                    [this](uint64_t number) {
+                      return (std::filesystem::path(db_dir_) / GenerateSSTableFilename(number)).string();
+                    });
+  std::set<uint64_t> blob_files_to_gc = SelectBlobFilesForGC(*cfd);
+  job.SetBlobOptions(
+      [this, cfd](uint64_t number) {
+        auto it = std::find_if(cfd->blob_files.begin(), cfd->blob_files.end(),
+                               [number](const BlobFileMetaData& b) { return b.number == number; });
+        if (it != cfd->blob_files.end()) {
+          return it->path;
+        }
+        return (std::filesystem::path(db_dir_) / GenerateBlobFilename(number)).string();
+      },
+      blob_files_to_gc);
+  Result run_res = job.Run();
+  if (!run_res.ok()) {
+    std::cout << "[DB::CompactLevel0] Compaction failed, discarding outputs: " << run_res.message() << std::endl;
+    job.DeleteOutputFiles();
+    return run_res;
+  }
+
+  VersionEdit edit;
+  for (const FileMetaData& f : cfd->levels[0]) {
+    edit.DeleteFile(0, f.number);
+  }
+  for (const FileMetaData& f : l1_inputs) {
+    edit.DeleteFile(1, f.number);
+  }
+  for (const FileMetaData& f : job.outputs()) {
+    edit.AddFile(1, f);
+  }
+  for (const BlobFileMetaData& blob_file : job.blob_outputs()) {
+    edit.AddBlobFile(blob_file);
+  }
+  for (const auto& [blob_file_number, garbage] : job.blob_garbage()) {
+    edit.AddBlobGarbage(blob_file_number, garbage.count, garbage.bytes);
+  }
+  Result edit_res = ApplyVersionEdit(cfd, edit);
+  if (!edit_res.ok()) {
+    job.DeleteOutputFiles();
+    return edit_res;
+  }
+
+  for (const FileMetaData& f : inputs) {
+    RemoveObsoleteFile(f.path);
+  }
+  std::cout << "[DB::CompactLevel0] Installed " << job.outputs().size() << " L1 files and "
+            << job.blob_outputs().size() << " blob files from " << job.NumSubcompactions()
+            << " subcompactions." << std::endl;
+  return Result::OK();
+}
+
+namespace {
+
+// A file with no comparator property predates properties and is assumed to
+// match.
+Result CheckFileComparator(const std::string& path, const Comparator* comparator) {
+  SSTableReader reader(path);
+  Result init_res = reader.Init();
+  if (!init_res.ok()) {
+    return init_res;
+  }
+  std::string name;
+  Result prop_res = reader.GetProperty(kComparatorNameProperty, &name);
+  if (prop_res.code() == ResultCode::kNotFound) {
+    return Result::OK();
+  }
+  if (!prop_res.ok()) {
+    return prop_res;
+  }
+  if (name != comparator->Name()) {
+    return Result::InvalidArgument("'" + path + "' is ordered by comparator '" + name + "', not '" +
+                                   comparator->Name() + "'.");
+  }
+  return Result::OK();
+}
+
+} // namespace
+
+bool DB::MemTableOverlapsRange(const ColumnFamilyData& cfd, const std::string& smallest,
+                               const std::string& largest) const {
+  // The memtables' key bounds may report an overlap that is not there; the
+  // caller then flushes, which is always correct.
+  for (const MemTable* memtable : {cfd.active_memtable.get(), cfd.immutable_memtable.get()}) {
+    if (memtable != nullptr && memtable->MayOverlapRange(StringAsSlice(smallest), StringAsSlice(largest))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Result DB::IngestExternalFile(const std::string& external_file, bool move_files) {
+  return IngestExternalFile(DefaultColumnFamily(), external_file, move_files);
+}
+
+Result DB::IngestExternalFile(ColumnFamilyHandle* column_family, const std::string& external_file,
+                              bool move_files) {
+  std::cout << "[DB::IngestExternalFile] ENTER. File: " << external_file << std::endl;
+  ColumnFamilyData* cfd = GetColumnFamilyData(column_family);
+  if (cfd == nullptr) {
+    return Result::InvalidArgument("Unknown column family.");
+  }
+  if (!cfd->active_memtable) {
+    return Result::IOError("Active memtable not available; DB may not be initialized or in error state.");
   }
 
-  Result put_res = active_memtable_->Put(key, value);
-  std::cout << "[DB::Put] active_memtable_->Put result. ok(): " << (put_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(put_res.code()) << ", message(): '" << put_res.message() << "'" << std::endl;
-  if (!put_res.ok()) {
-    std::cout << "[DB::Put] EXIT - Error from active_memtable_->Put." << std::endl;
-    return put_res;
+  Result comparator_res = CheckFileComparator(external_file, cfd->options.comparator);
+  if (!comparator_res.ok()) {
+    return comparator_res;
+  }
+  std::string smallest;
+  std::string largest;
+  Result range_res = ReadFileKeyRange(external_file, &smallest, &largest);
+  if (!range_res.ok()) {
+    if (range_res.code() == ResultCode::kNotFound) {
+      return Result::InvalidArgument("External file '" + external_file + "' has no entries.");
+    }
+    return range_res;
   }
 
-  size_t current_usage = active_memtable_->ApproximateMemoryUsage();
-  std::cout << "[DB::Put] Memtable usage: " << current_usage << ", Threshold: " << threshold_ << std::endl;
-  if (current_usage >= threshold_) {
-    std::cout << "[DB::Put] Threshold met. Calling FlushMemTable." << std::endl;
-    Result flush_res = FlushMemTable();
-    std::cout << "[DB::Put] FlushMemTable result. ok(): " << (flush_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(flush_res.code()) << ", message(): '" << flush_res.message() << "'" << std::endl;
+  // Ingested keys must shadow what the memtable holds, so that has to reach
+  // disk first.
+  if (MemTableOverlapsRange(*cfd, smallest, largest)) {
+    std::cout << "[DB::IngestExternalFile] Memtable overlaps [" << smallest << ", " << largest << "]. Flushing." << std::endl;
+    Result flush_res = FlushMemTable(cfd);
     if (!flush_res.ok()) {
-      std::cout << "[DB::Put] EXIT - Error from FlushMemTable." << std::endl;
       return flush_res;
     }
   }
-  Result final_ok_res = Result::OK();
-  std::cout << "[DB::Put] EXIT - Returning OK. ok(): " << (final_ok_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(final_ok_res.code()) << ", message(): '" << final_ok_res.message() << "'" << std::endl;
-  return final_ok_res;
+
+  // The file must sit above every file it overlaps, so it goes just above the
+  // shallowest overlapping level. Overlapping L0 forces it into L0 as newest.
+  int target_level = kNumLevels - 1;
+  for (int level = 0; level < kNumLevels; ++level) {
+    bool overlaps = false;
+    for (const FileMetaData& f : cfd->levels[static_cast<size_t>(level)]) {
+      std::string f_smallest = f.smallest_key;
+      std::string f_largest = f.largest_key;
+      Result f_res = f.has_key_range ? Result::OK() : ReadFileKeyRange(f.path, &f_smallest, &f_largest);
+      if (f_res.code() == ResultCode::kNotFound) {
+        continue; // Empty table.
+      }
+      if (!f_res.ok()) {
+        return f_res;
+      }
+      if (RangesOverlap(KeyComparator(cfd->options.comparator), smallest, largest, f_smallest, f_largest)) {
+        overlaps = true;
+        break;
+      }
+    }
+    if (overlaps) {
+      target_level = std::max(level - 1, 0);
+      break;
+    }
+  }
+
+  uint64_t file_number = NewFileNumber();
+  std::filesystem::path target_path = std::filesystem::path(db_dir_) / GenerateSSTableFilename(file_number);
+  std::error_code ec;
+  bool linked = true;
+  std::filesystem::create_hard_link(external_file, target_path, ec);
+  if (ec) {
+    std::cout << "[DB::IngestExternalFile] Hard link failed (" << ec.message() << "). Copying instead." << std::endl;
+    linked = false;
+    ec.clear();
+    std::filesystem::copy_file(external_file, target_path, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) {
+      return Result::IOError("Failed to copy external file '" + external_file + "': " + ec.message());
+    }
+  }
+  // Whoever wrote the external file may not have synced it; a link shares its data.
+  Result sync_res = SyncFile(target_path.string());
+  if (!sync_res.ok()) {
+    std::filesystem::remove(target_path, ec);
+    return sync_res;
+  }
+
+  FileMetaData meta;
+  meta.number = file_number;
+  meta.path = target_path.string();
+  meta.file_size = std::filesystem::file_size(target_path, ec);
+  if (ec) {
+    std::filesystem::remove(target_path, ec);
+    return Result::IOError("Failed to stat ingested file '" + target_path.string() + "'.");
+  }
+  meta.has_key_range = true;
+  meta.smallest_key = smallest;
+  meta.largest_key = largest;
+  VersionEdit edit;
+  edit.AddFile(target_level, std::move(meta));
+  Result edit_res = ApplyVersionEdit(cfd, edit);
+  if (!edit_res.ok()) {
+    std::filesystem::remove(target_path, ec);
+    return edit_res;
+  }
+
+  if (move_files && linked) {
+    std::filesystem::remove(external_file, ec);
+    if (ec) {
+      std::cout << "[DB::IngestExternalFile] Failed to remove original " << external_file << ": " << ec.message() << std::endl;
+    }
+  }
+  std::cout << "[DB::IngestExternalFile] Ingested " << external_file << " as " << target_path.string()
+            << " into L" << target_level << "." << std::endl;
+
+  Result compact_res = MaybeCompact(cfd);
+  if (!compact_res.ok()) {
+    std::cout << "[DB::IngestExternalFile] Ingestion succeeded but the triggered compaction failed: " << compact_res.message() << std::endl;
+    return compact_res;
+  }
+  return Result::OK();
 }
 
-Result DB::Delete(const Slice& key) {
-  std::cout << "[DB::Delete] ENTER. Key: " << key.ToString() << std::endl;
-  if (!active_memtable_) {
-    Result err_res = Result::IOError("Active memtable not available; DB may not be initialized or in error state.");
-    std::cout << "[DB::Delete] EXIT - Error: active_memtable_ is null!. ok(): " << (err_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(err_res.code()) << ", message(): '" << err_res.message() << "'" << std::endl;
-    return err_res;
+bool DB::ActiveMemTableIsEmpty(const ColumnFamilyData& cfd) const {
+  return !cfd.active_memtable || cfd.active_memtable->IsEmpty();
+}
+
+Result DB::CreateCheckpoint(const std::string& checkpoint_dir) {
+  std::cout << "[DB::CreateCheckpoint] ENTER. Target: " << checkpoint_dir << std::endl;
+  if (default_cfd_ == nullptr) {
+    return Result::IOError("Active memtable not available; DB may not be initialized or in error state.");
+  }
+  std::error_code ec;
+  if (std::filesystem::exists(checkpoint_dir, ec)) {
+    return Result::InvalidArgument("Checkpoint directory '" + checkpoint_dir + "' already exists.");
+  }
+  // The checkpoint is built under a temporary name and renamed into place, so
+  // a half-written checkpoint is never mistaken for a complete one.
+  std::filesystem::path staging_dir = checkpoint_dir;
+  staging_dir += ".tmp";
+  if (std::filesystem::exists(staging_dir, ec)) {
+    return Result::InvalidArgument("Checkpoint staging directory '" + staging_dir.string() + "' already exists.");
+  }
+
+  // Recent writes reach the checkpoint by being flushed rather than by
+  // copying the log, so the checkpoint holds only immutable files.
+  for (auto& [id, cfd] : column_families_) {
+    if (!ActiveMemTableIsEmpty(*cfd)) {
+      Result flush_res = FlushMemTable(cfd.get());
+      if (!flush_res.ok()) {
+        return flush_res;
+      }
+    }
+  }
+
+  if (!std::filesystem::create_directories(staging_dir, ec) || ec) {
+    return Result::IOError("Failed to create checkpoint directory '" + staging_dir.string() + "': " + ec.message());
+  }
+  auto fail = [&staging_dir](Result status) {
+    std::error_code cleanup_ec;
+    std::filesystem::remove_all(staging_dir, cleanup_ec);
+    return status;
+  };
+
+  // Links `source` into the staging directory and returns its new path.
+  size_t linked_files = 0;
+  auto add_file = [&](const std::string& source, std::string* target_out) {
+    std::filesystem::path target = staging_dir / std::filesystem::path(source).filename();
+    std::error_code link_ec;
+    std::filesystem::create_hard_link(source, target, link_ec);
+    if (link_ec) {
+      // Linking fails across filesystems; SSTables and blob files are
+      // immutable, so a copy is just as consistent, only slower.
+      link_ec.clear();
+      std::filesystem::copy_file(source, target, link_ec);
+      if (link_ec) {
+        return Result::IOError("Failed to add '" + source + "' to checkpoint: " + link_ec.message());
+      }
+      Result sync_res = SyncFile(target.string());
+      if (!sync_res.ok()) {
+        return sync_res;
+      }
+    } else {
+      linked_files++;
+    }
+    *target_out = target.string();
+    return Result::OK();
+  };
+
+  ManifestContents contents = BuildManifestContents();
+  for (ColumnFamilyManifest& cf : contents.column_families) {
+    for (std::vector<FileMetaData>& level_files : cf.levels) {
+      for (FileMetaData& f : level_files) {
+        Result add_res = add_file(f.path, &f.path);
+        if (!add_res.ok()) {
+          return fail(add_res);
+        }
+      }
+    }
+    for (BlobFileMetaData& b : cf.blob_files) {
+      Result add_res = add_file(b.path, &b.path);
+      if (!add_res.ok()) {
+        return fail(add_res);
+      }
+    }
+  }
+
+  Result manifest_res = WriteManifest(staging_dir.string(), contents);
+  if (!manifest_res.ok()) {
+    return fail(manifest_res);
   }
-  Result del_res = active_memtable_->Delete(key); // This should use the new MemTable::Delete that returns a rich Result
-   std::cout << "[DB::Delete] active_memtable_->Delete result. ok(): " << (del_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(del_res.code()) << ", message(): '" << del_res.message() << "'" << std::endl;
-  if (!del_res.ok()) {
-    // If MemTable::Delete itself fails (e.g., arena allocation for tombstone key), propagate.
-    return del_res;
+  std::filesystem::rename(staging_dir, checkpoint_dir, ec);
+  if (ec) {
+    return fail(Result::IOError("Failed to move checkpoint into place at '" + checkpoint_dir + "': " + ec.message()));
   }
+  // WriteManifest synced the staging directory; this makes the rename durable.
+  Result sync_res = SyncDirectory(std::filesystem::path(checkpoint_dir).parent_path().string());
+  if (!sync_res.ok()) {
+    return sync_res;
+  }
+  std::cout << "[DB::CreateCheckpoint] Created " << checkpoint_dir << " with " << linked_files
+            << " hard-linked files." << std::endl;
+  return Result::OK();
+}
+
+WriteStallStats DB::GetWriteStallStats() const {
+  return write_controller_.GetStats();
+}
+
+ThreadPoolStats DB::GetThreadPoolStats(ThreadPriority priority) const {
+  return options_.thread_pool->GetStats(priority);
+}
+
+Result DB::MakeRoomForWrite(ColumnFamilyData* cfd, size_t write_bytes) {
+  while (true) {
+    WriteController::Decision decision =
+        WriteController::Evaluate(cfd->options, cfd->levels[0].size(), EstimatePendingCompactionBytes(*cfd));
+
+    if (decision.condition == WriteStallCondition::kNormal) {
+      return Result::OK();
+    }
 
-  size_t current_usage = active_memtable_->ApproximateMemoryUsage();
-  std::cout << "[DB::Delete] Memtable usage: " << current_usage << ", Threshold: " << threshold_ << std::endl;
-  if (current_usage >= threshold_) {
-    std::cout << "[DB::Delete] Threshold met. Calling FlushMemTable." << std::endl;
-    Result flush_res = FlushMemTable();
-    std::cout << "[DB::Delete] FlushMemTable result. ok(): " << (flush_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(flush_res.code()) << ", message(): '" << flush_res.message() << "'" << std::endl;
+    if (decision.condition == WriteStallCondition::kDelayed) {
+      uint64_t delay_micros = write_controller_.GetDelayMicros(write_bytes, decision.severity);
+      if (delay_micros > 0) {
+        std::cout << "[DB::MakeRoomForWrite] Delaying write by " << delay_micros << "us. Cause: "
+                  << static_cast<int>(decision.cause) << ", severity: " << decision.severity << std::endl;
+        std::this_thread::sleep_for(std::chrono::microseconds(delay_micros));
+        write_controller_.RecordDelay(decision.cause, delay_micros);
+      }
+      return Result::OK();
+    }
+
+    // Stopped. Nothing runs in the background, so the writer does the work that
+    // lifts the stop itself and only then proceeds.
+    std::cout << "[DB::MakeRoomForWrite] Writes stopped. Cause: " << static_cast<int>(decision.cause) << std::endl;
+    auto stop_start = std::chrono::steady_clock::now();
+    Result compact_res = CompactLevel0(cfd);
+    auto stop_micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - stop_start).count();
+    write_controller_.RecordStop(decision.cause, static_cast<uint64_t>(stop_micros));
+    if (!compact_res.ok()) {
+      return compact_res;
+    }
+  }
+}
+
+Result DB::EnforceWriteBufferBudget() {
+  if (options_.db_write_buffer_size == 0) {
+    return Result::OK();
+  }
+  std::set<uint32_t> flushed;
+  while (true) {
+    size_t total_usage = 0;
+    ColumnFamilyData* largest = nullptr;
+    size_t largest_usage = 0;
+    for (const auto& [id, cfd] : column_families_) {
+      size_t usage = cfd->active_memtable->ApproximateMemoryUsage();
+      total_usage += usage;
+      if (usage > largest_usage && flushed.count(id) == 0) {
+        largest = cfd.get();
+        largest_usage = usage;
+      }
+    }
+    if (total_usage < options_.db_write_buffer_size || largest == nullptr) {
+      return Result::OK();
+    }
+    std::cout << "[DB::EnforceWriteBufferBudget] Memtables use " << total_usage << " of "
+              << options_.db_write_buffer_size << " bytes. Flushing '" << largest->name() << "' ("
+              << largest_usage << " bytes)." << std::endl;
+    flushed.insert(largest->id());
+    Result flush_res = FlushMemTable(largest);
     if (!flush_res.ok()) {
       return flush_res;
     }
   }
-  Result final_ok_res = Result::OK(); // Delete operation itself is OK, even if it's for a non-existent key
-  std::cout << "[DB::Delete] EXIT - Returning OK. ok(): " << (final_ok_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(final_ok_res.code()) << ", message(): '" << final_ok_res.message() << "'" << std::endl;
-  return final_ok_res;
 }
 
-// Internal helper to find a key across all storage layers.
-DB::GetInternalResult DB::GetInternal(const Slice& key, Arena* sstable_target_arena_for_copy) {
-  std::cout << "[DB::GetInternal] ENTER for key: " << key.ToString()
-            << (sstable_target_arena_for_copy ? " (SSTable target arena provided)" : " (No SSTable target arena)")
-            << std::endl;
+Result DB::Write(const WriteBatch& batch) {
+  std::cout << "[DB::Write] ENTER. Operations: " << batch.Count() << ", bytes: " << batch.ApproximateSize() << std::endl;
+  if (default_cfd_ == nullptr) {
+    Result err_res = Result::IOError("Active memtable not available; DB may not be initialized or in error state.");
+    std::cout << "[DB::Write] EXIT - Error: DB is not initialized." << std::endl;
+    return err_res;
+  }
 
-  // 1. Check active MemTable
-  if (active_memtable_) {
-    Result res = active_memtable_->Get(key); // Assumes MemTable::Get returns Result with value_tag_
-    std::cout << "[DB::GetInternal] Active memtable Get. ok(): " << res.ok()
-              << ", code: " << static_cast<int>(res.code())
-              << ", msg: " << res.message()
-              << ", has_value_slice: " << res.value_slice().has_value()
-              << ", value_tag: " << (res.value_tag().has_value() ? static_cast<int>(res.value_tag().value()) : -1)
-              << std::endl;
-    if (res.ok()) {
-      if (res.value_tag().has_value() && res.value_tag().value() == ValueTag::kTombstone) {
-        std::cout << "[DB::GetInternal] Found TOMBSTONE in active memtable." << std::endl;
-        return GetInternalResult::TombstoneFound();
-      } else if (res.value_slice().has_value() && res.value_tag().has_value() && res.value_tag().value() == ValueTag::kData) {
-        std::cout << "[DB::GetInternal] Found DATA in active memtable. Slice points to memtable's arena." << std::endl;
-        return GetInternalResult::ValueFound(res.value_slice().value());
-      } else {
-        // This state (OK but no valid data/tombstone tag) should ideally not be reached if MemTable::Get is robust.
-        std::cout << "[DB::GetInternal] Active MemTable::Get OK but inconsistent state (e.g. no value_slice for data, or no tag)." << std::endl;
-        return GetInternalResult::Error(Result::Corruption("Active MemTable::Get returned OK with inconsistent state"));
+  // Validate the whole batch before any of it is logged: a batch is applied
+  // entirely or not at all, also on replay.
+  std::map<uint32_t, size_t> bytes_per_family;
+  Result check_res = batch.Iterate([&](WALRecordType, uint32_t column_family_id, const Slice& key, const Slice& value) {
+    if (column_families_.count(column_family_id) == 0) {
+      return Result::InvalidArgument("Unknown column family id " + std::to_string(column_family_id));
+    }
+    if (key.empty()) {
+      return Result::InvalidArgument("Key cannot be empty.");
+    }
+    bytes_per_family[column_family_id] += key.size() + value.size();
+    return Result::OK();
+  });
+  if (!check_res.ok()) {
+    std::cout << "[DB::Write] EXIT - Rejected batch: " << check_res.message() << std::endl;
+    return check_res;
+  }
+
+  for (const auto& [id, bytes] : bytes_per_family) {
+    Result stall_res = MakeRoomForWrite(column_families_[id].get(), bytes);
+    if (!stall_res.ok()) {
+      return stall_res;
+    }
+  }
+
+  if (wal_) {
+    Slice record(reinterpret_cast<const std::byte*>(batch.Data().data()), batch.Data().size());
+    Result log_res = wal_->AddRecord(record);
+    if (log_res.ok() && options_.sync_wal) {
+      log_res = wal_->Sync();
+    }
+    if (!log_res.ok()) {
+      std::cout << "[DB::Write] EXIT - Failed to log batch: " << log_res.message() << std::endl;
+      return log_res;
+    }
+  }
+
+  Result insert_res = InsertIntoMemTables(batch, std::numeric_limits<uint64_t>::max());
+  std::cout << "[DB::Write] InsertIntoMemTables result. ok(): " << (insert_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(insert_res.code()) << ", message(): '" << insert_res.message() << "'" << std::endl;
+  if (!insert_res.ok()) {
+    return insert_res;
+  }
+
+  for (const auto& [id, bytes] : bytes_per_family) {
+    ColumnFamilyData* cfd = column_families_[id].get();
+    size_t current_usage = cfd->active_memtable->ApproximateMemoryUsage();
+    std::cout << "[DB::Write] Memtable usage of '" << cfd->name() << "': " << current_usage << ", Threshold: " << cfd->threshold << std::endl;
+    if (current_usage >= cfd->threshold) {
+      std::cout << "[DB::Write] Threshold met. Calling FlushMemTable." << std::endl;
+      Result flush_res = FlushMemTable(cfd);
+      if (!flush_res.ok()) {
+        std::cout << "[DB::Write] EXIT - Error from FlushMemTable: " << flush_res.message() << std::endl;
+        return flush_res;
       }
-    } else if (res.code() == ResultCode::kNotFound) {
-      // kNotFound from MemTable means key is TRULY not in this memtable's map. Continue search.
-      std::cout << "[DB::GetInternal] kNotFound (truly not in map) from active memtable. Continuing search..." << std::endl;
-      // Fall through to check immutable memtable
-    } else { // Other error from MemTable::Get (e.g. corruption within MemTable)
-        std::cout << "[DB::GetInternal] Error from active memtable Get: " << res.message() << std::endl;
-        return GetInternalResult::Error(res); // Propagate error
-    }
-  }
-
-  // 2. Check immutable MemTable
-  if (immutable_memtable_) {
-    Result res = immutable_memtable_->Get(key);
-     std::cout << "[DB::GetInternal] Immutable memtable Get. ok(): " << res.ok()
-              << ", code: " << static_cast<int>(res.code())
-              << ", msg: " << res.message()
-              << ", has_value_slice: " << res.value_slice().has_value()
-              << ", value_tag: " << (res.value_tag().has_value() ? static_cast<int>(res.value_tag().value()) : -1)
-              << std::endl;
+    }
+  }
+  Result budget_res = EnforceWriteBufferBudget();
+  if (!budget_res.ok()) {
+    return budget_res;
+  }
+  std::cout << "[DB::Write] EXIT - Returning OK." << std::endl;
+  return Result::OK();
+}
+
+Result DB::Put(const Slice& key, const Slice& value) {
+  return Put(DefaultColumnFamily(), key, value);
+}
+
+Result DB::Put(ColumnFamilyHandle* column_family, const Slice& key, const Slice& value) {
+  std::cout << "[DB::Put] ENTER. Key: " << key.ToString() << std::endl;
+  if (column_family == nullptr) {
+    return Result::IOError("Active memtable not available; DB may not be initialized or in error state.");
+  }
+  WriteBatch batch;
+  batch.Put(column_family, key, value);
+  return Write(batch);
+}
+
+Result DB::Delete(const Slice& key) {
+  return Delete(DefaultColumnFamily(), key);
+}
+
+Result DB::Delete(ColumnFamilyHandle* column_family, const Slice& key) {
+  std::cout << "[DB::Delete] ENTER. Key: " << key.ToString() << std::endl;
+  if (column_family == nullptr) {
+    return Result::IOError("Active memtable not available; DB may not be initialized or in error state.");
+  }
+  WriteBatch batch;
+  batch.Delete(column_family, key);
+  // Deleting a key that does not exist is not an error.
+  return Write(batch);
+}
+
+// Looks the key up in the active and then the immutable memtable. Returns
+// TrulyNotFound when neither holds an entry for it.
+DB::GetInternalResult DB::GetFromMemTables(const ColumnFamilyData& cfd, const Slice& key) const {
+  // Active first, then immutable. This is the hottest part of every read, so
+  // it neither logs nor allocates: misses and tombstones are plain status codes.
+  for (const MemTable* memtable : {cfd.active_memtable.get(), cfd.immutable_memtable.get()}) {
+    if (memtable == nullptr) {
+      continue;
+    }
+    Slice value;
+    Result res = memtable->Get(key, &value);
     if (res.ok()) {
-      if (res.value_tag().has_value() && res.value_tag().value() == ValueTag::kTombstone) {
-        std::cout << "[DB::GetInternal] Found TOMBSTONE in immutable memtable." << std::endl;
-        return GetInternalResult::TombstoneFound();
-      } else if (res.value_slice().has_value() && res.value_tag().has_value() && res.value_tag().value() == ValueTag::kData) {
-        std::cout << "[DB::GetInternal] Found DATA in immutable memtable. Slice points to memtable's arena." << std::endl;
-        return GetInternalResult::ValueFound(res.value_slice().value());
-      } else {
-        std::cout << "[DB::GetInternal] Immutable MemTable::Get OK but inconsistent state." << std::endl;
-        return GetInternalResult::Error(Result::Corruption("Immutable MemTable::Get returned OK with inconsistent state"));
+      return GetInternalResult::ValueFound(value); // Slice points to the memtable's arena.
+    }
+    if (res.IsTombstone()) {
+      return GetInternalResult::TombstoneFound();
+    }
+    if (!res.IsNotFound()) {
+      std::cout << "[DB::GetFromMemTables] Error from memtable Get: " << res.message() << std::endl;
+      return GetInternalResult::Error(res);
+    }
+  }
+
+  return GetInternalResult::TrulyNotFound();
+}
+
+// Looks the key up in one SSTable. A value found is copied into `arena`, and
+// a blob index is resolved through `blob_files`. Returns TrulyNotFound when
+// the table holds no entry for the key.
+DB::GetInternalResult DB::GetFromTable(SSTableReader& reader, const std::vector<BlobFileMetaData>& blob_files,
+                                       const Slice& key, Arena* arena) {
+  const std::string& reader_filename = reader.filename();
+  Slice value;
+  ValueTag tag = ValueTag::kData;
+  Result sst_read_res = reader.Get(key, arena, &value, &tag);
+
+  std::cout << "[DB::GetFromTable] SSTableReader (" << reader_filename << ") Get result. ok(): "
+            << (sst_read_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(sst_read_res.code())
+            << ", message(): '" << sst_read_res.message() << "'"
+            << ", value_tag: " << static_cast<int>(tag)
+            << std::endl;
+
+  if (sst_read_res.IsTombstone()) {
+    std::cout << "[DB::GetFromTable] Found TOMBSTONE in SSTable " << reader_filename << "." << std::endl;
+    return GetInternalResult::TombstoneFound();
+  }
+  if (sst_read_res.ok()) {
+    if (tag == ValueTag::kBlobIndex) {
+      Slice blob_value;
+      Result blob_res = ResolveBlobIndex(blob_files, value, arena, &blob_value);
+      if (!blob_res.ok()) {
+        std::cout << "[DB::GetFromTable] Failed to read blob referenced by " << reader_filename << ": " << blob_res.message() << std::endl;
+        return GetInternalResult::Error(blob_res);
       }
-    } else if (res.code() == ResultCode::kNotFound) {
-      std::cout << "[DB::GetInternal] kNotFound (truly not in map) from immutable memtable. Continuing search..." << std::endl;
-      // Fall through to check SSTables
-    } else { // Other error
-        std::cout << "[DB::GetInternal] Error from immutable memtable Get: " << res.message() << std::endl;
-        return GetInternalResult::Error(res);
+      std::cout << "[DB::GetFromTable] Found BLOB INDEX in SSTable " << reader_filename << ". Read " << blob_value.size() << " bytes from blob file." << std::endl;
+      return GetInternalResult::ValueFound(blob_value);
     }
+    // Actual data found; slice points into arena
+    std::cout << "[DB::GetFromTable] Found DATA in SSTable " << reader_filename << ". Slice points to arena: " << arena << std::endl;
+    return GetInternalResult::ValueFound(value);
+  } else if (sst_read_res.code() == ResultCode::kNotFound) {
+    // kNotFound from SSTableReader means key truly not in this file (neither data nor tombstone).
+    std::cout << "[DB::GetFromTable] kNotFound (truly not in file) from SSTable " << reader_filename << "." << std::endl;
+    return GetInternalResult::TrulyNotFound();
+  }
+  // Any other error from SSTableReader (e.g., kIOError, kCorruption)
+  std::cout << "[DB::GetFromTable] Error from SSTableReader " << reader_filename << ": " << sst_read_res.message() << std::endl;
+  return GetInternalResult::Error(sst_read_res);
+}
+
+// Internal helper to find a key across all storage layers.
+DB::GetInternalResult DB::GetInternal(ColumnFamilyData* cfd, const Slice& key, Arena* sstable_target_arena_for_copy) {
+  std::cout << "[DB::GetInternal] ENTER for key: " << key.ToString()
+            << (sstable_target_arena_for_copy ? " (SSTable target arena provided)" : " (No SSTable target arena)")
+            << std::endl;
+  if (cfd == nullptr) {
+    return GetInternalResult::Error(Result::IOError("Column family not available; DB may not be initialized."));
+  }
+
+  GetInternalResult memtable_res = GetFromMemTables(*cfd, key);
+  if (!memtable_res.IsTrulyNotFound()) {
+    return memtable_res;
   }
 
-  // 3. Iterate L0 SSTables (newest to oldest)
-  std::cout << "[DB::GetInternal] Key '" << key.ToString() << "' not in memtables. Checking " << l0_sstables_.size() << " L0 SSTables." << std::endl;
-  for (const std::string& sstable_filename : l0_sstables_) {
+  // Iterate SSTables level by level: L0 newest to oldest, then L1 and below.
+  std::cout << "[DB::GetInternal] Key '" << key.ToString() << "' not in memtables. Checking " << cfd->levels[0].size() << " L0 SSTables." << std::endl;
+  FilePicker picker(cfd->levels, cfd->file_indexer, KeyComparator(cfd->options.comparator), key);
+  for (const FileMetaData* file_meta = picker.GetNextFile(); file_meta != nullptr; file_meta = picker.GetNextFile()) {
+    const std::string& sstable_filename = file_meta->path;
     std::cout << "[DB::GetInternal] Checking SSTable: " << sstable_filename << " for key " << key.ToString() << std::endl;
 
-    SSTableReader local_reader_instance(sstable_filename);
+    SSTableReader local_reader_instance(sstable_filename, cfd->options.comparator);
     Result reader_init_res = local_reader_instance.Init();
     if (!reader_init_res.ok()) {
         std::cout << "[DB::GetInternal] Failed to init reader for " << sstable_filename << ". Skipping. Msg: " << reader_init_res.message() << std::endl;
@@ -317,55 +1490,30 @@ DB::GetInternalResult DB::GetInternal(const Slice& key, Arena* sstable_target_ar
 
     Arena temp_local_arena_for_sst_read; // Used if sstable_target_arena_for_copy is nullptr
     Arena* arena_to_use_for_sst_get = sstable_target_arena_for_copy ? sstable_target_arena_for_copy : &temp_local_arena_for_sst_read;
-    std::cout << "[DB::GetInternal] Using arena " << arena_to_use_for_sst_get
-              << (arena_to_use_for_sst_get == sstable_target_arena_for_copy ? " (caller-provided)" : " (temporary local)")
-              << " for SSTableReader::Get." << std::endl;
-
-    // ASSUMPTION: SSTableReader::Get is updated to return Result with value_tag_
-    Result sst_read_res = local_reader_instance.Get(key, arena_to_use_for_sst_get);
-
-    std::cout << "[DB::GetInternal] SSTableReader (" << sstable_filename << ") Get result. ok(): "
-              << (sst_read_res.ok() ? "true" : "false") << ", code(): " << static_cast<int>(sst_read_res.code())
-              << ", message(): '" << sst_read_res.message() << "'"
-              << ", has_value_slice: " << sst_read_res.value_slice().has_value()
-              << ", value_tag: " << (sst_read_res.value_tag().has_value() ? static_cast<int>(sst_read_res.value_tag().value()) : -1)
-              << std::endl;
-
-    if (sst_read_res.ok()) {
-      if (sst_read_res.value_tag().has_value() && sst_read_res.value_tag().value() == ValueTag::kTombstone) {
-        std::cout << "[DB::GetInternal] Found TOMBSTONE in SSTable " << sstable_filename << "." << std::endl;
-        return GetInternalResult::TombstoneFound();
-      } else if (sst_read_res.value_slice().has_value() && sst_read_res.value_tag().has_value() && sst_read_res.value_tag().value() == ValueTag::kData) {
-        // Actual data found; slice points into arena_to_use_for_sst_get
-        std::cout << "[DB::GetInternal] Found DATA in SSTable " << sstable_filename << ". Slice points to arena: " << arena_to_use_for_sst_get << std::endl;
-        return GetInternalResult::ValueFound(sst_read_res.value_slice().value());
-      } else {
-        std::cout << "[DB::GetInternal] SSTableReader::Get OK but inconsistent state for " << sstable_filename << std::endl;
-        return GetInternalResult::Error(Result::Corruption("SSTableReader::Get returned OK with inconsistent state for " + sstable_filename));
-      }
-    } else if (sst_read_res.code() == ResultCode::kNotFound) {
-      // kNotFound from SSTableReader means key truly not in this file (neither data nor tombstone). Continue search.
-      std::cout << "[DB::GetInternal] kNotFound (truly not in file) from SSTable " << sstable_filename << ". Continuing search..." << std::endl;
-      // Fall through to check next SSTable
-    } else { // Any other error from SSTableReader (e.g., kIOError, kCorruption)
-      std::cout << "[DB::GetInternal] Error from SSTableReader " << sstable_filename << ": " << sst_read_res.message() << ". Aborting GetInternal." << std::endl;
-      return GetInternalResult::Error(sst_read_res); // Propagate the error
+    GetInternalResult table_res = GetFromTable(local_reader_instance, cfd->blob_files, key, arena_to_use_for_sst_get);
+    if (!table_res.IsTrulyNotFound()) {
+      return table_res;
     }
   }
   std::cout << "[DB::GetInternal] Key '" << key.ToString() << "' truly not found after all checks." << std::endl;
   return GetInternalResult::TrulyNotFound();
 }
 
-
 Result DB::Get(const Slice& key, std::string* value_out) {
+  return Get(DefaultColumnFamily(), key, value_out);
+}
+
+Result DB::Get(ColumnFamilyHandle* column_family, const Slice& key, std::string* value_out) {
+  ColumnFamilyData* cfd = GetColumnFamilyData(column_family);
   if (value_out == nullptr) {
     return Result::InvalidArgument("Output string pointer (value_out) is null.");
   }
   value_out->clear();
   std::cout << "[DB::Get string*] ENTER for key: " << key.ToString() << std::endl;
 
-  // GetInternal uses a temporary arena for SSTable reads if sstable_target_arena_for_copy is nullptr.
-  GetInternalResult internal_res = GetInternal(key, nullptr);
+  // Values found in an SSTable are copied into this arena; it must outlive the copy into value_out.
+  Arena sstable_value_arena;
+  GetInternalResult internal_res = GetInternal(cfd, key, &sstable_value_arena);
 
   std::cout << "[DB::Get string*] GetInternal result. status.ok(): " << internal_res.status.ok()
             << ", is_tombstone: " << internal_res.is_tombstone
@@ -393,11 +1541,141 @@ Result DB::Get(const Slice& key, std::string* value_out) {
   }
 }
 
-Result DB::Get(const Slice& key, Arena& result_arena) {
+DB::GetAwaiter DB::AsyncGet(const Slice& key, std::string* value_out, ResumeFn resume) {
+  return AsyncGet(DefaultColumnFamily(), key, value_out, std::move(resume));
+}
+
+DB::GetAwaiter DB::AsyncGet(ColumnFamilyHandle* column_family, const Slice& key, std::string* value_out,
+                            ResumeFn resume) {
+  GetAwaiter awaiter;
+  if (value_out == nullptr) {
+    awaiter.status_ = Result::InvalidArgument("Output string pointer (value_out) is null.");
+    return awaiter;
+  }
+  value_out->clear();
+  ColumnFamilyData* cfd = GetColumnFamilyData(column_family);
+  if (cfd == nullptr) {
+    awaiter.status_ = Result::IOError("Column family not available; DB may not be initialized.");
+    return awaiter;
+  }
+
+  GetInternalResult memtable_res = GetFromMemTables(*cfd, key);
+  if (!memtable_res.IsTrulyNotFound()) {
+    if (memtable_res.status.ok() && !memtable_res.is_tombstone) {
+      value_out->assign(reinterpret_cast<const char*>(memtable_res.data_slice.data()), memtable_res.data_slice.size());
+    }
+    awaiter.status_ = memtable_res.status;
+    return awaiter;
+  }
+
+  // Same files, in the same order, as GetInternal searches. Only their paths
+  // are taken here; the tables are opened where they are read.
+  FilePicker picker(cfd->levels, cfd->file_indexer, KeyComparator(cfd->options.comparator), key);
+  for (const FileMetaData* file_meta = picker.GetNextFile(); file_meta != nullptr; file_meta = picker.GetNextFile()) {
+    awaiter.table_paths_.push_back(file_meta->path);
+  }
+  if (awaiter.table_paths_.empty()) {
+    awaiter.status_ = GetInternalResult::TrulyNotFound().status;
+    return awaiter;
+  }
+  if (!resume) {
+    awaiter.status_ = GetFromTables(awaiter.table_paths_, cfd->options.comparator, cfd->blob_files, key, value_out);
+    return awaiter;
+  }
+  awaiter.ready_ = false;
+  awaiter.key_ = key.ToString();
+  awaiter.value_out_ = value_out;
+  awaiter.comparator_ = cfd->options.comparator;
+  awaiter.blob_files_ = cfd->blob_files;
+  awaiter.db_ = this;
+  awaiter.resume_ = std::move(resume);
+  return awaiter;
+}
+
+void DB::GetAwaiter::await_suspend(std::coroutine_handle<> handle) {
+  // Counted from here, not from AsyncGet, so an awaiter that is never
+  // awaited does not hold back file removal forever.
+  db_->BeginAsyncRead();
+  db_->options_.thread_pool->Schedule([this, handle]() {
+    Slice key(reinterpret_cast<const std::byte*>(key_.data()), key_.size());
+    status_ = GetFromTables(table_paths_, comparator_, blob_files_, key, value_out_);
+    // The awaiter dies once the coroutine moves on; take what is still needed.
+    DB* db = db_;
+    ResumeFn resume = std::move(resume_);
+    db->EndAsyncRead();
+    resume(handle);
+  }, ThreadPriority::kUser);
+}
+
+Result DB::GetFromTables(const std::vector<std::string>& table_paths, const Comparator* comparator,
+                         const std::vector<BlobFileMetaData>& blob_files, const Slice& key,
+                         std::string* value_out) {
+  Arena value_arena;
+  for (const std::string& path : table_paths) {
+    SSTableReader reader(path, comparator);
+    Result reader_init_res = reader.Init();
+    if (!reader_init_res.ok()) {
+      std::cout << "[DB::GetFromTables] Failed to init reader for " << path << ". Skipping. Msg: " << reader_init_res.message() << std::endl;
+      continue;
+    }
+    GetInternalResult table_res = GetFromTable(reader, blob_files, key, &value_arena);
+    if (table_res.IsTrulyNotFound()) {
+      continue;
+    }
+    if (table_res.status.ok() && !table_res.is_tombstone) {
+      value_out->assign(reinterpret_cast<const char*>(table_res.data_slice.data()), table_res.data_slice.size());
+    }
+    return table_res.status;
+  }
+  return GetInternalResult::TrulyNotFound().status;
+}
+
+void DB::RemoveObsoleteFile(const std::string& path) {
+  {
+    std::lock_guard<std::mutex> lock(async_reads_mutex_);
+    if (async_reads_in_flight_ > 0) {
+      deferred_removals_.push_back(path);
+      std::cout << "[DB::RemoveObsoleteFile] Deferring removal of " << path << " until "
+                << async_reads_in_flight_ << " async lookups finish." << std::endl;
+      return;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  std::cout << "[DB::RemoveObsoleteFile] Removed " << path << (ec ? " (failed: " + ec.message() + ")" : "")
+            << std::endl;
+}
+
+void DB::BeginAsyncRead() {
+  std::lock_guard<std::mutex> lock(async_reads_mutex_);
+  async_reads_in_flight_++;
+}
+
+void DB::EndAsyncRead() {
+  std::vector<std::string> removals;
+  {
+    std::lock_guard<std::mutex> lock(async_reads_mutex_);
+    if (--async_reads_in_flight_ == 0) {
+      removals.swap(deferred_removals_);
+      // Under the lock: once the destructor sees zero, the DB may be gone.
+      async_reads_done_.notify_all();
+    }
+  }
+  // Quiet on purpose: this runs on a pool thread, alongside the DB's own logging.
+  for (const std::string& path : removals) {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+  }
+}
+
+Result DB::Get(const Slice& key, Arena& result_arena, Slice* value_out) {
+  if (value_out == nullptr) {
+    return Result::InvalidArgument("Output slice pointer is null.");
+  }
   std::cout << "[DB::Get Arena&] ENTER for key: " << key.ToString() << ", using provided result_arena: " << &result_arena << std::endl;
 
   // Pass the caller's result_arena to GetInternal.
-  GetInternalResult internal_res = GetInternal(key, &result_arena);
+  GetInternalResult internal_res = GetInternal(default_cfd_, key, &result_arena);
 
    std::cout << "[DB::Get Arena&] GetInternal result. status.ok(): " << internal_res.status.ok()
             << ", is_tombstone: " << internal_res.is_tombstone
@@ -429,7 +1707,8 @@ Result DB::Get(const Slice& key, Arena& result_arena) {
 
     if (data_already_in_result_arena) {
         std::cout << "[DB::Get Arena&] Re-using slice already in result_arena." << std::endl;
-        return Result::OK(original_slice);
+        *value_out = original_slice;
+        return Result::OK();
     } else {
         std::cout << "[DB::Get Arena&] Data slice from memtable or copy required. Allocating and copying to result_arena." << std::endl;
         void* copied_value_ptr = result_arena.Allocate(original_slice.size(), alignof(std::byte));
@@ -449,7 +1728,8 @@ Result DB::Get(const Slice& key, Arena& result_arena) {
             std::cout << "[DB::Get Arena&] Original slice was empty, allocated 0 bytes in result_arena (ptr: " << copied_value_ptr << ")." << std::endl;
         }
         Slice final_slice(static_cast<const std::byte*>(copied_value_ptr), original_slice.size());
-        return Result::OK(final_slice);
+        *value_out = final_slice;
+        return Result::OK();
     }
 
   } else {
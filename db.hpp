@@ -1,45 +1,220 @@
 #ifndef DB_HPP
 #define DB_HPP
 
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <functional>
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 #include <iostream> // For std::cout in debug prints
 
 #include "arena.hpp"
+#include "column_family.hpp"
+#include "manifest.hpp"
 #include "mem_table.hpp"
+#include "options.hpp"
 #include "result.hpp"
 #include "slice.hpp"
+#include "sstable_reader.hpp"
+#include "thread_pool.hpp"
+#include "version_edit.hpp"
+#include "wal_writer.hpp"
+#include "write_batch.hpp"
+#include "write_controller.hpp"
 
 // Forward declaration for SSTableReader to be used as an opaque pointer in GetInternal if needed
 // Though current GetInternal creates it locally.
 // struct SSTableReader;
 
 struct DB {
-  DB(std::string db_directory, std::size_t threshold);
-  ~DB() = default;
+  DB(std::string db_directory, std::size_t threshold, DBOptions options = DBOptions());
+  // Waits for AsyncGet lookups still queued or reading on the thread pool.
+  ~DB();
 
   DB(const DB&) = delete;
   DB& operator=(const DB&) = delete;
   DB(DB&&) = delete;
   DB& operator=(DB&&) = delete;
 
+  // Opens the DB: loads every column family from the manifest and replays
+  // writes that were still in the write-ahead log. Returns InvalidArgument if
+  // a column family was written with a comparator of another name.
   Result Init();
+  // As Init(), but the non-default column families named in
+  // `column_family_options` are reopened with those options instead of the DB's.
+  Result Init(const std::map<std::string, DBOptions>& column_family_options);
 
+  // Adds a column family with its own memtable flush threshold and options;
+  // see DBOptions for the settings that stay DB-wide. Returns InvalidArgument
+  // if the name is taken. Column families are recorded in the manifest, so
+  // after a reopen they are found with GetColumnFamily(), running with the
+  // DB's own threshold and the options passed to Init (by default the DB's).
+  Result CreateColumnFamily(const std::string& name, std::size_t threshold, DBOptions options,
+                            ColumnFamilyHandle** handle);
+  // nullptr if there is no column family of that name.
+  ColumnFamilyHandle* GetColumnFamily(const std::string& name) const;
+  ColumnFamilyHandle* DefaultColumnFamily() const;
+
+  // Applies every operation in `batch` atomically, across column families.
+  Result Write(const WriteBatch& batch);
+
+  // The overloads without a handle operate on the default column family.
   Result Put(const Slice& key, const Slice& value);
+  Result Put(ColumnFamilyHandle* column_family, const Slice& key, const Slice& value);
 
   Result Get(const Slice& key, std::string* value_out);
+  Result Get(ColumnFamilyHandle* column_family, const Slice& key, std::string* value_out);
+
+  // Hands a suspended AsyncGet back to the executor that awaits it, e.g. by
+  // queueing `handle` for that executor to resume. Called on a pool thread;
+  // it should return quickly rather than resume the coroutine there.
+  using ResumeFn = std::function<void(std::coroutine_handle<>)>;
+
+  // Awaitable returned by AsyncGet; `co_await` yields the same Result as Get.
+  struct GetAwaiter {
+   public:
+    GetAwaiter(GetAwaiter&&) = default;
+    GetAwaiter& operator=(GetAwaiter&&) = default;
+
+    bool await_ready() const noexcept { return ready_; }
+    void await_suspend(std::coroutine_handle<> handle);
+    Result await_resume() { return std::move(status_); }
+
+   private:
+    friend struct DB;
+    GetAwaiter() = default;
 
-  // Get method that copies the value into the provided Arena,
-  // and the Result object contains the Slice pointing to it.
-  //Result Get(const Slice& key, Arena& result_arena);
+    bool ready_ = true;
+    Result status_;
+    std::string key_;
+    std::string* value_out_ = nullptr;
+    // Tables that may hold the key, in search order. The DB keeps them on
+    // disk until the lookup finishes, even if a compaction replaces them.
+    std::vector<std::string> table_paths_;
+    const Comparator* comparator_ = nullptr;
+    std::vector<BlobFileMetaData> blob_files_;
+    DB* db_ = nullptr;
+    ResumeFn resume_;
+  };
+
+  // Coroutine-friendly Get. Memtable hits complete without suspending. Other
+  // lookups open and read their SSTables on a ThreadPriority::kUser thread of
+  // the pool, stopping at the first table that holds the key, and then pass
+  // the awaiting coroutine to `resume`, so one executor thread can keep many
+  // lookups in flight. Without `resume` there is no executor to return to:
+  // the tables are read on the calling thread and the lookup completes
+  // without suspending. Pass a `resume` that calls handle.resume() to have
+  // the coroutine continue on the pool thread instead; any DB call it makes
+  // there then runs concurrently with the executor's.
+  // Await the result right away; `value_out` must outlive the co_await. Like
+  // every DB call, AsyncGet itself must not run concurrently with writes.
+  GetAwaiter AsyncGet(const Slice& key, std::string* value_out, ResumeFn resume = nullptr);
+  GetAwaiter AsyncGet(ColumnFamilyHandle* column_family, const Slice& key, std::string* value_out,
+                      ResumeFn resume = nullptr);
+
+  // Get method that copies the value into the provided Arena and points
+  // *value_out at the copy.
+  Result Get(const Slice& key, Arena& result_arena, Slice* value_out);
 
   Result Delete(const Slice& key);
+  Result Delete(ColumnFamilyHandle* column_family, const Slice& key);
+
+  // Merges every L0 file together with the overlapping L1 files into new L1 files.
+  // Runs automatically after a flush once L0 reaches
+  // DBOptions::level0_file_num_compaction_trigger files.
+  Result CompactLevel0();
+  Result CompactLevel0(ColumnFamilyHandle* column_family);
+
+  // Adds an SSTable built by SstFileWriter to the DB without rewriting it.
+  // Its entries become visible atomically and take precedence over every
+  // existing version of the same keys. The file is hard-linked into the DB
+  // directory (copied if linking fails, e.g. across filesystems) and placed
+  // in the lowest level where it overlaps no existing file, flushing the
+  // memtable first if it holds keys in the file's range. With `move_files`
+  // the original is removed after a successful link.
+  Result IngestExternalFile(const std::string& external_file, bool move_files = false);
+  Result IngestExternalFile(ColumnFamilyHandle* column_family, const std::string& external_file,
+                            bool move_files = false);
+
+  // Creates a consistent, openable copy of the DB in `checkpoint_dir`, which
+  // must not exist yet; neither may `checkpoint_dir`.tmp, where the copy is
+  // staged. The memtables of all column families are flushed,
+  // every live SSTable is hard-linked (copied if linking fails) together with
+  // every live blob file, and a manifest listing them is written, so no table
+  // data is copied on the common path.
+  Result CreateCheckpoint(const std::string& checkpoint_dir);
+
+  size_t NumFilesAtLevel(int level) const;
+  size_t NumFilesAtLevel(ColumnFamilyHandle* column_family, int level) const;
+
+  // Blob files still referenced by some SSTable, with their garbage counts.
+  const std::vector<BlobFileMetaData>& GetLiveBlobFiles() const;
+  const std::vector<BlobFileMetaData>& GetLiveBlobFiles(ColumnFamilyHandle* column_family) const;
+
+  // Bytes the next L0 compactions would have to rewrite: for every column
+  // family with files in L0, all of L0 plus every L1 file it may overlap.
+  uint64_t EstimatePendingCompactionBytes() const;
+
+  // How often and for how long writes were slowed down or stopped, by cause.
+  WriteStallStats GetWriteStallStats() const;
+
+  // Queue depth and time spent of the background thread pool. With a pool
+  // shared through DBOptions::thread_pool, this covers every DB using it.
+  ThreadPoolStats GetThreadPoolStats(ThreadPriority priority) const;
 
  private:
-  Result FlushMemTable();
-  std::string GenerateSSTableFilename();
+  ColumnFamilyData* GetColumnFamilyData(ColumnFamilyHandle* column_family) const;
+  Result NewColumnFamilyData(uint32_t id, const std::string& name, std::size_t threshold,
+                             DBOptions options, ColumnFamilyData** cfd);
+
+  Result FlushMemTable(ColumnFamilyData* cfd);
+  Result MaybeCompact(ColumnFamilyData* cfd);
+  Result CompactLevel0(ColumnFamilyData* cfd);
+  // Applies write stall decisions before a write of `write_bytes` enters the memtable.
+  Result MakeRoomForWrite(ColumnFamilyData* cfd, size_t write_bytes);
+  // Flushes the largest memtable while all memtables together exceed
+  // DBOptions::db_write_buffer_size.
+  Result EnforceWriteBufferBudget();
+  std::string GenerateSSTableFilename(uint64_t file_number) const;
+  std::string GenerateBlobFilename(uint64_t file_number) const;
+  std::string GenerateLogFilename(uint64_t file_number) const;
+  uint64_t NewFileNumber();
+  bool ActiveMemTableIsEmpty(const ColumnFamilyData& cfd) const;
+  bool MemTableOverlapsRange(const ColumnFamilyData& cfd, const std::string& smallest,
+                             const std::string& largest) const;
+  uint64_t EstimatePendingCompactionBytes(const ColumnFamilyData& cfd) const;
+
+  // Installs all additions and removals of `edit` into the levels and blob
+  // files of `cfd` at once, after recording the result in the manifest. Blob
+  // files left without live blobs are deleted.
+  Result ApplyVersionEdit(ColumnFamilyData* cfd, const VersionEdit& edit);
+  // The current state of every column family, as the manifest records it.
+  ManifestContents BuildManifestContents() const;
+  // Blob files whose blobs the next compaction should relocate: the oldest
+  // blob_garbage_collection_age_cutoff fraction of them.
+  std::set<uint64_t> SelectBlobFilesForGC(const ColumnFamilyData& cfd) const;
+  // Replaces a blob index found in an SSTable with the value it points to,
+  // read into `arena`.
+  static Result ResolveBlobIndex(const std::vector<BlobFileMetaData>& blob_files, const Slice& blob_index,
+                                 Arena* arena, Slice* value_out);
+  void TuneRateLimiter();
+
+  // Applies the operations of a batch to the memtables, without logging them.
+  Result InsertIntoMemTables(const WriteBatch& batch, uint64_t log_number);
+  // Replays the logs that may hold unflushed writes. Sets `*damaged` if a log
+  // ended in a damaged record; replay stops there.
+  Result RecoverLogs(bool* damaged);
+  // Starts a new write-ahead log. Writes logged before this call are all in
+  // logs numbered below `*new_log_number`.
+  Result SwitchLog(uint64_t* new_log_number);
+  // Removes logs whose writes have been flushed by every column family.
+  void DeleteObsoleteLogs();
 
   // Helper for Get logic to avoid code duplication.
   struct GetInternalResult {
@@ -59,13 +234,13 @@ struct DB {
     static GetInternalResult TombstoneFound() {
       GetInternalResult res;
       // For the caller (public Get), a tombstone means the key is "not found"
-      res.status = Result::NotFound("Key is a tombstone");
+      res.status = Result::NotFound();
       res.is_tombstone = true;
       return res;
     }
     static GetInternalResult TrulyNotFound() {
       GetInternalResult res;
-      res.status = Result::NotFound("Key not found in DB");
+      res.status = Result::NotFound();
       res.is_tombstone = false; // Not a tombstone, just absent
       return res;
     }
@@ -75,23 +250,59 @@ struct DB {
         res.is_tombstone = false; // Not relevant for errors
         return res;
     }
+    // The layer searched holds nothing for the key; keep looking further down.
+    bool IsTrulyNotFound() const { return status.code() == ResultCode::kNotFound && !is_tombstone; }
   };
+  GetInternalResult GetFromMemTables(const ColumnFamilyData& cfd, const Slice& key) const;
+  static GetInternalResult GetFromTable(SSTableReader& reader, const std::vector<BlobFileMetaData>& blob_files,
+                                        const Slice& key, Arena* arena);
+  // Searches the tables at `table_paths` in order, opening each only when
+  // the ones before it do not hold the key, and copies a value found into
+  // `value_out`. Touches no DB state, so it may run on any thread.
+  static Result GetFromTables(const std::vector<std::string>& table_paths, const Comparator* comparator,
+                              const std::vector<BlobFileMetaData>& blob_files, const Slice& key,
+                              std::string* value_out);
+
+  // Files replaced by a version edit are removed through RemoveObsoleteFile.
+  // While an AsyncGet is reading tables on the pool, removal is deferred
+  // until the last such lookup ends, so none of them loses a file it was
+  // about to open.
+  void RemoveObsoleteFile(const std::string& path);
+  void BeginAsyncRead();
+  void EndAsyncRead();
   // Arena* parameter is for the target arena if data is found in an SSTable
   // and needs to be copied into a user-provided arena.
-  GetInternalResult GetInternal(const Slice& key, Arena* sstable_target_arena_for_copy);
+  GetInternalResult GetInternal(ColumnFamilyData* cfd, const Slice& key, Arena* sstable_target_arena_for_copy);
 
 
-  std::unique_ptr<Arena> active_memtable_arena_;
-  std::unique_ptr<MemTable> active_memtable_;
+  // Keyed by column family id; the default family is id 0.
+  std::map<uint32_t, std::unique_ptr<ColumnFamilyData>> column_families_;
+  ColumnFamilyData* default_cfd_;
+  uint32_t next_column_family_id_;
 
-  std::unique_ptr<Arena> immutable_memtable_arena_;
-  std::unique_ptr<MemTable> immutable_memtable_;
+  // The log new writes go to, and the numbers of every log that may still
+  // hold unflushed writes, oldest first.
+  std::unique_ptr<WALWriter> wal_;
+  std::vector<uint64_t> alive_logs_;
 
-  std::vector<std::string> l0_sstables_;
   size_t threshold_;
   std::string db_dir_;
+  DBOptions options_;
+  WriteController write_controller_;
+
+  // Guards next_sstable_id_; compaction threads allocate output file numbers concurrently.
+  // SSTables, blob files and logs share this number space.
+  mutable std::mutex file_number_mutex_;
   uint64_t next_sstable_id_;
 
+  // AsyncGet lookups reading on the pool, and the files whose removal waits
+  // for them. EndAsyncRead runs on pool threads, hence the mutex; it signals
+  // async_reads_done_ when the last lookup ends.
+  std::mutex async_reads_mutex_;
+  std::condition_variable async_reads_done_;
+  size_t async_reads_in_flight_ = 0;
+  std::vector<std::string> deferred_removals_;
+
   // TODO (Performance): Consider adding an SSTableReader cache (e.g., LRUCache)
   // to avoid re-opening and re-initializing readers for frequently accessed SSTables,
   // especially if L0 can grow large or for higher levels.
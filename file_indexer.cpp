@@ -0,0 +1,115 @@
+#include "file_indexer.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace {
+
+Slice StringAsSlice(const std::string& s) {
+  return Slice(reinterpret_cast<const std::byte*>(s.data()), s.size());
+}
+
+} // namespace
+
+void FileIndexer::Update(const KeyComparator& comparator, const std::vector<std::vector<FileMetaData>>& levels) {
+  levels_.assign(levels.size(), LevelHints());
+  for (size_t level = 1; level < levels.size(); ++level) {
+    levels_[level].sorted = std::all_of(levels[level].begin(), levels[level].end(),
+                                        [](const FileMetaData& f) { return f.has_key_range; });
+  }
+
+  for (size_t level = 1; level < levels.size(); ++level) {
+    const std::vector<FileMetaData>& files = levels[level];
+    if (files.empty() || !levels_[level].sorted) {
+      continue;
+    }
+    size_t next = level + 1;
+    while (next < levels.size() && levels[next].empty()) {
+      next++;
+    }
+    if (next == levels.size() || !levels_[next].sorted) {
+      continue;
+    }
+    // Both levels are in key order, so one merge pass places every file.
+    const std::vector<FileMetaData>& next_files = levels[next];
+    LevelHints& hints = levels_[level];
+    hints.next_level = static_cast<int>(next);
+    hints.next_level_index.resize(files.size());
+    size_t j = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+      while (j < next_files.size() &&
+             comparator.Compare(StringAsSlice(next_files[j].largest_key), StringAsSlice(files[i].largest_key)) < 0) {
+        j++;
+      }
+      hints.next_level_index[i] = static_cast<uint32_t>(j);
+    }
+  }
+}
+
+FilePicker::FilePicker(const std::vector<std::vector<FileMetaData>>& levels, const FileIndexer& indexer,
+                       const KeyComparator& comparator, const Slice& key)
+    : levels_(levels), indexer_(indexer), comparator_(comparator), key_(key) {}
+
+const FileMetaData* FilePicker::GetNextFile() {
+  while (level_ < levels_.size()) {
+    const std::vector<FileMetaData>& files = levels_[level_];
+    // Hints that do not match the level (an indexer never updated for these
+    // levels) are not trusted.
+    bool searchable = level_ > 0 && level_ < indexer_.levels_.size() && indexer_.levels_[level_].sorted &&
+                      (indexer_.levels_[level_].next_level < 0 ||
+                       indexer_.levels_[level_].next_level_index.size() == files.size());
+    if (searchable) {
+      const FileMetaData* file = SearchSortedLevel();
+      if (file != nullptr) {
+        return file;
+      }
+      continue;
+    }
+    while (next_file_ < files.size()) {
+      const FileMetaData& file = files[next_file_++];
+      if (!file.has_key_range ||
+          (comparator_.Compare(key_, StringAsSlice(file.smallest_key)) >= 0 &&
+           comparator_.Compare(key_, StringAsSlice(file.largest_key)) <= 0)) {
+        return &file;
+      }
+    }
+    level_++;
+    next_file_ = 0;
+  }
+  return nullptr;
+}
+
+const FileMetaData* FilePicker::SearchSortedLevel() {
+  const std::vector<FileMetaData>& files = levels_[level_];
+  const FileIndexer::LevelHints& hints = indexer_.levels_[level_];
+  size_t lo = 0;
+  size_t hi = files.size();
+  if (has_window_ && window_level_ == level_) {
+    lo = std::min(search_lo_, files.size());
+    hi = std::min(search_hi_, files.size());
+  }
+  // First file in [lo, hi) whose largest key is not below the key, or hi.
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (comparator_.Compare(StringAsSlice(files[mid].largest_key), key_) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  size_t index = lo;
+
+  if (hints.next_level >= 0) {
+    search_lo_ = index > 0 ? hints.next_level_index[index - 1] : 0;
+    search_hi_ = index < files.size() ? hints.next_level_index[index]
+                                      : levels_[static_cast<size_t>(hints.next_level)].size();
+    window_level_ = static_cast<size_t>(hints.next_level);
+    has_window_ = true;
+  }
+  level_++;
+
+  if (index < files.size() && comparator_.Compare(key_, StringAsSlice(files[index].smallest_key)) >= 0) {
+    return &files[index];
+  }
+  return nullptr;
+}
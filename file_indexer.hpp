@@ -0,0 +1,79 @@
+#ifndef FILE_INDEXER_HPP
+#define FILE_INDEXER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "comparator.hpp"
+#include "slice.hpp"
+#include "version_edit.hpp"
+
+// Search hints across the sorted levels (L1 and below), rebuilt whenever the
+// level structure changes.
+//
+// A lookup finds the key's place in a sorted level as the first file whose
+// largest key is not below it. For each file the indexer records where that
+// file's largest key falls in the next non-empty level. The key lies between
+// the largest keys of two neighbouring files, so the hints of those two files
+// bound where it can fall one level down. Each level is then binary-searched
+// over that window only, not over all of its files (fractional cascading, as
+// in LevelDB's and RocksDB's FilePicker).
+//
+// A level holding a file without a recorded key range cannot be searched by
+// position. FilePicker scans such a level linearly and gives the level below
+// it no window.
+struct FileIndexer {
+ public:
+  // `levels` as kept by ColumnFamilyData: L0 newest first, deeper levels in
+  // key order.
+  void Update(const KeyComparator& comparator, const std::vector<std::vector<FileMetaData>>& levels);
+
+ private:
+  friend struct FilePicker;
+
+  struct LevelHints {
+    bool sorted = false;   // Every file has a key range, so the level is searchable
+    int next_level = -1;   // Level the hints point into; -1 when there are none
+    // Per file: the first file of next_level whose largest key is not below
+    // this file's largest key, or the size of next_level if there is none.
+    std::vector<uint32_t> next_level_index;
+  };
+
+  std::vector<LevelHints> levels_;
+};
+
+// Yields, in search order, the files that may hold one key: the L0 files
+// whose range includes it, newest first, then at most one file per deeper
+// level. `levels` and `indexer` must stay unchanged while the picker is in
+// use.
+struct FilePicker {
+ public:
+  FilePicker(const std::vector<std::vector<FileMetaData>>& levels, const FileIndexer& indexer,
+             const KeyComparator& comparator, const Slice& key);
+
+  // The next file to search, or nullptr once none is left.
+  const FileMetaData* GetNextFile();
+
+ private:
+  // Finds the key's position in the sorted level `level_`, narrows the
+  // window for the level below, and returns the file at that position if its
+  // range holds the key.
+  const FileMetaData* SearchSortedLevel();
+
+  const std::vector<std::vector<FileMetaData>>& levels_;
+  const FileIndexer& indexer_;
+  KeyComparator comparator_;
+  Slice key_;
+
+  size_t level_ = 0;
+  size_t next_file_ = 0; // For levels scanned linearly: L0 and unsorted levels
+  // Window of positions in window_level_ the key can fall at, both ends
+  // inclusive; a position equal to the level's size means after its last file.
+  bool has_window_ = false;
+  size_t window_level_ = 0;
+  size_t search_lo_ = 0;
+  size_t search_hi_ = 0;
+};
+
+#endif // FILE_INDEXER_HPP
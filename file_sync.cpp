@@ -0,0 +1,34 @@
+#include "file_sync.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>  // For open
+#include <unistd.h> // For fsync, close
+
+namespace {
+
+Result SyncPath(const std::string& path, int flags, const char* what) {
+  int fd = ::open(path.c_str(), flags);
+  if (fd < 0) {
+    return Result::IOError(std::string("Failed to open ") + what + " '" + path + "' for sync: " +
+                           std::strerror(errno));
+  }
+  int sync_res = ::fsync(fd);
+  int sync_errno = errno;
+  ::close(fd);
+  if (sync_res != 0) {
+    return Result::IOError(std::string("Failed to sync ") + what + " '" + path + "': " + std::strerror(sync_errno));
+  }
+  return Result::OK();
+}
+
+} // namespace
+
+Result SyncFile(const std::string& path) {
+  return SyncPath(path, O_RDONLY, "file");
+}
+
+Result SyncDirectory(const std::string& dir) {
+  return SyncPath(dir.empty() ? "." : dir, O_RDONLY | O_DIRECTORY, "directory");
+}
@@ -0,0 +1,19 @@
+#ifndef FILE_SYNC_HPP
+#define FILE_SYNC_HPP
+
+#include <string>
+
+#include "result.hpp"
+
+// Durability helpers for files written through streams, which give no
+// access to their descriptor. Both reopen the path and fsync it.
+
+// Forces the contents of the file at `path` to stable storage. Call it once
+// the file is closed.
+Result SyncFile(const std::string& path);
+
+// Forces the entries of directory `dir` (files created, renamed or removed
+// in it) to stable storage.
+Result SyncDirectory(const std::string& dir);
+
+#endif // FILE_SYNC_HPP
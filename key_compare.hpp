@@ -0,0 +1,26 @@
+#ifndef KEY_COMPARE_HPP
+#define KEY_COMPARE_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// The first 8 bytes of a key as a big-endian integer, zero-padded when the
+// key is shorter. Prefixes order like the keys they come from: if a < b
+// bytewise then KeyPrefix(a) <= KeyPrefix(b), so unequal prefixes decide a
+// comparison with one integer compare and only equal ones need the bytes.
+inline uint64_t KeyPrefix(const void* data, size_t size) {
+  unsigned char bytes[8] = {};
+  if (size > 0) {
+    std::memcpy(bytes, data, size < 8 ? size : 8);
+  }
+  uint64_t word;
+  std::memcpy(&word, bytes, sizeof(word));
+  if constexpr (std::endian::native == std::endian::little) {
+    word = __builtin_bswap64(word);
+  }
+  return word;
+}
+
+#endif // KEY_COMPARE_HPP
@@ -0,0 +1,242 @@
+#include "manifest.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "coding.hpp"
+#include "file_sync.hpp"
+
+// The manifest is a sequence of tagged records, each a LE32 tag followed by
+// the tag's fields. Integers are little endian, strings are a LE32 length
+// followed by the bytes. A kEnd record must close the file; its absence means
+// the manifest was truncated.
+//
+// kComparator, kFile and kBlobFile records belong to the column family of the
+// closest kColumnFamily record before them, or to the default family if there is
+// none (manifests written before column families existed). A kFileKeyRange
+// record belongs to the kFile record right before it; files written before
+// key ranges were recorded have none.
+namespace {
+
+constexpr char kManifestMagic[] = "LSMMANIF";
+constexpr size_t kManifestMagicSize = sizeof(kManifestMagic) - 1;
+
+enum ManifestTag : uint32_t {
+  kEnd = 0,
+  kNextFileNumber = 1, // u64
+  kFile = 2,           // u32 level, u64 number, u64 file_size, string file name
+  kBlobFile = 3,       // u64 number, u64 total count, u64 total bytes, u64 garbage count,
+                       // u64 garbage bytes, string file name
+  kColumnFamily = 4,   // u32 id, u64 log number, string name
+  kComparator = 5,     // string comparator name
+  kFileKeyRange = 6,   // string smallest key, string largest key
+};
+
+void PutLengthPrefixed(std::string* dst, const std::string& value) {
+  PutFixed32(dst, static_cast<uint32_t>(value.size()));
+  dst->append(value);
+}
+
+// Consumes fields from the front of a manifest buffer.
+struct ManifestParser {
+  const std::string& data;
+  size_t pos = 0;
+
+  bool GetFixed32(uint32_t* value) {
+    if (pos + 4 > data.size()) {
+      return false;
+    }
+    *value = ReadLittleEndian32(data.data() + pos);
+    pos += 4;
+    return true;
+  }
+
+  bool GetFixed64(uint64_t* value) {
+    if (pos + 8 > data.size()) {
+      return false;
+    }
+    *value = ReadLittleEndian64(data.data() + pos);
+    pos += 8;
+    return true;
+  }
+
+  bool GetLengthPrefixed(std::string* value) {
+    uint32_t size = 0;
+    if (!GetFixed32(&size) || pos + size > data.size()) {
+      return false;
+    }
+    value->assign(data, pos, size);
+    pos += size;
+    return true;
+  }
+};
+
+} // namespace
+
+Result WriteManifest(const std::string& dir, const ManifestContents& contents) {
+  std::string buffer(kManifestMagic, kManifestMagicSize);
+  PutFixed32(&buffer, kNextFileNumber);
+  PutFixed64(&buffer, contents.next_file_number);
+  for (const ColumnFamilyManifest& cf : contents.column_families) {
+    PutFixed32(&buffer, kColumnFamily);
+    PutFixed32(&buffer, cf.id);
+    PutFixed64(&buffer, cf.log_number);
+    PutLengthPrefixed(&buffer, cf.name);
+    if (!cf.comparator_name.empty()) {
+      PutFixed32(&buffer, kComparator);
+      PutLengthPrefixed(&buffer, cf.comparator_name);
+    }
+    for (size_t level = 0; level < cf.levels.size(); ++level) {
+      for (const FileMetaData& f : cf.levels[level]) {
+        PutFixed32(&buffer, kFile);
+        PutFixed32(&buffer, static_cast<uint32_t>(level));
+        PutFixed64(&buffer, f.number);
+        PutFixed64(&buffer, f.file_size);
+        PutLengthPrefixed(&buffer, std::filesystem::path(f.path).filename().string());
+        if (f.has_key_range) {
+          PutFixed32(&buffer, kFileKeyRange);
+          PutLengthPrefixed(&buffer, f.smallest_key);
+          PutLengthPrefixed(&buffer, f.largest_key);
+        }
+      }
+    }
+    for (const BlobFileMetaData& b : cf.blob_files) {
+      PutFixed32(&buffer, kBlobFile);
+      PutFixed64(&buffer, b.number);
+      PutFixed64(&buffer, b.total_blob_count);
+      PutFixed64(&buffer, b.total_blob_bytes);
+      PutFixed64(&buffer, b.garbage_blob_count);
+      PutFixed64(&buffer, b.garbage_blob_bytes);
+      PutLengthPrefixed(&buffer, std::filesystem::path(b.path).filename().string());
+    }
+  }
+  PutFixed32(&buffer, kEnd);
+
+  std::filesystem::path manifest_path = std::filesystem::path(dir) / kManifestFileName;
+  std::filesystem::path temp_path = manifest_path;
+  temp_path += ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return Result::IOError("Failed to open manifest for writing: " + temp_path.string());
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.close();
+    if (!out) {
+      return Result::IOError("Failed to write manifest: " + temp_path.string());
+    }
+  }
+  // The new manifest and the directory entries of every file it names (the
+  // callers sync the files themselves) must be durable before it replaces
+  // the old one; the rename itself is durable once the directory is synced
+  // again.
+  Result sync_res = SyncFile(temp_path.string());
+  if (sync_res.ok()) {
+    sync_res = SyncDirectory(dir);
+  }
+  if (!sync_res.ok()) {
+    return sync_res;
+  }
+  std::error_code ec;
+  std::filesystem::rename(temp_path, manifest_path, ec);
+  if (ec) {
+    return Result::IOError("Failed to install manifest " + manifest_path.string() + ": " + ec.message());
+  }
+  return SyncDirectory(dir);
+}
+
+Result ReadManifest(const std::string& dir, ManifestContents* contents) {
+  std::filesystem::path manifest_path = std::filesystem::path(dir) / kManifestFileName;
+  std::ifstream in(manifest_path, std::ios::binary);
+  if (!in.is_open()) {
+    return Result::NotFound("No manifest in " + dir);
+  }
+  std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (data.compare(0, kManifestMagicSize, kManifestMagic) != 0) {
+    return Result::Corruption("Bad manifest magic in " + manifest_path.string());
+  }
+
+  ManifestContents parsed;
+  ColumnFamilyManifest* cf = &parsed.column_families[0];
+  FileMetaData* last_file = nullptr; // Target of a kFileKeyRange record
+  ManifestParser parser{data, kManifestMagicSize};
+  while (true) {
+    uint32_t tag = 0;
+    if (!parser.GetFixed32(&tag)) {
+      return Result::Corruption("Manifest is truncated: " + manifest_path.string());
+    }
+    if (tag == kEnd) {
+      break;
+    }
+    if (tag == kNextFileNumber) {
+      if (!parser.GetFixed64(&parsed.next_file_number)) {
+        return Result::Corruption("Manifest is truncated: " + manifest_path.string());
+      }
+    } else if (tag == kColumnFamily) {
+      uint32_t id = 0;
+      uint64_t log_number = 0;
+      std::string name;
+      if (!parser.GetFixed32(&id) || !parser.GetFixed64(&log_number) || !parser.GetLengthPrefixed(&name)) {
+        return Result::Corruption("Manifest is truncated: " + manifest_path.string());
+      }
+      if (id == kDefaultColumnFamilyId) {
+        cf = &parsed.column_families[0];
+      } else {
+        parsed.column_families.emplace_back();
+        cf = &parsed.column_families.back();
+      }
+      cf->id = id;
+      cf->log_number = log_number;
+      cf->name = std::move(name);
+      last_file = nullptr;
+    } else if (tag == kComparator) {
+      if (!parser.GetLengthPrefixed(&cf->comparator_name)) {
+        return Result::Corruption("Manifest is truncated: " + manifest_path.string());
+      }
+    } else if (tag == kFile) {
+      uint32_t level = 0;
+      FileMetaData f;
+      std::string file_name;
+      if (!parser.GetFixed32(&level) || !parser.GetFixed64(&f.number) ||
+          !parser.GetFixed64(&f.file_size) || !parser.GetLengthPrefixed(&file_name)) {
+        return Result::Corruption("Manifest is truncated: " + manifest_path.string());
+      }
+      if (level >= cf->levels.size()) {
+        return Result::Corruption("Manifest names level " + std::to_string(level) + " which does not exist.");
+      }
+      f.path = (std::filesystem::path(dir) / file_name).string();
+      cf->levels[level].push_back(std::move(f));
+      last_file = &cf->levels[level].back();
+    } else if (tag == kFileKeyRange) {
+      std::string smallest_key;
+      std::string largest_key;
+      if (!parser.GetLengthPrefixed(&smallest_key) || !parser.GetLengthPrefixed(&largest_key)) {
+        return Result::Corruption("Manifest is truncated: " + manifest_path.string());
+      }
+      if (last_file == nullptr) {
+        return Result::Corruption("Manifest key range does not follow a file: " + manifest_path.string());
+      }
+      last_file->has_key_range = true;
+      last_file->smallest_key = std::move(smallest_key);
+      last_file->largest_key = std::move(largest_key);
+      last_file = nullptr;
+    } else if (tag == kBlobFile) {
+      BlobFileMetaData b;
+      std::string file_name;
+      if (!parser.GetFixed64(&b.number) || !parser.GetFixed64(&b.total_blob_count) ||
+          !parser.GetFixed64(&b.total_blob_bytes) || !parser.GetFixed64(&b.garbage_blob_count) ||
+          !parser.GetFixed64(&b.garbage_blob_bytes) || !parser.GetLengthPrefixed(&file_name)) {
+        return Result::Corruption("Manifest is truncated: " + manifest_path.string());
+      }
+      b.path = (std::filesystem::path(dir) / file_name).string();
+      cf->blob_files.push_back(std::move(b));
+      last_file = nullptr;
+    } else {
+      return Result::Corruption("Unknown manifest record tag " + std::to_string(tag));
+    }
+  }
+  *contents = std::move(parsed);
+  return Result::OK();
+}
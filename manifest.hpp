@@ -0,0 +1,49 @@
+#ifndef MANIFEST_HPP
+#define MANIFEST_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "result.hpp"
+#include "version_edit.hpp"
+
+// Name of the file, inside a DB directory, that lists every column family
+// with the live SSTables of each level and its live blob files. A directory
+// is only a usable DB (or checkpoint) once it holds a manifest.
+inline constexpr char kManifestFileName[] = "MANIFEST";
+
+// The persistent state of one column family.
+struct ColumnFamilyManifest {
+  uint32_t id = kDefaultColumnFamilyId;
+  std::string name = kDefaultColumnFamilyName;
+  // Oldest write-ahead log that may hold unflushed writes of this family.
+  uint64_t log_number = 0;
+  // Comparator::Name() of the family's key order. Empty in manifests written
+  // before it was recorded.
+  std::string comparator_name;
+  // kNumLevels entries; levels[0] is newest first.
+  std::vector<std::vector<FileMetaData>> levels = std::vector<std::vector<FileMetaData>>(kNumLevels);
+  // Live blob files, with their garbage accounting.
+  std::vector<BlobFileMetaData> blob_files;
+};
+
+struct ManifestContents {
+  uint64_t next_file_number = 1;
+  // The default column family always comes first.
+  std::vector<ColumnFamilyManifest> column_families = std::vector<ColumnFamilyManifest>(1);
+};
+
+// Replaces the manifest in `dir` with `contents`. The new manifest is written
+// to a temporary file and renamed over the old one, so a crash leaves either
+// the old or the new manifest, never a torn one. The manifest and the
+// directory are synced, so once this returns OK the new manifest survives a
+// power loss; the files it names must already be synced. File paths are
+// stored relative to the directory.
+Result WriteManifest(const std::string& dir, const ManifestContents& contents);
+
+// Loads the manifest in `dir`, resolving file paths against `dir`. Returns
+// NotFound if the directory has no manifest.
+Result ReadManifest(const std::string& dir, ManifestContents* contents);
+
+#endif // MANIFEST_HPP
@@ -0,0 +1,113 @@
+#include "map_table.hpp"
+#include <cstring>
+
+
+MapTable::MapTable(Arena& arena, const Comparator* comparator)
+	: arena_(arena), map_(KeyComparator(comparator)) {
+}
+
+MapTable::~MapTable() {
+	// Keys and values are in arena_, managed externally; the map frees its nodes.
+}
+
+Result MapTable::Insert(const Slice& key, const ValueEntry& entry) {
+	auto it = map_.lower_bound(key);
+	if (it != map_.end() && map_.key_comp().Compare(it->first, key) == 0) {
+		it->second = entry;
+		return Result::OK();
+	}
+	void* key_mem = arena_.Allocate(key.size(), alignof(std::byte));
+	if (key_mem == nullptr) {
+		return Result::ArenaAllocationFail("Failed to allocate for key in map table.");
+	}
+	std::memcpy(key_mem, key.data(), key.size());
+	map_.emplace_hint(it, Slice(static_cast<const std::byte*>(key_mem), key.size()), entry);
+	return Result::OK();
+}
+
+Result MapTable::Put(const Slice& key_input, const Slice& value_input) {
+	if (key_input.empty()) {
+		return Result::InvalidArgument("Key cannot be empty for Put.");
+	}
+
+	std::byte* value_arena_ptr = nullptr;
+	if (value_input.size() > 0) {
+		void* value_mem_raw = arena_.Allocate(value_input.size(), alignof(std::byte));
+		if (!value_mem_raw) {
+			return Result::ArenaAllocationFail("Failed to allocate for value in Put.");
+		}
+		value_arena_ptr = static_cast<std::byte*>(value_mem_raw);
+		std::memcpy(value_arena_ptr, value_input.data(), value_input.size());
+	}
+	Slice arena_value_slice(value_arena_ptr, value_input.size());
+
+	return Insert(key_input, ValueEntry(arena_value_slice, ValueTag::kData));
+}
+
+Result MapTable::Get(const Slice& key, Slice* value_out) const {
+	auto it = map_.find(key);
+	if (it == map_.end()) {
+		return Result::NotFound();
+	}
+	if (it->second.IsTombstone()) {
+		return Result::FoundTombstone();
+	}
+	*value_out = it->second.value_slice;
+	return Result::OK();
+}
+
+Result MapTable::Delete(const Slice& key_input) {
+	if (key_input.empty()) {
+		return Result::InvalidArgument("Key cannot be empty for Delete.");
+	}
+	// The key stays, marked by a tombstone, so the delete reaches SSTables.
+	return Insert(key_input, ValueEntry(ValueTag::kTombstone));
+}
+
+SortedTableIterator* MapTable::NewIterator() const {
+	return new MapTableIterator(this); // Caller owns this for now
+}
+
+size_t MapTable::ApproximateMemoryUsage() const {
+	// Per entry, a red-black tree node: three pointers and a colour word
+	// around the key Slice and ValueEntry.
+	return arena_.GetTotalBytesUsed() + map_.size() * (4 * sizeof(void*) + sizeof(Map::value_type)) +
+	       sizeof(*this);
+}
+
+MapTableIterator::MapTableIterator(const MapTable* table)
+	: map_(&table->map_), it_(map_->end()) {}
+
+bool MapTableIterator::Valid() const {
+	return it_ != map_->end();
+}
+
+void MapTableIterator::SeekToFirst() {
+	it_ = map_->begin();
+}
+
+void MapTableIterator::Seek(const Slice& target) {
+	it_ = map_->lower_bound(target);
+}
+
+void MapTableIterator::Next() {
+	if (Valid()) {
+		++it_;
+	}
+}
+
+Slice MapTableIterator::key() const {
+	if (!Valid()) return Slice();
+	return it_->first;
+}
+
+ValueEntry MapTableIterator::value() const {
+	if (!Valid()) {
+		return ValueEntry(ValueTag::kTombstone);
+	}
+	return it_->second;
+}
+
+Result MapTableIterator::status() const {
+	return Result::OK();
+}
@@ -0,0 +1,68 @@
+#ifndef MAP_TABLE_HPP
+#define MAP_TABLE_HPP
+
+#include <map>
+
+#include "sorted_table.hpp"
+#include "arena.hpp"
+#include "comparator.hpp"
+#include "result.hpp"
+#include "value.hpp"
+
+
+class MapTableIterator; // Forward declaration
+
+// Memtable table backed by a std::map from arena-copied keys to their
+// latest value. A key is copied once, on its first write; later writes of
+// it copy only the value. Any comparator.
+//
+// Writes must not overlap reads or iterators; the DB serialises them.
+// Iterators stay valid across later writes, which they may or may not see.
+class MapTable : public SortedTable {
+ public:
+  explicit MapTable(Arena& arena, const Comparator* comparator = BytewiseComparator());
+  ~MapTable() override;
+
+  MapTable(const MapTable&) = delete;
+  MapTable& operator=(const MapTable&) = delete;
+
+  // --- SortedTable Interface Implementation ---
+  Result Put(const Slice& key, const Slice& value) override;
+  Result Get(const Slice& key, Slice* value_out) const override;
+  Result Delete(const Slice& key) override;
+  SortedTableIterator* NewIterator() const override;
+  size_t ApproximateMemoryUsage() const override;
+
+ private:
+  friend class MapTableIterator;
+
+  using Map = std::map<Slice, ValueEntry, KeyComparator>;
+
+  Result Insert(const Slice& key, const ValueEntry& entry);
+
+  Arena& arena_; // Holds keys and values
+  Map map_;
+};
+
+
+class MapTableIterator : public SortedTableIterator {
+ public:
+  explicit MapTableIterator(const MapTable* table);
+  ~MapTableIterator() override = default;
+
+  bool Valid() const override;
+  void SeekToFirst() override;
+  void Seek(const Slice& target) override;
+  void Next() override;
+
+  Slice key() const override;
+  ValueEntry value() const override;
+  Result status() const override;
+
+ private:
+  const MapTable::Map* map_;
+  MapTable::Map::const_iterator it_;
+};
+
+
+#endif // MAP_TABLE_HPP
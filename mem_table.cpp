@@ -4,32 +4,58 @@
 #include "sorted_table.hpp"
 #include <iostream>
 
-MemTable::MemTable(Arena& arena) : arena_ref_(arena) {
+namespace {
+
+Slice StringAsSlice(const std::string& s) {
+  return Slice(reinterpret_cast<const std::byte*>(s.data()), s.size());
+}
+
+} // namespace
+
+MemTable::MemTable(Arena& arena, const Comparator* comparator, const MemTableFactory* factory,
+                   size_t bloom_filter_bytes, bool inplace_update)
+    : arena_ref_(arena), comparator_(comparator), bloom_(arena, bloom_filter_bytes) {
   std::cout << "[MemTable Constructor] Called. Arena ref: " << &arena_ref_ << std::endl; // DEBUG
-  table_ = std::make_unique<SkipList>(arena_ref_);
+  if (factory == nullptr) {
+    factory = MapMemTableFactory();
+  }
+  table_ = factory->Create(arena_ref_, comparator, inplace_update);
   if (!table_) {
-        std::cout << "[MemTable Constructor] FAILED to create SkipList (table_)." << std::endl; // DEBUG
-        // This would be a problem, but std::make_unique throws on failure, make_unique_nothrow would return nullptr
-        // If using make_unique_nothrow, you'd need to handle the nullptr case.
-        // For std::make_unique, if this fails, an exception is thrown.
+        std::cout << "[MemTable Constructor] FAILED to create " << factory->Name() << " (table_)." << std::endl; // DEBUG
+        // Callers check the factory supports the comparator first (see
+        // DB::NewColumnFamilyData), so this means out of memory.
     } else {
-        std::cout << "[MemTable Constructor] SkipList (table_) created. Ptr: " << table_.get() << std::endl; // DEBUG
+        std::cout << "[MemTable Constructor] " << factory->Name() << " (table_) created. Ptr: " << table_.get() << std::endl; // DEBUG
     }
 }
 
 MemTable::~MemTable() {};
 
 Result MemTable::Put(const Slice& key, const Slice& value) {
+  // Set the key's bits before the entry is visible, so a reader that can
+  // find the entry never has the filter rule it out.
+  bloom_.Add(key);
   Result result = table_->Put(key, value);
+  if (result.ok()) {
+    RecordKey(key);
+  }
   return result;
 }
 
-Result MemTable::Get(const Slice& key) const {
-  return table_->Get(key);
+Result MemTable::Get(const Slice& key, Slice* value_out) const {
+  if (!bloom_.MayContain(key)) {
+    return Result::NotFound();
+  }
+  return table_->Get(key, value_out);
 }
 
 Result MemTable::Delete(const Slice& key) {
-  return table_->Delete(key);
+  bloom_.Add(key);
+  Result result = table_->Delete(key);
+  if (result.ok()) {
+    RecordKey(key);
+  }
+  return result;
 }
 
 SortedTableIterator* MemTable::NewIterator() const {
@@ -40,3 +66,25 @@ size_t MemTable::ApproximateMemoryUsage() const {
   return table_->ApproximateMemoryUsage();
 }
 
+bool MemTable::MayOverlapRange(const Slice& smallest, const Slice& largest) const {
+  if (num_entries_ == 0) {
+    return false;
+  }
+  return comparator_.Compare(StringAsSlice(largest_key_), smallest) >= 0 &&
+         comparator_.Compare(largest, StringAsSlice(smallest_key_)) >= 0;
+}
+
+void MemTable::RecordKey(const Slice& key) {
+  // Most writes fall inside the range, which then costs two comparisons.
+  if (num_entries_++ == 0) {
+    smallest_key_.assign(reinterpret_cast<const char*>(key.data()), key.size());
+    largest_key_ = smallest_key_;
+    return;
+  }
+  if (comparator_.Compare(key, StringAsSlice(smallest_key_)) < 0) {
+    smallest_key_.assign(reinterpret_cast<const char*>(key.data()), key.size());
+  } else if (comparator_.Compare(key, StringAsSlice(largest_key_)) > 0) {
+    largest_key_.assign(reinterpret_cast<const char*>(key.data()), key.size());
+  }
+}
+
@@ -8,23 +8,54 @@
 #include "arena.hpp"
 #include "sorted_table.hpp"
 #include "result.hpp"
+#include "comparator.hpp"
+#include "mem_table_factory.hpp"
+#include "mem_table_bloom.hpp"
+#include <cstdint>
 #include <memory>
+#include <string>
 
 struct MemTable {
  public:
-  MemTable(Arena& arena);
+  // The table itself comes from `factory`, which must support `comparator`.
+  // With bloom_filter_bytes > 0, a Bloom filter of about that size is kept
+  // in `arena` over every key written, and Get skips the table for keys it
+  // rules out. The filter compares keys by their bytes. `inplace_update`
+  // is passed on to the factory.
+  MemTable(Arena& arena, const Comparator* comparator = BytewiseComparator(),
+           const MemTableFactory* factory = MapMemTableFactory(), size_t bloom_filter_bytes = 0,
+           bool inplace_update = false);
   ~MemTable();
 
   Result Put(const Slice& key, const Slice& value);
-  Result Get(const Slice& key) const;
+  // See SortedTable::Get.
+  Result Get(const Slice& key, Slice* value_out) const;
   Result Delete(const Slice& key);
   SortedTableIterator* NewIterator() const;
 
   size_t ApproximateMemoryUsage() const;
-  
+
+  // Writes (puts and deletes) applied so far. Kept as they happen, so
+  // neither call builds an iterator.
+  uint64_t NumEntries() const { return num_entries_; }
+  bool IsEmpty() const { return num_entries_ == 0; }
+
+  // Whether a key written so far may lie in [smallest, largest]. Answered
+  // from the smallest and largest keys ever written, so it may report an
+  // overlap across a gap between them.
+  bool MayOverlapRange(const Slice& smallest, const Slice& largest) const;
+
  private:
+  // Widens [smallest_key_, largest_key_] to cover `key`.
+  void RecordKey(const Slice& key);
+
   Arena& arena_ref_;
+  KeyComparator comparator_;
+  MemTableBloom bloom_;
   std::unique_ptr<SortedTable> table_;
+  uint64_t num_entries_ = 0;
+  std::string smallest_key_;
+  std::string largest_key_;
 };
 
 #endif // MEM_TABLE_HPP
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "mem_table_bloom.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace {
+
+// MurmurHash64A. Keys are hashed once per Put and once per Get.
+uint64_t HashKey(const Slice& key) {
+	constexpr uint64_t m = 0xc6a4a7935bd1e995ULL;
+	constexpr int r = 47;
+	const auto* data = reinterpret_cast<const unsigned char*>(key.data());
+	size_t len = key.size();
+	uint64_t h = 0x8445d61a4e774912ULL ^ (len * m);
+
+	for (; len >= 8; data += 8, len -= 8) {
+		uint64_t k;
+		std::memcpy(&k, data, sizeof(k));
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		h ^= k;
+		h *= m;
+	}
+	if (len > 0) {
+		uint64_t tail = 0;
+		std::memcpy(&tail, data, len);
+		h ^= tail;
+		h *= m;
+	}
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+	return h;
+}
+
+} // namespace
+
+MemTableBloom::MemTableBloom(Arena& arena, size_t bytes, int num_probes)
+	: words_(nullptr), num_blocks_(0), num_probes_(std::clamp(num_probes, 1, 16)) {
+	constexpr size_t kBlockBytes = kWordsPerBlock * sizeof(uint64_t);
+	size_t blocks = std::min<size_t>((bytes + kBlockBytes - 1) / kBlockBytes, UINT32_MAX);
+	if (blocks == 0) {
+		return;
+	}
+	void* mem = arena.Allocate(blocks * kBlockBytes, kBlockBytes);
+	if (mem == nullptr) {
+		return;
+	}
+	auto* words = static_cast<std::atomic<uint64_t>*>(mem);
+	for (size_t i = 0; i < blocks * kWordsPerBlock; ++i) {
+		new (&words[i]) std::atomic<uint64_t>(0);
+	}
+	words_ = words;
+	num_blocks_ = static_cast<uint32_t>(blocks);
+}
+
+// The upper 32 bits of the hash pick the block, the lower 32 the bits in it:
+// each probe takes 9 bits of a rotating value, as in double hashing.
+void MemTableBloom::Add(const Slice& key) {
+	if (!enabled()) {
+		return;
+	}
+	uint64_t h = HashKey(key);
+	std::atomic<uint64_t>* block =
+		words_ + static_cast<size_t>(((h >> 32) * num_blocks_) >> 32) * kWordsPerBlock;
+	auto bits = static_cast<uint32_t>(h);
+	const uint32_t delta = (bits >> 17) | (bits << 15);
+	for (int i = 0; i < num_probes_; ++i) {
+		uint32_t bit = bits & 511;
+		block[bit >> 6].fetch_or(uint64_t{1} << (bit & 63), std::memory_order_relaxed);
+		bits += delta;
+	}
+}
+
+bool MemTableBloom::MayContain(const Slice& key) const {
+	if (!enabled()) {
+		return true;
+	}
+	uint64_t h = HashKey(key);
+	const std::atomic<uint64_t>* block =
+		words_ + static_cast<size_t>(((h >> 32) * num_blocks_) >> 32) * kWordsPerBlock;
+	auto bits = static_cast<uint32_t>(h);
+	const uint32_t delta = (bits >> 17) | (bits << 15);
+	for (int i = 0; i < num_probes_; ++i) {
+		uint32_t bit = bits & 511;
+		if ((block[bit >> 6].load(std::memory_order_relaxed) & (uint64_t{1} << (bit & 63))) == 0) {
+			return false;
+		}
+		bits += delta;
+	}
+	return true;
+}
@@ -0,0 +1,45 @@
+#ifndef MEM_TABLE_BLOOM_HPP
+#define MEM_TABLE_BLOOM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "arena.hpp"
+#include "slice.hpp"
+
+// Whole-key Bloom filter grown alongside a memtable, so a Get for a key the
+// memtable never saw skips the table search. The bits are a fixed array in
+// the memtable's arena, split into 64-byte blocks: every probe of a key
+// lands in the same block, so a check touches one cache line.
+//
+// Add is for the single writer; MayContain may run concurrently with it.
+// Bits are only ever set, with atomic ORs, so a reader never sees a key's
+// bits cleared once it has seen them set.
+class MemTableBloom {
+ public:
+  // A filter of about `bytes` bytes, `num_probes` bits per key. With bytes
+  // of 0, or if the arena cannot provide them, the filter is disabled and
+  // MayContain always returns true.
+  MemTableBloom(Arena& arena, size_t bytes, int num_probes = kDefaultNumProbes);
+
+  MemTableBloom(const MemTableBloom&) = delete;
+  MemTableBloom& operator=(const MemTableBloom&) = delete;
+
+  bool enabled() const { return words_ != nullptr; }
+
+  void Add(const Slice& key);
+  // False only if `key` was never added.
+  bool MayContain(const Slice& key) const;
+
+  static constexpr int kDefaultNumProbes = 6;
+
+ private:
+  static constexpr size_t kWordsPerBlock = 8; // 64 bytes
+
+  std::atomic<uint64_t>* words_;
+  uint32_t num_blocks_;
+  int num_probes_;
+};
+
+#endif // MEM_TABLE_BLOOM_HPP
@@ -0,0 +1,87 @@
+#include "mem_table_factory.hpp"
+#include "adaptive_radix_tree.hpp"
+#include "map_table.hpp"
+#include "skip_list.hpp"
+#include "vector_table.hpp"
+#include <new>
+
+namespace {
+
+class MapFactory : public MemTableFactory {
+ public:
+  std::unique_ptr<SortedTable> Create(Arena& arena, const Comparator* comparator,
+                                      bool inplace_update) const override {
+    if (inplace_update) {
+      return nullptr;
+    }
+    return std::unique_ptr<SortedTable>(new (std::nothrow) MapTable(arena, comparator));
+  }
+
+  const char* Name() const override { return "lsm.MapMemTable"; }
+};
+
+class SkipListFactory : public MemTableFactory {
+ public:
+  std::unique_ptr<SortedTable> Create(Arena& arena, const Comparator* comparator,
+                                      bool inplace_update) const override {
+    return std::unique_ptr<SortedTable>(new (std::nothrow) SkipList(
+        arena, SkipList::kDefaultMaxHeight, SkipList::kDefaultProbability, comparator, inplace_update));
+  }
+
+  bool SupportsInplaceUpdate() const override { return true; }
+
+  const char* Name() const override { return "lsm.SkipListMemTable"; }
+};
+
+class AdaptiveRadixTreeFactory : public MemTableFactory {
+ public:
+  std::unique_ptr<SortedTable> Create(Arena& arena, const Comparator* comparator,
+                                      bool inplace_update) const override {
+    if (!SupportsComparator(comparator) || inplace_update) {
+      return nullptr;
+    }
+    return std::unique_ptr<SortedTable>(new (std::nothrow) AdaptiveRadixTree(arena));
+  }
+
+  // The tree orders keys by their bytes and nothing else.
+  bool SupportsComparator(const Comparator* comparator) const override {
+    return comparator == nullptr || comparator == BytewiseComparator();
+  }
+
+  const char* Name() const override { return "lsm.AdaptiveRadixTreeMemTable"; }
+};
+
+class VectorFactory : public MemTableFactory {
+ public:
+  std::unique_ptr<SortedTable> Create(Arena& arena, const Comparator* comparator,
+                                      bool inplace_update) const override {
+    if (inplace_update) {
+      return nullptr;
+    }
+    return std::unique_ptr<SortedTable>(new (std::nothrow) VectorTable(arena, comparator));
+  }
+
+  const char* Name() const override { return "lsm.VectorMemTable"; }
+};
+
+} // namespace
+
+const MemTableFactory* MapMemTableFactory() {
+  static const MapFactory factory;
+  return &factory;
+}
+
+const MemTableFactory* SkipListMemTableFactory() {
+  static const SkipListFactory factory;
+  return &factory;
+}
+
+const MemTableFactory* AdaptiveRadixTreeMemTableFactory() {
+  static const AdaptiveRadixTreeFactory factory;
+  return &factory;
+}
+
+const MemTableFactory* VectorMemTableFactory() {
+  static const VectorFactory factory;
+  return &factory;
+}
@@ -0,0 +1,53 @@
+#ifndef MEM_TABLE_FACTORY_HPP
+#define MEM_TABLE_FACTORY_HPP
+
+#include <memory>
+
+#include "arena.hpp"
+#include "comparator.hpp"
+#include "sorted_table.hpp"
+
+// Builds the SortedTable behind each memtable of a column family. Chosen per
+// column family through DBOptions::memtable_factory; factories are stateless
+// and must outlive the DB.
+class MemTableFactory {
+ public:
+  virtual ~MemTableFactory() = default;
+
+  // A new, empty table keeping its data in `arena`, ordered by `comparator`.
+  // With `inplace_update`, overwrites reuse a key's value slot where they
+  // fit (see DBOptions::inplace_update_support). Returns nullptr if it
+  // cannot be allocated or does not support the request.
+  virtual std::unique_ptr<SortedTable> Create(Arena& arena, const Comparator* comparator,
+                                              bool inplace_update) const = 0;
+
+  // Whether Create can order keys by `comparator`.
+  virtual bool SupportsComparator(const Comparator* comparator) const {
+    (void)comparator;
+    return true;
+  }
+
+  // Whether Create honours inplace_update.
+  virtual bool SupportsInplaceUpdate() const { return false; }
+
+  virtual const char* Name() const = 0;
+};
+
+// MapTable: a std::map, any comparator. The default: the DB never reads a
+// memtable while writing it, and the map's lookups are still faster than
+// the skip list's.
+const MemTableFactory* MapMemTableFactory();
+
+// SkipList: any comparator, reads run concurrently with the writer, and
+// in-place updates.
+const MemTableFactory* SkipListMemTableFactory();
+
+// AdaptiveRadixTree: faster point lookups on large memtables, bytewise
+// comparator only, and reads must not overlap writes.
+const MemTableFactory* AdaptiveRadixTreeMemTableFactory();
+
+// VectorTable: unsorted appends, sorted when flushed; for bulk loads that
+// do not read until then. Any comparator; Get scans every entry.
+const MemTableFactory* VectorMemTableFactory();
+
+#endif // MEM_TABLE_FACTORY_HPP
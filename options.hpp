@@ -0,0 +1,128 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "comparator.hpp"
+#include "mem_table_factory.hpp"
+#include "rate_limiter.hpp"
+#include "thread_pool.hpp"
+
+// Tunables for a DB instance. The memtable flush threshold is still passed to
+// the DB constructor directly; everything added since lives here.
+//
+// Column families take their own DBOptions for key order, memtable, compaction,
+// write stall threshold and blob settings. The write-ahead log, delayed write
+// rate, I/O and thread pool settings are DB-wide and always come from the
+// options the DB was constructed with.
+struct DBOptions {
+  // --- Keys ---
+
+  // Orders the keys of the column family. It must outlive the DB, and a
+  // family must always be reopened with a comparator of the same Name().
+  const Comparator* comparator = BytewiseComparator();
+
+  // --- Memtable ---
+
+  // Builds the table behind the family's memtables. The default std::map
+  // takes any comparator. SkipListMemTableFactory() adds in-place updates,
+  // AdaptiveRadixTreeMemTableFactory() suits point-lookup-heavy families
+  // with the bytewise comparator, and VectorMemTableFactory() bulk loads
+  // that do not read before the flush. Opening a family with a factory that
+  // does not support its comparator fails.
+  const MemTableFactory* memtable_factory = MapMemTableFactory();
+
+  // Size of a whole-key Bloom filter kept in each memtable, as a fraction of
+  // the family's flush threshold; 0.02 gives roughly 10 bits per key for
+  // 64-byte entries. Point lookups for keys a memtable does not hold then
+  // skip its table search. The filter lives in the memtable's arena and
+  // counts toward the threshold. 0 disables it; values above 0.25 are
+  // treated as 0.25. Keys that compare equal must have the same bytes.
+  double memtable_bloom_size_ratio = 0;
+
+  // Overwrite values in place: a Put of a key already in the memtable whose
+  // new value is no longer than the stored one reuses its slot instead of
+  // appending a new version, so memtables of frequently rewritten counters
+  // and flags grow with the number of distinct keys, not writes. Needs a
+  // factory that supports it, such as SkipListMemTableFactory().
+  bool inplace_update_support = false;
+
+  // --- Compaction ---
+
+  // A flush that leaves at least this many files in L0 triggers an L0->L1 compaction.
+  int level0_file_num_compaction_trigger = 4;
+
+  // When true, compactions only run through DB::CompactLevel0().
+  bool disable_auto_compactions = false;
+
+  // Upper bound on the number of key ranges (and threads) a single compaction
+  // is split into. 1 disables subcompactions.
+  int max_subcompactions = 4;
+
+  // A compaction output file is closed and a new one started once it reaches
+  // roughly this many bytes on disk.
+  size_t target_file_size = 2 * 1024 * 1024;
+
+  // --- Write stalls ---
+  // Each signal has a slowdown threshold, above which writes are paced at a
+  // reduced rate, and a stop threshold, above which writes wait until the
+  // backlog is worked off. A threshold of 0 disables it.
+
+  int level0_slowdown_writes_trigger = 20;
+  int level0_stop_writes_trigger = 36;
+
+  uint64_t soft_pending_compaction_bytes_limit = 64ull * 1024 * 1024 * 1024;
+  uint64_t hard_pending_compaction_bytes_limit = 256ull * 1024 * 1024 * 1024;
+
+  // Write rate (bytes/s) allowed when a slowdown threshold is first crossed.
+  uint64_t delayed_write_rate = 16 * 1024 * 1024;
+
+  // --- Blob files ---
+  // Values of at least min_blob_size bytes are written to separate blob files
+  // at flush and compaction time; the SSTable keeps only a small BlobIndex,
+  // so compactions stop rewriting the large values themselves.
+
+  bool enable_blob_files = false;
+  size_t min_blob_size = 4096;
+  uint64_t blob_file_size = 256 * 1024 * 1024;
+
+  // Compactions move still-referenced blobs out of the oldest
+  // blob_garbage_collection_age_cutoff fraction of blob files, so those files
+  // eventually hold only garbage and are deleted.
+  bool enable_blob_garbage_collection = true;
+  double blob_garbage_collection_age_cutoff = 0.25;
+
+  // --- Write-ahead log and memory ---
+
+  // Every DB::Write is appended to a write-ahead log shared by all column
+  // families before it reaches a memtable, and unflushed writes are replayed
+  // by Init. With disable_wal, writes in memtables are lost on close.
+  bool disable_wal = false;
+
+  // fsync the log after every DB::Write. A WriteBatch costs one fsync no
+  // matter how many operations or column families it covers.
+  bool sync_wal = false;
+
+  // Budget for the memtables of all column families together. Once it is
+  // exceeded, the largest memtable is flushed. 0 leaves only the per-family
+  // thresholds.
+  size_t db_write_buffer_size = 0;
+
+  // --- I/O ---
+
+  // Paces flush (IOPriority::kHigh) and compaction (IOPriority::kLow) writes.
+  // May be shared by several DBs on the same device. nullptr disables pacing.
+  std::shared_ptr<RateLimiter> rate_limiter;
+
+  // --- Background threads ---
+
+  // Runs memtable flushes (ThreadPriority::kHigh) and subcompactions
+  // (ThreadPriority::kLow). Share one pool between DBs to bound the number of
+  // background threads per process. nullptr gives the DB a pool of its own
+  // with one flush thread and max_subcompactions - 1 compaction threads.
+  std::shared_ptr<ThreadPool> thread_pool;
+};
+
+#endif // OPTIONS_HPP
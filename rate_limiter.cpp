@@ -0,0 +1,124 @@
+#include "rate_limiter.hpp"
+
+#include <algorithm>
+
+RateLimiter::RateLimiter(int64_t bytes_per_second, int64_t refill_period_us,
+                         bool auto_tuned, uint64_t backlog_for_max_rate)
+    : refill_period_(refill_period_us > 0 ? refill_period_us : kDefaultRefillPeriodUs),
+      auto_tuned_(auto_tuned),
+      max_bytes_per_second_(std::max<int64_t>(bytes_per_second, 1)),
+      backlog_for_max_rate_(backlog_for_max_rate > 0 ? backlog_for_max_rate : kDefaultBacklogForMaxRate),
+      bytes_per_second_(auto_tuned ? std::max<int64_t>(max_bytes_per_second_ / kAutoTuneRangeFactor, 1)
+                                   : max_bytes_per_second_),
+      available_bytes_(0),
+      next_refill_time_(Clock::now()) {}
+
+int64_t RateLimiter::RefillBytesPerPeriodLocked() const {
+  int64_t bytes = bytes_per_second_ * refill_period_.count() / 1000000;
+  return std::max<int64_t>(bytes, 1);
+}
+
+void RateLimiter::SetBytesPerSecond(int64_t bytes_per_second) {
+  std::lock_guard<std::mutex> lock(mu_);
+  bytes_per_second_ = std::max<int64_t>(bytes_per_second, 1);
+}
+
+int64_t RateLimiter::GetBytesPerSecond() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return bytes_per_second_;
+}
+
+void RateLimiter::TuneForBacklog(uint64_t pending_compaction_bytes) {
+  if (!auto_tuned_) {
+    return;
+  }
+  int64_t min_rate = std::max<int64_t>(max_bytes_per_second_ / kAutoTuneRangeFactor, 1);
+  double fill = std::min(1.0, static_cast<double>(pending_compaction_bytes) /
+                                  static_cast<double>(backlog_for_max_rate_));
+  int64_t rate = min_rate + static_cast<int64_t>(static_cast<double>(max_bytes_per_second_ - min_rate) * fill);
+  SetBytesPerSecond(rate);
+}
+
+int64_t RateLimiter::GetTotalBytesThrough(IOPriority priority) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return total_bytes_through_[static_cast<size_t>(priority)];
+}
+
+int64_t RateLimiter::GetTotalRequests(IOPriority priority) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return total_requests_[static_cast<size_t>(priority)];
+}
+
+void RateLimiter::Request(int64_t bytes, IOPriority priority) {
+  if (bytes <= 0) {
+    return;
+  }
+  if (priority == IOPriority::kUser) {
+    std::lock_guard<std::mutex> lock(mu_);
+    total_bytes_through_[static_cast<size_t>(priority)] += bytes;
+    total_requests_[static_cast<size_t>(priority)]++;
+    return;
+  }
+  while (bytes > 0) {
+    int64_t chunk;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      chunk = std::min(bytes, RefillBytesPerPeriodLocked());
+    }
+    RequestChunk(chunk, priority);
+    bytes -= chunk;
+  }
+}
+
+void RateLimiter::RequestChunk(int64_t bytes, IOPriority priority) {
+  std::unique_lock<std::mutex> lock(mu_);
+  size_t pri = static_cast<size_t>(priority);
+  total_bytes_through_[pri] += bytes;
+  total_requests_[pri]++;
+
+  Req req{bytes};
+  queues_[pri].push_back(&req);
+  while (true) {
+    RefillIfDue(Clock::now());
+    if (GrantQueuedRequests()) {
+      cv_.notify_all();
+    }
+    if (req.granted) {
+      return;
+    }
+    cv_.wait_until(lock, next_refill_time_);
+  }
+}
+
+void RateLimiter::RefillIfDue(Clock::time_point now) {
+  if (now < next_refill_time_) {
+    return;
+  }
+  // Unused budget does not accumulate beyond one period, so an idle limiter
+  // cannot release a large burst later.
+  int64_t refill = RefillBytesPerPeriodLocked();
+  available_bytes_ = std::min(available_bytes_ + refill, refill);
+  next_refill_time_ = now + refill_period_;
+}
+
+bool RateLimiter::GrantQueuedRequests() {
+  bool granted_any = false;
+  int64_t full_bucket = RefillBytesPerPeriodLocked();
+  for (std::deque<Req*>& queue : queues_) {
+    // A chunk sized before the rate was lowered may exceed a whole period's
+    // budget; it is let through once the bucket is full rather than never.
+    while (!queue.empty() &&
+           (queue.front()->bytes <= available_bytes_ || available_bytes_ >= full_bucket)) {
+      available_bytes_ = std::max<int64_t>(available_bytes_ - queue.front()->bytes, 0);
+      queue.front()->granted = true;
+      queue.pop_front();
+      granted_any = true;
+    }
+    if (!queue.empty()) {
+      // A higher-priority request is still waiting; lower priorities must not
+      // take the tokens it is saving up for.
+      break;
+    }
+  }
+  return granted_any;
+}
@@ -0,0 +1,88 @@
+#ifndef RATE_LIMITER_HPP
+#define RATE_LIMITER_HPP
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+// Who is asking for I/O budget. Flushes outrank compactions so a slow compaction
+// cannot hold back memtable flushes; user reads are never throttled.
+enum class IOPriority : int {
+  kHigh = 0, // Memtable flush
+  kLow = 1,  // Compaction
+  kUser = 2, // Foreground reads; passes through without waiting
+};
+
+// Token bucket shared by every background writer of one or more DBs.
+// Tokens (bytes) are refilled once per refill period; waiting requests are
+// granted in priority order, FIFO within a priority.
+class RateLimiter {
+ public:
+  static constexpr int64_t kDefaultRefillPeriodUs = 100 * 1000;
+  static constexpr uint64_t kDefaultBacklogForMaxRate = 64ull * 1024 * 1024;
+
+  // In auto-tuned mode `bytes_per_second` is the ceiling; the effective rate moves
+  // between bytes_per_second / kAutoTuneRangeFactor and bytes_per_second as the
+  // compaction backlog reported through TuneForBacklog() grows.
+  explicit RateLimiter(int64_t bytes_per_second,
+                       int64_t refill_period_us = kDefaultRefillPeriodUs,
+                       bool auto_tuned = false,
+                       uint64_t backlog_for_max_rate = kDefaultBacklogForMaxRate);
+  ~RateLimiter() = default;
+
+  RateLimiter(const RateLimiter&) = delete;
+  RateLimiter& operator=(const RateLimiter&) = delete;
+
+  // Blocks until `bytes` may be written. Requests larger than one refill period's
+  // budget are granted in several chunks.
+  void Request(int64_t bytes, IOPriority priority);
+
+  void SetBytesPerSecond(int64_t bytes_per_second);
+  int64_t GetBytesPerSecond() const;
+  bool IsAutoTuned() const { return auto_tuned_; }
+
+  // Adjusts the rate from the estimated number of bytes still waiting to be
+  // compacted. No-op unless the limiter was created in auto-tuned mode.
+  void TuneForBacklog(uint64_t pending_compaction_bytes);
+
+  int64_t GetTotalBytesThrough(IOPriority priority) const;
+  int64_t GetTotalRequests(IOPriority priority) const;
+
+ private:
+  static constexpr int64_t kAutoTuneRangeFactor = 20;
+  static constexpr size_t kNumQueuedPriorities = 2; // kHigh, kLow
+
+  struct Req {
+    int64_t bytes;
+    bool granted = false;
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  void RequestChunk(int64_t bytes, IOPriority priority);
+  // Both expect mu_ to be held.
+  void RefillIfDue(Clock::time_point now);
+  bool GrantQueuedRequests();
+  int64_t RefillBytesPerPeriodLocked() const;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+
+  const std::chrono::microseconds refill_period_;
+  const bool auto_tuned_;
+  const int64_t max_bytes_per_second_;
+  const uint64_t backlog_for_max_rate_;
+
+  int64_t bytes_per_second_;
+  int64_t available_bytes_;
+  Clock::time_point next_refill_time_;
+  std::array<std::deque<Req*>, kNumQueuedPriorities> queues_;
+
+  std::array<int64_t, 3> total_bytes_through_{};
+  std::array<int64_t, 3> total_requests_{};
+};
+
+#endif // RATE_LIMITER_HPP
@@ -2,18 +2,14 @@
 #include <string>     // For std::to_string
 
 
+const std::string& Result::message() const {
+  static const std::string kEmptyMessage;
+  return message_ ? *message_ : kEmptyMessage;
+}
+
 std::string Result::ToString() const {
   if (ok()) {
-    if (value_slice_.has_value()) {
-      // If Slice has a ToString() method for a human-readable representation:
-      return "OK (value: " + value_slice_->ToString() + ")";
-      // If Slice does not have ToString(), or you want something simpler:
-      // return "OK (with value)";
-      // Or even more detailed (if Slice has size()):
-      // return "OK (value slice, size: " + std::to_string(value_slice_->size()) + ")";
-    } else {
-      return "OK";
-    }
+    return "OK";
   }
 
   // Handle error codes
@@ -37,6 +33,15 @@ std::string Result::ToString() const {
     case ResultCode::kIOError:
       type_str = "IOError";
       break;
+    case ResultCode::kError:
+      type_str = "Error";
+      break;
+    case ResultCode::kFoundTombstone:
+      type_str = "FoundTombstone";
+      break;
+    case ResultCode::kSSTableMiss:
+      type_str = "SSTableMiss";
+      break;
     default:
       // This case should ideally not be reached if all codes are handled,
       // but good for robustness.
@@ -44,9 +49,9 @@ std::string Result::ToString() const {
       break;
   }
 
-  if (message_.empty()) {
+  if (!message_) {
     return type_str;
   } else {
-    return type_str + ": " + message_;
+    return type_str + ": " + *message_;
   }
 }
@@ -1,16 +1,13 @@
 #ifndef RESULT_HPP
 #define RESULT_HPP
 
+#include <memory>
 #include <string>
 #include <utility>
-#include <optional>
-#include "slice.hpp"
-#include "value.hpp"
-#include <iostream>
 
 
 enum struct ResultCode : int {
-  kOk = 0,                   // Operation successful, value_slice may contain data
+  kOk = 0,
   kArenaAllocationFail = 1,
   kNotFound = 2,             // Generic not found, or key not found globally in DB
   kCorruption = 3,
@@ -19,54 +16,42 @@ enum struct ResultCode : int {
   kIOError = 6,
   kError = 7,                // Generic error
 
-  // New codes for SSTableReader::Get specifics
+  // Point lookup outcomes
   kFoundTombstone = 8,       // Key was found, but it's a tombstone
   kSSTableMiss = 9           // Key was not found in the current SSTable (search can continue)
 };
 
+// Outcome of an operation: a code, plus a message for real errors. Values are
+// returned through out-parameters, never inside a Result. OK, NotFound and
+// FoundTombstone are normally created without a message, and then neither
+// creating nor copying a Result allocates, so misses on the read path cost
+// nothing beyond the lookup itself.
 class Result {
  public:
-  // Constructors
-   Result() : code_(ResultCode::kOk), value_tag_(ValueTag::kData), value_slice_(std::nullopt), message_("") {}
+  Result() : code_(ResultCode::kOk) {}
 
-  // OK with a data value (implies ValueTag::kData)
-  explicit Result(const Slice& success_slice)
-      : code_(ResultCode::kOk), value_slice_(success_slice), value_tag_(ValueTag::kData), message_("") {
-        std::cout << "[Result(Slice) Ctor] Called. Slice size: " << success_slice.size() 
-              << ". Set value_tag_ to: " << static_cast<int>(value_tag_.value()) << std::endl;
-      }
+  // The message is only kept (on the heap) when it is not empty.
+  Result(ResultCode code, std::string message)
+      : code_(code),
+        message_(message.empty() ? nullptr : std::make_unique<std::string>(std::move(message))) {}
 
-  // Error constructor
-  Result(ResultCode error_code, std::string error_message)
-      : code_(error_code),
-        message_(std::move(error_message)),
-        value_slice_(std::nullopt), // Errors don't have a value slice
-        value_tag_(ValueTag::kData) { }
-
-  static Result OkTombstone() {
-    Result res; // code_ is kOk by default
-    res.value_tag_ = ValueTag::kTombstone;
-    // value_slice_ remains std::nullopt
-    return res;
-  }
-
-  // Copy constructor
-  Result(const Result& other) = default;
-  // Move constructor
+  Result(const Result& other)
+      : code_(other.code_),
+        message_(other.message_ ? std::make_unique<std::string>(*other.message_) : nullptr) {}
   Result(Result&& other) noexcept = default;
-  // Copy assignment operator
-  Result& operator=(const Result& other) = default;
-  // Move assignment operator
+  Result& operator=(const Result& other) {
+    if (this != &other) {
+      code_ = other.code_;
+      message_ = other.message_ ? std::make_unique<std::string>(*other.message_) : nullptr;
+    }
+    return *this;
+  }
   Result& operator=(Result&& other) noexcept = default;
 
   ~Result() = default;
 
   // Static factory methods
   static Result OK() { return Result(); }
-  static Result OK(const Slice& success_slice) {
-    return Result(success_slice);
-  }
-  // Keep existing error factories
   static Result ArenaAllocationFail(std::string message = "") {
     return Result(ResultCode::kArenaAllocationFail, std::move(message));
   }
@@ -88,8 +73,6 @@ class Result {
   static Result Error(std::string message) { // Generic error factory
     return Result(ResultCode::kError, std::move(message));
   }
-
-  // New static factory methods for SSTable specific outcomes
   static Result FoundTombstone(std::string message = "") {
       return Result(ResultCode::kFoundTombstone, std::move(message));
   }
@@ -99,25 +82,23 @@ class Result {
 
 
   // Accessors
-  bool ok() const { return code_ == ResultCode::kOk; } // Only kOk is considered "ok" for value presence
+  bool ok() const { return code_ == ResultCode::kOk; }
   ResultCode code() const { return code_; }
-  const std::string& message() const { return message_; }
-  const std::optional<Slice>& value_slice() const { return value_slice_; }
-  std::optional<ValueTag> value_tag() const { return value_tag_; }
+  bool IsNotFound() const { return code_ == ResultCode::kNotFound; }
+  bool IsTombstone() const { return code_ == ResultCode::kFoundTombstone; }
+  // Empty unless the Result was created with a message.
+  const std::string& message() const;
 
-  std::string ToString() const; // Implementation assumed to exist elsewhere
+  std::string ToString() const;
 
   bool operator==(const Result& other) const {
-    return code_ == other.code_ && message_ == other.message_ &&
-           value_slice_ == other.value_slice_;
+    return code_ == other.code_ && message() == other.message();
   }
   bool operator!=(const Result& other) const { return !(*this == other); }
 
  private:
   ResultCode code_;
-  std::string message_;
-  std::optional<Slice> value_slice_; // Only valid if code_ == kOk
-  std::optional<ValueTag> value_tag_ = std::nullopt;
+  std::unique_ptr<std::string> message_;
 };
 
-#endif  // RESULT_HPP
\ No newline at end of file
+#endif  // RESULT_HPP
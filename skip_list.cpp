@@ -1,177 +1,340 @@
 #include "skip_list.hpp"
+#include "key_compare.hpp"
 #include "value.hpp"
+#include <algorithm>
 #include <cstddef>
+#include <new>
 
-#include <iostream>
 
+// Header of every node. The tower of `height` next pointers follows it
+// directly, then the `key_size` key bytes.
+struct SkipList::Node {
+	uint64_t key_prefix; // KeyPrefix of the key
+	uint32_t key_size;
+	int32_t height;
+	// Replaced as a whole when the key is written again, unless the write
+	// fits in place.
+	std::atomic<const ValueCell*> value;
 
-// --- SkipList (Map-backed placeholder) ---
+	std::atomic<Node*>* tower() { return reinterpret_cast<std::atomic<Node*>*>(this + 1); }
+	const std::atomic<Node*>* tower() const { return reinterpret_cast<const std::atomic<Node*>*>(this + 1); }
 
-SkipList::SkipList(Arena& arena, int max_height, double probability)
-	: arena_(arena), 
-	  ignored_max_height_(max_height),         // Store but ignore
-	  ignored_probability_(probability),       // Store but ignore
-	  map_nodes_overhead_estimate_(0) {
-	// The head_ node, current_max_level_, random_generator_, etc.
-	// from a real SkipList are not needed for this map-based placeholder.
+	Node* Next(int level) const { return tower()[level].load(std::memory_order_acquire); }
+	void SetNext(int level, Node* next) { tower()[level].store(next, std::memory_order_release); }
+	// Only for the writer, on links no reader can reach yet.
+	Node* NoBarrierNext(int level) const { return tower()[level].load(std::memory_order_relaxed); }
+	void NoBarrierSetNext(int level, Node* next) { tower()[level].store(next, std::memory_order_relaxed); }
+
+	std::byte* key_data() { return reinterpret_cast<std::byte*>(tower() + height); }
+	const std::byte* key_data() const { return reinterpret_cast<const std::byte*>(tower() + height); }
+	Slice key() const { return Slice(key_data(), key_size); }
+};
+
+// A stored value: this header, then `capacity` bytes of which the value
+// uses `size`. The two only differ after an in-place write of a shorter
+// value. Cells are 16 bytes plus the value, against 24 for a ValueEntry
+// and a separate copy of the bytes.
+struct SkipList::ValueCell {
+	ValueTag type;
+	uint32_t capacity;
+	std::atomic<uint32_t> size;
+	// Seqlock for in-place writes: odd while the writer rewrites the bytes.
+	std::atomic<uint32_t> seq;
+
+	std::byte* data() { return reinterpret_cast<std::byte*>(this + 1); }
+	const std::byte* data() const { return reinterpret_cast<const std::byte*>(this + 1); }
+};
+
+// Shared by every tombstone, so a delete allocates no value. Never written:
+// in-place writes only reuse data cells.
+SkipList::ValueCell* SkipList::TombstoneCell() {
+	static ValueCell cell{ValueTag::kTombstone, 0, {0}, {0}};
+	return &cell;
+}
+
+
+SkipList::SkipList(Arena& arena, int max_height, double probability, const Comparator* comparator,
+                   bool inplace_update)
+	: arena_(arena),
+	  comparator_(comparator),
+	  max_height_(std::clamp(max_height, 1, kMaxHeightLimit)),
+	  inplace_update_(inplace_update),
+	  level_up_threshold_(static_cast<uint32_t>(std::clamp(probability, 0.0, 1.0) * 4294967295.0)),
+	  random_state_(0x9E3779B97F4A7C15ULL),
+	  head_(NewNode(Slice(), max_height_, nullptr)),
+	  current_height_(1) {
 }
 
 SkipList::~SkipList() {
-	// Data for Slices in table_ is in arena_, managed externally.
-	// std::map (table_) cleans up its own nodes.
+	// Nodes, keys and values are in arena_, managed externally.
 }
 
-Result SkipList::Put(const Slice& key_input, const Slice& value_input) {
-	if (key_input.empty()) {
-		return Result::InvalidArgument("Key cannot be empty for Put.");
+size_t SkipList::CellBytes(const ValueEntry& entry) {
+	return sizeof(ValueCell) + entry.value_slice.size();
+}
+
+const SkipList::ValueCell* SkipList::NewCell(void* mem, const ValueEntry& entry) {
+	auto size = static_cast<uint32_t>(entry.value_slice.size());
+	auto* cell = new (mem) ValueCell{entry.type, size, {size}, {0}};
+	if (size > 0) {
+		std::memcpy(cell->data(), entry.value_slice.data(), size);
+	}
+	return cell;
+}
+
+ValueEntry SkipList::LoadValue(const Node* node) const {
+	const ValueCell* cell = node->value.load(std::memory_order_acquire);
+	return ValueEntry(Slice(cell->data(), cell->size.load(std::memory_order_acquire)), cell->type);
+}
+
+SkipList::Node* SkipList::NewNode(const Slice& key, int height, const ValueEntry* value) {
+	static_assert(sizeof(Node) % alignof(std::atomic<Node*>) == 0,
+	              "The tower must start aligned right after the node header.");
+	size_t tower_bytes = sizeof(std::atomic<Node*>) * static_cast<size_t>(height);
+	size_t key_end = sizeof(Node) + tower_bytes + key.size();
+	// The first value is kept after the key, in the same allocation, so a
+	// hit usually reads no other cache line; rewrites get their own.
+	size_t cell_offset = 0;
+	size_t bytes = key_end;
+	if (value != nullptr && !value->IsTombstone()) {
+		cell_offset = (key_end + alignof(ValueCell) - 1) / alignof(ValueCell) * alignof(ValueCell);
+		bytes = cell_offset + CellBytes(*value);
 	}
-	std::byte* key_arena_ptr;
-	// 1. Allocate and copy key data into arena
-	if (key_input.size() == 0) {
-		key_arena_ptr = nullptr;
-	} else {
-		void* key_mem_raw = arena_.Allocate(key_input.size(), alignof(std::byte));
-		if (!key_mem_raw) {
-			return Result::ArenaAllocationFail("Failed to allocate for key in Put.");
+	void* mem = arena_.Allocate(bytes, alignof(Node));
+	if (mem == nullptr) {
+		return nullptr;
+	}
+	Node* node = new (mem) Node;
+	node->key_prefix = KeyPrefix(key.data(), key.size());
+	node->key_size = static_cast<uint32_t>(key.size());
+	node->height = height;
+	for (int level = 0; level < height; ++level) {
+		new (&node->tower()[level]) std::atomic<Node*>(nullptr);
+	}
+	if (key.size() > 0) {
+		std::memcpy(node->key_data(), key.data(), key.size());
+	}
+	const ValueCell* cell = nullptr;
+	if (value != nullptr) {
+		cell = value->IsTombstone() ? TombstoneCell() : NewCell(static_cast<std::byte*>(mem) + cell_offset, *value);
+	}
+	node->value.store(cell, std::memory_order_relaxed);
+	return node;
+}
+
+int SkipList::RandomHeight() {
+	// xorshift64*; the list only needs heights to be independent.
+	int height = 1;
+	while (height < max_height_) {
+		random_state_ ^= random_state_ >> 12;
+		random_state_ ^= random_state_ << 25;
+		random_state_ ^= random_state_ >> 27;
+		auto sample = static_cast<uint32_t>((random_state_ * 0x2545F4914F6CDD1DULL) >> 32);
+		if (sample >= level_up_threshold_) {
+			break;
+		}
+		height++;
+	}
+	return height;
+}
+
+int SkipList::CompareNode(const Node* node, const Slice& key, uint64_t key_prefix) const {
+	if (comparator_.IsBytewise() && node->key_prefix != key_prefix) {
+		return node->key_prefix < key_prefix ? -1 : 1;
+	}
+	return comparator_.Compare(node->key(), key);
+}
+
+SkipList::Node* SkipList::FindGreaterOrEqual(const Slice& key, Node** prev) const {
+	const uint64_t key_prefix = comparator_.IsBytewise() ? KeyPrefix(key.data(), key.size()) : 0;
+	Node* x = head_;
+	int level = GetMaxHeight() - 1;
+	// The node that ended the search one level up. Going down, the search
+	// often meets it again, and it is already known not to be before the key.
+	const Node* last_bigger = nullptr;
+	while (true) {
+		Node* next = x->Next(level);
+		bool before_key = false;
+		if (next != nullptr && next != last_bigger) {
+			// Random lookups miss the cache on nearly every node; start loading
+			// the one after next while next is compared.
+			__builtin_prefetch(next->NoBarrierNext(level));
+			before_key = CompareNode(next, key, key_prefix) < 0;
 		}
-		key_arena_ptr = static_cast<std::byte*>(key_mem_raw);
-		std::memcpy(key_arena_ptr, key_input.data(), key_input.size());
-	}
-	Slice arena_key(key_arena_ptr, key_input.size());
-
-	// 2. Allocate and copy value data into arena
-	std::byte* value_arena_ptr;
-	if (value_input.size() == 0) {
-		value_arena_ptr = nullptr;
-	} else {
-		void* value_mem_raw = arena_.Allocate(value_input.size(), alignof(std::byte));
-		if (!value_mem_raw) {
-			return Result::ArenaAllocationFail("Failed to allocate for value in Put.");
+		if (before_key) {
+			x = next; // Keep searching in this level
+		} else {
+			if (prev != nullptr) {
+				prev[level] = x;
+			}
+			if (level == 0) {
+				return next;
+			}
+			last_bigger = next;
+			level--; // Switch to next level down
 		}
-		value_arena_ptr = static_cast<std::byte*>(value_mem_raw);
-		std::memcpy(value_arena_ptr, value_input.data(), value_input.size());
 	}
-	Slice arena_value_slice(value_arena_ptr, value_input.size());
+}
 
-	// 3. Create a ValueEntry for the normal value
-	ValueEntry entry(arena_value_slice, ValueTag::kData);
+Result SkipList::Upsert(const Slice& key, const ValueEntry& entry) {
+	// Search first: an existing key keeps its node, and only the value is
+	// stored again, if at all.
+	Node* prev[kMaxHeightLimit];
+	Node* x = FindGreaterOrEqual(key, prev);
+	if (x != nullptr && comparator_.Compare(x->key(), key) == 0) {
+		if (entry.IsTombstone()) {
+			x->value.store(TombstoneCell(), std::memory_order_release);
+			return Result::OK();
+		}
+		if (inplace_update_ && TryUpdateInPlace(x, entry.value_slice)) {
+			return Result::OK();
+		}
+		void* cell_mem = arena_.Allocate(CellBytes(entry), alignof(ValueCell));
+		if (cell_mem == nullptr) {
+			return Result::ArenaAllocationFail("Failed to allocate value entry.");
+		}
+		x->value.store(NewCell(cell_mem, entry), std::memory_order_release);
+		return Result::OK();
+	}
 
-	// 4. Insert or assign into the map
-	auto [iter, inserted] = table_.insert_or_assign(arena_key, entry);
+	int height = RandomHeight();
+	if (height > GetMaxHeight()) {
+		for (int level = GetMaxHeight(); level < height; ++level) {
+			prev[level] = head_;
+		}
+		// Readers seeing the new height before the node is linked just find
+		// nullptr from head_ on the new levels and move down.
+		current_height_.store(height, std::memory_order_relaxed);
+	}
 
-	if (inserted) {
-		map_nodes_overhead_estimate_ += sizeof(void*) * 3 + sizeof(Slice) + sizeof(ValueEntry); // Approx
-	} else {
-		// If updated, estimate potential change in ValueEntry size if it varied significantly
-		// For fixed size ValueEntry (Slice + enum), this is less of an issue.
+	Node* node = NewNode(key, height, &entry);
+	if (node == nullptr) {
+		return Result::ArenaAllocationFail("Failed to allocate skip list node.");
+	}
+	for (int level = 0; level < height; ++level) {
+		// The node is not reachable yet, so its own link needs no barrier;
+		// publishing it through prev does.
+		node->NoBarrierSetNext(level, prev[level]->NoBarrierNext(level));
+		prev[level]->SetNext(level, node);
 	}
 	return Result::OK();
 }
 
+bool SkipList::TryUpdateInPlace(Node* node, const Slice& value) {
+	auto* cell = const_cast<ValueCell*>(node->value.load(std::memory_order_relaxed));
+	if (cell->type != ValueTag::kData || value.size() > cell->capacity) {
+		return false;
+	}
+	// Seqlock write: readers that overlap it see an odd or changed seq and retry.
+	uint32_t seq = cell->seq.load(std::memory_order_relaxed);
+	cell->seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	if (value.size() > 0) {
+		std::memcpy(cell->data(), value.data(), value.size());
+	}
+	cell->size.store(static_cast<uint32_t>(value.size()), std::memory_order_relaxed);
+	cell->seq.store(seq + 2, std::memory_order_release);
+	return true;
+}
 
-Result SkipList::Get(const Slice& key) const {
-	// Assuming 'table_' is your std::map<Slice, ValueEntry, ...>
-	std::cout << "[SkipList::Get] Looking for key: " << key.ToString() << std::endl; // DEBUG
-	auto it = table_.find(key);
-	if (it == table_.end()) {
-			std::cout << "[SkipList::Get] Key not found in map." << std::endl; // DEBUG
-			// Key is not in the map at all.
-			return Result::NotFound(key.ToString() + " (not in skiplist map)");
+Result SkipList::Put(const Slice& key_input, const Slice& value_input) {
+	if (key_input.empty()) {
+		return Result::InvalidArgument("Key cannot be empty for Put.");
+	}
+
+	if (value_input.size() > UINT32_MAX) {
+		return Result::InvalidArgument("Value too large for Put.");
 	}
+	// Upsert copies the key (for a new node) and the value into the arena.
+	return Upsert(key_input, ValueEntry(value_input, ValueTag::kData));
+}
 
-	// Key is in the map, 'it->second' is a ValueEntry
-	const ValueEntry& entry = it->second;
-	std::cout << "[SkipList::Get] Key found in map. Entry type: " 
-						<< (entry.IsTombstone() ? "TOMBSTONE" : "DATA") << std::endl; // DEBUG
 
+Result SkipList::Get(const Slice& key, Slice* value_out) const {
+	// Hot path: a miss or hit must not allocate, so no debug output here.
+	const Node* x = FindGreaterOrEqual(key, nullptr);
+	if (x == nullptr || comparator_.Compare(x->key(), key) != 0) {
+		return Result::NotFound();
+	}
+	ValueEntry entry = LoadValue(x);
 	if (entry.IsTombstone()) {
-			// It's a tombstone. Return an OK Result that indicates this.
-			// The public DB::Get will interpret this as the key being "deleted".
-			return Result::OkTombstone();
-	} else {
-			// It's actual data.
-			return Result::OK(entry.value_slice); // This Result constructor sets value_tag_ to kData
+		return Result::FoundTombstone();
+	}
+	*value_out = entry.value_slice;
+	return Result::OK();
+}
+
+Result SkipList::GetValueCopy(const Slice& key, std::string* value_out) const {
+	const Node* x = FindGreaterOrEqual(key, nullptr);
+	if (x == nullptr || comparator_.Compare(x->key(), key) != 0) {
+		return Result::NotFound();
+	}
+	while (true) {
+		const ValueCell* cell = x->value.load(std::memory_order_acquire);
+		if (cell->type == ValueTag::kTombstone) {
+			return Result::FoundTombstone();
+		}
+		uint32_t seq = cell->seq.load(std::memory_order_acquire);
+		if ((seq & 1) != 0) {
+			continue; // The writer is mid-update
 		}
+		size_t size = std::min(cell->size.load(std::memory_order_relaxed), cell->capacity);
+		value_out->assign(reinterpret_cast<const char*>(cell->data()), size);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (cell->seq.load(std::memory_order_relaxed) == seq) {
+			return Result::OK();
+		}
+	}
 }
 
 Result SkipList::Delete(const Slice& key_input) {
 	if (key_input.empty()) {
 		return Result::InvalidArgument("Key cannot be empty for Delete.");
 	}
-
-	// 1. Allocate and copy key data into arena (key is still needed for the tombstone)
-	void* key_mem_raw = arena_.Allocate(key_input.size(), alignof(std::byte));
-	if (!key_mem_raw) {
-		return Result::ArenaAllocationFail("Failed to allocate for key in Delete.");
-	}
-	std::byte* key_arena_ptr = static_cast<std::byte*>(key_mem_raw);
-	std::memcpy(key_arena_ptr, key_input.data(), key_input.size());
-	Slice arena_key(key_arena_ptr, key_input.size());
-
-	// 2. Create a ValueEntry representing a tombstone
-	ValueEntry tombstone_entry(ValueTag::kTombstone); 
-	// tombstone_entry.value_slice will be an empty Slice by its constructor
-
-	// 3. Insert or assign the tombstone into the map
-	auto [iter, inserted] = table_.insert_or_assign(arena_key, tombstone_entry);
-
-	if (inserted) {
-		map_nodes_overhead_estimate_ += sizeof(void*) * 3 + sizeof(Slice) + sizeof(ValueEntry); // Approx
-	}
-	// If an existing value was "overwritten" by a tombstone, or an old tombstone
-	// was overwritten by a new one (idempotent).
-	return Result::OK();
+	// The key stays, marked by a tombstone, so the delete reaches SSTables.
+	return Upsert(key_input, ValueEntry(ValueTag::kTombstone));
 }
 
 
 SortedTableIterator* SkipList::NewIterator() const {
-	// The iterator object itself could also be allocated from the arena_
-	// if the MemTable (or SkipList owner) wants to manage its memory.
-	// return arena_.Create<SkipListIterator>(&table_); 
-	return new SkipListIterator(&table_); // Caller owns this for now
+	return new SkipListIterator(this); // Caller owns this for now
 }
 
 size_t SkipList::ApproximateMemoryUsage() const {
-	return arena_.GetTotalBytesUsed() + map_nodes_overhead_estimate_ + sizeof(*this);
+	return arena_.GetTotalBytesUsed() + sizeof(*this);
 }
 
-//just wrap map iterator for now
-SkipListIterator::SkipListIterator(const SkipList::InternalMapType* map_ptr)
-	: map_ptr_(map_ptr), current_iter_(map_ptr_->end()) {}
+SkipListIterator::SkipListIterator(const SkipList* list)
+	: list_(list), node_(nullptr) {}
 
 bool SkipListIterator::Valid() const {
-	return map_ptr_ && current_iter_ != map_ptr_->end();
+	return node_ != nullptr;
 }
 
 void SkipListIterator::SeekToFirst() {
-	if (map_ptr_) {
-		current_iter_ = map_ptr_->begin();
-	}
+	node_ = list_->head_->Next(0);
 }
 
 void SkipListIterator::Seek(const Slice& target) {
-	if (map_ptr_) {
-		current_iter_ = map_ptr_->lower_bound(target);
-	}
+	node_ = list_->FindGreaterOrEqual(target, nullptr);
 }
 
 void SkipListIterator::Next() {
 	if (Valid()) {
-		++current_iter_;
+		node_ = node_->Next(0);
 	}
 }
 
 Slice SkipListIterator::key() const {
 	if (!Valid()) return Slice();
-	return current_iter_->first;
+	return node_->key();
 }
 
 ValueEntry SkipListIterator::value() const {
 	if (!Valid()) {
-		// Return a default/invalid ValueEntry, perhaps a tombstone or specific error type if ValueEntry supported it
-		return ValueEntry(ValueTag::kTombstone); // Or some other convention
-    }
-	return current_iter_->second; // This is the ValueEntry stored in the map>
+		return ValueEntry(ValueTag::kTombstone);
+	}
+	return list_->LoadValue(node_);
 }
 
 Result SkipListIterator::status() const {
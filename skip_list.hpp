@@ -1,37 +1,60 @@
 #ifndef SKIP_LIST_HPP
 #define SKIP_LIST_HPP
 
-#include <map>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
+#include <string>
 
 #include "sorted_table.hpp"
 #include "arena.hpp"
+#include "comparator.hpp"
 #include "result.hpp"
 #include "value.hpp"
 
 
-class SkipListIterator; // Forward declaration for the iterator (will wrap map iterator)
-
-// Custom comparator for Slice keys in the std::map
-struct SliceMapComparatorForSkipListPlaceholder { // Renamed for clarity
-    bool operator()(const Slice& a, const Slice& b) const {
-        // Ensure Slice has a compare method or implement full comparison here
-        return a.compare(b) < 0; 
-    }
-};
-
-// This class is named SkipList and has its expected API,
-// but internally uses std::map as a placeholder.
+class SkipListIterator; // Forward declaration
+
+// Ordered table behind the memtable. Nodes, keys and values all live in the
+// arena and are never freed individually; the list is dropped with it.
+//
+// Each node is one arena allocation laid out as
+//   [header: key prefix, key length, height, value][tower of next pointers][key bytes][first value]
+// A Put of an existing key keeps its node and stores only the new value,
+// header and bytes in one allocation; deletes share a single tombstone.
+// The header carries the key's first 8 bytes as a big-endian integer (see
+// KeyPrefix), so under the bytewise comparator most comparisons made while
+// searching are decided by the node's first cache line, without a second
+// pointer chase to the key. Short keys sit in that same line; only prefix
+// ties read the key bytes. Random point lookups in a large table still
+// visit more nodes than a balanced tree would, and are slower than
+// MapTable's, which is why that stays the default memtable; the list is
+// for lock-free readers, in-place updates and a smaller footprint.
+//
+// One writer at a time (Put/Delete), any number of concurrent readers (Get,
+// iterators). Links and values are published with release stores, so a
+// reader never sees a node or value before it is fully written.
+//
+// With inplace_update, a Put of an existing key whose value fits in the
+// stored value's slot writes over the stored bytes instead of allocating,
+// so the arena grows with the number of distinct keys rather than writes.
+// A seqlock in each value guards those writes. The Slice from Get or an
+// iterator may change under a later Put of the same key; a reader running
+// alongside the writer takes a consistent copy with GetValueCopy.
 class SkipList : public SortedTable {
  public:
-  // Constructor signature matches a real SkipList,
-  // but max_height and probability are ignored by this map-based backend.
   static constexpr int kDefaultMaxHeight = 12;
   static constexpr double kDefaultProbability = 0.25;
+  // Upper bound on max_height.
+  static constexpr int kMaxHeightLimit = 32;
 
-  explicit SkipList(Arena& arena, 
-                    int max_height = kDefaultMaxHeight, // Ignored by this impl
-                    double probability = kDefaultProbability); // Ignored by this impl
+  // Keys are kept in `comparator` order. Each node is one level taller than
+  // the last with `probability`, up to `max_height` levels.
+  explicit SkipList(Arena& arena,
+                    int max_height = kDefaultMaxHeight,
+                    double probability = kDefaultProbability,
+                    const Comparator* comparator = BytewiseComparator(),
+                    bool inplace_update = false);
 
   ~SkipList() override;
 
@@ -42,32 +65,60 @@ class SkipList : public SortedTable {
 
   // --- SortedTable Interface Implementation ---
   Result Put(const Slice& key, const Slice& value) override;
-  Result Get(const Slice& key) const override;
+  Result Get(const Slice& key, Slice* value_out) const override;
   Result Delete(const Slice& key) override;
   SortedTableIterator* NewIterator() const override;
   size_t ApproximateMemoryUsage() const override;
 
- private:
-  friend class SkipListIterator; // Grant access to internal map
+  // Like Get, but copies the value into *value_out, consistently even while
+  // the writer updates it in place.
+  Result GetValueCopy(const Slice& key, std::string* value_out) const;
 
-  using InternalMapType = std::map<Slice, ValueEntry, SliceMapComparatorForSkipListPlaceholder>;
-  
-  Arena& arena_; // Reference to the arena where actual K/V data is stored
-  InternalMapType table_; // The std::map used as the backing store
-
-  // Parameters from constructor, stored but unused by this map implementation
-  const int ignored_max_height_; 
-  const double ignored_probability_;
-
-  size_t map_nodes_overhead_estimate_; // Rough estimate for map's own structural overhead
+ private:
+  friend class SkipListIterator;
+
+  struct Node;
+  struct ValueCell;
+
+  // Inserts `key` with `entry`, or replaces the value of an existing key.
+  Result Upsert(const Slice& key, const ValueEntry& entry);
+  // Writes `value` over the stored value of `node` if it fits. In-place mode only.
+  bool TryUpdateInPlace(Node* node, const Slice& value);
+  Node* NewNode(const Slice& key, int height, const ValueEntry* value);
+  // Bytes of the cell storing `entry`, and building one in `mem`.
+  static size_t CellBytes(const ValueEntry& entry);
+  static const ValueCell* NewCell(void* mem, const ValueEntry& entry);
+  static ValueCell* TombstoneCell();
+  // The current value of `node`.
+  ValueEntry LoadValue(const Node* node) const;
+  int RandomHeight();
+
+  // Same sign as comparator_.Compare(node's key, key). `key_prefix` is
+  // KeyPrefix(key), only used under the bytewise comparator.
+  int CompareNode(const Node* node, const Slice& key, uint64_t key_prefix) const;
+
+  // First node whose key is >= key, or nullptr. If `prev` is set, fills
+  // prev[level] with the last node before it on every level.
+  Node* FindGreaterOrEqual(const Slice& key, Node** prev) const;
+
+  int GetMaxHeight() const { return current_height_.load(std::memory_order_relaxed); }
+
+  Arena& arena_; // Holds nodes, keys and values
+  KeyComparator comparator_;
+  const int max_height_;
+  const bool inplace_update_;
+  uint32_t level_up_threshold_; // probability scaled to 2^32
+  uint64_t random_state_;
+  Node* head_;
+  std::atomic<int> current_height_;
 };
 
 
-// This iterator is named SkipListIterator for API consistency,
-// but it wraps a std::map iterator for this placeholder implementation.
+// Walks the level-0 chain. Valid while the SkipList and its arena live;
+// entries added after the iterator is created may or may not be seen.
 class SkipListIterator : public SortedTableIterator {
  public:
-  explicit SkipListIterator(const SkipList::InternalMapType* map_ptr);
+  explicit SkipListIterator(const SkipList* list);
   ~SkipListIterator() override = default;
 
   bool Valid() const override;
@@ -80,9 +131,9 @@ class SkipListIterator : public SortedTableIterator {
   Result status() const override;
 
  private:
-  const SkipList::InternalMapType* map_ptr_;
-  SkipList::InternalMapType::const_iterator current_iter_;
+  const SkipList* list_;
+  const SkipList::Node* node_;
 };
 
 
-#endif // SKIP_LIST_HPP
\ No newline at end of file
+#endif // SKIP_LIST_HPP
@@ -15,9 +15,9 @@ public:
 
   virtual Result Put(const Slice& key, const Slice& value) = 0;
   
-  // Get now returns a Result containing a ValueEntry on success (if found and not a tombstone),
-  // or a Slice view if we want to hide ValueEntry from the direct Get result.
-  virtual Result Get(const Slice& key) const = 0;
+  // OK with *value_out pointing at the stored value, FoundTombstone if the key
+  // was deleted, NotFound if the table has no entry for it. Never allocates.
+  virtual Result Get(const Slice& key, Slice* value_out) const = 0;
 
   virtual Result Delete(const Slice& key) = 0;
 
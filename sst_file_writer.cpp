@@ -0,0 +1,38 @@
+#include "sst_file_writer.hpp"
+
+#include <iostream>
+
+SstFileWriter::SstFileWriter(bool enable_compression, int compression_level,
+                             size_t target_block_size)
+    : builder_(enable_compression, compression_level, target_block_size),
+      finished_(false) {}
+
+Result SstFileWriter::Open(const std::string& filename) {
+  if (builder_.IsOpen() || finished_) {
+    return Result::NotSupported("SstFileWriter: Open called twice.");
+  }
+  std::cout << "[SstFileWriter::Open] Writing external SSTable " << filename << std::endl;
+  return builder_.Open(filename);
+}
+
+Result SstFileWriter::Put(const Slice& key, const Slice& value) {
+  return builder_.Add(key, ValueEntry(value, ValueTag::kData));
+}
+
+Result SstFileWriter::Delete(const Slice& key) {
+  return builder_.Add(key, ValueEntry(ValueTag::kTombstone));
+}
+
+Result SstFileWriter::Finish() {
+  if (!builder_.IsOpen()) {
+    return Result::NotSupported("SstFileWriter: file is not open for writing.");
+  }
+  if (builder_.NumEntries() == 0) {
+    return Result::InvalidArgument("SstFileWriter: cannot finish a file with no entries.");
+  }
+  Result finish_res = builder_.Finish();
+  if (finish_res.ok()) {
+    finished_ = true;
+  }
+  return finish_res;
+}
@@ -0,0 +1,53 @@
+#ifndef SST_FILE_WRITER_HPP
+#define SST_FILE_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "result.hpp"
+#include "slice.hpp"
+#include "table_builder.hpp"
+#include "value.hpp"
+
+// Builds an SSTable offline from input that is already sorted, without going
+// through a MemTable. The output uses the same block format as flushed tables
+// and can be handed to DB::IngestExternalFile.
+//
+//   SstFileWriter writer;
+//   writer.Open("/tmp/bulk.sst");
+//   writer.Put(key_a, value_a);  // keys must be strictly increasing
+//   writer.Put(key_b, value_b);
+//   writer.Finish();
+struct SstFileWriter {
+ public:
+  explicit SstFileWriter(bool enable_compression = true, int compression_level = 1,
+                         size_t target_block_size = 4096);
+
+  SstFileWriter(const SstFileWriter&) = delete;
+  SstFileWriter& operator=(const SstFileWriter&) = delete;
+
+  // Keys must be added in `comparator` order, and the file can only be
+  // ingested into a column family using a comparator of the same name.
+  // Call before Open.
+  void SetComparator(const Comparator* comparator) { builder_.SetComparator(comparator); }
+
+  Result Open(const std::string& filename);
+
+  // Both return InvalidArgument if `key` does not sort strictly after the
+  // previously added key.
+  Result Put(const Slice& key, const Slice& value);
+  Result Delete(const Slice& key);
+
+  // Writes the last block and closes the file. Finishing a file without any
+  // entries is an error, since such a file cannot be ingested.
+  Result Finish();
+
+  uint64_t NumEntries() const { return builder_.NumEntries(); }
+
+ private:
+  TableBuilder builder_;
+  bool finished_;
+};
+
+#endif // SST_FILE_WRITER_HPP
@@ -144,8 +144,8 @@ Result SSTableIterator::ParseEntryFromBuffer(
          (int)temp_parsed_value_slice.size(), temp_parsed_value_slice.data() ? (const char*)temp_parsed_value_slice.data() : "");
   printf("    Tag to be used for ValueEntry: %d\n", (int)current_tag);
 
-  if (current_tag == ValueTag::kData) {
-    *value_out = ValueEntry(temp_parsed_value_slice, ValueTag::kData);
+  if (current_tag == ValueTag::kData || current_tag == ValueTag::kBlobIndex) {
+    *value_out = ValueEntry(temp_parsed_value_slice, current_tag);
   } else if (current_tag == ValueTag::kTombstone) {
     if (value_length != 0) {
       return Result::Corruption("ParseEntry: Tombstone has non-zero value length.");
@@ -346,7 +346,7 @@ void SSTableIterator::Seek(const Slice& target) {
     printf("DEBUG ITER::Seek - Comparing current_key '%.*s' with target '%.*s'.\n",
            (int)current_key_.size(), current_key_.data() ? (const char*)current_key_.data() : "",
            (int)target.size(), target.data() ? (const char*)target.data() : "");
-    if (current_key_.compare(target) >= 0) {
+    if (reader_->comparator().Compare(current_key_, target) >= 0) {
       printf("DEBUG ITER::Seek - Found key >= target.\n");
       return;
     }
@@ -6,15 +6,33 @@
 #include "sstable_writer.hpp" // For ReadLittleEndian32 and CompressionType
 #include "result.hpp"       // Ensure this is the updated Result.hpp
 #include "value.hpp"        // For ValueTag
+#include "zstd_context.hpp"
+
+namespace {
+
+// Holds compressed block payloads between the read and the decompression.
+// Readers are often short-lived (one per table per lookup), so the buffer
+// belongs to the thread rather than the reader, and keeps the capacity of
+// the largest block it has loaded, up to kMaxRetainedScratchBytes.
+constexpr size_t kMaxRetainedScratchBytes = 1 << 20;
+
+std::vector<char>& CompressedBlockScratch() {
+  thread_local std::vector<char> scratch;
+  return scratch;
+}
+
+} // namespace
 
 // SSTableReader Constructor, Destructor, Init, LoadBlockIntoBuffer remain the same
 // as your last provided version.
 
-SSTableReader::SSTableReader(std::string filename)
+SSTableReader::SSTableReader(std::string filename, const Comparator* comparator)
     : filename_(std::move(filename)),
-      zstd_dctx_(nullptr),
+      comparator_(comparator),
       is_open_(false),
-      file_size_(0) {
+      file_size_(0),
+      format_version_(0),
+      properties_offset_(0) {
     std::cout << "[SSTableReader Constructor] Filename: " << filename_ << std::endl;
 }
 
@@ -23,10 +41,6 @@ SSTableReader::~SSTableReader() {
   if (file_stream_.is_open()) {
     file_stream_.close();
   }
-  if (zstd_dctx_ != nullptr) {
-    ZSTD_freeDCtx(zstd_dctx_);
-    zstd_dctx_ = nullptr;
-  }
 }
 
 Result SSTableReader::Init() {
@@ -57,13 +71,6 @@ Result SSTableReader::Init() {
     return Result::IOError("SSTableReader: Failed to seek to beginning of file for: " + filename_);
   }
 
-  zstd_dctx_ = ZSTD_createDCtx();
-  if (zstd_dctx_ == nullptr) {
-    std::cout << "[SSTableReader::Init] Failed to create ZSTD decompression context." << std::endl;
-    file_stream_.close();
-    return Result::IOError("SSTableReader: Failed to create ZSTD decompression context.");
-  }
-
   is_open_ = true;
   std::cout << "[SSTableReader::Init] Successfully initialized: " << filename_ << std::endl;
   return Result::OK();
@@ -71,6 +78,14 @@ Result SSTableReader::Init() {
 
 Result SSTableReader::LoadBlockIntoBuffer(
     uint64_t block_offset, uint64_t* block_size_on_disk_out) {
+  Result res = ReadBlock(block_offset, block_size_on_disk_out);
+  if (!res.ok()) {
+    internal_block_buffer_.clear();
+  }
+  return res;
+}
+
+Result SSTableReader::ReadBlock(uint64_t block_offset, uint64_t* block_size_on_disk_out) {
   // std::cout << "[SSTableReader::LoadBlockIntoBuffer] Offset: " << block_offset << std::endl; // Can be noisy
   if (!is_open_) {
     return Result::NotSupported("SSTableReader is not open.");
@@ -81,12 +96,10 @@ Result SSTableReader::LoadBlockIntoBuffer(
 
   if (block_offset >= file_size_) {
     // This condition also handles file_size_ == 0 correctly if block_offset is 0 or more.
-    internal_block_buffer_.clear();
     // std::cout << "[SSTableReader::LoadBlockIntoBuffer] EOF (offset >= file_size)." << std::endl; // Can be noisy
     return Result::NotFound("EOF (offset out of bounds or empty file).");
   }
 
-  internal_block_buffer_.clear();
   file_stream_.seekg(block_offset);
   if (file_stream_.fail() || file_stream_.eof()) { // Check eof too after seek
     // If seekg goes past EOF, eofbit is set, failbit might be set.
@@ -111,6 +124,9 @@ Result SSTableReader::LoadBlockIntoBuffer(
   uint32_t uncompressed_size = ReadLittleEndian32(header_buf);
   uint32_t on_disk_payload_size = ReadLittleEndian32(header_buf + sizeof(uint32_t));
   char compression_flag = header_buf[sizeof(uint32_t) + sizeof(uint32_t)];
+  if (compression_flag == kPropertiesBlockFlag) {
+    return Result::NotFound("End of data blocks.");
+  }
   // std::cout << "[SSTableReader::LoadBlockIntoBuffer] Header: uncomp=" << uncompressed_size 
   //           << ", on_disk_payload=" << on_disk_payload_size << ", flag=" << (int)compression_flag << std::endl;
 
@@ -122,45 +138,55 @@ Result SSTableReader::LoadBlockIntoBuffer(
     return Result::Corruption("Block physical size exceeds file bounds.");
   }
 
-  std::vector<char> raw_disk_data(on_disk_payload_size);
-  if (on_disk_payload_size > 0) {
-    file_stream_.read(raw_disk_data.data(), on_disk_payload_size);
+  if (compression_flag == CompressionType::kNoCompression) {
+    if (uncompressed_size != on_disk_payload_size) {
+      return Result::Corruption("Size mismatch for uncompressed block: uncompressed=" + std::to_string(uncompressed_size) + ", payload=" + std::to_string(on_disk_payload_size));
+    }
+    // Straight into the block buffer; it keeps its capacity between blocks.
+    internal_block_buffer_.resize(uncompressed_size);
+    if (uncompressed_size > 0) {
+      file_stream_.read(internal_block_buffer_.data(), uncompressed_size);
+      if (static_cast<uint32_t>(file_stream_.gcount()) != uncompressed_size) {
+        std::cout << "[SSTableReader::LoadBlockIntoBuffer] Corruption: Failed to read full block payload. Expected "
+                  << uncompressed_size << ", got " << file_stream_.gcount() << std::endl;
+        return Result::Corruption("Failed to read full block payload.");
+      }
+    }
+  } else if (compression_flag == CompressionType::kZstdCompressed) {
+    if (uncompressed_size == 0 && on_disk_payload_size > 0) {
+      return Result::Corruption("ZSTD block has 0 uncompressed size but non-zero payload.");
+    }
+    if (uncompressed_size > 0 && on_disk_payload_size == 0) {
+      return Result::Corruption("ZSTD block expects uncompressed data but on-disk payload is empty.");
+    }
+    std::vector<char>& scratch = CompressedBlockScratch();
+    if (scratch.size() < on_disk_payload_size) {
+      scratch.resize(on_disk_payload_size);
+    }
+    file_stream_.read(scratch.data(), on_disk_payload_size);
     if (static_cast<uint32_t>(file_stream_.gcount()) != on_disk_payload_size) {
       std::cout << "[SSTableReader::LoadBlockIntoBuffer] Corruption: Failed to read full block payload. Expected "
                 << on_disk_payload_size << ", got " << file_stream_.gcount() << std::endl;
       return Result::Corruption("Failed to read full block payload.");
     }
-  }
-
-  if (compression_flag == CompressionType::kZstdCompressed) {
-    if (uncompressed_size == 0 && on_disk_payload_size > 0) {
-      return Result::Corruption("ZSTD block has 0 uncompressed size but non-zero payload.");
-    }
-    if (uncompressed_size > 0) { // Only decompress if there's something to decompress to
-        if (on_disk_payload_size == 0) { // Cannot decompress from an empty payload if uncompressed_size > 0
-            return Result::Corruption("ZSTD block expects uncompressed data but on-disk payload is empty.");
-        }
-      internal_block_buffer_.resize(uncompressed_size);
+    internal_block_buffer_.resize(uncompressed_size);
+    if (uncompressed_size > 0) {
+      ZSTD_DCtx* dctx = ThreadLocalZstdDCtx();
+      if (dctx == nullptr) {
+        return Result::IOError("SSTableReader: Failed to create ZSTD decompression context.");
+      }
       size_t decompressed_size = ZSTD_decompressDCtx(
-          zstd_dctx_, internal_block_buffer_.data(), uncompressed_size,
-          raw_disk_data.data(), on_disk_payload_size);
+          dctx, internal_block_buffer_.data(), uncompressed_size,
+          scratch.data(), on_disk_payload_size);
       if (ZSTD_isError(decompressed_size) || decompressed_size != uncompressed_size) {
-        std::cout << "[SSTableReader::LoadBlockIntoBuffer] Zstd decompression error or size mismatch. ZSTD Err: " 
-                  << ZSTD_getErrorName(decompressed_size) << ", Expected size: " << uncompressed_size 
+        std::cout << "[SSTableReader::LoadBlockIntoBuffer] Zstd decompression error or size mismatch. ZSTD Err: "
+                  << ZSTD_getErrorName(decompressed_size) << ", Expected size: " << uncompressed_size
                   << ", Got: " << decompressed_size << std::endl;
         return Result::Corruption("Zstd decompression error or size mismatch. Error: " + std::string(ZSTD_getErrorName(decompressed_size)));
       }
-    } else { // uncompressed_size is 0
-        internal_block_buffer_.clear(); // Ensure buffer is empty
-    }
-  } else if (compression_flag == CompressionType::kNoCompression) {
-    if (uncompressed_size != on_disk_payload_size) {
-      return Result::Corruption("Size mismatch for uncompressed block: uncompressed=" + std::to_string(uncompressed_size) + ", payload=" + std::to_string(on_disk_payload_size));
     }
-    if (uncompressed_size > 0) {
-      internal_block_buffer_.assign(raw_disk_data.begin(), raw_disk_data.end());
-    } else {
-        internal_block_buffer_.clear();
+    if (scratch.capacity() > kMaxRetainedScratchBytes) {
+      std::vector<char>().swap(scratch);
     }
   } else {
     return Result::NotSupported("Unknown compression flag: " + std::to_string(static_cast<int>(compression_flag)));
@@ -173,6 +199,331 @@ Result SSTableReader::LoadBlockIntoBuffer(
   return Result::OK();
 }
 
+Result SSTableReader::GetBlockBoundaryKeys(std::vector<std::string>* keys_out) {
+  if (keys_out == nullptr) {
+    return Result::InvalidArgument("Output key vector pointer is null.");
+  }
+  if (!is_open_) {
+    return Result::NotSupported("SSTableReader not open. Call Init() first.");
+  }
+
+  uint64_t current_block_disk_offset = 0;
+  while (current_block_disk_offset < file_size_) {
+    uint64_t current_block_total_size_on_disk = 0;
+    Result load_res = LoadBlockIntoBuffer(current_block_disk_offset, &current_block_total_size_on_disk);
+    if (!load_res.ok()) {
+      if (load_res.code() == ResultCode::kNotFound) { // EOF reached
+        break;
+      }
+      return load_res;
+    }
+    if (current_block_total_size_on_disk == 0) {
+      return Result::Corruption("Encountered zero-sized block in non-empty SSTable before EOF.");
+    }
+
+    if (!internal_block_buffer_.empty()) {
+      ParsedEntryInfo entry_info = ParseNextEntry(internal_block_buffer_.data(), internal_block_buffer_.size(), 0);
+      if (!entry_info.status.ok()) {
+        return entry_info.status;
+      }
+      keys_out->push_back(entry_info.key.ToString());
+    }
+    current_block_disk_offset += current_block_total_size_on_disk;
+  }
+  std::cout << "[SSTableReader::GetBlockBoundaryKeys] " << filename_ << ": collected "
+            << keys_out->size() << " block boundary keys." << std::endl;
+  return Result::OK();
+}
+
+Result SSTableReader::GetKeyRange(std::string* smallest_out, std::string* largest_out) {
+  if (smallest_out == nullptr || largest_out == nullptr) {
+    return Result::InvalidArgument("Output key pointer is null.");
+  }
+  if (!is_open_) {
+    return Result::NotSupported("SSTableReader not open. Call Init() first.");
+  }
+  if (file_size_ == 0) {
+    return Result::NotFound("SSTable has no entries.");
+  }
+
+  TableProperties properties;
+  Result props_res = GetTableProperties(&properties);
+  if (props_res.ok()) {
+    *smallest_out = std::move(properties.smallest_key);
+    *largest_out = std::move(properties.largest_key);
+    return Result::OK();
+  }
+  if (!props_res.IsNotFound()) {
+    return props_res;
+  }
+
+  // Hop from header to header to find where the last block starts.
+  const size_t header_size = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(char);
+  uint64_t offset = 0;
+  uint64_t last_block_offset = 0;
+  while (offset < file_size_) {
+    char header_buf[sizeof(uint32_t) + sizeof(uint32_t) + sizeof(char)];
+    file_stream_.clear();
+    file_stream_.seekg(static_cast<std::streamoff>(offset));
+    file_stream_.read(header_buf, header_size);
+    if (static_cast<size_t>(file_stream_.gcount()) != header_size) {
+      return Result::Corruption("Failed to read block header at offset " + std::to_string(offset));
+    }
+    uint32_t on_disk_payload_size = ReadLittleEndian32(header_buf + sizeof(uint32_t));
+    if (offset + header_size + on_disk_payload_size > file_size_) {
+      return Result::Corruption("Block physical size exceeds file bounds.");
+    }
+    if (header_buf[header_size - 1] == kPropertiesBlockFlag) {
+      break;
+    }
+    last_block_offset = offset;
+    offset += header_size + on_disk_payload_size;
+  }
+
+  Result load_res = LoadBlockIntoBuffer(0, nullptr);
+  if (!load_res.ok()) {
+    return load_res;
+  }
+  if (internal_block_buffer_.empty()) {
+    return Result::Corruption("First block of non-empty SSTable has no entries.");
+  }
+  ParsedEntryInfo first = ParseNextEntry(internal_block_buffer_.data(), internal_block_buffer_.size(), 0);
+  if (!first.status.ok()) {
+    return first.status;
+  }
+  *smallest_out = first.key.ToString();
+
+  if (last_block_offset != 0) {
+    load_res = LoadBlockIntoBuffer(last_block_offset, nullptr);
+    if (!load_res.ok()) {
+      return load_res;
+    }
+  }
+  size_t pos = 0;
+  Slice last_key;
+  while (pos < internal_block_buffer_.size()) {
+    ParsedEntryInfo entry_info = ParseNextEntry(internal_block_buffer_.data(), internal_block_buffer_.size(), pos);
+    if (!entry_info.status.ok()) {
+      return entry_info.status;
+    }
+    last_key = entry_info.key;
+    pos += entry_info.entry_size_in_block;
+  }
+  *largest_out = last_key.ToString();
+  return Result::OK();
+}
+
+Result SSTableReader::ReadFooter() {
+  if (format_version_ != 0) {
+    return Result::OK();
+  }
+  if (file_size_ < kTableFooterSize) {
+    format_version_ = 1;
+    return Result::OK();
+  }
+  char footer[kTableFooterSize];
+  file_stream_.clear();
+  file_stream_.seekg(static_cast<std::streamoff>(file_size_ - kTableFooterSize));
+  file_stream_.read(footer, kTableFooterSize);
+  if (static_cast<size_t>(file_stream_.gcount()) != kTableFooterSize) {
+    return Result::IOError("Failed to read table footer: " + filename_);
+  }
+  if (ReadLittleEndian64(footer + 12) != kTableMagicNumber) {
+    format_version_ = 1; // Written before tables had a footer
+    return Result::OK();
+  }
+  uint32_t version = ReadLittleEndian32(footer + 8);
+  if (version < 2) {
+    return Result::Corruption("Table footer has invalid format version " + std::to_string(version) + ": " +
+                              filename_);
+  }
+  if (version > kTableFormatVersion) {
+    return Result::NotSupported("Table format version " + std::to_string(version) +
+                                " is newer than this build supports: " + filename_);
+  }
+  uint64_t properties_offset = ReadLittleEndian64(footer);
+  if (properties_offset + kBlockHeaderSize > file_size_ - kTableFooterSize) {
+    return Result::Corruption("Table footer points past the end of the file: " + filename_);
+  }
+  format_version_ = version;
+  properties_offset_ = properties_offset;
+  return Result::OK();
+}
+
+Result SSTableReader::FindPropertiesBlock(uint64_t* offset_out) {
+  Result footer_res = ReadFooter();
+  if (!footer_res.ok()) {
+    return footer_res;
+  }
+  if (format_version_ >= 2) {
+    *offset_out = properties_offset_;
+    return Result::OK();
+  }
+
+  const size_t header_size = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(char);
+  uint64_t offset = 0;
+  while (offset < file_size_) {
+    char header_buf[sizeof(uint32_t) + sizeof(uint32_t) + sizeof(char)];
+    file_stream_.clear();
+    file_stream_.seekg(static_cast<std::streamoff>(offset));
+    file_stream_.read(header_buf, header_size);
+    if (static_cast<size_t>(file_stream_.gcount()) != header_size) {
+      return Result::Corruption("Failed to read block header at offset " + std::to_string(offset));
+    }
+    if (header_buf[header_size - 1] == kPropertiesBlockFlag) {
+      *offset_out = offset;
+      return Result::OK();
+    }
+    offset += header_size + ReadLittleEndian32(header_buf + sizeof(uint32_t));
+  }
+  return Result::NotFound("SSTable has no properties block: " + filename_);
+}
+
+Result SSTableReader::ReadProperties(std::vector<std::pair<std::string, std::string>>* properties_out) {
+  if (!is_open_) {
+    return Result::NotSupported("SSTableReader not open. Call Init() first.");
+  }
+  uint64_t offset = 0;
+  Result find_res = FindPropertiesBlock(&offset);
+  if (!find_res.ok()) {
+    return find_res;
+  }
+
+  char header_buf[kBlockHeaderSize];
+  file_stream_.clear();
+  file_stream_.seekg(static_cast<std::streamoff>(offset));
+  file_stream_.read(header_buf, kBlockHeaderSize);
+  if (static_cast<size_t>(file_stream_.gcount()) != kBlockHeaderSize ||
+      header_buf[kBlockHeaderSize - 1] != kPropertiesBlockFlag) {
+    return Result::Corruption("No properties block at offset " + std::to_string(offset) + ": " + filename_);
+  }
+  uint32_t size = ReadLittleEndian32(header_buf + sizeof(uint32_t));
+  if (offset + kBlockHeaderSize + size > file_size_) {
+    return Result::Corruption("Properties block exceeds file bounds: " + filename_);
+  }
+  std::string block(size, '\0');
+  file_stream_.read(block.data(), static_cast<std::streamsize>(size));
+  if (static_cast<uint32_t>(file_stream_.gcount()) != size) {
+    return Result::Corruption("Failed to read properties block: " + filename_);
+  }
+
+  size_t pos = 0;
+  auto next_string = [&block, &pos](std::string* out) {
+    if (pos + sizeof(uint32_t) > block.size()) {
+      return false;
+    }
+    uint32_t length = ReadLittleEndian32(block.data() + pos);
+    pos += sizeof(uint32_t);
+    if (pos + length > block.size()) {
+      return false;
+    }
+    out->assign(block, pos, length);
+    pos += length;
+    return true;
+  };
+  properties_out->clear();
+  while (pos < block.size()) {
+    std::pair<std::string, std::string> property;
+    if (!next_string(&property.first) || !next_string(&property.second)) {
+      return Result::Corruption("Malformed properties block: " + filename_);
+    }
+    properties_out->push_back(std::move(property));
+  }
+  return Result::OK();
+}
+
+Result SSTableReader::GetProperty(const std::string& name, std::string* value_out) {
+  if (value_out == nullptr) {
+    return Result::InvalidArgument("Output string pointer is null.");
+  }
+  std::vector<std::pair<std::string, std::string>> properties;
+  Result read_res = ReadProperties(&properties);
+  if (!read_res.ok()) {
+    return read_res;
+  }
+  for (auto& [property_name, property_value] : properties) {
+    if (property_name == name) {
+      *value_out = std::move(property_value);
+      return Result::OK();
+    }
+  }
+  return Result::NotFound("SSTable has no property '" + name + "': " + filename_);
+}
+
+Result SSTableReader::GetTableProperties(TableProperties* properties_out) {
+  if (properties_out == nullptr) {
+    return Result::InvalidArgument("Output properties pointer is null.");
+  }
+  if (!is_open_) {
+    return Result::NotSupported("SSTableReader not open. Call Init() first.");
+  }
+  if (file_size_ == 0) {
+    return Result::NotFound("SSTable has no entries.");
+  }
+  Result footer_res = ReadFooter();
+  if (!footer_res.ok()) {
+    return footer_res;
+  }
+  if (format_version_ < 2) {
+    return Result::NotFound("SSTable predates table properties: " + filename_);
+  }
+  std::vector<std::pair<std::string, std::string>> properties;
+  Result read_res = ReadProperties(&properties);
+  if (!read_res.ok()) {
+    return read_res;
+  }
+
+  TableProperties result;
+  result.format_version = format_version_;
+  struct NumberProperty {
+    const char* name;
+    uint64_t* value;
+    bool found;
+  };
+  NumberProperty numbers[] = {
+      {kNumEntriesProperty, &result.num_entries, false},
+      {kNumTombstonesProperty, &result.num_tombstones, false},
+      {kNumDataBlocksProperty, &result.num_data_blocks, false},
+      {kRawKeyBytesProperty, &result.raw_key_bytes, false},
+      {kRawValueBytesProperty, &result.raw_value_bytes, false},
+      {kDataBytesProperty, &result.data_bytes, false},
+  };
+  // Properties this build does not know are skipped, so newer writers may
+  // add more without a version bump.
+  for (auto& [name, value] : properties) {
+    bool is_number = false;
+    for (NumberProperty& number : numbers) {
+      if (name == number.name) {
+        if (value.size() != sizeof(uint64_t)) {
+          return Result::Corruption("Property '" + name + "' is not 8 bytes: " + filename_);
+        }
+        *number.value = ReadLittleEndian64(value.data());
+        number.found = true;
+        is_number = true;
+      }
+    }
+    if (is_number) {
+      continue;
+    }
+    if (name == kSmallestKeyProperty) {
+      result.smallest_key = std::move(value);
+    } else if (name == kLargestKeyProperty) {
+      result.largest_key = std::move(value);
+    } else if (name == kCompressionProperty) {
+      result.compression = std::move(value);
+    } else if (name == kComparatorNameProperty) {
+      result.comparator_name = std::move(value);
+    }
+  }
+  for (const NumberProperty& number : numbers) {
+    if (!number.found) {
+      return Result::Corruption(std::string("Table properties lack '") + number.name + "': " + filename_);
+    }
+  }
+  *properties_out = std::move(result);
+  return Result::OK();
+}
+
 SSTableReader::ParsedEntryInfo SSTableReader::ParseNextEntry(
     const char* block_data_start, size_t block_size,
     size_t current_offset_in_block_param) { // Renamed param for clarity
@@ -244,7 +595,8 @@ SSTableReader::ParsedEntryInfo SSTableReader::ParseNextEntry(
 }
 
 
-Result SSTableReader::Get(const Slice& search_key, Arena* arena_for_value_copy) {
+Result SSTableReader::Get(const Slice& search_key, Arena* arena_for_value_copy, Slice* value_out,
+                          ValueTag* tag_out) {
   std::cout << "[SSTableReader::Get Arena*] Key: " << search_key.ToString() << std::endl;
   if (!is_open_) {
     return Result::NotSupported("SSTableReader not open. Call Init() first.");
@@ -252,8 +604,8 @@ Result SSTableReader::Get(const Slice& search_key, Arena* arena_for_value_copy)
   if (search_key.empty()) {
     return Result::InvalidArgument("Search key cannot be empty.");
   }
-  if (arena_for_value_copy == nullptr) {
-    return Result::InvalidArgument("Arena cannot be null for Get operation requiring Arena copy.");
+  if (arena_for_value_copy == nullptr || value_out == nullptr) {
+    return Result::InvalidArgument("Arena and value output cannot be null for Get operation requiring Arena copy.");
   }
 
   uint64_t current_block_disk_offset = 0;
@@ -293,10 +645,11 @@ Result SSTableReader::Get(const Slice& search_key, Arena* arena_for_value_copy)
         return entry_info.status; // Corruption in block
       }
 
-      if (entry_info.key.compare(search_key) == 0) {
+      int cmp = comparator_.Compare(entry_info.key, search_key);
+      if (cmp == 0) {
         if (entry_info.tag == ValueTag::kTombstone) {
           std::cout << "[SSTableReader::Get Arena*] Found TOMBSTONE for key " << search_key.ToString() << std::endl;
-          return Result::OkTombstone(); // Use the new static factory
+          return Result::FoundTombstone();
         }
         if (entry_info.tag == ValueTag::kData) {
           std::cout << "[SSTableReader::Get Arena*] Found DATA for key " << search_key.ToString() << ". Value size: " << entry_info.value_in_block.size() << std::endl;
@@ -308,33 +661,44 @@ Result SSTableReader::Get(const Slice& search_key, Arena* arena_for_value_copy)
           if (entry_info.value_in_block.size() > 0) {
             std::memcpy(arena_mem, entry_info.value_in_block.data(), entry_info.value_in_block.size());
           }
-          // Result::OK(Slice) constructor correctly sets value_tag_ to kData
-          std::cout << "[SSTableReader::Get Arena*] Found DATA for key " << search_key.ToString() 
-                    << ". Value slice ptr in arena: " << (void*)arena_mem << std::endl; // DEBUG
-          return Result::OK(Slice(static_cast<const std::byte*>(arena_mem), entry_info.value_in_block.size()));
+          *value_out = Slice(static_cast<const std::byte*>(arena_mem), entry_info.value_in_block.size());
+          if (tag_out != nullptr) {
+            *tag_out = ValueTag::kData;
+          }
+          return Result::OK();
+        }
+        if (entry_info.tag == ValueTag::kBlobIndex) {
+          // The index is small; the caller resolves it against the blob file.
+          void* arena_mem = arena_for_value_copy->Allocate(
+              entry_info.value_in_block.size(), alignof(std::byte));
+          if (arena_mem == nullptr) {
+            return Result::ArenaAllocationFail("Failed to allocate memory in arena for blob index.");
+          }
+          std::memcpy(arena_mem, entry_info.value_in_block.data(), entry_info.value_in_block.size());
+          *value_out = Slice(static_cast<const std::byte*>(arena_mem), entry_info.value_in_block.size());
+          if (tag_out != nullptr) {
+            *tag_out = ValueTag::kBlobIndex;
+          }
+          return Result::OK();
         }
-        // Should not happen if tags are only kData or kTombstone
         return Result::Corruption("Unknown value tag encountered for key '" + search_key.ToString() + "'");
       }
-      // If current entry's key is greater than search_key, and keys are sorted,
-      // search_key cannot be in this block or any subsequent block in this file.
-      // This is an optimization if your SSTable blocks store keys in sorted order.
-      // if (entry_info.key.compare(search_key) > 0) {
-      //    std::cout << "[SSTableReader::Get Arena*] Current key " << entry_info.key.ToString() 
-      //              << " > search_key " << search_key.ToString() << ". Key not in this block/SSTable." << std::endl;
-      //    return Result::NotFound(search_key.ToString() + " (not found by sorted order check)");
-      // }
+      // Keys are sorted, so once past search_key it is in no later entry or block.
+      if (cmp > 0) {
+        std::cout << "[SSTableReader::Get Arena*] Passed key " << search_key.ToString() << " at " << entry_info.key.ToString() << std::endl;
+        return Result::NotFound();
+      }
       offset_in_block += entry_info.entry_size_in_block; // This was missing!
     }
     current_block_disk_offset += current_block_total_size_on_disk;
   }
 
   std::cout << "[SSTableReader::Get Arena*] Key " << search_key.ToString() << " not found in any block." << std::endl;
-  return Result::NotFound(search_key.ToString() + " (not found in this SSTable)");
+  return Result::NotFound();
 }
 
 // Get version for std::string output
-Result SSTableReader::Get(const Slice& search_key, std::string* value_out) {
+Result SSTableReader::Get(const Slice& search_key, std::string* value_out, ValueTag* tag_out) {
   std::cout << "[SSTableReader::Get string*] Key: " << search_key.ToString() << std::endl;
   if (value_out == nullptr) {
     return Result::InvalidArgument("Output string pointer is null.");
@@ -388,10 +752,11 @@ Result SSTableReader::Get(const Slice& search_key, std::string* value_out) {
         return entry_info.status; // Corruption
       }
 
-      if (entry_info.key.compare(search_key) == 0) {
+      int cmp = comparator_.Compare(entry_info.key, search_key);
+      if (cmp == 0) {
         if (entry_info.tag == ValueTag::kTombstone) {
            std::cout << "[SSTableReader::Get string*] Found TOMBSTONE for key " << search_key.ToString() << std::endl;
-          return Result::OkTombstone(); // Signal tombstone correctly
+          return Result::FoundTombstone();
         }
         if (entry_info.tag == ValueTag::kData) {
           std::cout << "[SSTableReader::Get string*] Found DATA for key " << search_key.ToString() << ". Value size: " << entry_info.value_in_block.size() << std::endl;
@@ -400,27 +765,31 @@ Result SSTableReader::Get(const Slice& search_key, std::string* value_out) {
                 reinterpret_cast<const char*>(entry_info.value_in_block.data()),
                 entry_info.value_in_block.size());
           }
-          // Result::OK() default constructor is fine here, value_tag_ will be kData by Slice constructor
-          // if we returned Result::OK(entry_info.value_in_block), but we don't need to for string version.
-          // Just Result::OK() is enough as data is in value_out.
-          // However, to be consistent with DB::GetInternal expectations, the Result should indicate it's data.
-          // The public DB::Get(string*) will get Result::OK() from this path, and its internal_res.value_tag_ will be kData
-          // because the value_slice IS populated by the Result(Slice) constructor.
-          // So, this should be:
-          std::cout << "[SSTableReader::Get string*] Found DATA for key " << search_key.ToString() 
-                    << ". Value copied to string." << std::endl; // DEBUG
-          return Result::OK(entry_info.value_in_block); // Pass the slice, Result ctor will set tag.
+          if (tag_out != nullptr) {
+            *tag_out = ValueTag::kData;
+          }
+          return Result::OK();
+        }
+        if (entry_info.tag == ValueTag::kBlobIndex) {
+          // value_out receives the encoded index; the caller resolves it.
+          value_out->assign(reinterpret_cast<const char*>(entry_info.value_in_block.data()),
+                            entry_info.value_in_block.size());
+          if (tag_out != nullptr) {
+            *tag_out = ValueTag::kBlobIndex;
+          }
+          return Result::OK();
         }
         return Result::Corruption("Unknown value tag encountered for key '" + search_key.ToString() + "'");
       }
-      // Optional optimization:
-      // if (entry_info.key.compare(search_key) > 0) {
-      //    return Result::NotFound(search_key.ToString() + " (not found by sorted order check)");
-      // }
+      // Keys are sorted, so once past search_key it is in no later entry or block.
+      if (cmp > 0) {
+        std::cout << "[SSTableReader::Get string*] Passed key " << search_key.ToString() << " at " << entry_info.key.ToString() << std::endl;
+        return Result::NotFound();
+      }
       offset_in_block += entry_info.entry_size_in_block; // This was missing!
     }
     current_block_disk_offset += current_block_total_size_on_disk;
   }
   std::cout << "[SSTableReader::Get string*] Key " << search_key.ToString() << " not found in any block." << std::endl;
-  return Result::NotFound(search_key.ToString() + " (not found in this SSTable)");
+  return Result::NotFound();
 }
\ No newline at end of file
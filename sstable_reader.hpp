@@ -4,17 +4,20 @@
 #include <cstdint>
 #include <fstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "arena.hpp" 
+#include "comparator.hpp"
 #include "result.hpp"
 #include "slice.hpp"
+#include "table_builder.hpp"
 #include "value.hpp"
-#include "zstd.h"
 
 struct SSTableReader {
  public:
-  explicit SSTableReader(std::string filename);
+  // `comparator` must be the one the table was written with.
+  explicit SSTableReader(std::string filename, const Comparator* comparator = BytewiseComparator());
   ~SSTableReader();
 
   SSTableReader(const SSTableReader&) = delete;
@@ -24,20 +27,50 @@ struct SSTableReader {
 
   Result Init();
   bool IsOpen() const { return is_open_; }
+  const std::string& filename() const { return filename_; }
   uint64_t FileSize() const { return file_size_; }
+  const KeyComparator& comparator() const { return comparator_; }
 
-  // Get method that copies value to an Arena if found
-  Result Get(const Slice& search_key, Arena* arena_for_value_copy);
+  // Get methods return OK with the value (and, if asked, whether it is data
+  // or a blob index), FoundTombstone for a deleted key, or a message-less
+  // NotFound when the key is not in this file.
 
-  // Get method that copies value to a std::string if found
-  Result Get(const Slice& search_key, std::string* value_out);
+  // Copies the value into the Arena; *value_out points into it.
+  Result Get(const Slice& search_key, Arena* arena_for_value_copy, Slice* value_out,
+             ValueTag* tag_out = nullptr);
 
-  // Helper to load a data block from disk and decompress it into internal_block_buffer_
+  // Copies the value into a std::string.
+  Result Get(const Slice& search_key, std::string* value_out, ValueTag* tag_out = nullptr);
+
+  // Helper to load a data block from disk and decompress it into internal_block_buffer_.
+  // Uncompressed blocks are read straight into it; compressed ones go through
+  // a per-thread scratch buffer. Both keep their memory between blocks.
+  // Returns NotFound past the last data block, including at the properties block.
   Result LoadBlockIntoBuffer(uint64_t block_offset,
                              uint64_t* block_size_on_disk_out);
 
   const std::vector<char>& GetBlockBuffer() {return internal_block_buffer_;};
 
+  // Collects the first key of every data block, in file order. Compaction uses
+  // these as candidate split points when dividing work into subcompactions.
+  Result GetBlockBoundaryKeys(std::vector<std::string>* keys_out);
+
+  // Returns the first and last key stored in the file, from the properties
+  // block when the table has one. Otherwise only block headers are read on
+  // the way to the last block, so this is cheap even for large files.
+  // Returns NotFound for a file without entries.
+  Result GetKeyRange(std::string* smallest_out, std::string* largest_out);
+
+  // Reads a property from the table's properties block, e.g.
+  // kComparatorNameProperty. Returns NotFound if the table has no properties
+  // block (it was written before they existed) or no such property.
+  Result GetProperty(const std::string& name, std::string* value_out);
+
+  // Reads every property at once, finding the properties block through the
+  // footer. Returns NotFound for a table written before the footer (format
+  // version 1) or without entries, and NotSupported for a newer format.
+  Result GetTableProperties(TableProperties* properties_out);
+
 #ifdef ENABLE_SSTABLE_READER_TEST_HOOKS
   const std::vector<char>& TEST_ONLY_get_internal_buffer_DEBUG() const {
     return internal_block_buffer_;
@@ -73,11 +106,26 @@ struct SSTableReader {
                                  size_t block_size,
                                  size_t current_offset_in_block);
 
+  // LoadBlockIntoBuffer without clearing the block buffer on failure.
+  Result ReadBlock(uint64_t block_offset, uint64_t* block_size_on_disk_out);
+
+  // Reads the footer, if the table has one, on first use.
+  Result ReadFooter();
+
+  // Offset of the properties block: from the footer, or for older tables
+  // found by hopping over the data block headers.
+  Result FindPropertiesBlock(uint64_t* offset_out);
+
+  // Every name/value pair of the properties block, in file order.
+  Result ReadProperties(std::vector<std::pair<std::string, std::string>>* properties_out);
+
   std::string filename_;
+  KeyComparator comparator_;
   std::ifstream file_stream_;
-  ZSTD_DCtx* zstd_dctx_;
   bool is_open_;
   uint64_t file_size_;
+  uint32_t format_version_;    // 0 until ReadFooter has run
+  uint64_t properties_offset_; // From the footer; format version 2 and up
   std::vector<char> internal_block_buffer_; // Stores the decompressed block data
 };
 
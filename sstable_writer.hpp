@@ -6,22 +6,13 @@
 #include <string>
 #include <vector>
 
+#include "blob_file.hpp"
 #include "mem_table.hpp" // Assumed to provide MemTable and SortedTableIterator
+#include "rate_limiter.hpp"
 #include "result.hpp"
 #include "slice.hpp"
-#include "zstd.h"
-
-inline uint32_t ReadLittleEndian32(const char* buffer) {
-    return static_cast<uint32_t>(static_cast<unsigned char>(buffer[0])) |
-           (static_cast<uint32_t>(static_cast<unsigned char>(buffer[1])) << 8) |
-           (static_cast<uint32_t>(static_cast<unsigned char>(buffer[2])) << 16) |
-           (static_cast<uint32_t>(static_cast<unsigned char>(buffer[3])) << 24);
-}
-
-namespace CompressionType {
-        static constexpr char kNoCompression = 0x00;
-        static constexpr char kZstdCompressed = 0x01;
-    }
+#include "sorted_table.hpp"
+#include "table_builder.hpp"
 
 // Forward declaration if SortedTableIterator is not fully defined via mem_table.hpp
 // class SortedTableIterator;
@@ -33,28 +24,48 @@ struct IndexEntry {
   size_t uncompressed_size;
 };
 
+// Writes a complete sorted source (a MemTable or any SortedTableIterator) to
+// one SSTable. For streaming or multi-file output use TableBuilder directly.
 struct SSTableWriter {
  public:
   SSTableWriter(bool enable_compression, int compression_level = 1,
                 size_t target_block_size = 4096);
-  ~SSTableWriter();
+  ~SSTableWriter() = default;
 
   SSTableWriter(const SSTableWriter&) = delete;
   SSTableWriter& operator=(const SSTableWriter&) = delete;
 
+  // Kept for existing callers; the compression context is created by the
+  // builder when the first file is opened.
   Result Init();
+
+  // Every block written afterwards first requests its on-disk size from
+  // `rate_limiter` at `io_priority`. nullptr (the default) disables pacing.
+  void SetRateLimiter(RateLimiter* rate_limiter, IOPriority io_priority);
+
+  // The order the source yields keys in; see TableBuilder::SetComparator.
+  void SetComparator(const Comparator* comparator) { builder_.SetComparator(comparator); }
+
+  // Values the builder chooses to separate are written to `blob_builder` and
+  // replaced by a blob index in the table. The caller finishes (or abandons)
+  // the blob builder. nullptr (the default) keeps every value inline.
+  void SetBlobFileBuilder(BlobFileBuilder* blob_builder) { blob_builder_ = blob_builder; }
+
   Result WriteMemTableToFile(const MemTable& memtable,
                                const std::string& filename);
 
+  // Writes every entry of `iter`, from its first position on, to `filename`.
+  // The iterator must yield keys in strictly increasing order.
+  Result WriteIteratorToFile(SortedTableIterator* iter,
+                             const std::string& filename);
+
+  // What the last file written recorded in its properties block.
+  const TableProperties& properties() const { return builder_.properties(); }
+
  private:
-  void AppendLittleEndian32(std::vector<char>& buf, uint32_t value);
-  void AppendBytesToBuffer(std::vector<char>& buf, const std::byte* data,
-                             size_t size);
-
-  ZSTD_CCtx* zstd_cctx_;
-  int compression_level_;
-  bool compression_enabled_;
-  size_t target_block_size_;
+  TableBuilder builder_;
+  BlobFileBuilder* blob_builder_ = nullptr;
+  std::string blob_index_buffer_;
 };
 
 #endif  // SSTABLE_WRITER_HPP
\ No newline at end of file
@@ -0,0 +1,413 @@
+#include "table_builder.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include "file_sync.hpp"
+#include "zstd_context.hpp"
+
+namespace {
+
+void AppendLittleEndian32(std::vector<char>& buf, uint32_t value) {
+  char encoded[sizeof(uint32_t)];
+  EncodeFixed32(encoded, value);
+  buf.insert(buf.end(), encoded, encoded + sizeof(encoded));
+}
+
+// Per-block tracing, including a dump of every entry, costs far more than
+// building the block; release builds skip it.
+#ifdef NDEBUG
+constexpr bool kTraceBlocks = false;
+#else
+constexpr bool kTraceBlocks = true;
+#endif
+
+// Prints every entry of a block about to be written.
+void DumpBlockEntries(const char* block, size_t size) {
+  std::cout << "  Content of buffer being flushed (parsed):" << std::endl;
+  size_t pos = 0;
+  int entries = 0;
+  while (pos < size) {
+    entries++;
+    if (pos + 4 > size) { std::cout << "    DebugParse: Ran out of data for k_len" << std::endl; break; }
+    uint32_t k_len = ReadLittleEndian32(block + pos); pos += 4;
+    if (pos + k_len > size) { std::cout << "    DebugParse: Ran out of data for key" << std::endl; break; }
+    std::string k_str(block + pos, k_len); pos += k_len;
+    if (pos + 1 > size) { std::cout << "    DebugParse: Ran out of data for tag" << std::endl; break; }
+    char tag_char = block[pos]; pos += 1;
+    if (pos + 4 > size) { std::cout << "    DebugParse: Ran out of data for v_len" << std::endl; break; }
+    uint32_t v_len = ReadLittleEndian32(block + pos); pos += 4;
+    if (pos + v_len > size) { std::cout << "    DebugParse: Ran out of data for value" << std::endl; break; }
+    pos += v_len;
+    std::cout << "    Entry " << entries << ": Key='" << k_str
+              << "', Tag=" << static_cast<int>(static_cast<ValueTag>(tag_char))
+              << ", ValLen=" << v_len << std::endl;
+  }
+  std::cout << "  Total entries debug-parsed in this block: " << entries << std::endl;
+}
+
+} // namespace
+
+void BlockBuffer::Reserve(size_t capacity) {
+  if (capacity <= capacity_) {
+    return;
+  }
+  std::unique_ptr<char[]> grown(new char[capacity]);
+  if (size_ > 0) {
+    std::memcpy(grown.get(), data_.get(), size_);
+  }
+  data_ = std::move(grown);
+  capacity_ = capacity;
+}
+
+TableBuilder::TableBuilder(bool enable_compression, int compression_level,
+                           size_t target_block_size)
+    : compression_level_(compression_level),
+      compression_enabled_(enable_compression),
+      target_block_size_(target_block_size > 0 ? target_block_size : 4096),
+      rate_limiter_(nullptr),
+      io_priority_(IOPriority::kHigh),
+      is_open_(false),
+      num_entries_(0),
+      bytes_written_(0) {
+  // A block closes with the entry that reaches the target, so leave room for
+  // one more modest entry before growing.
+  block_buffer_.Reserve(2 * target_block_size_);
+}
+
+TableBuilder::~TableBuilder() {
+  // A file that was never finished is incomplete; don't leave it around where
+  // it could be mistaken for a valid table.
+  if (is_open_) {
+    Abandon();
+  }
+}
+
+void TableBuilder::SetRateLimiter(RateLimiter* rate_limiter, IOPriority io_priority) {
+  rate_limiter_ = rate_limiter;
+  io_priority_ = io_priority;
+}
+
+Result TableBuilder::Open(const std::string& filename) {
+  if (is_open_) {
+    return Result::NotSupported("TableBuilder: Open called while '" + filename_ + "' is still being built.");
+  }
+  if (compression_enabled_ && ThreadLocalZstdCCtx() == nullptr) {
+    return Result::IOError("TableBuilder: Failed to create ZSTD compression context.");
+  }
+  out_file_.open(filename, std::ios::binary | std::ios::trunc);
+  if (!out_file_.is_open()) {
+    std::cerr << "[TableBuilder::Open] ERROR: Failed to open SSTable file for writing: " << filename << std::endl;
+    return Result::IOError("TableBuilder: Failed to open SSTable file for writing: " + filename);
+  }
+  filename_ = filename;
+  is_open_ = true;
+  block_buffer_.Reset();
+  last_key_.clear();
+  num_entries_ = 0;
+  bytes_written_ = 0;
+  properties_ = TableProperties();
+  std::cout << "[TableBuilder::Open] Building " << filename_ << ", TargetBlockSize: " << target_block_size_ << std::endl;
+  return Result::OK();
+}
+
+Result TableBuilder::Add(const Slice& key, const ValueEntry& value_entry) {
+  if (!is_open_) {
+    return Result::NotSupported("TableBuilder: no file is open.");
+  }
+  Slice last_key_slice(reinterpret_cast<const std::byte*>(last_key_.data()), last_key_.size());
+  if (num_entries_ > 0 && comparator_.Compare(key, last_key_slice) <= 0) {
+    return Result::InvalidArgument("TableBuilder: keys must be added in strictly increasing order ('" +
+                                   key.ToString() + "' after '" + last_key_ + "').");
+  }
+
+  AppendEntry(key, value_entry);
+  if (num_entries_ == 0) {
+    properties_.smallest_key.assign(reinterpret_cast<const char*>(key.data()), key.size());
+  }
+  last_key_.assign(reinterpret_cast<const char*>(key.data()), key.size());
+  num_entries_++;
+  properties_.raw_key_bytes += key.size();
+  if (value_entry.IsTombstone()) {
+    properties_.num_tombstones++;
+  } else {
+    properties_.raw_value_bytes += value_entry.value_slice.size();
+  }
+
+  if (block_buffer_.size() >= target_block_size_) {
+    return WriteBlock();
+  }
+  return Result::OK();
+}
+
+Result TableBuilder::Finish() {
+  if (!is_open_) {
+    return Result::NotSupported("TableBuilder: no file is open.");
+  }
+  if (!block_buffer_.empty()) {
+    Result write_res = WriteBlock();
+    if (!write_res.ok()) {
+      return write_res;
+    }
+  }
+  if (num_entries_ > 0) {
+    Result props_res = WritePropertiesBlock();
+    if (!props_res.ok()) {
+      return props_res;
+    }
+  }
+  out_file_.close();
+  is_open_ = false;
+  if (out_file_.fail()) {
+    std::cerr << "[TableBuilder::Finish] ERROR: Error reported after closing SSTable file: " << filename_ << std::endl;
+    return Result::IOError("TableBuilder: Error reported after closing SSTable file: " + filename_);
+  }
+  // A manifest may name the table as soon as this returns.
+  Result sync_res = SyncFile(filename_);
+  if (!sync_res.ok()) {
+    return sync_res;
+  }
+  std::cout << "[TableBuilder::Finish] Wrote " << num_entries_ << " entries, " << bytes_written_
+            << " bytes to " << filename_ << std::endl;
+  return Result::OK();
+}
+
+void TableBuilder::Abandon() {
+  if (!is_open_) {
+    return;
+  }
+  out_file_.close();
+  out_file_.clear();
+  is_open_ = false;
+  block_buffer_.Reset();
+  std::error_code ec;
+  std::filesystem::remove(filename_, ec);
+  std::cout << "[TableBuilder::Abandon] Discarded " << filename_ << std::endl;
+}
+
+void TableBuilder::AppendEntry(const Slice& key, const ValueEntry& value_entry) {
+  const uint32_t key_size = static_cast<uint32_t>(key.size());
+  uint32_t value_size = 0;
+  if (!value_entry.IsTombstone()) {
+    value_size = static_cast<uint32_t>(value_entry.value_slice.size());
+  }
+
+  // key size, key, type byte, value size, value
+  char* dst = block_buffer_.Extend(sizeof(uint32_t) + key_size + 1 + sizeof(uint32_t) + value_size);
+  EncodeFixed32(dst, key_size);
+  dst += sizeof(uint32_t);
+  if (key_size > 0) {
+    std::memcpy(dst, key.data(), key_size);
+    dst += key_size;
+  }
+  *dst++ = static_cast<char>(value_entry.type);
+  EncodeFixed32(dst, value_size);
+  dst += sizeof(uint32_t);
+  if (value_size > 0) {
+    std::memcpy(dst, value_entry.value_slice.data(), value_size);
+  }
+}
+
+Result TableBuilder::WriteBlock() {
+  uint32_t uncompressed_size = static_cast<uint32_t>(block_buffer_.size());
+  if (kTraceBlocks) {
+    std::cout << "------------------------------------------------------------\n"
+              << "[TableBuilder::WriteBlock] FLUSHING BLOCK START\n"
+              << "  Target Block Size for writer: " << target_block_size_ << "\n"
+              << "  Current Data Block Buffer Size (uncompressed): " << uncompressed_size << std::endl;
+    DumpBlockEntries(block_buffer_.data(), uncompressed_size);
+  }
+
+  const char* data_to_write_ptr = block_buffer_.data();
+  uint32_t on_disk_size = uncompressed_size;
+  char current_compression_flag = CompressionType::kNoCompression;
+
+  ZSTD_CCtx* cctx = compression_enabled_ && uncompressed_size > 0 ? ThreadLocalZstdCCtx() : nullptr;
+  if (cctx != nullptr) {
+    size_t estimated_compressed_bound = ZSTD_compressBound(uncompressed_size);
+    if (compressed_buffer_.size() < estimated_compressed_bound) {
+         compressed_buffer_.resize(estimated_compressed_bound);
+    }
+
+    size_t actual_compressed_size_zstd = ZSTD_compressCCtx(
+        cctx, compressed_buffer_.data(), compressed_buffer_.size(),
+        block_buffer_.data(), uncompressed_size,
+        compression_level_);
+
+    if (!ZSTD_isError(actual_compressed_size_zstd) && actual_compressed_size_zstd < uncompressed_size) {
+        on_disk_size = static_cast<uint32_t>(actual_compressed_size_zstd);
+        data_to_write_ptr = compressed_buffer_.data();
+        current_compression_flag = CompressionType::kZstdCompressed;
+    } else if (kTraceBlocks) {
+        std::cout << "[TableBuilder::WriteBlock]   Compression did not reduce size or failed: "
+                  << (ZSTD_isError(actual_compressed_size_zstd) ? ZSTD_getErrorName(actual_compressed_size_zstd) : "No size reduction")
+                  << ". Writing uncompressed." << std::endl;
+    }
+  }
+
+  char header[kBlockHeaderSize];
+  EncodeFixed32(header, uncompressed_size);
+  EncodeFixed32(header + sizeof(uint32_t), on_disk_size);
+  header[2 * sizeof(uint32_t)] = current_compression_flag;
+
+  if (rate_limiter_ != nullptr) {
+    rate_limiter_->Request(static_cast<int64_t>(sizeof(header) + on_disk_size), io_priority_);
+  }
+
+  if (kTraceBlocks) {
+    std::cout << "[TableBuilder::WriteBlock]   Writing block header: uncomp=" << uncompressed_size
+              << ", on_disk=" << on_disk_size << ", flag=" << static_cast<int>(current_compression_flag) << std::endl;
+  }
+  out_file_.write(header, sizeof(header));
+  if (!out_file_) {
+    std::cerr << "[TableBuilder::WriteBlock] ERROR: Failed to write block header to file: " << filename_ << std::endl;
+    block_buffer_.Reset();
+    return Result::IOError("TableBuilder: Failed to write block header to file: " + filename_);
+  }
+
+  if (on_disk_size > 0) {
+    out_file_.write(data_to_write_ptr, on_disk_size);
+    if (!out_file_) {
+        std::cerr << "[TableBuilder::WriteBlock] ERROR: Failed to write block data payload to file: " << filename_ << std::endl;
+        block_buffer_.Reset();
+        return Result::IOError("TableBuilder: Failed to write block data payload to file: " + filename_);
+    }
+  }
+  if (kTraceBlocks) {
+    std::cout << "[TableBuilder::WriteBlock] FLUSHING BLOCK END" << std::endl;
+  }
+  bytes_written_ += sizeof(header) + on_disk_size;
+  properties_.num_data_blocks++;
+  block_buffer_.Reset(); // Keep the memory for the next block
+  return Result::OK();
+}
+
+Result TableBuilder::WritePropertiesBlock() {
+  const uint64_t properties_offset = bytes_written_;
+  properties_.format_version = kTableFormatVersion;
+  properties_.num_entries = num_entries_;
+  properties_.data_bytes = bytes_written_;
+  properties_.largest_key = last_key_;
+  properties_.compression = compression_enabled_ ? "zstd" : "none";
+  properties_.comparator_name = comparator_.Name();
+
+  std::vector<char> block;
+  auto append_string = [&block](const char* value, size_t size) {
+    AppendLittleEndian32(block, static_cast<uint32_t>(size));
+    block.insert(block.end(), value, value + size);
+  };
+  auto append_property = [&append_string](const char* name, const std::string& value) {
+    append_string(name, std::strlen(name));
+    append_string(value.data(), value.size());
+  };
+  auto append_number = [&append_string](const char* name, uint64_t value) {
+    char encoded[sizeof(uint64_t)];
+    EncodeFixed64(encoded, value);
+    append_string(name, std::strlen(name));
+    append_string(encoded, sizeof(encoded));
+  };
+  append_property(kComparatorNameProperty, properties_.comparator_name);
+  append_number(kNumEntriesProperty, properties_.num_entries);
+  append_number(kNumTombstonesProperty, properties_.num_tombstones);
+  append_number(kNumDataBlocksProperty, properties_.num_data_blocks);
+  append_number(kRawKeyBytesProperty, properties_.raw_key_bytes);
+  append_number(kRawValueBytesProperty, properties_.raw_value_bytes);
+  append_number(kDataBytesProperty, properties_.data_bytes);
+  append_property(kSmallestKeyProperty, properties_.smallest_key);
+  append_property(kLargestKeyProperty, properties_.largest_key);
+  append_property(kCompressionProperty, properties_.compression);
+
+  char header[kBlockHeaderSize];
+  EncodeFixed32(header, static_cast<uint32_t>(block.size()));
+  EncodeFixed32(header + sizeof(uint32_t), static_cast<uint32_t>(block.size()));
+  header[2 * sizeof(uint32_t)] = kPropertiesBlockFlag;
+  if (rate_limiter_ != nullptr) {
+    rate_limiter_->Request(static_cast<int64_t>(sizeof(header) + block.size()), io_priority_);
+  }
+  out_file_.write(header, sizeof(header));
+  out_file_.write(block.data(), static_cast<std::streamsize>(block.size()));
+  if (!out_file_) {
+    return Result::IOError("TableBuilder: Failed to write properties block to file: " + filename_);
+  }
+  bytes_written_ += sizeof(header) + block.size();
+  return WriteFooter(properties_offset);
+}
+
+Result TableBuilder::WriteFooter(uint64_t properties_offset) {
+  char footer[kTableFooterSize];
+  EncodeFixed64(footer, properties_offset);
+  EncodeFixed32(footer + 8, kTableFormatVersion);
+  EncodeFixed64(footer + 12, kTableMagicNumber);
+  if (rate_limiter_ != nullptr) {
+    rate_limiter_->Request(static_cast<int64_t>(sizeof(footer)), io_priority_);
+  }
+  out_file_.write(footer, sizeof(footer));
+  if (!out_file_) {
+    return Result::IOError("TableBuilder: Failed to write footer to file: " + filename_);
+  }
+  bytes_written_ += sizeof(footer);
+  return Result::OK();
+}
+
+RollingTableBuilder::RollingTableBuilder(bool enable_compression, uint64_t target_file_size,
+                                         std::function<FileMetaData()> new_output)
+    : builder_(enable_compression),
+      target_file_size_(target_file_size > 0 ? target_file_size : 1),
+      new_output_(std::move(new_output)) {}
+
+void RollingTableBuilder::SetRateLimiter(RateLimiter* rate_limiter, IOPriority io_priority) {
+  builder_.SetRateLimiter(rate_limiter, io_priority);
+}
+
+Result RollingTableBuilder::Add(const Slice& key, const ValueEntry& value_entry) {
+  if (!builder_.IsOpen()) {
+    current_ = new_output_();
+    Result open_res = builder_.Open(current_.path);
+    if (!open_res.ok()) {
+      return open_res;
+    }
+  }
+  Result add_res = builder_.Add(key, value_entry);
+  if (!add_res.ok()) {
+    return add_res;
+  }
+  if (builder_.FileSize() >= target_file_size_) {
+    return FinishCurrentFile();
+  }
+  return Result::OK();
+}
+
+Result RollingTableBuilder::Finish() {
+  if (!builder_.IsOpen()) {
+    return Result::OK();
+  }
+  return FinishCurrentFile();
+}
+
+Result RollingTableBuilder::FinishCurrentFile() {
+  Result finish_res = builder_.Finish();
+  if (!finish_res.ok()) {
+    std::error_code ec;
+    std::filesystem::remove(current_.path, ec);
+    return finish_res;
+  }
+  current_.file_size = builder_.FileSize();
+  if (builder_.properties().num_entries > 0) {
+    current_.has_key_range = true;
+    current_.smallest_key = builder_.properties().smallest_key;
+    current_.largest_key = builder_.properties().largest_key;
+  }
+  outputs_.push_back(std::move(current_));
+  current_ = FileMetaData();
+  return Result::OK();
+}
+
+void RollingTableBuilder::Abandon() {
+  builder_.Abandon();
+  for (const FileMetaData& output : outputs_) {
+    std::error_code ec;
+    std::filesystem::remove(output.path, ec);
+  }
+  outputs_.clear();
+}
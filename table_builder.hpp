@@ -0,0 +1,222 @@
+#ifndef TABLE_BUILDER_HPP
+#define TABLE_BUILDER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "coding.hpp"
+#include "comparator.hpp"
+#include "rate_limiter.hpp"
+#include "result.hpp"
+#include "slice.hpp"
+#include "value.hpp"
+#include "version_edit.hpp"
+
+namespace CompressionType {
+        static constexpr char kNoCompression = 0x00;
+        static constexpr char kZstdCompressed = 0x01;
+    }
+
+// Stored in the compression flag byte of a table's last block. That block is
+// never compressed and holds the table's properties, as LE32 length-prefixed
+// name/value pairs, instead of entries. Readers stop at it.
+inline constexpr char kPropertiesBlockFlag = 0x50;
+
+// Every table with entries ends in a footer of kTableFooterSize bytes:
+//   LE64 offset of the properties block
+//   LE32 format version
+//   LE64 kTableMagicNumber
+// Tables written before the footer existed end right after their properties
+// block (or their last data block); readers treat them as format version 1.
+inline constexpr uint64_t kTableMagicNumber = 0x88e241b785f4cff7ull;
+inline constexpr uint32_t kTableFormatVersion = 2;
+inline constexpr size_t kTableFooterSize = 2 * sizeof(uint64_t) + sizeof(uint32_t);
+
+// Properties. Counts and sizes are stored as LE64, the rest as raw bytes.
+// Name of the comparator the table's keys are ordered by.
+inline constexpr char kComparatorNameProperty[] = "lsm.comparator";
+inline constexpr char kNumEntriesProperty[] = "lsm.num.entries";
+inline constexpr char kNumTombstonesProperty[] = "lsm.num.tombstones";
+inline constexpr char kNumDataBlocksProperty[] = "lsm.num.data.blocks";
+inline constexpr char kRawKeyBytesProperty[] = "lsm.raw.key.bytes";
+inline constexpr char kRawValueBytesProperty[] = "lsm.raw.value.bytes";
+// Data blocks as stored, headers included: the compressed size of the keys
+// and values, which share blocks and are compressed together.
+inline constexpr char kDataBytesProperty[] = "lsm.data.bytes";
+inline constexpr char kSmallestKeyProperty[] = "lsm.smallest.key";
+inline constexpr char kLargestKeyProperty[] = "lsm.largest.key";
+// "zstd" or "none": what the builder was configured with. A block zstd
+// could not shrink is still stored uncompressed.
+inline constexpr char kCompressionProperty[] = "lsm.compression";
+
+// What a table's properties block records about it, so compaction and tools
+// can learn about a file without scanning its blocks.
+struct TableProperties {
+  uint32_t format_version = 0;
+  uint64_t num_entries = 0;
+  uint64_t num_tombstones = 0;
+  uint64_t num_data_blocks = 0;
+  uint64_t raw_key_bytes = 0;
+  uint64_t raw_value_bytes = 0; // Blob indexes count as their own size
+  uint64_t data_bytes = 0;
+  std::string smallest_key;
+  std::string largest_key;
+  std::string compression;
+  std::string comparator_name;
+};
+
+// Every block starts with LE32 uncompressed size, LE32 on-disk size and the
+// compression flag byte.
+inline constexpr size_t kBlockHeaderSize = 2 * sizeof(uint32_t) + sizeof(char);
+
+// The bytes of the block being built. Its memory outlives the block: Reset
+// only rewinds it, so a builder streaming similar blocks allocates once and
+// entries are encoded straight into place.
+class BlockBuffer {
+ public:
+  BlockBuffer() = default;
+
+  BlockBuffer(const BlockBuffer&) = delete;
+  BlockBuffer& operator=(const BlockBuffer&) = delete;
+
+  void Reserve(size_t capacity);
+
+  // Appends `n` uninitialized bytes and returns where they start.
+  char* Extend(size_t n) {
+    if (capacity_ - size_ < n) {
+      Reserve(std::max(size_ + n, 2 * capacity_));
+    }
+    char* dst = data_.get() + size_;
+    size_ += n;
+    return dst;
+  }
+
+  void Reset() { size_ = 0; }
+
+  const char* data() const { return data_.get(); }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  std::unique_ptr<char[]> data_;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+};
+
+// Streams sorted entries into a single SSTable file, one block at a time.
+// Flush, compaction and SstFileWriter all produce their tables through this.
+//
+//   TableBuilder builder(true /* compression */);
+//   builder.Open(path);
+//   builder.Add(key, value_entry);  // keys strictly increasing
+//   builder.Finish();               // or Abandon() to discard the file
+//
+// Keys are ordered by the comparator given to SetComparator (bytewise by
+// default); its name is written to the table's properties block.
+//
+// A builder can be reopened for another file after Finish() or Abandon(); the
+// block buffers are reused. Compression uses the thread's zstd context (see
+// zstd_context.hpp).
+struct TableBuilder {
+ public:
+  TableBuilder(bool enable_compression, int compression_level = 1,
+               size_t target_block_size = 4096);
+  ~TableBuilder();
+
+  TableBuilder(const TableBuilder&) = delete;
+  TableBuilder& operator=(const TableBuilder&) = delete;
+
+  // Every block written afterwards first requests its on-disk size from
+  // `rate_limiter` at `io_priority`. nullptr (the default) disables pacing.
+  void SetRateLimiter(RateLimiter* rate_limiter, IOPriority io_priority);
+
+  // Applies to files opened afterwards.
+  void SetComparator(const Comparator* comparator) { comparator_ = KeyComparator(comparator); }
+
+  Result Open(const std::string& filename);
+
+  // Returns InvalidArgument if `key` does not sort strictly after the
+  // previously added key.
+  Result Add(const Slice& key, const ValueEntry& value_entry);
+
+  // Writes the pending block, the properties block and the footer, and
+  // closes the file. A file without entries is left empty on disk.
+  Result Finish();
+
+  // Closes and removes the file being built.
+  void Abandon();
+
+  bool IsOpen() const { return is_open_; }
+  uint64_t NumEntries() const { return num_entries_; }
+  // What the last finished file recorded in its properties block.
+  const TableProperties& properties() const { return properties_; }
+  // Bytes written so far plus the pending, not yet compressed block.
+  uint64_t FileSize() const { return bytes_written_ + block_buffer_.size(); }
+  const std::string& filename() const { return filename_; }
+
+ private:
+  void AppendEntry(const Slice& key, const ValueEntry& value_entry);
+  Result WriteBlock();
+  Result WritePropertiesBlock();
+  Result WriteFooter(uint64_t properties_offset);
+
+  int compression_level_;
+  bool compression_enabled_;
+  size_t target_block_size_;
+  RateLimiter* rate_limiter_;
+  IOPriority io_priority_;
+  KeyComparator comparator_;
+
+  std::ofstream out_file_;
+  std::string filename_;
+  bool is_open_;
+  BlockBuffer block_buffer_;
+  std::vector<char> compressed_buffer_;
+  std::string last_key_;
+  uint64_t num_entries_;
+  uint64_t bytes_written_;
+  TableProperties properties_;
+};
+
+// Writes one sorted stream into a sequence of files of roughly
+// `target_file_size` bytes each, starting a new file whenever the current one
+// reaches the target. `new_output` supplies the number and path of each file.
+struct RollingTableBuilder {
+ public:
+  RollingTableBuilder(bool enable_compression, uint64_t target_file_size,
+                      std::function<FileMetaData()> new_output);
+
+  RollingTableBuilder(const RollingTableBuilder&) = delete;
+  RollingTableBuilder& operator=(const RollingTableBuilder&) = delete;
+
+  void SetRateLimiter(RateLimiter* rate_limiter, IOPriority io_priority);
+  void SetComparator(const Comparator* comparator) { builder_.SetComparator(comparator); }
+
+  Result Add(const Slice& key, const ValueEntry& value_entry);
+
+  // Finishes the file currently being written, if any.
+  Result Finish();
+
+  // Abandons the current file and removes every file finished so far.
+  void Abandon();
+
+  // Finished files in key order, with file_size filled in.
+  const std::vector<FileMetaData>& outputs() const { return outputs_; }
+
+ private:
+  Result FinishCurrentFile();
+
+  TableBuilder builder_;
+  uint64_t target_file_size_;
+  std::function<FileMetaData()> new_output_;
+  FileMetaData current_;
+  std::vector<FileMetaData> outputs_;
+};
+
+#endif // TABLE_BUILDER_HPP
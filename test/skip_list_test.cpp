@@ -3,10 +3,14 @@
 #include "test_utils.hpp" // Include the test utilities header
 #include "arena.hpp"
 
+#include <atomic>
+#include <cstdio>
 #include <string>
+#include <thread>
 #include <vector>
 #include <map>
 #include <memory>
+#include <random>
 
 namespace lsm_project {
 
@@ -20,7 +24,7 @@ class SkipListTest : public ::testing::Test {
  protected:
   static constexpr size_t kArenaSize = 1024 * 1024; // 1MB Arena for tests
   Arena arena_;
-  SkipList list_; // Uses the map-backed placeholder SkipList for now
+  SkipList list_;
 
   SkipListTest() : arena_(kArenaSize), list_(arena_) {}
 
@@ -30,38 +34,17 @@ class SkipListTest : public ::testing::Test {
   }
 
   Result GetString(const std::string& k, std::string* value_out_str = nullptr) {
-    Result r = list_.Get(Slice(k)); // list_.Get() is SkipList::Get()
-
-    std::cout << "[SkipListTest::GetString] For key '" << k << "', list_.Get() result: ok=" << r.ok()
-              << ", code=" << static_cast<int>(r.code()) << ", msg='" << r.message()
-              << "', has_slice=" << r.value_slice().has_value()
-              << ", tag=" << (r.value_tag().has_value() ? static_cast<int>(r.value_tag().value()) : -1)
-              << std::endl; // DEBUG
-
-    if (r.ok()) {
-        // Check if it's a tombstone first
-        if (r.value_tag().has_value() && r.value_tag().value() == ValueTag::kTombstone) {
-            std::cout << "[SkipListTest::GetString] Detected TOMBSTONE for key '" << k << "'. Returning NotFound." << std::endl; //DEBUG
-            // It's a tombstone. For the purpose of GetString returning a value, this means "not found".
-            return Result::NotFound("Key '" + k + "' is a tombstone in SkipList");
-        }
-        
-        // If it's OK and not a tombstone, it must be data and have a value_slice AND data tag.
-        if (r.value_slice().has_value() && r.value_tag().has_value() && r.value_tag().value() == ValueTag::kData) {
-            if (value_out_str) {
-                *value_out_str = r.value_slice().value().ToString();
-            }
-            // Return the original 'r' because it's already a valid OK_Data result
-            return r; 
-        } else {
-            // This path means r.ok() is true, but it's not a tombstone and not valid data.
-            std::cout << "[SkipListTest::GetString] Corruption: OK but not Tombstone and not valid Data for key '" << k << "'" << std::endl; //DEBUG
-            return Result::Corruption(
-                "Internal error in GetString for key '" + k +
-                "': Get() returned OK but not valid data or tombstone. Original Result: " + r.ToString());
-        }
+    Slice value;
+    Result r = list_.Get(Slice(k), &value); // list_.Get() is SkipList::Get()
+
+    if (r.IsTombstone()) {
+        // For the purpose of GetString returning a value, a tombstone means "not found".
+        return Result::NotFound("Key '" + k + "' is a tombstone in SkipList");
     }
-    return r; // Return original result if not r.ok() initially (e.g. kNotFound from SkipList::Get)
+    if (r.ok() && value_out_str) {
+        *value_out_str = value.ToString();
+    }
+    return r;
 }
 };
 
@@ -71,10 +54,8 @@ TEST_F(SkipListTest, EmptyList) {
     Result r = GetString("any_key", &val_str);
     ASSERT_FALSE(r.ok());
     ASSERT_EQ(r.code(), ResultCode::kNotFound);
-    // For the map-backed SkipList, ApproximateMemoryUsage should be the size of the
-    // SkipList object itself plus arena usage (which should be minimal or zero if
-    // the constructor doesn't allocate anything from the arena by default).
-    // The placeholder doesn't have a head_ node in the arena like a real skip list.
+    // ApproximateMemoryUsage is the SkipList object itself plus arena usage,
+    // which for an empty list is just the head node.
     size_t expected_empty_usage = sizeof(SkipList) + arena_.GetTotalBytesUsed();
     ASSERT_EQ(list_.ApproximateMemoryUsage(), expected_empty_usage);
 }
@@ -255,12 +236,109 @@ TEST_F(SkipListTest, IteratorSeekToFirstThenNext) {
 }
 
 
+TEST_F(SkipListTest, KeysSharingInlinePrefix_StayOrdered) {
+    // Keys that tie on their first 8 bytes, or are prefixes of each other,
+    // must be told apart by their full bytes.
+    std::vector<std::string> keys = {"prefix00", "prefix00a", "prefix00b", "prefix0", "prefix00\xff",
+                                     "prefix01", "p", "prefix00aa"};
+    for (const std::string& k : keys) {
+        PutString(k, "v_" + k);
+    }
+    std::map<std::string, std::string> expected;
+    for (const std::string& k : keys) {
+        expected[k] = "v_" + k;
+    }
+
+    std::unique_ptr<SortedTableIterator> iter(list_.NewIterator());
+    auto it = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+        ASSERT_NE(it, expected.end());
+        EXPECT_EQ(iter->key().ToString(), it->first);
+        EXPECT_EQ(iter->value().value_slice.ToString(), it->second);
+    }
+    EXPECT_EQ(it, expected.end());
+
+    iter->Seek(Slice("prefix00ab"));
+    ASSERT_TRUE(iter->Valid());
+    EXPECT_EQ(iter->key().ToString(), "prefix00b");
+    EXPECT_EQ(GetString("prefix00c").code(), ResultCode::kNotFound);
+}
+
+TEST_F(SkipListTest, ManyRandomKeys_MatchOrderedMap) {
+    std::mt19937 rng(1234);
+    std::map<std::string, std::string> expected;
+    for (int i = 0; i < 5000; ++i) {
+        std::string key = "k" + std::to_string(rng() % 3000);
+        std::string value = "v" + std::to_string(i);
+        PutString(key, value);
+        expected[key] = value;
+    }
+
+    std::unique_ptr<SortedTableIterator> iter(list_.NewIterator());
+    size_t count = 0;
+    auto it = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it, ++count) {
+        ASSERT_NE(it, expected.end());
+        ASSERT_EQ(iter->key().ToString(), it->first);
+        ASSERT_EQ(iter->value().value_slice.ToString(), it->second);
+    }
+    EXPECT_EQ(count, expected.size());
+}
+
+TEST_F(SkipListTest, ReaderRunsConcurrentlyWithWriter) {
+    constexpr int kKeys = 20000;
+    std::atomic<bool> done{false};
+    std::atomic<bool> reader_ok{true};
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            std::unique_ptr<SortedTableIterator> iter(list_.NewIterator());
+            std::string previous;
+            for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+                std::string key = iter->key().ToString();
+                if (!previous.empty() && key <= previous) {
+                    reader_ok.store(false);
+                }
+                previous = std::move(key);
+            }
+        }
+    });
+    for (int i = 0; i < kKeys; ++i) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "key%07d", (i * 7919) % kKeys);
+        PutString(key, "v");
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    EXPECT_TRUE(reader_ok.load());
+    EXPECT_TRUE(GetString("key0012345").ok());
+}
+
+TEST_F(SkipListTest, OverwriteStoresOnlyTheValue) {
+    const std::string key(100, 'k');
+    PutString(key, "v1");
+    size_t used = arena_.GetTotalBytesUsed();
+    PutString(key, "v2");
+    size_t overwrite_bytes = arena_.GetTotalBytesUsed() - used;
+    EXPECT_LT(overwrite_bytes, key.size()) << "The key must not be copied again.";
+
+    used = arena_.GetTotalBytesUsed();
+    ASSERT_TRUE(list_.Delete(Slice(key)).ok());
+    ASSERT_TRUE(list_.Delete(Slice(key)).ok());
+    EXPECT_EQ(arena_.GetTotalBytesUsed(), used) << "Tombstones over existing keys allocate nothing.";
+    EXPECT_EQ(GetString(key).code(), ResultCode::kNotFound);
+
+    PutString(key, "v3");
+    std::string value;
+    ASSERT_TRUE(GetString(key, &value).ok());
+    EXPECT_EQ(value, "v3");
+}
+
+
 // Test with a different max_height to ensure flexibility
-// (This mostly tests constructor API compatibility for the placeholder)
 class SkipListCustomHeightTest : public ::testing::Test {
  protected:
   Arena arena_;
-  SkipList list_; // Placeholder SkipList
+  SkipList list_;
 
   SkipListCustomHeightTest() : arena_(1024*1024), list_(arena_, 4 /* max_height=4 */, 0.5 /* probability */) {}
 };
@@ -277,11 +355,11 @@ TEST_F(SkipListCustomHeightTest, PutAndGetWithLowMaxHeight) {
         std::string key = "key" + std::to_string(i);
         std::string expected_val = "val" + std::to_string(i);
         std::string actual_val_str;
-        Result r_get = list_.Get(Slice(key)); // Call Get from the list_ member
-        
+        Slice value;
+        Result r_get = list_.Get(Slice(key), &value); // Call Get from the list_ member
+
         ASSERT_TRUE(r_get.ok()) << "Failed for key: " << key << ". Result: " << r_get.ToString();
-        ASSERT_TRUE(r_get.value_slice().has_value()) << "No value slice for key: " << key;
-        actual_val_str = r_get.value_slice().value().ToString();
+        actual_val_str = value.ToString();
         ASSERT_EQ(actual_val_str, expected_val);
     }
 }
@@ -347,4 +425,73 @@ TEST_F(SkipListTest, IteratorShowsTombstones) {
     ASSERT_FALSE(iter->Valid());
 }
 
+// Skip list with in-place updates enabled.
+class SkipListInPlaceTest : public ::testing::Test {
+ protected:
+  Arena arena_;
+  SkipList list_;
+
+  SkipListInPlaceTest()
+      : arena_(1024 * 1024),
+        list_(arena_, SkipList::kDefaultMaxHeight, SkipList::kDefaultProbability, BytewiseComparator(), true) {}
+
+  std::string GetValue(const std::string& k) {
+    Slice value;
+    Result r = list_.Get(Slice(k), &value);
+    return r.ok() ? value.ToString() : "<" + r.ToString() + ">";
+  }
+};
+
+TEST_F(SkipListInPlaceTest, OverwritesThatFitDoNotGrowArena) {
+    ASSERT_TRUE(list_.Put(Slice("counter"), Slice("00000000")).ok());
+    size_t used = arena_.GetTotalBytesUsed();
+    for (int i = 1; i <= 1000; ++i) {
+        char value[16];
+        std::snprintf(value, sizeof(value), "%08d", i);
+        ASSERT_TRUE(list_.Put(Slice("counter"), Slice(std::string(value))).ok());
+    }
+    EXPECT_EQ(arena_.GetTotalBytesUsed(), used);
+    EXPECT_EQ(GetValue("counter"), "00001000");
+
+    // Shorter values reuse the slot too; the iterator sees the current length.
+    ASSERT_TRUE(list_.Put(Slice("counter"), Slice("7")).ok());
+    EXPECT_EQ(arena_.GetTotalBytesUsed(), used);
+    std::unique_ptr<SortedTableIterator> iter(list_.NewIterator());
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    EXPECT_EQ(iter->value().value_slice.ToString(), "7");
+
+    // A longer value, and a write after a delete, need a new slot.
+    ASSERT_TRUE(list_.Put(Slice("counter"), Slice("0123456789")).ok());
+    EXPECT_GT(arena_.GetTotalBytesUsed(), used);
+    EXPECT_EQ(GetValue("counter"), "0123456789");
+    ASSERT_TRUE(list_.Delete(Slice("counter")).ok());
+    std::string copy;
+    EXPECT_TRUE(list_.GetValueCopy(Slice("counter"), &copy).IsTombstone());
+    ASSERT_TRUE(list_.Put(Slice("counter"), Slice("1")).ok());
+    EXPECT_EQ(GetValue("counter"), "1");
+}
+
+TEST_F(SkipListInPlaceTest, GetValueCopyNeverSeesTornValues) {
+    const std::string a(64, 'a');
+    const std::string b(64, 'b');
+    ASSERT_TRUE(list_.Put(Slice("k"), Slice(a)).ok());
+    std::atomic<bool> done{false};
+    std::atomic<bool> torn{false};
+    std::thread reader([&] {
+        std::string value;
+        while (!done.load(std::memory_order_acquire)) {
+            if (!list_.GetValueCopy(Slice("k"), &value).ok() || (value != a && value != b)) {
+                torn.store(true);
+            }
+        }
+    });
+    for (int i = 0; i < 200000; ++i) {
+        ASSERT_TRUE(list_.Put(Slice("k"), Slice(i % 2 == 0 ? b : a)).ok());
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    EXPECT_FALSE(torn.load());
+}
+
 } // namespace lsm_project
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+#include "adaptive_radix_tree.hpp"
+#include "mem_table_factory.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class AdaptiveRadixTreeTest : public TempDirTest {
+protected:
+    AdaptiveRadixTreeTest() : TempDirTest("test_art_temp_dir") {}
+
+    std::unique_ptr<AdaptiveRadixTree> tree_;
+
+    void SetUp() override {
+        TempDirTest::SetUp();
+        tree_ = std::make_unique<AdaptiveRadixTree>(*op_arena_);
+    }
+
+    void TearDown() override {
+        tree_.reset();
+        TempDirTest::TearDown();
+    }
+
+    std::string GetOrStatus(const std::string& key) {
+        Slice value;
+        Result res = tree_->Get(StrToSlice(key), &value);
+        if (res.IsTombstone()) return "<tombstone>";
+        return res.ok() ? value.ToString() : "<not found>";
+    }
+
+    std::vector<std::string> Keys() {
+        std::vector<std::string> keys;
+        std::unique_ptr<SortedTableIterator> it(tree_->NewIterator());
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            keys.push_back(it->key().ToString());
+        }
+        return keys;
+    }
+
+    std::string SeekKey(const std::string& target) {
+        std::unique_ptr<SortedTableIterator> it(tree_->NewIterator());
+        it->Seek(StrToSlice(target));
+        return it->Valid() ? it->key().ToString() : "<end>";
+    }
+};
+
+TEST_F(AdaptiveRadixTreeTest, PrefixKeys_OrderedAsTerminalsBeforeLongerKeys) {
+    for (const char* key : {"abc", "a", "abcd", "ab", "b", "abd", "abce"}) {
+        ASSERT_TRUE(tree_->Put(StrToSlice(key), StrToSlice(std::string("v_") + key)).ok());
+    }
+    EXPECT_EQ(Keys(), (std::vector<std::string>{"a", "ab", "abc", "abcd", "abce", "abd", "b"}));
+    EXPECT_EQ(GetOrStatus("ab"), "v_ab");
+    EXPECT_EQ(GetOrStatus("abcd"), "v_abcd");
+    EXPECT_EQ(GetOrStatus("abcde"), "<not found>");
+    EXPECT_EQ(GetOrStatus("aa"), "<not found>");
+
+    ASSERT_TRUE(tree_->Put(StrToSlice("ab"), StrToSlice("new")).ok());
+    ASSERT_TRUE(tree_->Delete(StrToSlice("abc")).ok());
+    EXPECT_EQ(GetOrStatus("ab"), "new");
+    EXPECT_EQ(GetOrStatus("abc"), "<tombstone>");
+    EXPECT_EQ(Keys().size(), 7U) << "A delete keeps its key as a tombstone.";
+}
+
+TEST_F(AdaptiveRadixTreeTest, ManyChildren_GrowThroughAllNodeSizes) {
+    // One node fans out to every byte value, and "k" to each of them again.
+    for (int b = 255; b >= 0; --b) {
+        std::string key = "k" + std::string(1, static_cast<char>(b));
+        ASSERT_TRUE(tree_->Put(StrToSlice(key), StrToSlice(std::to_string(b))).ok());
+        if (b % 37 == 0) {
+            EXPECT_EQ(GetOrStatus(key), std::to_string(b));
+        }
+    }
+    for (int b = 0; b < 256; ++b) {
+        EXPECT_EQ(GetOrStatus("k" + std::string(1, static_cast<char>(b))), std::to_string(b));
+    }
+    std::vector<std::string> keys = Keys();
+    ASSERT_EQ(keys.size(), 256U);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(static_cast<unsigned char>(keys[i][1]), i);
+    }
+}
+
+TEST_F(AdaptiveRadixTreeTest, Seek_FindsLowerBoundForAbsentTargets) {
+    for (const char* key : {"apple", "applesauce", "apricot", "banana", "band", "bandana", "cherry"}) {
+        ASSERT_TRUE(tree_->Put(StrToSlice(key), StrToSlice("v")).ok());
+    }
+    EXPECT_EQ(SeekKey("a"), "apple");
+    EXPECT_EQ(SeekKey("apple"), "apple");
+    EXPECT_EQ(SeekKey("applea"), "applesauce");
+    EXPECT_EQ(SeekKey("applet"), "apricot");
+    EXPECT_EQ(SeekKey("apq"), "apricot");
+    EXPECT_EQ(SeekKey("azz"), "banana");
+    EXPECT_EQ(SeekKey("ban"), "banana");
+    EXPECT_EQ(SeekKey("bandaid"), "bandana");
+    EXPECT_EQ(SeekKey("bandz"), "cherry");
+    EXPECT_EQ(SeekKey("cherry"), "cherry");
+    EXPECT_EQ(SeekKey("cherryx"), "<end>");
+    EXPECT_EQ(SeekKey("d"), "<end>");
+}
+
+TEST_F(AdaptiveRadixTreeTest, RandomOperations_MatchOrderedMap) {
+    std::mt19937 rng(17);
+    std::map<std::string, std::string> model;
+    const std::string alphabet = "abc\x01\xff";
+    for (int i = 0; i < 20000; ++i) {
+        std::string key(1 + rng() % 6, 'a');
+        for (char& c : key) {
+            c = alphabet[rng() % alphabet.size()];
+        }
+        if (rng() % 5 == 0) {
+            ASSERT_TRUE(tree_->Delete(StrToSlice(key)).ok());
+            model[key] = "<tombstone>";
+        } else {
+            std::string value = "v" + std::to_string(i);
+            ASSERT_TRUE(tree_->Put(StrToSlice(key), StrToSlice(value)).ok());
+            model[key] = value;
+        }
+    }
+
+    std::vector<std::string> expected_keys;
+    for (const auto& [key, value] : model) {
+        ASSERT_EQ(GetOrStatus(key), value) << key;
+        expected_keys.push_back(key);
+    }
+    EXPECT_EQ(Keys(), expected_keys);
+
+    for (int i = 0; i < 2000; ++i) {
+        std::string target(rng() % 7, 'a');
+        for (char& c : target) {
+            c = alphabet[rng() % alphabet.size()];
+        }
+        auto expected = model.lower_bound(target);
+        EXPECT_EQ(SeekKey(target), expected == model.end() ? "<end>" : expected->first) << target;
+    }
+}
+
+TEST_F(AdaptiveRadixTreeTest, DB_FlushesAndReadsWithRadixTreeMemTable) {
+    DBOptions options;
+    options.memtable_factory = AdaptiveRadixTreeMemTableFactory();
+    options.disable_auto_compactions = true;
+    DB db(test_dir_, 2048, options);
+    ASSERT_TRUE(db.Init().ok());
+    for (int i = 0; i < 300; ++i) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "key%05d", i);
+        ASSERT_TRUE(db.Put(StrToSlice(key), StrToSlice("v" + std::to_string(i))).ok());
+    }
+    ASSERT_TRUE(db.Delete(StrToSlice("key00007")).ok());
+    EXPECT_GT(db.NumFilesAtLevel(0), 0U);
+
+    std::string value;
+    ASSERT_TRUE(db.Get(StrToSlice("key00000"), &value).ok());
+    EXPECT_EQ(value, "v0");
+    ASSERT_TRUE(db.Get(StrToSlice("key00299"), &value).ok());
+    EXPECT_EQ(value, "v299");
+    EXPECT_TRUE(db.Get(StrToSlice("key00007"), &value).IsNotFound());
+}
+
+TEST_F(AdaptiveRadixTreeTest, DB_RejectsRadixTreeWithCustomComparator) {
+    static const ReverseBytewiseComparator reverse;
+    DBOptions options;
+    options.comparator = &reverse;
+    options.memtable_factory = AdaptiveRadixTreeMemTableFactory();
+    EXPECT_FALSE(AdaptiveRadixTreeMemTableFactory()->SupportsComparator(&reverse));
+    EXPECT_TRUE(SkipListMemTableFactory()->SupportsComparator(&reverse));
+
+    DB db(test_dir_, 2048, options);
+    EXPECT_EQ(db.Init().code(), ResultCode::kInvalidArgument);
+}
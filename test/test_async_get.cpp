@@ -0,0 +1,309 @@
+#include "gtest/gtest.h"
+#include "db.hpp"
+#include "options.hpp"
+#include "thread_pool.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Starts running immediately and frees its frame when it finishes.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+struct Lookup {
+    std::string value;
+    Result status;
+    std::thread::id resumed_on;
+};
+
+// Counts finished lookups. The count is changed and signalled under the
+// mutex, so a waiter that saw zero may destroy it right away.
+struct LookupLatch {
+    explicit LookupLatch(int count) : remaining(count) {}
+
+    void CountDown() {
+        std::lock_guard<std::mutex> lock(mu);
+        remaining--;
+        cv.notify_all();
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mu);
+        cv.wait(lock, [this] { return remaining == 0; });
+    }
+
+    int Remaining() {
+        std::lock_guard<std::mutex> lock(mu);
+        return remaining;
+    }
+
+    std::mutex mu;
+    std::condition_variable cv;
+    int remaining;
+};
+
+// A single-threaded executor: lookups hand their coroutines back through the
+// hook from Poster, and Run resumes them on the thread that calls it.
+struct ResumeQueue {
+    DB::ResumeFn Poster() {
+        return [this](std::coroutine_handle<> handle) {
+            std::lock_guard<std::mutex> lock(mu);
+            handles.push_back(handle);
+            cv.notify_all();
+        };
+    }
+
+    // Resumes posted coroutines until every lookup counted by `latch` is done.
+    void Run(LookupLatch* latch) {
+        while (latch->Remaining() > 0) {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                cv.wait(lock, [this] { return !handles.empty(); });
+                handle = handles.front();
+                handles.pop_front();
+            }
+            handle.resume();
+        }
+    }
+
+    std::mutex mu;
+    std::condition_variable cv;
+    std::deque<std::coroutine_handle<>> handles;
+};
+
+DetachedTask RunLookup(DB* db, std::string key, Lookup* lookup, LookupLatch* latch, DB::ResumeFn resume) {
+    Slice key_slice(reinterpret_cast<const std::byte*>(key.data()), key.size());
+    lookup->status = co_await db->AsyncGet(key_slice, &lookup->value, std::move(resume));
+    lookup->resumed_on = std::this_thread::get_id();
+    latch->CountDown();
+}
+
+} // namespace
+
+class AsyncGetTest : public TempDirTest {
+protected:
+    AsyncGetTest() : TempDirTest("test_async_get_temp_dir") {}
+};
+
+TEST_F(AsyncGetTest, MemTableHit_CompletesWithoutSuspending) {
+    DB db(test_dir_ + "/db", 1 << 20);
+    ASSERT_TRUE(db.Init().ok());
+    ASSERT_TRUE(db.Put(StrToSlice("k"), StrToSlice("v")).ok());
+    ASSERT_TRUE(db.Put(StrToSlice("deleted"), StrToSlice("x")).ok());
+    ASSERT_TRUE(db.Delete(StrToSlice("deleted")).ok());
+
+    ResumeQueue executor;
+    LookupLatch latch(2);
+    Lookup hit;
+    Lookup tombstone;
+    RunLookup(&db, "k", &hit, &latch, executor.Poster());
+    RunLookup(&db, "deleted", &tombstone, &latch, executor.Poster());
+
+    // Both coroutines already ran to completion on this thread.
+    EXPECT_EQ(latch.Remaining(), 0);
+    ASSERT_TRUE(hit.status.ok()) << hit.status.message();
+    EXPECT_EQ(hit.value, "v");
+    EXPECT_EQ(hit.resumed_on, std::this_thread::get_id());
+    EXPECT_EQ(tombstone.status.code(), ResultCode::kNotFound);
+    EXPECT_EQ(db.GetThreadPoolStats(ThreadPriority::kUser).jobs_scheduled, 0U);
+}
+
+TEST_F(AsyncGetTest, SSTableHit_ResumesOnTheExecutor) {
+    DBOptions options;
+    options.disable_auto_compactions = true;
+    DB db(test_dir_ + "/db", 4096, options);
+    ASSERT_TRUE(db.Init().ok());
+    ASSERT_TRUE(db.Put(StrToSlice("flushed"), StrToSlice("on_disk")).ok());
+    ASSERT_TRUE(db.Put(StrToSlice("gone"), StrToSlice("x")).ok());
+    FlushByFilling(&db);
+    ASSERT_TRUE(db.Delete(StrToSlice("gone")).ok());
+    FlushByFilling(&db);
+
+    ResumeQueue executor;
+    LookupLatch latch(3);
+    Lookup hit;
+    Lookup deleted;
+    Lookup missing;
+    RunLookup(&db, "flushed", &hit, &latch, executor.Poster());
+    RunLookup(&db, "gone", &deleted, &latch, executor.Poster());
+    RunLookup(&db, "never_written", &missing, &latch, executor.Poster());
+    EXPECT_EQ(latch.Remaining(), 3);
+    executor.Run(&latch);
+
+    ASSERT_TRUE(hit.status.ok()) << hit.status.message();
+    EXPECT_EQ(hit.value, "on_disk");
+    EXPECT_EQ(hit.resumed_on, std::this_thread::get_id());
+    EXPECT_EQ(deleted.status.code(), ResultCode::kNotFound);
+    EXPECT_EQ(missing.status.code(), ResultCode::kNotFound);
+    EXPECT_EQ(db.GetThreadPoolStats(ThreadPriority::kUser).jobs_scheduled, 3U);
+}
+
+TEST_F(AsyncGetTest, SSTableHit_WithoutResumeReadsOnCallingThread) {
+    DBOptions options;
+    options.disable_auto_compactions = true;
+    DB db(test_dir_ + "/db", 4096, options);
+    ASSERT_TRUE(db.Init().ok());
+    ASSERT_TRUE(db.Put(StrToSlice("flushed"), StrToSlice("on_disk")).ok());
+    FlushByFilling(&db);
+
+    LookupLatch latch(1);
+    Lookup hit;
+    RunLookup(&db, "flushed", &hit, &latch, nullptr);
+
+    EXPECT_EQ(latch.Remaining(), 0);
+    ASSERT_TRUE(hit.status.ok()) << hit.status.message();
+    EXPECT_EQ(hit.value, "on_disk");
+    EXPECT_EQ(db.GetThreadPoolStats(ThreadPriority::kUser).jobs_scheduled, 0U);
+}
+
+TEST_F(AsyncGetTest, SSTableHit_CanOptIntoResumingOnReadThread) {
+    DBOptions options;
+    options.disable_auto_compactions = true;
+    DB db(test_dir_ + "/db", 4096, options);
+    ASSERT_TRUE(db.Init().ok());
+    ASSERT_TRUE(db.Put(StrToSlice("flushed"), StrToSlice("on_disk")).ok());
+    FlushByFilling(&db);
+
+    LookupLatch latch(1);
+    Lookup hit;
+    RunLookup(&db, "flushed", &hit, &latch, [](std::coroutine_handle<> handle) { handle.resume(); });
+    latch.Wait();
+
+    ASSERT_TRUE(hit.status.ok()) << hit.status.message();
+    EXPECT_EQ(hit.value, "on_disk");
+    EXPECT_NE(hit.resumed_on, std::this_thread::get_id());
+}
+
+TEST_F(AsyncGetTest, ManyLookupsInFlightFromOneThread) {
+    ThreadPoolOptions pool_options;
+    pool_options.user_priority_threads = 2;
+    DBOptions options;
+    options.thread_pool = std::make_shared<ThreadPool>(pool_options);
+    DB db(test_dir_ + "/db", 8192, options);
+    ASSERT_TRUE(db.Init().ok());
+    const int kKeys = 200;
+    for (int i = 0; i < kKeys; ++i) {
+        ASSERT_TRUE(db.Put(StrToSlice("key" + std::to_string(i)), StrToSlice("value" + std::to_string(i))).ok());
+    }
+    FlushByFilling(&db);
+
+    ResumeQueue executor;
+    std::vector<Lookup> lookups(kKeys);
+    LookupLatch latch(kKeys);
+    for (int i = 0; i < kKeys; ++i) {
+        RunLookup(&db, "key" + std::to_string(i), &lookups[static_cast<size_t>(i)], &latch, executor.Poster());
+    }
+    executor.Run(&latch);
+
+    for (int i = 0; i < kKeys; ++i) {
+        const Lookup& lookup = lookups[static_cast<size_t>(i)];
+        ASSERT_TRUE(lookup.status.ok()) << i << ": " << lookup.status.message();
+        EXPECT_EQ(lookup.value, "value" + std::to_string(i));
+        EXPECT_EQ(lookup.resumed_on, std::this_thread::get_id());
+    }
+    ThreadPoolStats reads = db.GetThreadPoolStats(ThreadPriority::kUser);
+    EXPECT_EQ(reads.num_threads, 2);
+    EXPECT_EQ(reads.jobs_scheduled, static_cast<uint64_t>(kKeys));
+}
+
+TEST_F(AsyncGetTest, InFlightLookup_SurvivesCompactionOfItsTables) {
+    ThreadPoolOptions pool_options;
+    pool_options.user_priority_threads = 1;
+    auto pool = std::make_shared<ThreadPool>(pool_options);
+    DBOptions options;
+    options.thread_pool = pool;
+    options.disable_auto_compactions = true;
+    DB db(test_dir_ + "/db", 4096, options);
+    ASSERT_TRUE(db.Init().ok());
+    ASSERT_TRUE(db.Put(StrToSlice("k"), StrToSlice("v")).ok());
+    FlushByFilling(&db);
+    FlushByFilling(&db);
+
+    // Hold the only read thread so the lookup stays queued.
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::future<void> blocker = pool->Schedule([released]() { released.wait(); }, ThreadPriority::kUser);
+
+    ResumeQueue executor;
+    LookupLatch latch(1);
+    Lookup lookup;
+    RunLookup(&db, "k", &lookup, &latch, executor.Poster());
+    ASSERT_EQ(latch.Remaining(), 1);
+
+    // The compaction replaces the files the lookup will open; their removal
+    // waits for it.
+    ASSERT_TRUE(db.CompactLevel0().ok());
+    ASSERT_EQ(db.NumFilesAtLevel(0), 0U);
+
+    release.set_value();
+    blocker.get();
+    executor.Run(&latch);
+    ASSERT_TRUE(lookup.status.ok()) << lookup.status.message();
+    EXPECT_EQ(lookup.value, "v");
+
+    size_t tables_on_disk = 0;
+    for (const fs::directory_entry& entry : fs::directory_iterator(test_dir_ + "/db")) {
+        if (entry.path().extension() == ".sst") {
+            tables_on_disk++;
+        }
+    }
+    EXPECT_EQ(tables_on_disk, db.NumFilesAtLevel(1)) << "Deferred removals must happen once the lookup ends.";
+}
+
+TEST_F(AsyncGetTest, Destructor_WaitsForQueuedLookups) {
+    ThreadPoolOptions pool_options;
+    pool_options.user_priority_threads = 1;
+    auto pool = std::make_shared<ThreadPool>(pool_options);
+    DBOptions options;
+    options.thread_pool = pool;
+    auto db = std::make_unique<DB>(test_dir_ + "/db", 4096, options);
+    ASSERT_TRUE(db->Init().ok());
+    ASSERT_TRUE(db->Put(StrToSlice("k"), StrToSlice("v")).ok());
+    FlushByFilling(db.get());
+
+    // Hold the only read thread so the lookup stays queued.
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::future<void> blocker = pool->Schedule([released]() { released.wait(); }, ThreadPriority::kUser);
+
+    ResumeQueue executor;
+    LookupLatch latch(1);
+    Lookup lookup;
+    RunLookup(db.get(), "k", &lookup, &latch, executor.Poster());
+    ASSERT_EQ(latch.Remaining(), 1);
+
+    std::future<void> destroyed = std::async(std::launch::async, [&db]() { db.reset(); });
+    EXPECT_EQ(destroyed.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout)
+        << "The DB was destroyed while a lookup was still queued against it.";
+
+    release.set_value();
+    blocker.get();
+    destroyed.get();
+    executor.Run(&latch);
+    ASSERT_TRUE(lookup.status.ok()) << lookup.status.message();
+    EXPECT_EQ(lookup.value, "v");
+}
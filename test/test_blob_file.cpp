@@ -0,0 +1,211 @@
+#include "gtest/gtest.h"
+#include "blob_file.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace fs = std::filesystem;
+
+class BlobFileTest : public TempDirTest {
+protected:
+    BlobFileTest() : TempDirTest("test_blob_file_temp_dir") {}
+
+    // Incompressible, so SSTable sizes show whether values were moved out.
+    static std::string LargeValueFor(int i, int version) {
+        std::mt19937 rng(static_cast<uint32_t>(i * 31 + version));
+        std::string value(1000, '\0');
+        for (char& c : value) {
+            c = static_cast<char>('a' + rng() % 26);
+        }
+        return value;
+    }
+
+    static DBOptions BlobOptions() {
+        DBOptions options;
+        options.enable_blob_files = true;
+        options.min_blob_size = 512;
+        options.disable_auto_compactions = true;
+        return options;
+    }
+};
+
+TEST_F(BlobFileTest, BuilderAndReadBlob_RoundTrip) {
+    BlobIndex index{7, 12345, 678};
+    std::string encoded;
+    index.EncodeTo(&encoded);
+    ASSERT_EQ(encoded.size(), BlobIndex::kEncodedSize);
+    BlobIndex decoded;
+    ASSERT_TRUE(BlobIndex::DecodeFrom(StrToSlice(encoded), &decoded).ok());
+    EXPECT_EQ(decoded.file_number, 7U);
+    EXPECT_EQ(decoded.offset, 12345U);
+    EXPECT_EQ(decoded.size, 678U);
+    EXPECT_FALSE(BlobIndex::DecodeFrom(StrToSlice("short"), &decoded).ok());
+
+    uint64_t next_number = 1;
+    // Roll over after roughly three values.
+    BlobFileBuilder builder(512, 2500, [&]() {
+        BlobFileMetaData meta;
+        meta.number = next_number++;
+        meta.path = test_dir_ + "/" + std::to_string(meta.number) + ".blob";
+        return meta;
+    });
+    EXPECT_FALSE(builder.ShouldSeparate(511));
+    EXPECT_TRUE(builder.ShouldSeparate(512));
+
+    std::vector<std::string> indexes;
+    for (int i = 0; i < 10; ++i) {
+        std::string blob_index;
+        ASSERT_TRUE(builder.AddBlob(StrToSlice(KeyFor(i)), StrToSlice(LargeValueFor(i, 1)), &blob_index).ok());
+        indexes.push_back(blob_index);
+    }
+    ASSERT_TRUE(builder.Finish().ok());
+    ASSERT_EQ(builder.blob_files().size(), 4U);
+    uint64_t total_blobs = 0;
+    for (const BlobFileMetaData& meta : builder.blob_files()) {
+        total_blobs += meta.total_blob_count;
+    }
+    EXPECT_EQ(total_blobs, 10U);
+
+    for (int i = 0; i < 10; ++i) {
+        BlobIndex blob;
+        ASSERT_TRUE(BlobIndex::DecodeFrom(StrToSlice(indexes[i]), &blob).ok());
+        std::string value(blob.size, '\0');
+        std::string path = test_dir_ + "/" + std::to_string(blob.file_number) + ".blob";
+        ASSERT_TRUE(ReadBlob(path, blob, value.data()).ok()) << i;
+        EXPECT_EQ(value, LargeValueFor(i, 1)) << i;
+    }
+
+    // An index that does not point at a record is rejected.
+    BlobIndex bad;
+    ASSERT_TRUE(BlobIndex::DecodeFrom(StrToSlice(indexes[0]), &bad).ok());
+    bad.offset += 1;
+    std::string value(bad.size, '\0');
+    EXPECT_FALSE(ReadBlob(test_dir_ + "/1.blob", bad, value.data()).ok());
+}
+
+TEST_F(BlobFileTest, LargeValues_SeparatedAtFlushAndCompaction) {
+    DB db(test_dir_ + "/db", 8192, BlobOptions());
+    ASSERT_TRUE(db.Init().ok());
+    for (int i = 0; i < 30; ++i) {
+        ASSERT_TRUE(db.Put(StrToSlice(KeyFor(i)), StrToSlice(LargeValueFor(i, 1))).ok());
+        ASSERT_TRUE(db.Put(StrToSlice("small" + std::to_string(i)), StrToSlice("tiny")).ok());
+    }
+    FlushByFilling(&db);
+    EXPECT_FALSE(db.GetLiveBlobFiles().empty());
+
+    for (int i = 0; i < 30; ++i) {
+        EXPECT_EQ(GetOrStatus(&db, KeyFor(i)), LargeValueFor(i, 1)) << i;
+        EXPECT_EQ(GetOrStatus(&db, "small" + std::to_string(i)), "tiny") << i;
+    }
+
+    ASSERT_TRUE(db.CompactLevel0().ok());
+    ASSERT_EQ(db.NumFilesAtLevel(0), 0U);
+    for (int i = 0; i < 30; ++i) {
+        EXPECT_EQ(GetOrStatus(&db, KeyFor(i)), LargeValueFor(i, 1)) << i;
+    }
+
+    // The tables only hold keys and 24-byte blob indexes.
+    uintmax_t sst_bytes = 0;
+    for (const auto& entry : fs::directory_iterator(test_dir_ + "/db")) {
+        if (entry.path().extension() == ".sst") {
+            sst_bytes += fs::file_size(entry.path());
+        }
+    }
+    EXPECT_LT(sst_bytes, 30U * 1000U / 4);
+}
+
+TEST_F(BlobFileTest, ShadowedBlobs_MakeBlobFilesObsolete) {
+    DBOptions options = BlobOptions();
+    options.enable_blob_garbage_collection = false;
+    DB db(test_dir_ + "/db", 8192, options);
+    ASSERT_TRUE(db.Init().ok());
+    for (int version = 1; version <= 2; ++version) {
+        for (int i = 0; i < 20; ++i) {
+            ASSERT_TRUE(db.Put(StrToSlice(KeyFor(i)), StrToSlice(LargeValueFor(i, version))).ok());
+        }
+        FlushByFilling(&db);
+    }
+    size_t blob_files_before = db.GetLiveBlobFiles().size();
+
+    ASSERT_TRUE(db.CompactLevel0().ok());
+
+    // Every first version was overwritten, so only blob files of the second remain.
+    uint64_t live_blobs = 0;
+    for (const BlobFileMetaData& meta : db.GetLiveBlobFiles()) {
+        EXPECT_FALSE(meta.IsObsolete());
+        EXPECT_EQ(meta.garbage_blob_count, 0U);
+        live_blobs += meta.total_blob_count;
+    }
+    EXPECT_EQ(live_blobs, 20U);
+    EXPECT_LT(db.GetLiveBlobFiles().size(), blob_files_before);
+    EXPECT_EQ(CountFilesWithExtension(test_dir_ + "/db", ".blob"), db.GetLiveBlobFiles().size());
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(GetOrStatus(&db, KeyFor(i)), LargeValueFor(i, 2)) << i;
+    }
+}
+
+TEST_F(BlobFileTest, GarbageCollection_RelocatesOldBlobs) {
+    DBOptions options = BlobOptions();
+    options.blob_garbage_collection_age_cutoff = 1.0;
+    DB db(test_dir_ + "/db", 8192, options);
+    ASSERT_TRUE(db.Init().ok());
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(db.Put(StrToSlice(KeyFor(i)), StrToSlice(LargeValueFor(i, 1))).ok());
+    }
+    FlushByFilling(&db);
+    ASSERT_TRUE(db.CompactLevel0().ok());
+    std::vector<BlobFileMetaData> first_generation = db.GetLiveBlobFiles();
+    ASSERT_FALSE(first_generation.empty());
+
+    // A compaction with nothing overwritten still moves every blob out of the
+    // files selected for collection, which then disappear. The new key only
+    // makes L0 overlap the table holding the blob references.
+    ASSERT_TRUE(db.Put(StrToSlice(KeyFor(0) + "_"), StrToSlice("small")).ok());
+    FlushByFilling(&db);
+    ASSERT_TRUE(db.CompactLevel0().ok());
+    for (const BlobFileMetaData& old_file : first_generation) {
+        EXPECT_FALSE(fs::exists(old_file.path)) << old_file.path;
+        for (const BlobFileMetaData& live : db.GetLiveBlobFiles()) {
+            EXPECT_NE(live.number, old_file.number);
+        }
+    }
+    uint64_t live_blobs = 0;
+    for (const BlobFileMetaData& meta : db.GetLiveBlobFiles()) {
+        live_blobs += meta.total_blob_count - meta.garbage_blob_count;
+    }
+    EXPECT_EQ(live_blobs, 20U);
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(GetOrStatus(&db, KeyFor(i)), LargeValueFor(i, 1)) << i;
+    }
+}
+
+TEST_F(BlobFileTest, Reopen_RestoresBlobFilesFromManifest) {
+    std::vector<BlobFileMetaData> blob_files;
+    {
+        DB db(test_dir_ + "/db", 8192, BlobOptions());
+        ASSERT_TRUE(db.Init().ok());
+        for (int i = 0; i < 20; ++i) {
+            ASSERT_TRUE(db.Put(StrToSlice(KeyFor(i)), StrToSlice(LargeValueFor(i, 1))).ok());
+        }
+        FlushByFilling(&db);
+        blob_files = db.GetLiveBlobFiles();
+        ASSERT_FALSE(blob_files.empty());
+    }
+
+    DB reopened(test_dir_ + "/db", 8192, BlobOptions());
+    ASSERT_TRUE(reopened.Init().ok());
+    ASSERT_EQ(reopened.GetLiveBlobFiles().size(), blob_files.size());
+    for (size_t i = 0; i < blob_files.size(); ++i) {
+        EXPECT_EQ(reopened.GetLiveBlobFiles()[i].number, blob_files[i].number);
+        EXPECT_EQ(reopened.GetLiveBlobFiles()[i].total_blob_count, blob_files[i].total_blob_count);
+    }
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(GetOrStatus(&reopened, KeyFor(i)), LargeValueFor(i, 1)) << i;
+    }
+}
@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include "db.hpp"
+#include "manifest.hpp"
+#include "options.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace fs = std::filesystem;
+
+class CheckpointTest : public TempDirTest {
+protected:
+    CheckpointTest() : TempDirTest("test_checkpoint_temp_dir") {}
+
+    std::string db_dir_ = "test_checkpoint_temp_dir/db";
+    std::string checkpoint_dir_ = "test_checkpoint_temp_dir/checkpoint";
+};
+
+TEST_F(CheckpointTest, Checkpoint_IsPointInTimeCopy) {
+    DBOptions options;
+    options.level0_file_num_compaction_trigger = 3;
+    {
+        DB db(db_dir_, 1024, options);
+        ASSERT_TRUE(db.Init().ok());
+        for (int i = 0; i < 200; ++i) {
+            ASSERT_TRUE(db.Put(StrToSlice(KeyFor(i)), StrToSlice("v1_" + std::to_string(i))).ok());
+        }
+        ASSERT_TRUE(db.Delete(StrToSlice(KeyFor(7))).ok());
+        // The last writes are still only in the memtable.
+        ASSERT_TRUE(db.Put(StrToSlice("zz_unflushed"), StrToSlice("in_memtable")).ok());
+
+        ASSERT_TRUE(db.CreateCheckpoint(checkpoint_dir_).ok());
+        EXPECT_TRUE(fs::exists(fs::path(checkpoint_dir_) / kManifestFileName));
+        EXPECT_FALSE(fs::exists(checkpoint_dir_ + ".tmp"));
+
+        // SSTables are shared with the live DB rather than copied.
+        for (const auto& entry : fs::directory_iterator(checkpoint_dir_)) {
+            if (entry.path().extension() == ".sst") {
+                EXPECT_GE(fs::hard_link_count(entry.path()), 2U) << entry.path();
+            }
+        }
+
+        // Later writes, including compactions that delete files, do not reach the checkpoint.
+        for (int i = 0; i < 200; ++i) {
+            ASSERT_TRUE(db.Put(StrToSlice(KeyFor(i)), StrToSlice("v2_" + std::to_string(i))).ok());
+        }
+        ASSERT_TRUE(db.CompactLevel0().ok());
+        EXPECT_EQ(GetOrStatus(&db, KeyFor(7)), "v2_7");
+    }
+
+    DB checkpoint(checkpoint_dir_, 1024, options);
+    ASSERT_TRUE(checkpoint.Init().ok());
+    for (int i = 0; i < 200; ++i) {
+        if (i == 7) {
+            EXPECT_EQ(GetOrStatus(&checkpoint, KeyFor(i)), "<" + std::to_string(static_cast<int>(ResultCode::kNotFound)) + ">");
+        } else {
+            EXPECT_EQ(GetOrStatus(&checkpoint, KeyFor(i)), "v1_" + std::to_string(i)) << KeyFor(i);
+        }
+    }
+    EXPECT_EQ(GetOrStatus(&checkpoint, "zz_unflushed"), "in_memtable");
+
+    // A checkpoint is a normal DB and accepts writes without touching the original.
+    ASSERT_TRUE(checkpoint.Put(StrToSlice(KeyFor(1)), StrToSlice("from_checkpoint")).ok());
+    EXPECT_EQ(GetOrStatus(&checkpoint, KeyFor(1)), "from_checkpoint");
+}
+
+TEST_F(CheckpointTest, Checkpoint_RejectsExistingDirectory) {
+    DB db(db_dir_, 1024);
+    ASSERT_TRUE(db.Init().ok());
+    fs::create_directories(checkpoint_dir_);
+    EXPECT_EQ(db.CreateCheckpoint(checkpoint_dir_).code(), ResultCode::kInvalidArgument);
+}
+
+TEST_F(CheckpointTest, Checkpoint_LeavesExistingStagingDirectoryAlone) {
+    DB db(db_dir_, 1024);
+    ASSERT_TRUE(db.Init().ok());
+    std::string unrelated = (fs::path(checkpoint_dir_ + ".tmp") / "unrelated").string();
+    fs::create_directories(checkpoint_dir_ + ".tmp");
+    { std::ofstream(unrelated) << "keep me"; }
+    EXPECT_EQ(db.CreateCheckpoint(checkpoint_dir_).code(), ResultCode::kInvalidArgument);
+    EXPECT_TRUE(fs::exists(unrelated));
+    EXPECT_FALSE(fs::exists(checkpoint_dir_));
+}
+
+TEST_F(CheckpointTest, Manifest_ReopenRestoresLevels) {
+    DBOptions options;
+    options.disable_auto_compactions = true;
+    size_t l0_files = 0;
+    {
+        DB db(db_dir_, 512, options);
+        ASSERT_TRUE(db.Init().ok());
+        for (int i = 0; i < 100; ++i) {
+            ASSERT_TRUE(db.Put(StrToSlice(KeyFor(i)), StrToSlice("value_" + std::to_string(i))).ok());
+        }
+        l0_files = db.NumFilesAtLevel(0);
+        ASSERT_GT(l0_files, 1U);
+    }
+
+    DB reopened(db_dir_, 512, options);
+    ASSERT_TRUE(reopened.Init().ok());
+    EXPECT_EQ(reopened.NumFilesAtLevel(0), l0_files);
+    EXPECT_EQ(GetOrStatus(&reopened, KeyFor(3)), "value_3");
+
+    // New files must not reuse numbers of files that are already live.
+    for (int i = 100; i < 150; ++i) {
+        ASSERT_TRUE(reopened.Put(StrToSlice(KeyFor(i)), StrToSlice("value_" + std::to_string(i))).ok());
+    }
+    EXPECT_GT(reopened.NumFilesAtLevel(0), l0_files);
+    EXPECT_EQ(GetOrStatus(&reopened, KeyFor(3)), "value_3");
+}
@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+#include "column_family.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "write_batch.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace fs = std::filesystem;
+
+class ColumnFamilyTest : public TempDirTest {
+protected:
+    ColumnFamilyTest() : TempDirTest("test_column_family_temp_dir") {}
+
+    static DBOptions NoCompactionOptions() {
+        DBOptions options;
+        options.disable_auto_compactions = true;
+        return options;
+    }
+
+    std::string NotFound() {
+        return "<" + std::to_string(static_cast<int>(ResultCode::kNotFound)) + ">";
+    }
+};
+
+TEST_F(ColumnFamilyTest, Families_AreIsolated) {
+    DB db(test_dir_ + "/db", 4096, NoCompactionOptions());
+    ASSERT_TRUE(db.Init().ok());
+    ColumnFamilyHandle* users = nullptr;
+    ASSERT_TRUE(db.CreateColumnFamily("users", 1 << 20, NoCompactionOptions(), &users).ok());
+    ASSERT_NE(users, nullptr);
+    EXPECT_EQ(users->GetName(), "users");
+    EXPECT_NE(users->GetID(), db.DefaultColumnFamily()->GetID());
+    EXPECT_EQ(db.GetColumnFamily("users"), users);
+
+    ColumnFamilyHandle* duplicate = nullptr;
+    EXPECT_EQ(db.CreateColumnFamily("users", 4096, NoCompactionOptions(), &duplicate).code(),
+              ResultCode::kInvalidArgument);
+
+    ASSERT_TRUE(db.Put(StrToSlice("k"), StrToSlice("default_value")).ok());
+    ASSERT_TRUE(db.Put(users, StrToSlice("k"), StrToSlice("users_value")).ok());
+    ASSERT_TRUE(db.Put(users, StrToSlice("only_users"), StrToSlice("u")).ok());
+    EXPECT_EQ(GetOrStatus(&db, db.DefaultColumnFamily(), "k"), "default_value");
+    EXPECT_EQ(GetOrStatus(&db, users, "k"), "users_value");
+    EXPECT_EQ(GetOrStatus(&db, db.DefaultColumnFamily(), "only_users"), NotFound());
+
+    // Each family flushes on its own threshold.
+    FlushByFilling(&db, db.DefaultColumnFamily());
+    EXPECT_EQ(db.NumFilesAtLevel(users, 0), 0U);
+    ASSERT_TRUE(db.Delete(users, StrToSlice("k")).ok());
+    EXPECT_EQ(GetOrStatus(&db, users, "k"), NotFound());
+    EXPECT_EQ(GetOrStatus(&db, db.DefaultColumnFamily(), "k"), "default_value");
+}
+
+TEST_F(ColumnFamilyTest, WriteBatch_RecoveredFromLogAcrossFamilies) {
+    {
+        DB db(test_dir_ + "/db", 1 << 20, NoCompactionOptions());
+        ASSERT_TRUE(db.Init().ok());
+        ColumnFamilyHandle* users = nullptr;
+        ASSERT_TRUE(db.CreateColumnFamily("users", 1 << 20, NoCompactionOptions(), &users).ok());
+        ASSERT_TRUE(db.Put(StrToSlice("gone"), StrToSlice("x")).ok());
+
+        WriteBatch batch;
+        batch.Put(StrToSlice("a"), StrToSlice("1"));
+        batch.Put(users, StrToSlice("b"), StrToSlice("2"));
+        batch.Delete(StrToSlice("gone"));
+        ASSERT_TRUE(db.Write(batch).ok());
+
+        // A batch naming an unknown family is rejected as a whole.
+        ColumnFamilyHandle bogus(99, "bogus");
+        WriteBatch bad;
+        bad.Put(StrToSlice("c"), StrToSlice("3"));
+        bad.Put(&bogus, StrToSlice("d"), StrToSlice("4"));
+        EXPECT_EQ(db.Write(bad).code(), ResultCode::kInvalidArgument);
+        EXPECT_EQ(GetOrStatus(&db, db.DefaultColumnFamily(), "c"), NotFound());
+        // Nothing was flushed; the data lives only in the memtables and the log.
+        EXPECT_EQ(db.NumFilesAtLevel(0), 0U);
+    }
+
+    DB reopened(test_dir_ + "/db", 1 << 20, NoCompactionOptions());
+    ASSERT_TRUE(reopened.Init().ok());
+    ColumnFamilyHandle* users = reopened.GetColumnFamily("users");
+    ASSERT_NE(users, nullptr);
+    EXPECT_EQ(GetOrStatus(&reopened, reopened.DefaultColumnFamily(), "a"), "1");
+    EXPECT_EQ(GetOrStatus(&reopened, users, "b"), "2");
+    EXPECT_EQ(GetOrStatus(&reopened, reopened.DefaultColumnFamily(), "gone"), NotFound());
+    EXPECT_EQ(GetOrStatus(&reopened, users, "a"), NotFound());
+}
+
+TEST_F(ColumnFamilyTest, Recovery_StopsAtTornLogTail) {
+    {
+        DB db(test_dir_ + "/db", 1 << 20, NoCompactionOptions());
+        ASSERT_TRUE(db.Init().ok());
+        ASSERT_TRUE(db.Put(StrToSlice("k1"), StrToSlice("v1")).ok());
+        ASSERT_TRUE(db.Put(StrToSlice("k2"), StrToSlice("v2")).ok());
+    }
+    for (const auto& entry : fs::directory_iterator(test_dir_ + "/db")) {
+        if (entry.path().extension() == ".log") {
+            std::ofstream out(entry.path(), std::ios::binary | std::ios::app);
+            out.write("\x01\x02\x03\x04\x05", 5);
+        }
+    }
+
+    {
+        DB reopened(test_dir_ + "/db", 1 << 20, NoCompactionOptions());
+        ASSERT_TRUE(reopened.Init().ok());
+        EXPECT_EQ(GetOrStatus(&reopened, reopened.DefaultColumnFamily(), "k1"), "v1");
+        EXPECT_EQ(GetOrStatus(&reopened, reopened.DefaultColumnFamily(), "k2"), "v2");
+        ASSERT_TRUE(reopened.Put(StrToSlice("k3"), StrToSlice("v3")).ok());
+    }
+
+    // Writes after the damaged recovery survive the next reopen too.
+    DB again(test_dir_ + "/db", 1 << 20, NoCompactionOptions());
+    ASSERT_TRUE(again.Init().ok());
+    EXPECT_EQ(GetOrStatus(&again, again.DefaultColumnFamily(), "k1"), "v1");
+    EXPECT_EQ(GetOrStatus(&again, again.DefaultColumnFamily(), "k3"), "v3");
+}
+
+TEST_F(ColumnFamilyTest, ObsoleteLogs_DeletedOnceEveryFamilyFlushed) {
+    DB db(test_dir_ + "/db", 4096, NoCompactionOptions());
+    ASSERT_TRUE(db.Init().ok());
+    ColumnFamilyHandle* users = nullptr;
+    ASSERT_TRUE(db.CreateColumnFamily("users", 4096, NoCompactionOptions(), &users).ok());
+    ASSERT_TRUE(db.Put(users, StrToSlice("pending"), StrToSlice("p")).ok());
+    EXPECT_EQ(CountFilesWithExtension(test_dir_ + "/db", ".log"), 1U);
+
+    // The first log still holds the unflushed write to "users".
+    FlushByFilling(&db, db.DefaultColumnFamily());
+    EXPECT_EQ(CountFilesWithExtension(test_dir_ + "/db", ".log"), 2U);
+
+    // Once "users" flushes too, only the current log is needed.
+    FlushByFilling(&db, users);
+    EXPECT_EQ(CountFilesWithExtension(test_dir_ + "/db", ".log"), 1U);
+    EXPECT_EQ(GetOrStatus(&db, users, "pending"), "p");
+}
+
+TEST_F(ColumnFamilyTest, DBWriteBufferSize_FlushesLargestMemTable) {
+    DBOptions options = NoCompactionOptions();
+    options.db_write_buffer_size = 8192;
+    DB db(test_dir_ + "/db", 1 << 20, options);
+    ASSERT_TRUE(db.Init().ok());
+    ColumnFamilyHandle* big = nullptr;
+    ASSERT_TRUE(db.CreateColumnFamily("big", 1 << 20, NoCompactionOptions(), &big).ok());
+
+    ASSERT_TRUE(db.Put(StrToSlice("small_key"), StrToSlice("s")).ok());
+    std::string value(200, 'v');
+    for (int i = 0; i < 60; ++i) {
+        ASSERT_TRUE(db.Put(big, StrToSlice("key" + std::to_string(i)), StrToSlice(value)).ok());
+    }
+
+    // Neither family reached its own threshold, but together they exceeded
+    // the DB-wide budget, which flushed the family holding the most data.
+    EXPECT_GT(db.NumFilesAtLevel(big, 0), 0U);
+    EXPECT_EQ(db.NumFilesAtLevel(0), 0U);
+    EXPECT_EQ(GetOrStatus(&db, big, "key0"), value);
+    EXPECT_EQ(GetOrStatus(&db, db.DefaultColumnFamily(), "small_key"), "s");
+}
+
+TEST_F(ColumnFamilyTest, DisableWAL_LosesUnflushedWrites) {
+    DBOptions options = NoCompactionOptions();
+    options.disable_wal = true;
+    {
+        DB db(test_dir_ + "/db", 1 << 20, options);
+        ASSERT_TRUE(db.Init().ok());
+        ASSERT_TRUE(db.Put(StrToSlice("k"), StrToSlice("v")).ok());
+        EXPECT_EQ(CountFilesWithExtension(test_dir_ + "/db", ".log"), 0U);
+    }
+    DB reopened(test_dir_ + "/db", 1 << 20, options);
+    ASSERT_TRUE(reopened.Init().ok());
+    EXPECT_EQ(GetOrStatus(&reopened, reopened.DefaultColumnFamily(), "k"), NotFound());
+}
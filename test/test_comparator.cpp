@@ -0,0 +1,159 @@
+#include "gtest/gtest.h"
+#include "comparator.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "mem_table.hpp"
+#include "sst_file_writer.hpp"
+#include "sstable_reader.hpp"
+#include "sstable_iterator.hpp"
+#include "table_builder.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const Comparator* ReverseComparator() {
+  static const ReverseBytewiseComparator reverse;
+  return &reverse;
+}
+
+} // namespace
+
+class ComparatorTest : public TempDirTest {
+protected:
+    ComparatorTest() : TempDirTest("test_comparator_temp_dir") {}
+
+    static DBOptions ReverseOptions() {
+        DBOptions options;
+        options.comparator = ReverseComparator();
+        options.disable_auto_compactions = true;
+        return options;
+    }
+
+    static std::vector<std::string> Keys(SortedTableIterator* it) {
+        std::vector<std::string> keys;
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            keys.push_back(it->key().ToString());
+        }
+        return keys;
+    }
+};
+
+TEST_F(ComparatorTest, KeyComparator_BytewiseFastPathMatchesVirtualCompare) {
+    KeyComparator bytewise;
+    KeyComparator from_null(nullptr);
+    KeyComparator reverse(ReverseComparator());
+    Slice a = StrToSlice("a");
+    Slice ab = StrToSlice("ab");
+    Slice b = StrToSlice("b");
+
+    EXPECT_LT(bytewise.Compare(a, ab), 0);
+    EXPECT_EQ(bytewise.Compare(a, ab) < 0, BytewiseComparator()->Compare(a, ab) < 0);
+    EXPECT_EQ(bytewise.Compare(b, b), 0);
+    EXPECT_STREQ(from_null.Name(), BytewiseComparator()->Name());
+    EXPECT_GT(reverse.Compare(a, b), 0);
+    EXPECT_TRUE(reverse(b, a));
+}
+
+TEST_F(ComparatorTest, MemTable_IteratesInComparatorOrder) {
+    MemTable memtable(*op_arena_, ReverseComparator());
+    for (const char* key : {"b", "d", "a", "c"}) {
+        ASSERT_TRUE(memtable.Put(StrToSlice(key), StrToSlice("v")).ok());
+    }
+    std::unique_ptr<SortedTableIterator> it(memtable.NewIterator());
+    EXPECT_EQ(Keys(it.get()), (std::vector<std::string>{"d", "c", "b", "a"}));
+
+    Slice value;
+    EXPECT_TRUE(memtable.Get(StrToSlice("c"), &value).ok());
+}
+
+TEST_F(ComparatorTest, SstFile_RecordsComparatorAndKeepsItsOrder) {
+    std::string path = (fs::path(test_dir_) / "reverse.sst").string();
+    SstFileWriter writer;
+    writer.SetComparator(ReverseComparator());
+    ASSERT_TRUE(writer.Open(path).ok());
+    for (int i = 999; i >= 0; --i) {
+        ASSERT_TRUE(writer.Put(StrToSlice(KeyFor(i)), StrToSlice("v" + std::to_string(i))).ok());
+    }
+    EXPECT_EQ(writer.Put(StrToSlice(KeyFor(5000)), StrToSlice("late")).code(), ResultCode::kInvalidArgument)
+        << "A key that sorts before the last one under the comparator is out of order.";
+    ASSERT_TRUE(writer.Finish().ok());
+
+    SSTableReader reader(path, ReverseComparator());
+    ASSERT_TRUE(reader.Init().ok());
+    std::string name;
+    ASSERT_TRUE(reader.GetProperty(kComparatorNameProperty, &name).ok());
+    EXPECT_EQ(name, ReverseComparator()->Name());
+    EXPECT_TRUE(reader.GetProperty("no.such.property", &name).IsNotFound());
+
+    std::string value_out;
+    ASSERT_TRUE(reader.Get(StrToSlice(KeyFor(123)), &value_out).ok());
+    EXPECT_EQ(value_out, "v123");
+
+    SSTableIterator it(&reader);
+    std::vector<std::string> keys = Keys(&it);
+    ASSERT_EQ(keys.size(), 1000U);
+    EXPECT_EQ(keys.front(), KeyFor(999));
+    EXPECT_EQ(keys.back(), KeyFor(0));
+
+    it.Seek(StrToSlice(KeyFor(500)));
+    ASSERT_TRUE(it.Valid());
+    EXPECT_EQ(it.key().ToString(), KeyFor(500));
+    it.Next();
+    ASSERT_TRUE(it.Valid());
+    EXPECT_EQ(it.key().ToString(), KeyFor(499));
+}
+
+TEST_F(ComparatorTest, DB_FlushAndCompactUnderCustomComparator) {
+    std::string db_dir = test_dir_ + "/db";
+    {
+        DB db(db_dir, 2048, ReverseOptions());
+        ASSERT_TRUE(db.Init().ok());
+        for (int i = 0; i < 300; ++i) {
+            ASSERT_TRUE(db.Put(StrToSlice(KeyFor(i)), StrToSlice("v" + std::to_string(i))).ok());
+        }
+        ASSERT_TRUE(db.Delete(StrToSlice(KeyFor(7))).ok());
+        ASSERT_GT(db.NumFilesAtLevel(0), 1U);
+        ASSERT_TRUE(db.CompactLevel0().ok());
+        EXPECT_EQ(db.NumFilesAtLevel(0), 0U);
+
+        EXPECT_EQ(GetOrStatus(&db, KeyFor(0)), "v0");
+        EXPECT_EQ(GetOrStatus(&db, KeyFor(299)), "v299");
+        EXPECT_EQ(GetOrStatus(&db, KeyFor(7)), "<" + std::to_string(static_cast<int>(ResultCode::kNotFound)) + ">");
+    }
+
+    // The same comparator reopens; a different one is refused.
+    {
+        DB db(db_dir, 2048, ReverseOptions());
+        ASSERT_TRUE(db.Init().ok());
+        EXPECT_EQ(GetOrStatus(&db, KeyFor(150)), "v150");
+    }
+    {
+        DBOptions bytewise;
+        bytewise.disable_auto_compactions = true;
+        DB db(db_dir, 2048, bytewise);
+        EXPECT_EQ(db.Init().code(), ResultCode::kInvalidArgument);
+    }
+}
+
+TEST_F(ComparatorTest, Ingest_RejectsFileWithDifferentComparator) {
+    std::string path = (fs::path(test_dir_) / "bytewise.sst").string();
+    SstFileWriter writer;
+    ASSERT_TRUE(writer.Open(path).ok());
+    ASSERT_TRUE(writer.Put(StrToSlice("a"), StrToSlice("1")).ok());
+    ASSERT_TRUE(writer.Put(StrToSlice("b"), StrToSlice("2")).ok());
+    ASSERT_TRUE(writer.Finish().ok());
+
+    DB db(test_dir_ + "/db", 1 << 20, ReverseOptions());
+    ASSERT_TRUE(db.Init().ok());
+    EXPECT_EQ(db.IngestExternalFile(path).code(), ResultCode::kInvalidArgument);
+    EXPECT_EQ(db.NumFilesAtLevel(kNumLevels - 1), 0U);
+    EXPECT_TRUE(fs::exists(path));
+}
@@ -123,14 +123,13 @@ TEST_F(DBTest, PutAndGet_Simple) {
 
     // Get with Arena output
     Arena result_arena; // This is the local arena results should be copied into
-    Result get_res_arena = db->Get(key, result_arena);
+    Slice result_slice;
+    Result get_res_arena = db->Get(key, result_arena, &result_slice);
     ASSERT_TRUE(get_res_arena.ok()) << "Get(Arena&) failed: " << get_res_arena.message();
-    ASSERT_TRUE(get_res_arena.value_slice().has_value());
-    ASSERT_EQ(get_res_arena.value_slice().value().ToString(), "value1");
+    ASSERT_EQ(result_slice.ToString(), "value1");
 
 #ifdef LSM_PROJECT_ENABLE_TESTING_HOOKS // Guard the call to IsAddressInCurrentBlock
     // Ensure slice from Get(Arena&) points into result_arena, and not op_arena_
-    const Slice& result_slice = get_res_arena.value_slice().value();
     const void* result_data_ptr = result_slice.data();
 
     if (result_slice.size() > 0) {
@@ -157,7 +156,8 @@ TEST_F(DBTest, Get_NotFound) {
     ASSERT_EQ(get_res_str.code(), ResultCode::kNotFound);
 
     Arena result_arena;
-    Result get_res_arena = db->Get(key, result_arena);
+    Slice result_slice;
+    Result get_res_arena = db->Get(key, result_arena, &result_slice);
     ASSERT_FALSE(get_res_arena.ok());
     ASSERT_EQ(get_res_arena.code(), ResultCode::kNotFound);
 }
@@ -336,6 +336,31 @@ TEST_F(DBTest, Get_ReadsAcrossMultipleSSTablesAndMemtable) {
 }
 
 
+TEST_F(DBTest, InplaceUpdate_OverwritesDoNotFillMemtable) {
+    DBOptions options;
+    options.inplace_update_support = true;
+    options.memtable_factory = SkipListMemTableFactory();
+    DB db(test_db_dir_, 64 * 1024, options);
+    ASSERT_TRUE(db.Init().ok());
+    for (int i = 0; i < 20000; ++i) {
+        char value[16];
+        std::snprintf(value, sizeof(value), "%08d", i);
+        ASSERT_TRUE(db.Put(StrToSlice("counter" + std::to_string(i % 10)), StrToSlice(value)).ok());
+    }
+    EXPECT_EQ(CountSSTables(), 0U) << "Ten keys rewritten in place must not reach the flush threshold.";
+    std::string value_out;
+    ASSERT_TRUE(db.Get(StrToSlice("counter9"), &value_out).ok());
+    EXPECT_EQ(value_out, "00019999");
+
+    DBOptions unsupported;
+    unsupported.inplace_update_support = true;
+    unsupported.memtable_factory = VectorMemTableFactory();
+    DB rejected(test_db_dir_ + "_rejected", 64 * 1024, unsupported);
+    EXPECT_EQ(rejected.Init().code(), ResultCode::kInvalidArgument);
+    fs::remove_all(test_db_dir_ + "_rejected");
+}
+
+
 TEST_F(DBTest, DISABLED_FlushFailure_CannotCreateNewActiveMemtable) {
     GTEST_SKIP() << "Skipping test that requires controlled allocation failure.";
 }
@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+#include "file_indexer.hpp"
+#include "comparator.hpp"
+#include "version_edit.hpp"
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+Slice AsSlice(const std::string& s) {
+    return Slice(reinterpret_cast<const std::byte*>(s.data()), s.size());
+}
+
+FileMetaData FileWithRange(uint64_t number, int smallest, int largest) {
+    FileMetaData f;
+    f.number = number;
+    f.has_key_range = true;
+    f.smallest_key = KeyFor(smallest, 6);
+    f.largest_key = KeyFor(largest, 6);
+    return f;
+}
+
+// Splits [0, key_space) into `num_files` non-overlapping files with gaps
+// between them, as a sorted level would hold.
+std::vector<FileMetaData> RandomLevel(std::mt19937* rng, uint64_t* next_number, int num_files, int key_space) {
+    std::vector<int> bounds;
+    for (int i = 0; i < num_files * 2; ++i) {
+        bounds.push_back(static_cast<int>((*rng)() % static_cast<unsigned>(key_space)));
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+    std::vector<FileMetaData> files;
+    for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+        files.push_back(FileWithRange((*next_number)++, bounds[i], bounds[i + 1]));
+    }
+    return files;
+}
+
+std::vector<uint64_t> PickedFiles(const std::vector<std::vector<FileMetaData>>& levels, const FileIndexer& indexer,
+                                  const std::string& key) {
+    std::vector<uint64_t> numbers;
+    FilePicker picker(levels, indexer, KeyComparator(), AsSlice(key));
+    for (const FileMetaData* f = picker.GetNextFile(); f != nullptr; f = picker.GetNextFile()) {
+        numbers.push_back(f->number);
+    }
+    return numbers;
+}
+
+// Every file, level by level, whose range holds the key or is unknown.
+std::vector<uint64_t> ScannedFiles(const std::vector<std::vector<FileMetaData>>& levels, const std::string& key) {
+    std::vector<uint64_t> numbers;
+    for (const std::vector<FileMetaData>& level : levels) {
+        for (const FileMetaData& f : level) {
+            if (!f.has_key_range || (key >= f.smallest_key && key <= f.largest_key)) {
+                numbers.push_back(f.number);
+            }
+        }
+    }
+    return numbers;
+}
+
+} // namespace
+
+TEST(FileIndexerTest, Picker_MatchesFullScanAcrossRandomLevels) {
+    std::mt19937 rng(75);
+    for (int round = 0; round < 20; ++round) {
+        uint64_t next_number = 1;
+        std::vector<std::vector<FileMetaData>> levels(kNumLevels);
+        levels[0] = {FileWithRange(next_number++, 100, 900), FileWithRange(next_number++, 5000, 5100)};
+        for (int level = 1; level < kNumLevels; ++level) {
+            // Leave some levels empty so hints have to skip them.
+            if (rng() % 4 != 0) {
+                levels[static_cast<size_t>(level)] = RandomLevel(&rng, &next_number, 1 << level, 10000);
+            }
+        }
+        FileIndexer indexer;
+        indexer.Update(KeyComparator(), levels);
+        for (int i = -1; i <= 10000; i += 7) {
+            std::string key = i < 0 ? std::string("a") : KeyFor(i, 6);
+            ASSERT_EQ(PickedFiles(levels, indexer, key), ScannedFiles(levels, key)) << "Round " << round << ", key " << key;
+        }
+    }
+}
+
+TEST(FileIndexerTest, Picker_ScansLevelsWithUnknownRanges) {
+    std::vector<std::vector<FileMetaData>> levels(kNumLevels);
+    levels[1] = {FileWithRange(1, 0, 99), FileWithRange(2, 200, 299)};
+    FileMetaData no_range;
+    no_range.number = 3;
+    levels[2] = {no_range, FileWithRange(4, 0, 49), FileWithRange(5, 250, 260)};
+    levels[3] = {FileWithRange(6, 0, 10), FileWithRange(7, 255, 400)};
+
+    FileIndexer indexer;
+    indexer.Update(KeyComparator(), levels);
+    EXPECT_EQ(PickedFiles(levels, indexer, KeyFor(5, 6)), (std::vector<uint64_t>{1, 3, 4, 6}));
+    EXPECT_EQ(PickedFiles(levels, indexer, KeyFor(255, 6)), (std::vector<uint64_t>{2, 3, 5, 7}));
+    EXPECT_EQ(PickedFiles(levels, indexer, KeyFor(150, 6)), (std::vector<uint64_t>{3}));
+
+    // An indexer never updated for these levels falls back to scanning them.
+    FileIndexer stale;
+    EXPECT_EQ(PickedFiles(levels, stale, KeyFor(255, 6)), (std::vector<uint64_t>{2, 3, 5, 7}));
+}
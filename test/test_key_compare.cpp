@@ -0,0 +1,26 @@
+#include "gtest/gtest.h"
+#include "key_compare.hpp"
+#include "slice.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+TEST(KeyCompareTest, KeyPrefix_IsConsistentWithByteOrder) {
+    const char* keys[] = {"", "\x01", "a", "a\x00", "ab", "abcdefgh", "abcdefgh\x01", "abcdefgi", "b", "\xff"};
+    const size_t sizes[] = {0, 1, 1, 2, 2, 8, 9, 8, 1, 1};
+    for (size_t i = 0; i < std::size(keys); ++i) {
+        for (size_t j = 0; j < std::size(keys); ++j) {
+            Slice a(reinterpret_cast<const std::byte*>(keys[i]), sizes[i]);
+            Slice b(reinterpret_cast<const std::byte*>(keys[j]), sizes[j]);
+            uint64_t pa = KeyPrefix(a.data(), a.size());
+            uint64_t pb = KeyPrefix(b.data(), b.size());
+            if (a.compare(b) < 0) {
+                EXPECT_LE(pa, pb) << i << " vs " << j;
+            }
+            if (pa < pb) {
+                EXPECT_LT(a.compare(b), 0) << i << " vs " << j;
+            }
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+#include "map_table.hpp"
+#include "mem_table_factory.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+class MapTableTest : public TempDirTest {
+protected:
+    MapTableTest() : TempDirTest("test_map_table_temp_dir") {}
+
+    static std::vector<std::string> Entries(SortedTableIterator* it) {
+        std::vector<std::string> entries;
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            ValueEntry value = it->value();
+            entries.push_back(it->key().ToString() + "=" +
+                              (value.IsTombstone() ? "<tombstone>" : value.value_slice.ToString()));
+        }
+        return entries;
+    }
+};
+
+TEST_F(MapTableTest, Get_SeesLatestWriteOfEachKey) {
+    MapTable table(*op_arena_);
+    ASSERT_TRUE(table.Put(StrToSlice("k"), StrToSlice("old")).ok());
+    ASSERT_TRUE(table.Put(StrToSlice("k"), StrToSlice("new")).ok());
+    ASSERT_TRUE(table.Put(StrToSlice("gone"), StrToSlice("v")).ok());
+    ASSERT_TRUE(table.Delete(StrToSlice("gone")).ok());
+    EXPECT_FALSE(table.Put(StrToSlice(""), StrToSlice("v")).ok());
+
+    Slice value;
+    ASSERT_TRUE(table.Get(StrToSlice("k"), &value).ok());
+    EXPECT_EQ(value.ToString(), "new");
+    EXPECT_TRUE(table.Get(StrToSlice("gone"), &value).IsTombstone());
+    EXPECT_TRUE(table.Get(StrToSlice("missing"), &value).IsNotFound());
+
+    std::unique_ptr<SortedTableIterator> it(table.NewIterator());
+    EXPECT_EQ(Entries(it.get()), (std::vector<std::string>{"gone=<tombstone>", "k=new"}));
+    it->Seek(StrToSlice("h"));
+    ASSERT_TRUE(it->Valid());
+    EXPECT_EQ(it->key().ToString(), "k");
+}
+
+TEST_F(MapTableTest, Overwrite_CopiesOnlyTheValue) {
+    MapTable table(*op_arena_);
+    // StrToSlice copies into the same arena, so take the slices up front.
+    Slice key = StrToSlice(std::string(1024, 'k'));
+    Slice first = StrToSlice("1");
+    Slice second = StrToSlice("2");
+    ASSERT_TRUE(table.Put(key, first).ok());
+    size_t before = op_arena_->GetTotalBytesUsed();
+    ASSERT_TRUE(table.Put(key, second).ok());
+    EXPECT_LT(op_arena_->GetTotalBytesUsed() - before, key.size());
+}
+
+TEST_F(MapTableTest, RandomWrites_MatchOrderedMapUnderBothComparators) {
+    ReverseBytewiseComparator reverse;
+    for (const Comparator* comparator : {BytewiseComparator(), static_cast<const Comparator*>(&reverse)}) {
+        MapTable table(*op_arena_, comparator);
+        std::map<std::string, std::string> model;
+        std::mt19937 rng(29);
+        for (int i = 0; i < 5000; ++i) {
+            std::string key = "key" + std::to_string(rng() % 2000);
+            std::string value = std::to_string(i);
+            if (rng() % 5 == 0) {
+                ASSERT_TRUE(table.Delete(StrToSlice(key)).ok());
+                value = "<tombstone>";
+            } else {
+                ASSERT_TRUE(table.Put(StrToSlice(key), StrToSlice(value)).ok());
+            }
+            model[key] = value;
+        }
+        std::vector<std::string> expected;
+        for (const auto& [key, value] : model) {
+            expected.push_back(key + "=" + value);
+        }
+        if (comparator != BytewiseComparator()) {
+            std::reverse(expected.begin(), expected.end());
+        }
+        std::unique_ptr<SortedTableIterator> it(table.NewIterator());
+        EXPECT_EQ(Entries(it.get()), expected) << comparator->Name();
+    }
+}
+
+TEST_F(MapTableTest, DB_DefaultsToMapMemTable) {
+    EXPECT_EQ(DBOptions().memtable_factory, MapMemTableFactory());
+    EXPECT_FALSE(MapMemTableFactory()->SupportsInplaceUpdate());
+
+    DBOptions options;
+    options.inplace_update_support = true;
+    DB rejected(test_dir_, 64 * 1024, options);
+    EXPECT_EQ(rejected.Init().code(), ResultCode::kInvalidArgument);
+}
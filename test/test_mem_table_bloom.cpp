@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+#include "mem_table_bloom.hpp"
+#include "mem_table.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class MemTableBloomTest : public TempDirTest {
+protected:
+    MemTableBloomTest() : TempDirTest("test_mem_table_bloom_temp_dir") {}
+};
+
+TEST_F(MemTableBloomTest, NoFalseNegativesAndFewFalsePositives) {
+    // 10 bits per key.
+    MemTableBloom bloom(*op_arena_, 10000 * 10 / 8);
+    ASSERT_TRUE(bloom.enabled());
+    for (int i = 0; i < 10000; ++i) {
+        bloom.Add(StrToSlice("key" + std::to_string(i)));
+    }
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_TRUE(bloom.MayContain(StrToSlice("key" + std::to_string(i)))) << i;
+    }
+    int false_positives = 0;
+    for (int i = 0; i < 10000; ++i) {
+        if (bloom.MayContain(StrToSlice("other" + std::to_string(i)))) {
+            false_positives++;
+        }
+    }
+    EXPECT_LT(false_positives, 300) << "Expected about 1-2% at 10 bits per key.";
+
+    MemTableBloom disabled(*op_arena_, 0);
+    EXPECT_FALSE(disabled.enabled());
+    EXPECT_TRUE(disabled.MayContain(StrToSlice("anything")));
+}
+
+TEST_F(MemTableBloomTest, MemTable_FilterKeepsReadsCorrect) {
+    MemTable memtable(*op_arena_, BytewiseComparator(), SkipListMemTableFactory(), 4096);
+    ASSERT_TRUE(memtable.Put(StrToSlice("a"), StrToSlice("1")).ok());
+    ASSERT_TRUE(memtable.Delete(StrToSlice("b")).ok());
+
+    Slice value;
+    ASSERT_TRUE(memtable.Get(StrToSlice("a"), &value).ok());
+    EXPECT_EQ(value.ToString(), "1");
+    EXPECT_TRUE(memtable.Get(StrToSlice("b"), &value).IsTombstone()) << "Deletes must be added to the filter too.";
+    EXPECT_TRUE(memtable.Get(StrToSlice("c"), &value).IsNotFound());
+}
+
+TEST_F(MemTableBloomTest, ReaderRunsConcurrentlyWithWriter) {
+    constexpr int kKeys = 20000;
+    std::vector<std::string> keys;
+    for (int i = 0; i < kKeys; ++i) {
+        keys.push_back("key" + std::to_string(i));
+    }
+    MemTableBloom bloom(*op_arena_, kKeys);
+    std::atomic<int> published{0};
+    std::atomic<bool> failed{false};
+
+    std::thread reader([&] {
+        while (published.load(std::memory_order_acquire) < kKeys) {
+            int upto = published.load(std::memory_order_acquire);
+            for (int i = 0; i < upto; i += 97) {
+                Slice key(reinterpret_cast<const std::byte*>(keys[static_cast<size_t>(i)].data()),
+                          keys[static_cast<size_t>(i)].size());
+                if (!bloom.MayContain(key)) {
+                    failed.store(true);
+                }
+            }
+        }
+    });
+    for (int i = 0; i < kKeys; ++i) {
+        Slice key(reinterpret_cast<const std::byte*>(keys[static_cast<size_t>(i)].data()),
+                  keys[static_cast<size_t>(i)].size());
+        bloom.Add(key);
+        published.store(i + 1, std::memory_order_release);
+    }
+    reader.join();
+    EXPECT_FALSE(failed.load()) << "A key added before it was published must never be ruled out.";
+}
+
+TEST_F(MemTableBloomTest, DB_ReadsWithMemTableBloomEnabled) {
+    DBOptions options;
+    options.memtable_bloom_size_ratio = 0.05;
+    options.disable_auto_compactions = true;
+    DB db(test_dir_, 1 << 20, options);
+    ASSERT_TRUE(db.Init().ok());
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(db.Put(StrToSlice("key" + std::to_string(i)), StrToSlice("v" + std::to_string(i))).ok());
+    }
+    ASSERT_TRUE(db.Delete(StrToSlice("key7")).ok());
+
+    std::string value;
+    ASSERT_TRUE(db.Get(StrToSlice("key42"), &value).ok());
+    EXPECT_EQ(value, "v42");
+    EXPECT_TRUE(db.Get(StrToSlice("key7"), &value).IsNotFound());
+    EXPECT_TRUE(db.Get(StrToSlice("missing"), &value).IsNotFound());
+}
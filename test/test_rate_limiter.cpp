@@ -0,0 +1,115 @@
+#include "gtest/gtest.h"
+#include "rate_limiter.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "test_utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+using Clock = std::chrono::steady_clock;
+
+static int64_t ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+TEST(RateLimiterTest, UserRequests_AreNeverThrottled) {
+    RateLimiter limiter(1024 /* bytes/s */);
+    auto start = Clock::now();
+    limiter.Request(100 * 1024 * 1024, IOPriority::kUser);
+    EXPECT_LT(ElapsedMs(start), 50);
+    EXPECT_EQ(limiter.GetTotalBytesThrough(IOPriority::kUser), 100 * 1024 * 1024);
+}
+
+TEST(RateLimiterTest, BackgroundRequests_ArePacedToConfiguredRate) {
+    // 1MB/s refilled every 10ms -> ~10KB per period.
+    RateLimiter limiter(1024 * 1024, 10 * 1000);
+    auto start = Clock::now();
+    limiter.Request(200 * 1024, IOPriority::kLow);
+    // 200KB at 1MB/s needs ~195ms; allow generous slack for slow machines.
+    EXPECT_GE(ElapsedMs(start), 150);
+    EXPECT_EQ(limiter.GetTotalBytesThrough(IOPriority::kLow), 200 * 1024);
+    EXPECT_EQ(limiter.GetTotalBytesThrough(IOPriority::kHigh), 0);
+}
+
+TEST(RateLimiterTest, HighPriority_IsGrantedBeforeQueuedLowPriority) {
+    // 100KB/s refilled every 100ms -> 10KB per period.
+    RateLimiter limiter(100 * 1024, 100 * 1000);
+    limiter.Request(10 * 1024, IOPriority::kLow); // Drain the first period.
+
+    std::atomic<int> completion_order{0};
+    int low_finished_as = -1;
+    int high_finished_as = -1;
+
+    std::thread low([&] {
+        limiter.Request(10 * 1024, IOPriority::kLow);
+        low_finished_as = completion_order.fetch_add(1);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::thread high([&] {
+        limiter.Request(10 * 1024, IOPriority::kHigh);
+        high_finished_as = completion_order.fetch_add(1);
+    });
+    low.join();
+    high.join();
+
+    EXPECT_EQ(high_finished_as, 0) << "Flush-priority request should overtake the queued compaction request.";
+    EXPECT_EQ(low_finished_as, 1);
+}
+
+TEST(RateLimiterTest, AutoTune_FollowsCompactionBacklog) {
+    const int64_t max_rate = 20 * 1024 * 1024;
+    const uint64_t backlog_for_max = 64 * 1024 * 1024;
+    RateLimiter limiter(max_rate, RateLimiter::kDefaultRefillPeriodUs, true /* auto_tuned */, backlog_for_max);
+    ASSERT_TRUE(limiter.IsAutoTuned());
+
+    limiter.TuneForBacklog(0);
+    int64_t idle_rate = limiter.GetBytesPerSecond();
+    EXPECT_LT(idle_rate, max_rate);
+    EXPECT_GT(idle_rate, 0);
+
+    limiter.TuneForBacklog(backlog_for_max / 2);
+    int64_t half_rate = limiter.GetBytesPerSecond();
+    EXPECT_GT(half_rate, idle_rate);
+    EXPECT_LT(half_rate, max_rate);
+
+    limiter.TuneForBacklog(backlog_for_max * 4);
+    EXPECT_EQ(limiter.GetBytesPerSecond(), max_rate);
+}
+
+TEST(RateLimiterTest, NotAutoTuned_IgnoresBacklog) {
+    RateLimiter limiter(1024 * 1024);
+    limiter.TuneForBacklog(1ull << 40);
+    EXPECT_EQ(limiter.GetBytesPerSecond(), 1024 * 1024);
+}
+
+TEST(RateLimiterTest, DB_RoutesFlushAndCompactionWritesThroughLimiter) {
+    const std::string db_dir = "test_rate_limiter_db_dir";
+    fs::remove_all(db_dir);
+    {
+        DBOptions options;
+        options.rate_limiter = std::make_shared<RateLimiter>(64 * 1024 * 1024);
+        options.level0_file_num_compaction_trigger = 2;
+        DB db(db_dir, 256, options);
+        ASSERT_TRUE(db.Init().ok());
+
+        Arena arena;
+        for (int i = 0; i < 20; ++i) {
+            std::string key = "key" + std::to_string(i);
+            ASSERT_TRUE(db.Put(StringToSlice(arena, key), StringToSlice(arena, "value_" + key)).ok());
+        }
+        EXPECT_GT(options.rate_limiter->GetTotalBytesThrough(IOPriority::kHigh), 0);
+        EXPECT_GT(options.rate_limiter->GetTotalBytesThrough(IOPriority::kLow), 0);
+        EXPECT_EQ(options.rate_limiter->GetTotalBytesThrough(IOPriority::kUser), 0);
+
+        std::string value_out;
+        ASSERT_TRUE(db.Get(StringToSlice(arena, "key3"), &value_out).ok());
+        EXPECT_EQ(value_out, "value_key3");
+    }
+    fs::remove_all(db_dir);
+}
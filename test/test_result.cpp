@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+#include "result.hpp"
+#include "mem_table.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+
+// Counts heap allocations made by this thread while counting is switched on.
+// The replacement operators are global, so they see every allocation in the
+// test binary; only the ones inside a CountAllocations scope are counted.
+namespace {
+thread_local bool counting_allocations = false;
+thread_local size_t allocation_count = 0;
+
+struct CountAllocations {
+    CountAllocations() {
+        allocation_count = 0;
+        counting_allocations = true;
+    }
+    ~CountAllocations() { counting_allocations = false; }
+    size_t count() const { return allocation_count; }
+};
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (counting_allocations) {
+        allocation_count++;
+    }
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+class ResultTest : public ::testing::Test {
+protected:
+    Arena arena_;
+    MemTable memtable_{arena_};
+
+    void SetUp() override {
+        ASSERT_TRUE(memtable_.Put(StringToSlice(arena_, "live"), StringToSlice(arena_, "value")).ok());
+        ASSERT_TRUE(memtable_.Put(StringToSlice(arena_, "deleted"), StringToSlice(arena_, "x")).ok());
+        ASSERT_TRUE(memtable_.Delete(StringToSlice(arena_, "deleted")).ok());
+    }
+};
+
+TEST_F(ResultTest, StatusOnlyResults_DoNotAllocate) {
+    size_t allocations = 0;
+    {
+        CountAllocations counter;
+        Result ok = Result::OK();
+        Result not_found = Result::NotFound();
+        Result tombstone = Result::FoundTombstone();
+        Result copy = not_found;
+        Result moved = std::move(tombstone);
+        copy = ok;
+        EXPECT_TRUE(copy.ok());
+        EXPECT_TRUE(moved.IsTombstone());
+        EXPECT_TRUE(not_found.IsNotFound());
+        EXPECT_TRUE(not_found.message().empty());
+        allocations = counter.count();
+    }
+    EXPECT_EQ(allocations, 0U);
+}
+
+TEST_F(ResultTest, MemTableGet_HitMissAndTombstone_DoNotAllocate) {
+    Slice live = StringToSlice(arena_, "live");
+    Slice deleted = StringToSlice(arena_, "deleted");
+    Slice missing = StringToSlice(arena_, "missing");
+    Slice value;
+    Result hit, tombstone, miss;
+    size_t allocations = 0;
+    {
+        CountAllocations counter;
+        hit = memtable_.Get(live, &value);
+        tombstone = memtable_.Get(deleted, &value);
+        miss = memtable_.Get(missing, &value);
+        allocations = counter.count();
+    }
+    EXPECT_EQ(allocations, 0U);
+    ASSERT_TRUE(hit.ok()) << hit.ToString();
+    EXPECT_EQ(tombstone.code(), ResultCode::kFoundTombstone);
+    EXPECT_EQ(miss.code(), ResultCode::kNotFound);
+
+    Slice hit_value;
+    ASSERT_TRUE(memtable_.Get(live, &hit_value).ok());
+    EXPECT_EQ(hit_value.ToString(), "value");
+}
+
+TEST_F(ResultTest, ErrorMessage_SurvivesCopyAndMove) {
+    Result corruption = Result::Corruption("bad block");
+    Result copy = corruption;
+    Result moved = std::move(corruption);
+    EXPECT_EQ(copy.code(), ResultCode::kCorruption);
+    EXPECT_EQ(copy.message(), "bad block");
+    EXPECT_EQ(moved.message(), "bad block");
+    EXPECT_EQ(copy, moved);
+    EXPECT_EQ(moved.ToString(), "Corruption: bad block");
+    EXPECT_NE(Result::NotFound(), Result::NotFound("other"));
+}
@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+#include "sst_file_writer.hpp"
+#include "sstable_reader.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace fs = std::filesystem;
+
+class SstFileWriterTest : public TempDirTest {
+protected:
+    SstFileWriterTest() : TempDirTest("test_sst_file_writer_temp_dir") {}
+
+    std::string db_dir_ = "test_sst_file_writer_temp_dir/db";
+    // Writes keys [begin, end) with values prefixed by `value_prefix`.
+    std::string BuildExternalFile(const std::string& name, int begin, int end, const std::string& value_prefix) {
+        std::string path = (fs::path(test_dir_) / name).string();
+        SstFileWriter writer;
+        EXPECT_TRUE(writer.Open(path).ok());
+        for (int i = begin; i < end; ++i) {
+            EXPECT_TRUE(writer.Put(StrToSlice(KeyFor(i)), StrToSlice(value_prefix + std::to_string(i))).ok());
+        }
+        EXPECT_TRUE(writer.Finish().ok());
+        return path;
+    }
+
+    uint64_t CountTombstonesInDB() {
+        uint64_t tombstones = 0;
+        for (const auto& entry : fs::directory_iterator(db_dir_)) {
+            if (entry.path().extension() != ".sst") {
+                continue;
+            }
+            SSTableReader reader(entry.path().string());
+            EXPECT_TRUE(reader.Init().ok());
+            TableProperties properties;
+            EXPECT_TRUE(reader.GetTableProperties(&properties).ok());
+            tombstones += properties.num_tombstones;
+        }
+        return tombstones;
+    }
+};
+
+TEST_F(SstFileWriterTest, Writer_RejectsOutOfOrderKeys) {
+    SstFileWriter writer;
+    ASSERT_TRUE(writer.Open((fs::path(test_dir_) / "unordered.sst").string()).ok());
+    ASSERT_TRUE(writer.Put(StrToSlice("b"), StrToSlice("1")).ok());
+    EXPECT_EQ(writer.Put(StrToSlice("a"), StrToSlice("2")).code(), ResultCode::kInvalidArgument);
+    EXPECT_EQ(writer.Delete(StrToSlice("b")).code(), ResultCode::kInvalidArgument);
+    EXPECT_TRUE(writer.Delete(StrToSlice("c")).ok());
+    EXPECT_EQ(writer.NumEntries(), 2U);
+    EXPECT_TRUE(writer.Finish().ok());
+}
+
+TEST_F(SstFileWriterTest, Writer_OutputIsReadableAndReportsKeyRange) {
+    std::string path = BuildExternalFile("range.sst", 0, 2000, "value_");
+
+    SSTableReader reader(path);
+    ASSERT_TRUE(reader.Init().ok());
+    std::string smallest;
+    std::string largest;
+    ASSERT_TRUE(reader.GetKeyRange(&smallest, &largest).ok());
+    EXPECT_EQ(smallest, KeyFor(0));
+    EXPECT_EQ(largest, KeyFor(1999));
+
+    std::vector<std::string> boundaries;
+    ASSERT_TRUE(reader.GetBlockBoundaryKeys(&boundaries).ok());
+    EXPECT_GT(boundaries.size(), 1U) << "2000 entries should span several blocks.";
+
+    std::string value_out;
+    ASSERT_TRUE(reader.Get(StrToSlice(KeyFor(1234)), &value_out).ok());
+    EXPECT_EQ(value_out, "value_1234");
+}
+
+TEST_F(SstFileWriterTest, Ingest_NonOverlappingFileGoesToBottomLevel) {
+    DBOptions options;
+    DB db(db_dir_, 1024 * 1024, options);
+    ASSERT_TRUE(db.Init().ok());
+
+    std::string path = BuildExternalFile("bulk.sst", 0, 500, "bulk_");
+    ASSERT_TRUE(db.IngestExternalFile(path).ok());
+    EXPECT_TRUE(fs::exists(path)) << "Without move_files the original is kept.";
+    EXPECT_EQ(db.NumFilesAtLevel(kNumLevels - 1), 1U);
+    EXPECT_EQ(db.NumFilesAtLevel(0), 0U);
+
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(0)), "bulk_0");
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(499)), "bulk_499");
+
+    // A second, disjoint file also fits at the bottom.
+    std::string path2 = BuildExternalFile("bulk2.sst", 500, 600, "bulk_");
+    ASSERT_TRUE(db.IngestExternalFile(path2, true /* move_files */).ok());
+    EXPECT_FALSE(fs::exists(path2));
+    EXPECT_EQ(db.NumFilesAtLevel(kNumLevels - 1), 2U);
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(550)), "bulk_550");
+}
+
+TEST_F(SstFileWriterTest, Ingest_BottomFileKeepsOnlyTombstonesItMayShadow) {
+    DBOptions options;
+    options.disable_auto_compactions = true;
+    DB db(db_dir_, 1024, options);
+    ASSERT_TRUE(db.Init().ok());
+    ASSERT_TRUE(db.IngestExternalFile(BuildExternalFile("bulk.sst", 0, 100, "bulk_")).ok());
+    ASSERT_EQ(db.NumFilesAtLevel(kNumLevels - 1), 1U);
+
+    // Nothing below L1 holds this key, so compaction drops its tombstone.
+    ASSERT_TRUE(db.Put(StrToSlice("outside_bulk"), StrToSlice("v")).ok());
+    ASSERT_TRUE(db.Delete(StrToSlice("outside_bulk")).ok());
+    FlushByFilling(&db);
+    ASSERT_TRUE(db.CompactLevel0().ok());
+    EXPECT_EQ(CountTombstonesInDB(), 0U);
+
+    // This one shadows an ingested key and has to be kept.
+    ASSERT_TRUE(db.Delete(StrToSlice(KeyFor(5))).ok());
+    FlushByFilling(&db);
+    ASSERT_TRUE(db.CompactLevel0().ok());
+    EXPECT_EQ(CountTombstonesInDB(), 1U);
+    std::string value_out;
+    EXPECT_EQ(db.Get(StrToSlice(KeyFor(5)), &value_out).code(), ResultCode::kNotFound);
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(6)), "bulk_6");
+}
+
+TEST_F(SstFileWriterTest, Ingest_OverlappingFileShadowsExistingData) {
+    DBOptions options;
+    options.disable_auto_compactions = true;
+    DB db(db_dir_, 1024 * 1024, options);
+    ASSERT_TRUE(db.Init().ok());
+
+    ASSERT_TRUE(db.IngestExternalFile(BuildExternalFile("base.sst", 0, 100, "old_")).ok());
+    ASSERT_EQ(db.NumFilesAtLevel(kNumLevels - 1), 1U);
+
+    // Overlaps the bottom file, so it lands one level above it.
+    ASSERT_TRUE(db.IngestExternalFile(BuildExternalFile("mid.sst", 50, 60, "mid_")).ok());
+    EXPECT_EQ(db.NumFilesAtLevel(kNumLevels - 2), 1U);
+
+    // The memtable holds an overlapping key; it is flushed to L0 first, and the
+    // ingested file goes above it as the newest L0 file.
+    ASSERT_TRUE(db.Put(StrToSlice(KeyFor(55)), StrToSlice("memtable")).ok());
+    ASSERT_TRUE(db.Put(StrToSlice(KeyFor(56)), StrToSlice("memtable")).ok());
+    ASSERT_TRUE(db.IngestExternalFile(BuildExternalFile("top.sst", 56, 58, "top_")).ok());
+    EXPECT_EQ(db.NumFilesAtLevel(0), 2U);
+
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(10)), "old_10");
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(52)), "mid_52");
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(55)), "memtable");
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(56)), "top_56");
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(57)), "top_57");
+
+    // Compacting L0 keeps the newest versions.
+    ASSERT_TRUE(db.CompactLevel0().ok());
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(55)), "memtable");
+    EXPECT_EQ(GetOrStatus(&db, KeyFor(56)), "top_56");
+}
+
+TEST_F(SstFileWriterTest, Ingest_RejectsEmptyOrMissingFile) {
+    DB db(db_dir_, 1024 * 1024);
+    ASSERT_TRUE(db.Init().ok());
+
+    std::string empty_path = (fs::path(test_dir_) / "empty.sst").string();
+    { std::ofstream(empty_path, std::ios::binary); }
+    EXPECT_FALSE(db.IngestExternalFile(empty_path).ok());
+    EXPECT_FALSE(db.IngestExternalFile((fs::path(test_dir_) / "missing.sst").string()).ok());
+    for (int level = 0; level < kNumLevels; ++level) {
+        EXPECT_EQ(db.NumFilesAtLevel(level), 0U);
+    }
+}
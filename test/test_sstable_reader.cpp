@@ -91,7 +91,8 @@ TEST_F(SSTableReaderAndIteratorTest, Reader_Init_EmptySSTableFile) {
 
     // Get on an empty SSTable should be NotFound
     Slice test_key("anykey");
-    Result get_res = reader.Get(test_key, arena_for_reads_.get());
+    Slice value;
+    Result get_res = reader.Get(test_key, arena_for_reads_.get(), &value);
     ASSERT_FALSE(get_res.ok());
     ASSERT_EQ(get_res.code(), ResultCode::kNotFound);
 }
@@ -114,11 +115,11 @@ TEST_F(SSTableReaderAndIteratorTest, Reader_Get_SingleBlock_KeyExists_NoCompress
     ASSERT_TRUE(reader.Init().ok());
 
     Slice key_to_find("key1");
-    Result get_res = reader.Get(key_to_find, arena_for_reads_.get());
+    Slice value;
+    Result get_res = reader.Get(key_to_find, arena_for_reads_.get(), &value);
     ASSERT_TRUE(get_res.ok()) << "Get failed for key1: " << get_res.message();
-    ASSERT_TRUE(get_res.value_slice().has_value());
-    ASSERT_EQ(get_res.value_slice().value().ToString(), "value1_nc");
-    ASSERT_TRUE(IsPointerDistinctFromBuffer(get_res.value_slice().value().data(), reader.TEST_ONLY_get_internal_buffer_DEBUG()))
+    ASSERT_EQ(value.ToString(), "value1_nc");
+    ASSERT_TRUE(IsPointerDistinctFromBuffer(value.data(), reader.TEST_ONLY_get_internal_buffer_DEBUG()))
         << "Value slice should point to arena memory, not reader's internal buffer.";
 }
 
@@ -133,11 +134,11 @@ TEST_F(SSTableReaderAndIteratorTest, Reader_Get_SingleBlock_KeyExists_WithCompre
     ASSERT_TRUE(reader.Init().ok());
 
     Slice key_to_find("keyA");
-    Result get_res = reader.Get(key_to_find, arena_for_reads_.get());
+    Slice value;
+    Result get_res = reader.Get(key_to_find, arena_for_reads_.get(), &value);
     ASSERT_TRUE(get_res.ok()) << "Get failed for keyA (compressed): " << get_res.message();
-    ASSERT_TRUE(get_res.value_slice().has_value());
-    ASSERT_EQ(get_res.value_slice().value().ToString(), std::string(100, 'a'));
-    ASSERT_TRUE(IsPointerDistinctFromBuffer(get_res.value_slice().value().data(), reader.TEST_ONLY_get_internal_buffer_DEBUG()));
+    ASSERT_EQ(value.ToString(), std::string(100, 'a'));
+    ASSERT_TRUE(IsPointerDistinctFromBuffer(value.data(), reader.TEST_ONLY_get_internal_buffer_DEBUG()));
 
 }
 
@@ -149,12 +150,13 @@ TEST_F(SSTableReaderAndIteratorTest, Reader_Get_KeyNotExists) {
     ASSERT_TRUE(reader.Init().ok());
 
     Slice key_to_find("non_existent_key");
-    Result get_res = reader.Get(key_to_find, arena_for_reads_.get());
+    Slice value;
+    Result get_res = reader.Get(key_to_find, arena_for_reads_.get(), &value);
     ASSERT_FALSE(get_res.ok());
     ASSERT_EQ(get_res.code(), ResultCode::kNotFound);
 }
 
-TEST_F(SSTableReaderAndIteratorTest, Reader_Get_KeyIsTombstone_ReturnsOkWithTombstoneTag) { // Renamed test
+TEST_F(SSTableReaderAndIteratorTest, Reader_Get_KeyIsTombstone_ReturnsFoundTombstone) {
     std::vector<TestEntry> entries = {
         {"live_key", "live_value"},
         {"deleted_key", "", ValueTag::kTombstone}
@@ -165,12 +167,12 @@ TEST_F(SSTableReaderAndIteratorTest, Reader_Get_KeyIsTombstone_ReturnsOkWithTomb
     ASSERT_TRUE(reader.Init().ok());
 
     Slice key_to_find("deleted_key");
-    Result get_res = reader.Get(key_to_find, arena_for_reads_.get());
+    Slice value;
+    Result get_res = reader.Get(key_to_find, arena_for_reads_.get(), &value);
     
-    ASSERT_TRUE(get_res.ok()) << "Get for a tombstone should return an OK status.";
-    ASSERT_TRUE(get_res.value_tag().has_value());
-    ASSERT_EQ(get_res.value_tag().value(), ValueTag::kTombstone) << "The value_tag should indicate kTombstone.";
-    ASSERT_FALSE(get_res.value_slice().has_value()) << "Value slice should not be present for a tombstone from Get.";
+    ASSERT_EQ(get_res.code(), ResultCode::kFoundTombstone) << get_res.ToString();
+    ASSERT_TRUE(get_res.message().empty());
+    ASSERT_TRUE(value.empty()) << "No value is returned for a tombstone.";
 }
 
 
@@ -191,11 +193,11 @@ TEST_F(SSTableReaderAndIteratorTest, Reader_Get_MultiBlock_KeyInLaterBlock) {
     ASSERT_TRUE(reader.Init().ok());
 
     Slice key_to_find("key03"); // Expected in the second block
-    Result get_res = reader.Get(key_to_find, arena_for_reads_.get());
+    Slice value;
+    Result get_res = reader.Get(key_to_find, arena_for_reads_.get(), &value);
     ASSERT_TRUE(get_res.ok()) << "Get failed for key03 (multi-block): " << get_res.message();
-    ASSERT_TRUE(get_res.value_slice().has_value());
-    ASSERT_EQ(get_res.value_slice().value().ToString(), std::string(30, 'c'));
-    ASSERT_TRUE(IsPointerDistinctFromBuffer(get_res.value_slice().value().data(), reader.TEST_ONLY_get_internal_buffer_DEBUG()));
+    ASSERT_EQ(value.ToString(), std::string(30, 'c'));
+    ASSERT_TRUE(IsPointerDistinctFromBuffer(value.data(), reader.TEST_ONLY_get_internal_buffer_DEBUG()));
 }
 
 TEST_F(SSTableReaderAndIteratorTest, Reader_Get_ValueIsEmpty) {
@@ -206,14 +208,42 @@ TEST_F(SSTableReaderAndIteratorTest, Reader_Get_ValueIsEmpty) {
     ASSERT_TRUE(reader.Init().ok());
     
     Slice key_to_find("key_with_empty_value");
-    Result get_res = reader.Get(key_to_find, arena_for_reads_.get());
+    Slice value;
+    Result get_res = reader.Get(key_to_find, arena_for_reads_.get(), &value);
     ASSERT_TRUE(get_res.ok()) << get_res.message();
-    ASSERT_TRUE(get_res.value_slice().has_value());
-    ASSERT_TRUE(get_res.value_slice().value().empty());
+    ASSERT_TRUE(value.empty());
     // Arena::Allocate(0) returns nullptr. Slice(nullptr,0) is valid.
-    ASSERT_EQ(get_res.value_slice().value().data(), nullptr); 
+    ASSERT_EQ(value.data(), nullptr); 
 }
 
+TEST_F(SSTableReaderAndIteratorTest, Reader_Get_BlocksOfVaryingSizesShareBuffers) {
+    // Block sizes shrink and grow between loads, and one block exceeds what
+    // the per-thread scratch buffer keeps. Two readers alternate on one thread.
+    const size_t kSizes[] = {10, 3000, 20, (1 << 20) + 100, 50};
+    for (bool compression : {false, true}) {
+        std::vector<TestEntry> entries;
+        for (int i = 0; i < 15; ++i) {
+            std::string value(kSizes[i % 5], static_cast<char>('a' + i));
+            value[0] = static_cast<char>('A' + i % 5);
+            entries.push_back({"key" + std::to_string(10 + i), value});
+        }
+        WriteTestSSTable(entries, compression, 100);
+
+        SSTableReader first(temp_sstable_filename_);
+        SSTableReader second(temp_sstable_filename_);
+        ASSERT_TRUE(first.Init().ok());
+        ASSERT_TRUE(second.Init().ok());
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t i = 0; i < entries.size(); ++i) {
+                SSTableReader& reader = (i + static_cast<size_t>(pass)) % 2 == 0 ? first : second;
+                std::string value_out;
+                ASSERT_TRUE(reader.Get(StringToSlice(*arena_for_reads_, entries[i].key), &value_out).ok())
+                    << entries[i].key << " compression=" << compression;
+                EXPECT_EQ(value_out, entries[i].value) << entries[i].key << " compression=" << compression;
+            }
+        }
+    }
+}
 
 // --- SSTableIterator Tests ---
 
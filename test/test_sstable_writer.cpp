@@ -257,6 +257,29 @@ protected:
              ASSERT_EQ(uncompressed_size_from_header, 0) << "If no entries expected, uncompressed size from header should be 0.";
         }
     }
+
+    // The data blocks are followed by the properties block and the footer,
+    // which ends the file.
+    void VerifyPropertiesBlockAndEof(std::ifstream& file_stream) {
+        uint64_t properties_offset = static_cast<uint64_t>(file_stream.tellg());
+        char header_buf[9];
+        file_stream.read(header_buf, 9);
+        ASSERT_EQ(file_stream.gcount(), 9) << "Failed to read properties block header.";
+        ASSERT_EQ(header_buf[8], kPropertiesBlockFlag);
+        uint32_t size = ReadLittleEndian32(header_buf + 4);
+        std::string block(size, '\0');
+        file_stream.read(block.data(), size);
+        ASSERT_EQ(static_cast<uint32_t>(file_stream.gcount()), size);
+        EXPECT_NE(block.find(BytewiseComparator()->Name()), std::string::npos);
+        char footer[kTableFooterSize];
+        file_stream.read(footer, kTableFooterSize);
+        ASSERT_EQ(static_cast<size_t>(file_stream.gcount()), kTableFooterSize) << "Failed to read footer.";
+        EXPECT_EQ(ReadLittleEndian64(footer), properties_offset);
+        EXPECT_EQ(ReadLittleEndian32(footer + 8), kTableFormatVersion);
+        EXPECT_EQ(ReadLittleEndian64(footer + 12), kTableMagicNumber);
+        file_stream.peek();
+        ASSERT_TRUE(file_stream.eof()) << "Expected end of file after the footer.";
+    }
 };
 
 TEST_F(SSTableWriterTest, WriteEmptyMemTable) {
@@ -292,8 +315,7 @@ TEST_F(SSTableWriterTest, WriteSingleSmallBlockNoCompression) {
     ASSERT_TRUE(file.is_open());
     VerifyBlock(file, expected_sorted_entries, false); 
     
-    file.peek(); 
-    ASSERT_TRUE(file.eof()) << "Expected end of file after single block.";
+    VerifyPropertiesBlockAndEof(file);
     file.close();
 }
 
@@ -318,8 +340,7 @@ TEST_F(SSTableWriterTest, WriteSingleSmallBlockWithCompression) {
     ASSERT_TRUE(file.is_open());
     VerifyBlock(file, expected_sorted_entries, true); 
     
-    file.peek();
-    ASSERT_TRUE(file.eof()) << "Expected end of file after single block.";
+    VerifyPropertiesBlockAndEof(file);
     file.close();
 }
 
@@ -345,8 +366,7 @@ TEST_F(SSTableWriterTest, WriteTombstone) {
     ASSERT_TRUE(file.is_open());
     VerifyBlock(file, expected_sorted_entries, false); 
     
-    file.peek();
-    ASSERT_TRUE(file.eof()) << "Expected end of file after tombstone block.";
+    VerifyPropertiesBlockAndEof(file);
     file.close();
 }
 
@@ -412,8 +432,7 @@ TEST_F(SSTableWriterTest, WriteMultipleBlocks) {
     ASSERT_TRUE(file.good() && !file.eof()) << "File ended prematurely after first block, or stream error.";
     VerifyBlock(file, expected_block2_entries, false); 
     
-    file.peek();
-    ASSERT_TRUE(file.eof()) << "Expected end of file after second block.";
+    VerifyPropertiesBlockAndEof(file);
     file.close();
 }
 
@@ -484,8 +503,7 @@ TEST_F(SSTableWriterTest, CompressionFallbackForIncompressibleData) {
     VerifyBlock(file, expected_sorted_entries, true); // true: writer was configured with compression ON
                                                       // VerifyBlock will check the actual flag written.
     
-    file.peek(); 
-    ASSERT_TRUE(file.eof()) << "Expected end of file after block of incompressible data.";
+    VerifyPropertiesBlockAndEof(file);
     file.close();
 }
 
@@ -0,0 +1,212 @@
+#include "gtest/gtest.h"
+#include "table_builder.hpp"
+#include "sstable_reader.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace fs = std::filesystem;
+
+class TableBuilderTest : public TempDirTest {
+protected:
+    TableBuilderTest() : TempDirTest("test_table_builder_temp_dir") {}
+
+    std::string PathFor(const std::string& name) {
+        return (fs::path(test_dir_) / name).string();
+    }
+};
+
+TEST_F(TableBuilderTest, AddFinish_WritesReadableTable) {
+    std::string path = PathFor("basic.sst");
+    TableBuilder builder(true);
+    ASSERT_TRUE(builder.Open(path).ok());
+    ASSERT_TRUE(builder.Add(StrToSlice("apple"), ValueEntry(StrToSlice("red"))).ok());
+    ASSERT_TRUE(builder.Add(StrToSlice("banana"), ValueEntry(ValueTag::kTombstone)).ok());
+    ASSERT_TRUE(builder.Add(StrToSlice("cherry"), ValueEntry(StrToSlice("dark"))).ok());
+    EXPECT_EQ(builder.Add(StrToSlice("banana"), ValueEntry(StrToSlice("late"))).code(), ResultCode::kInvalidArgument);
+    ASSERT_TRUE(builder.Finish().ok());
+    EXPECT_EQ(builder.NumEntries(), 3U);
+    EXPECT_EQ(builder.FileSize(), fs::file_size(path));
+
+    SSTableReader reader(path);
+    ASSERT_TRUE(reader.Init().ok());
+    std::string value_out;
+    ASSERT_TRUE(reader.Get(StrToSlice("cherry"), &value_out).ok());
+    EXPECT_EQ(value_out, "dark");
+    Result tombstone_res = reader.Get(StrToSlice("banana"), &value_out);
+    EXPECT_EQ(tombstone_res.code(), ResultCode::kFoundTombstone);
+}
+
+TEST_F(TableBuilderTest, Abandon_RemovesPartialFileAndAllowsReuse) {
+    TableBuilder builder(false);
+    ASSERT_TRUE(builder.Open(PathFor("abandoned.sst")).ok());
+    ASSERT_TRUE(builder.Add(StrToSlice("k"), ValueEntry(StrToSlice("v"))).ok());
+    builder.Abandon();
+    EXPECT_FALSE(builder.IsOpen());
+    EXPECT_FALSE(fs::exists(PathFor("abandoned.sst")));
+
+    // Ordering restarts with the next file.
+    ASSERT_TRUE(builder.Open(PathFor("second.sst")).ok());
+    ASSERT_TRUE(builder.Add(StrToSlice("a"), ValueEntry(StrToSlice("v"))).ok());
+    ASSERT_TRUE(builder.Finish().ok());
+    EXPECT_TRUE(fs::exists(PathFor("second.sst")));
+}
+
+TEST_F(TableBuilderTest, LargeOutput_HasNoEntryLimit) {
+    // The old writer gave up after 100,000 entries.
+    const int kEntries = 150000;
+    std::string path = PathFor("large.sst");
+    TableBuilder builder(true, 1, 64 * 1024);
+    ASSERT_TRUE(builder.Open(path).ok());
+    for (int i = 0; i < kEntries; ++i) {
+        std::string key = KeyFor(i, 7);
+        Slice key_slice(reinterpret_cast<const std::byte*>(key.data()), key.size());
+        ASSERT_TRUE(builder.Add(key_slice, ValueEntry(key_slice)).ok());
+    }
+    ASSERT_TRUE(builder.Finish().ok());
+    EXPECT_EQ(builder.NumEntries(), static_cast<uint64_t>(kEntries));
+
+    SSTableReader reader(path);
+    ASSERT_TRUE(reader.Init().ok());
+    std::string smallest;
+    std::string largest;
+    ASSERT_TRUE(reader.GetKeyRange(&smallest, &largest).ok());
+    EXPECT_EQ(smallest, KeyFor(0, 7));
+    EXPECT_EQ(largest, KeyFor(kEntries - 1, 7));
+}
+
+TEST_F(TableBuilderTest, OversizedEntries_GrowTheReusedBlockBuffer) {
+    // Values far beyond the block buffer's reserved capacity, between small
+    // entries, across two files built by the same builder.
+    TableBuilder builder(false, 1, 256);
+    for (const char* name : {"first.sst", "second.sst"}) {
+        std::string path = PathFor(name);
+        ASSERT_TRUE(builder.Open(path).ok());
+        for (int i = 0; i < 20; ++i) {
+            std::string value(i % 5 == 0 ? 10000 + static_cast<size_t>(i) : 8, static_cast<char>('a' + i));
+            ASSERT_TRUE(builder.Add(StrToSlice(KeyFor(i, 7)), ValueEntry(StrToSlice(value))).ok());
+        }
+        ASSERT_TRUE(builder.Finish().ok());
+        EXPECT_EQ(builder.FileSize(), fs::file_size(path));
+
+        SSTableReader reader(path);
+        ASSERT_TRUE(reader.Init().ok());
+        for (int i = 0; i < 20; ++i) {
+            std::string value_out;
+            ASSERT_TRUE(reader.Get(StrToSlice(KeyFor(i, 7)), &value_out).ok()) << name << " " << i;
+            EXPECT_EQ(value_out, std::string(i % 5 == 0 ? 10000 + static_cast<size_t>(i) : 8,
+                                             static_cast<char>('a' + i)));
+        }
+    }
+}
+
+TEST_F(TableBuilderTest, Properties_ReadThroughFooter) {
+    std::string path = PathFor("props.sst");
+    TableBuilder builder(true, 1, 256);
+    ASSERT_TRUE(builder.Open(path).ok());
+    uint64_t key_bytes = 0;
+    uint64_t value_bytes = 0;
+    for (int i = 0; i < 100; ++i) {
+        std::string key = KeyFor(i, 7);
+        key_bytes += key.size();
+        if (i % 10 == 3) {
+            ASSERT_TRUE(builder.Add(StrToSlice(key), ValueEntry(ValueTag::kTombstone)).ok());
+        } else {
+            std::string value(static_cast<size_t>(i), 'v');
+            value_bytes += value.size();
+            ASSERT_TRUE(builder.Add(StrToSlice(key), ValueEntry(StrToSlice(value))).ok());
+        }
+    }
+    ASSERT_TRUE(builder.Finish().ok());
+
+    SSTableReader reader(path);
+    ASSERT_TRUE(reader.Init().ok());
+    TableProperties props;
+    ASSERT_TRUE(reader.GetTableProperties(&props).ok());
+    EXPECT_EQ(props.format_version, kTableFormatVersion);
+    EXPECT_EQ(props.num_entries, 100U);
+    EXPECT_EQ(props.num_tombstones, 10U);
+    EXPECT_EQ(props.raw_key_bytes, key_bytes);
+    EXPECT_EQ(props.raw_value_bytes, value_bytes);
+    EXPECT_GT(props.num_data_blocks, 1U);
+    EXPECT_GT(props.data_bytes, 0U);
+    EXPECT_LT(props.data_bytes, fs::file_size(path));
+    EXPECT_EQ(props.smallest_key, KeyFor(0, 7));
+    EXPECT_EQ(props.largest_key, KeyFor(99, 7));
+    EXPECT_EQ(props.compression, "zstd");
+    EXPECT_EQ(props.comparator_name, BytewiseComparator()->Name());
+
+    const TableProperties& written = builder.properties();
+    EXPECT_EQ(written.num_data_blocks, props.num_data_blocks);
+    EXPECT_EQ(written.data_bytes, props.data_bytes);
+
+    // Every block is still readable up to the properties block.
+    std::string value_out;
+    ASSERT_TRUE(reader.Get(StrToSlice(KeyFor(99, 7)), &value_out).ok());
+    EXPECT_EQ(value_out, std::string(99, 'v'));
+}
+
+TEST_F(TableBuilderTest, Properties_TableWithoutFooterReadsAsVersionOne) {
+    std::string path = PathFor("old.sst");
+    TableBuilder builder(false);
+    ASSERT_TRUE(builder.Open(path).ok());
+    ASSERT_TRUE(builder.Add(StrToSlice("a"), ValueEntry(StrToSlice("1"))).ok());
+    ASSERT_TRUE(builder.Add(StrToSlice("b"), ValueEntry(StrToSlice("2"))).ok());
+    ASSERT_TRUE(builder.Finish().ok());
+    // Drop the footer, leaving the layout tables had before it existed.
+    fs::resize_file(path, fs::file_size(path) - kTableFooterSize);
+
+    SSTableReader reader(path);
+    ASSERT_TRUE(reader.Init().ok());
+    TableProperties props;
+    EXPECT_TRUE(reader.GetTableProperties(&props).IsNotFound());
+    std::string name;
+    ASSERT_TRUE(reader.GetProperty(kComparatorNameProperty, &name).ok());
+    EXPECT_EQ(name, BytewiseComparator()->Name());
+    std::string smallest;
+    std::string largest;
+    ASSERT_TRUE(reader.GetKeyRange(&smallest, &largest).ok());
+    EXPECT_EQ(smallest, "a");
+    EXPECT_EQ(largest, "b");
+}
+
+TEST_F(TableBuilderTest, Rolling_SplitsOutputAtTargetFileSize) {
+    uint64_t next_number = 1;
+    RollingTableBuilder rolling(false, 4096, [&]() {
+        FileMetaData meta;
+        meta.number = next_number++;
+        meta.path = PathFor("out" + std::to_string(meta.number) + ".sst");
+        return meta;
+    });
+    for (int i = 0; i < 2000; ++i) {
+        ASSERT_TRUE(rolling.Add(StrToSlice(KeyFor(i, 7)), ValueEntry(StrToSlice("value_" + std::to_string(i)))).ok());
+    }
+    ASSERT_TRUE(rolling.Finish().ok());
+
+    const std::vector<FileMetaData>& outputs = rolling.outputs();
+    ASSERT_GT(outputs.size(), 1U);
+    std::string previous_largest;
+    for (const FileMetaData& f : outputs) {
+        EXPECT_EQ(f.file_size, fs::file_size(f.path));
+        // Only the file being written when the target was crossed overshoots,
+        // and by less than one block.
+        EXPECT_LT(f.file_size, 4096U + 4096U);
+
+        SSTableReader reader(f.path);
+        ASSERT_TRUE(reader.Init().ok());
+        std::string smallest;
+        std::string largest;
+        ASSERT_TRUE(reader.GetKeyRange(&smallest, &largest).ok());
+        EXPECT_GT(smallest, previous_largest);
+        previous_largest = largest;
+    }
+    EXPECT_EQ(previous_largest, KeyFor(1999, 7));
+
+    rolling.Abandon();
+    for (const FileMetaData& f : outputs) {
+        EXPECT_FALSE(fs::exists(f.path));
+    }
+}
@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include "thread_pool.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace fs = std::filesystem;
+
+class ThreadPoolTest : public TempDirTest {
+protected:
+    ThreadPoolTest() : TempDirTest("test_thread_pool_temp_dir") {}
+};
+
+TEST_F(ThreadPoolTest, Schedule_RunsJobsAndCountsThem) {
+    ThreadPool pool;
+    std::atomic<int> runs{0};
+    std::vector<std::future<void>> jobs;
+    for (int i = 0; i < 10; ++i) {
+        jobs.push_back(pool.Schedule([&runs]() { runs++; }, i % 2 == 0 ? ThreadPriority::kHigh : ThreadPriority::kLow));
+    }
+    for (std::future<void>& job : jobs) {
+        job.get();
+    }
+    EXPECT_EQ(runs.load(), 10);
+
+    ThreadPoolStats high = pool.GetStats(ThreadPriority::kHigh);
+    ThreadPoolStats low = pool.GetStats(ThreadPriority::kLow);
+    EXPECT_EQ(high.jobs_scheduled, 5U);
+    EXPECT_EQ(high.jobs_completed, 5U);
+    EXPECT_EQ(low.jobs_completed, 5U);
+    EXPECT_EQ(high.queue_depth, 0U);
+    EXPECT_EQ(high.num_threads, 1);
+    EXPECT_EQ(low.num_threads, 3);
+
+    // Exceptions reach the caller instead of killing the worker.
+    std::future<void> failing = pool.Schedule([]() { throw std::runtime_error("boom"); }, ThreadPriority::kLow);
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    EXPECT_NO_THROW(pool.Schedule([]() {}, ThreadPriority::kLow).get());
+}
+
+TEST_F(ThreadPoolTest, HighPriority_NotBlockedByBusyLowQueue) {
+    ThreadPoolOptions options;
+    options.low_priority_threads = 1;
+    ThreadPool pool(options);
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    // The first job holds the only low thread; the other three stay queued.
+    std::promise<void> started;
+    std::future<void> running = started.get_future();
+    std::vector<std::future<void>> low_jobs;
+    low_jobs.push_back(pool.Schedule([released, &started]() {
+        started.set_value();
+        released.wait();
+    }, ThreadPriority::kLow));
+    for (int i = 1; i < 4; ++i) {
+        low_jobs.push_back(pool.Schedule([released]() { released.wait(); }, ThreadPriority::kLow));
+    }
+    running.wait();
+
+    // A flush still gets a thread while compactions pile up.
+    std::future<void> flush = pool.Schedule([]() {}, ThreadPriority::kHigh);
+    EXPECT_EQ(flush.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+
+    ThreadPoolStats low = pool.GetStats(ThreadPriority::kLow);
+    EXPECT_EQ(low.queue_depth, 3U);
+    EXPECT_GE(low.max_queue_depth, 3U);
+    EXPECT_EQ(low.jobs_completed, 0U);
+
+    release.set_value();
+    for (std::future<void>& job : low_jobs) {
+        job.get();
+    }
+    low = pool.GetStats(ThreadPriority::kLow);
+    EXPECT_EQ(low.queue_depth, 0U);
+    EXPECT_EQ(low.jobs_completed, 4U);
+    EXPECT_GT(low.total_queue_micros, 0U);
+}
+
+#if defined(__linux__)
+TEST_F(ThreadPoolTest, CpuAffinity_PinsThreads) {
+    ThreadPoolOptions options;
+    options.high_priority_cpus = {0};
+    ThreadPool pool(options);
+    int cpu = -1;
+    pool.Schedule([&cpu]() { cpu = sched_getcpu(); }, ThreadPriority::kHigh).get();
+    EXPECT_EQ(cpu, 0);
+}
+#endif
+
+TEST_F(ThreadPoolTest, SharedPool_UsedByEveryDB) {
+    ThreadPoolOptions pool_options;
+    pool_options.low_priority_threads = 2;
+    auto pool = std::make_shared<ThreadPool>(pool_options);
+
+    DBOptions options;
+    options.thread_pool = pool;
+    options.level0_file_num_compaction_trigger = 2;
+    DB db1(test_dir_ + "/db1", 4096, options);
+    DB db2(test_dir_ + "/db2", 4096, options);
+    ASSERT_TRUE(db1.Init().ok());
+    ASSERT_TRUE(db2.Init().ok());
+
+    std::string value(100, 'v');
+    for (int i = 0; i < 300; ++i) {
+        ASSERT_TRUE(db1.Put(StrToSlice("key" + std::to_string(i)), StrToSlice(value)).ok());
+        ASSERT_TRUE(db2.Put(StrToSlice("key" + std::to_string(i)), StrToSlice(value)).ok());
+    }
+
+    ThreadPoolStats flushes = db1.GetThreadPoolStats(ThreadPriority::kHigh);
+    EXPECT_EQ(flushes.num_threads, 1);
+    EXPECT_GE(flushes.jobs_completed, 2U);
+    EXPECT_EQ(flushes.jobs_completed, pool->GetStats(ThreadPriority::kHigh).jobs_completed);
+    EXPECT_EQ(db2.GetThreadPoolStats(ThreadPriority::kLow).num_threads, 2);
+
+    std::string value_out;
+    ASSERT_TRUE(db1.Get(StrToSlice("key0"), &value_out).ok());
+    EXPECT_EQ(value_out, value);
+    ASSERT_TRUE(db2.Get(StrToSlice("key299"), &value_out).ok());
+    EXPECT_EQ(value_out, value);
+}
@@ -1,7 +1,11 @@
 #include "test_utils.hpp"
+#include <cstdio>
 #include <cstring> // For std::memcpy
+#include <filesystem>
 #include <stdexcept> // For std::bad_alloc
 
+namespace fs = std::filesystem;
+
 TestEntry::TestEntry(std::string k, std::string v, ValueTag t)
     : key(std::move(k)), value(std::move(v)), tag(t) {}
 
@@ -27,3 +31,56 @@ bool IsPointerDistinctFromBuffer(const void* ptr, const std::vector<char>& buffe
     const char* buffer_end = buffer.data() + buffer.size();
     return (p_char < buffer_start || p_char >= buffer_end);
 }
+
+std::string KeyFor(int i, int width) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "key%0*d", width, i);
+    return buf;
+}
+
+void TempDirTest::SetUp() {
+    op_arena_ = std::make_unique<Arena>();
+    fs::remove_all(test_dir_);
+    fs::create_directories(test_dir_);
+}
+
+void TempDirTest::TearDown() {
+    op_arena_.reset();
+    fs::remove_all(test_dir_);
+}
+
+Slice TempDirTest::StrToSlice(const std::string& s) {
+    return StringToSlice(*op_arena_, s);
+}
+
+std::string TempDirTest::GetOrStatus(DB* db, const std::string& key) {
+    std::string value_out;
+    Result res = db->Get(StrToSlice(key), &value_out);
+    return res.ok() ? value_out : "<" + std::to_string(static_cast<int>(res.code())) + ">";
+}
+
+std::string TempDirTest::GetOrStatus(DB* db, ColumnFamilyHandle* cf, const std::string& key) {
+    std::string value_out;
+    Result res = db->Get(cf, StrToSlice(key), &value_out);
+    return res.ok() ? value_out : "<" + std::to_string(static_cast<int>(res.code())) + ">";
+}
+
+void TempDirTest::FlushByFilling(DB* db, ColumnFamilyHandle* cf) {
+    if (cf == nullptr) {
+        cf = db->DefaultColumnFamily();
+    }
+    size_t l0_files = db->NumFilesAtLevel(cf, 0);
+    for (int i = 0; db->NumFilesAtLevel(cf, 0) == l0_files; ++i) {
+        ASSERT_TRUE(db->Put(cf, StrToSlice("zz_fill_" + std::to_string(i)), StrToSlice("f")).ok());
+    }
+}
+
+size_t TempDirTest::CountFilesWithExtension(const std::string& dir, const std::string& extension) {
+    size_t count = 0;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.path().extension() == extension) {
+            count++;
+        }
+    }
+    return count;
+}
@@ -1,11 +1,16 @@
 #ifndef TEST_UTILS_HPP
 #define TEST_UTILS_HPP
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
+#include "gtest/gtest.h"
 #include "slice.hpp" // Assuming Slice is needed by StringToSlice
 #include "arena.hpp" // Assuming Arena is needed
 #include "value.hpp" // For ValueTag in TestEntry
+#include "comparator.hpp"
+#include "db.hpp"
 
 // Declare TestEntry if it's widely used, or define it here if simple enough
 struct TestEntry {
@@ -22,4 +27,41 @@ Slice StringToSlice(Arena& arena, const std::string& s);
 // You can also move IsPointerDistinctFromBuffer here if used elsewhere
 bool IsPointerDistinctFromBuffer(const void* ptr, const std::vector<char>& buffer);
 
+// "key" followed by `i` zero-padded to `width` digits, so keys sort like
+// their numbers.
+std::string KeyFor(int i, int width = 5);
+
+// Orders keys by their bytes, descending.
+class ReverseBytewiseComparator : public Comparator {
+ public:
+  int Compare(const Slice& a, const Slice& b) const override { return b.compare(a); }
+  const char* Name() const override { return "test.ReverseBytewiseComparator"; }
+};
+
+// Base fixture for tests that work in a scratch directory: test_dir_ is
+// emptied and created before each test and removed after it. StrToSlice
+// copies into op_arena_, which lives for one test.
+class TempDirTest : public ::testing::Test {
+protected:
+    explicit TempDirTest(std::string test_dir) : test_dir_(std::move(test_dir)) {}
+
+    void SetUp() override;
+    void TearDown() override;
+
+    Slice StrToSlice(const std::string& s);
+
+    // The value stored under `key`, or the failed Get's code as "<code>".
+    std::string GetOrStatus(DB* db, const std::string& key);
+    std::string GetOrStatus(DB* db, ColumnFamilyHandle* cf, const std::string& key);
+
+    // Writes filler keys into `cf` (the default family if null) until its
+    // memtable is flushed.
+    void FlushByFilling(DB* db, ColumnFamilyHandle* cf = nullptr);
+
+    size_t CountFilesWithExtension(const std::string& dir, const std::string& extension);
+
+    std::string test_dir_;
+    std::unique_ptr<Arena> op_arena_;
+};
+
 #endif // TEST_UTILS_HPP
@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include "vector_table.hpp"
+#include "mem_table.hpp"
+#include "mem_table_factory.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class VectorTableTest : public TempDirTest {
+protected:
+    VectorTableTest() : TempDirTest("test_vector_table_temp_dir") {}
+
+    static std::vector<std::string> Entries(SortedTableIterator* it) {
+        std::vector<std::string> entries;
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            ValueEntry value = it->value();
+            entries.push_back(it->key().ToString() + "=" +
+                              (value.IsTombstone() ? "<tombstone>" : value.value_slice.ToString()));
+        }
+        return entries;
+    }
+};
+
+TEST_F(VectorTableTest, Iterator_SortsAndKeepsLastWriteOfEachKey) {
+    VectorTable table(*op_arena_);
+    // "a" and "a\0" share a zero-padded prefix; the long keys share 8 bytes.
+    const std::string a_nul("a\0", 2);
+    ASSERT_TRUE(table.Put(StrToSlice("prefix__2"), StrToSlice("1")).ok());
+    ASSERT_TRUE(table.Put(StrToSlice(a_nul), StrToSlice("2")).ok());
+    ASSERT_TRUE(table.Put(StrToSlice("a"), StrToSlice("3")).ok());
+    ASSERT_TRUE(table.Put(StrToSlice("prefix__1"), StrToSlice("4")).ok());
+    ASSERT_TRUE(table.Put(StrToSlice("prefix__2"), StrToSlice("5")).ok());
+    ASSERT_TRUE(table.Delete(StrToSlice("a")).ok());
+    ASSERT_TRUE(table.Put(StrToSlice("b"), StrToSlice("6")).ok());
+
+    std::unique_ptr<SortedTableIterator> it(table.NewIterator());
+    EXPECT_EQ(Entries(it.get()), (std::vector<std::string>{"a=<tombstone>", a_nul + "=2", "b=6", "prefix__1=4",
+                                                           "prefix__2=5"}));
+
+    it->Seek(StrToSlice("c"));
+    ASSERT_TRUE(it->Valid());
+    EXPECT_EQ(it->key().ToString(), "prefix__1");
+    it->Seek(StrToSlice("z"));
+    EXPECT_FALSE(it->Valid());
+}
+
+TEST_F(VectorTableTest, Get_ScansForNewestWrite) {
+    VectorTable table(*op_arena_);
+    ASSERT_TRUE(table.Put(StrToSlice("k"), StrToSlice("old")).ok());
+    ASSERT_TRUE(table.Put(StrToSlice("k"), StrToSlice("new")).ok());
+    ASSERT_TRUE(table.Put(StrToSlice("gone"), StrToSlice("v")).ok());
+    ASSERT_TRUE(table.Delete(StrToSlice("gone")).ok());
+
+    Slice value;
+    ASSERT_TRUE(table.Get(StrToSlice("k"), &value).ok());
+    EXPECT_EQ(value.ToString(), "new");
+    EXPECT_TRUE(table.Get(StrToSlice("gone"), &value).IsTombstone());
+    EXPECT_TRUE(table.Get(StrToSlice("missing"), &value).IsNotFound());
+}
+
+TEST_F(VectorTableTest, Iterator_KeepsSnapshotAcrossLaterWrites) {
+    VectorTable table(*op_arena_);
+    ASSERT_TRUE(table.Put(StrToSlice("b"), StrToSlice("1")).ok());
+    std::unique_ptr<SortedTableIterator> before(table.NewIterator());
+    ASSERT_TRUE(table.Put(StrToSlice("a"), StrToSlice("2")).ok());
+    std::unique_ptr<SortedTableIterator> after(table.NewIterator());
+
+    EXPECT_EQ(Entries(before.get()), (std::vector<std::string>{"b=1"}));
+    EXPECT_EQ(Entries(after.get()), (std::vector<std::string>{"a=2", "b=1"}));
+}
+
+TEST_F(VectorTableTest, RandomWrites_MatchOrderedMapUnderBothComparators) {
+    ReverseBytewiseComparator reverse;
+    for (const Comparator* comparator : {BytewiseComparator(), static_cast<const Comparator*>(&reverse)}) {
+        VectorTable table(*op_arena_, comparator);
+        std::map<std::string, std::string> model;
+        std::mt19937 rng(23);
+        for (int i = 0; i < 5000; ++i) {
+            std::string key = "key" + std::to_string(rng() % 2000);
+            key.resize(key.size() + rng() % 8, 'x');
+            std::string value = std::to_string(i);
+            ASSERT_TRUE(table.Put(StrToSlice(key), StrToSlice(value)).ok());
+            model[key] = value;
+        }
+        std::vector<std::string> expected;
+        for (const auto& [key, value] : model) {
+            expected.push_back(key + "=" + value);
+        }
+        if (comparator != BytewiseComparator()) {
+            std::reverse(expected.begin(), expected.end());
+        }
+        std::unique_ptr<SortedTableIterator> it(table.NewIterator());
+        EXPECT_EQ(Entries(it.get()), expected) << comparator->Name();
+    }
+}
+
+TEST_F(VectorTableTest, MemTable_TracksEntriesAndKeyRangeWithoutSorting) {
+    ReverseBytewiseComparator reverse;
+    MemTable memtable(*op_arena_, &reverse, VectorMemTableFactory());
+    EXPECT_TRUE(memtable.IsEmpty());
+    EXPECT_FALSE(memtable.MayOverlapRange(StrToSlice("z"), StrToSlice("a")));
+
+    ASSERT_TRUE(memtable.Put(StrToSlice("m"), StrToSlice("1")).ok());
+    ASSERT_TRUE(memtable.Put(StrToSlice("d"), StrToSlice("2")).ok());
+    ASSERT_TRUE(memtable.Delete(StrToSlice("p")).ok());
+    ASSERT_TRUE(memtable.Put(StrToSlice("m"), StrToSlice("3")).ok());
+    EXPECT_FALSE(memtable.IsEmpty());
+    EXPECT_EQ(memtable.NumEntries(), 4U);
+
+    // Under the reverse order the written keys span [p, d].
+    EXPECT_TRUE(memtable.MayOverlapRange(StrToSlice("z"), StrToSlice("p")));
+    EXPECT_TRUE(memtable.MayOverlapRange(StrToSlice("d"), StrToSlice("a")));
+    EXPECT_TRUE(memtable.MayOverlapRange(StrToSlice("o"), StrToSlice("n")));
+    EXPECT_FALSE(memtable.MayOverlapRange(StrToSlice("z"), StrToSlice("q")));
+    EXPECT_FALSE(memtable.MayOverlapRange(StrToSlice("c"), StrToSlice("a")));
+}
+
+TEST_F(VectorTableTest, DB_BulkLoadsThroughVectorMemTable) {
+    DBOptions options;
+    options.memtable_factory = VectorMemTableFactory();
+    options.disable_auto_compactions = true;
+    DB db(test_dir_, 4096, options);
+    ASSERT_TRUE(db.Init().ok());
+    for (int i = 499; i >= 0; --i) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "key%05d", i);
+        ASSERT_TRUE(db.Put(StrToSlice(key), StrToSlice("v" + std::to_string(i))).ok());
+    }
+    EXPECT_GT(db.NumFilesAtLevel(0), 0U);
+
+    std::string value;
+    ASSERT_TRUE(db.Get(StrToSlice("key00000"), &value).ok());
+    EXPECT_EQ(value, "v0");
+    ASSERT_TRUE(db.Get(StrToSlice("key00499"), &value).ok());
+    EXPECT_EQ(value, "v499");
+}
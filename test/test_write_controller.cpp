@@ -0,0 +1,214 @@
+#include "gtest/gtest.h"
+#include "write_controller.hpp"
+#include "db.hpp"
+#include "options.hpp"
+#include "test_utils.hpp"
+
+#include <filesystem>
+#include <random>
+#include <string>
+
+namespace fs = std::filesystem;
+
+class WriteControllerTest : public ::testing::Test {
+protected:
+    DBOptions options_;
+
+    void SetUp() override {
+        options_.level0_slowdown_writes_trigger = 4;
+        options_.level0_stop_writes_trigger = 8;
+        options_.soft_pending_compaction_bytes_limit = 1000;
+        options_.hard_pending_compaction_bytes_limit = 2000;
+        options_.delayed_write_rate = 1000 * 1000; // 1 byte per microsecond
+    }
+};
+
+TEST_F(WriteControllerTest, Evaluate_BelowAllThresholdsIsNormal) {
+    WriteController controller(options_);
+    WriteController::Decision d = controller.Evaluate(3, 999);
+    EXPECT_EQ(d.condition, WriteStallCondition::kNormal);
+    EXPECT_EQ(d.cause, WriteStallCause::kNone);
+}
+
+TEST_F(WriteControllerTest, Evaluate_SlowdownThresholdsDelayWithCause) {
+    WriteController controller(options_);
+
+    WriteController::Decision d = controller.Evaluate(4, 0);
+    EXPECT_EQ(d.condition, WriteStallCondition::kDelayed);
+    EXPECT_EQ(d.cause, WriteStallCause::kL0FileCount);
+    EXPECT_DOUBLE_EQ(d.severity, 0.0);
+
+    d = controller.Evaluate(0, 1500);
+    EXPECT_EQ(d.condition, WriteStallCondition::kDelayed);
+    EXPECT_EQ(d.cause, WriteStallCause::kPendingCompactionBytes);
+    EXPECT_NEAR(d.severity, 0.5, 1e-9);
+
+    // The signal closest to its stop threshold is reported.
+    d = controller.Evaluate(7, 1500);
+    EXPECT_EQ(d.cause, WriteStallCause::kL0FileCount);
+    EXPECT_NEAR(d.severity, 0.75, 1e-9);
+}
+
+TEST_F(WriteControllerTest, Evaluate_StopThresholdsStopWrites) {
+    WriteController controller(options_);
+    EXPECT_EQ(controller.Evaluate(8, 0).condition, WriteStallCondition::kStopped);
+    EXPECT_EQ(controller.Evaluate(8, 0).cause, WriteStallCause::kL0FileCount);
+    EXPECT_EQ(controller.Evaluate(0, 2000).cause, WriteStallCause::kPendingCompactionBytes);
+    // A stop on one signal outranks a slowdown on another.
+    EXPECT_EQ(controller.Evaluate(5, 2000).condition, WriteStallCondition::kStopped);
+    EXPECT_EQ(controller.Evaluate(5, 2000).cause, WriteStallCause::kPendingCompactionBytes);
+}
+
+TEST_F(WriteControllerTest, DelayGrowsWithSeverityAndIsBatched) {
+    WriteController controller(options_);
+    // 500 bytes at 1 byte/us is below the minimum sleep, so it is only accrued.
+    EXPECT_EQ(controller.GetDelayMicros(500, 0.0), 0U);
+    // The next write pushes the owed delay over the minimum and pays it all.
+    EXPECT_EQ(controller.GetDelayMicros(500, 0.0), 1000U);
+
+    uint64_t mild = controller.GetDelayMicros(10000, 0.0);
+    uint64_t severe = controller.GetDelayMicros(10000, 0.9);
+    EXPECT_EQ(mild, 10000U);
+    EXPECT_GT(severe, mild);
+    // Never slower than 1/kMaxDelaySlowdown of the configured rate.
+    EXPECT_LE(severe, 10000U * WriteController::kMaxDelaySlowdown);
+}
+
+TEST_F(WriteControllerTest, Stats_RecordDurationsByCause) {
+    WriteController controller(options_);
+    controller.RecordDelay(WriteStallCause::kL0FileCount, 100);
+    controller.RecordDelay(WriteStallCause::kPendingCompactionBytes, 50);
+    controller.RecordStop(WriteStallCause::kL0FileCount, 1000);
+
+    WriteStallStats stats = controller.GetStats();
+    EXPECT_EQ(stats.delayed_writes, 2U);
+    EXPECT_EQ(stats.stopped_writes, 1U);
+    EXPECT_EQ(stats.total_delay_micros, 150U);
+    EXPECT_EQ(stats.total_stop_micros, 1000U);
+    size_t l0 = static_cast<size_t>(WriteStallCause::kL0FileCount);
+    EXPECT_EQ(stats.delayed_writes_by_cause[l0], 1U);
+    EXPECT_EQ(stats.stopped_writes_by_cause[l0], 1U);
+    EXPECT_EQ(stats.stall_micros_by_cause[l0], 1100U);
+}
+
+TEST(WriteControllerDBTest, L0Backlog_SlowsThenStopsWrites) {
+    const std::string db_dir = "test_write_controller_db_dir";
+    fs::remove_all(db_dir);
+    {
+        DBOptions options;
+        options.disable_auto_compactions = true;
+        options.level0_slowdown_writes_trigger = 2;
+        options.level0_stop_writes_trigger = 4;
+        options.delayed_write_rate = 64 * 1024 * 1024;
+        DB db(db_dir, 256, options);
+        ASSERT_TRUE(db.Init().ok());
+
+        Arena arena;
+        for (int i = 0; i < 40; ++i) {
+            std::string key = "key" + std::to_string(i);
+            ASSERT_TRUE(db.Put(StringToSlice(arena, key), StringToSlice(arena, "value_" + key)).ok());
+            EXPECT_LE(db.NumFilesAtLevel(0), 4U);
+        }
+
+        WriteStallStats stats = db.GetWriteStallStats();
+        size_t l0 = static_cast<size_t>(WriteStallCause::kL0FileCount);
+        EXPECT_GT(stats.stopped_writes_by_cause[l0], 0U);
+        EXPECT_GT(db.NumFilesAtLevel(1), 0U) << "A stopped writer should have compacted L0.";
+
+        for (int i = 0; i < 40; ++i) {
+            std::string key = "key" + std::to_string(i);
+            std::string value_out;
+            ASSERT_TRUE(db.Get(StringToSlice(arena, key), &value_out).ok()) << key;
+            EXPECT_EQ(value_out, "value_" + key);
+        }
+    }
+    fs::remove_all(db_dir);
+}
+
+TEST(WriteControllerDBTest, ColumnFamily_StallsOnItsOwnThresholds) {
+    const std::string db_dir = "test_write_controller_db_dir";
+    fs::remove_all(db_dir);
+    {
+        DBOptions options;
+        options.disable_auto_compactions = true;
+        options.delayed_write_rate = 64 * 1024 * 1024;
+        DB db(db_dir, 256, options);
+        ASSERT_TRUE(db.Init().ok());
+        DBOptions strict = options;
+        strict.level0_slowdown_writes_trigger = 2;
+        strict.level0_stop_writes_trigger = 4;
+        ColumnFamilyHandle* strict_cf = nullptr;
+        ASSERT_TRUE(db.CreateColumnFamily("strict", 256, strict, &strict_cf).ok());
+
+        // The default family runs on the DB's default thresholds.
+        Arena arena;
+        for (int i = 0; i < 15; ++i) {
+            std::string key = "key" + std::to_string(i);
+            ASSERT_TRUE(db.Put(StringToSlice(arena, key), StringToSlice(arena, "value_" + key)).ok());
+        }
+        ASSERT_GT(db.NumFilesAtLevel(0), 4U);
+        ASSERT_LT(db.NumFilesAtLevel(0), 20U);
+        size_t l0 = static_cast<size_t>(WriteStallCause::kL0FileCount);
+        EXPECT_EQ(db.GetWriteStallStats().delayed_writes_by_cause[l0], 0U);
+        EXPECT_EQ(db.GetWriteStallStats().stopped_writes_by_cause[l0], 0U);
+
+        for (int i = 0; i < 40; ++i) {
+            std::string key = "key" + std::to_string(i);
+            ASSERT_TRUE(db.Put(strict_cf, StringToSlice(arena, key), StringToSlice(arena, "value_" + key)).ok());
+            EXPECT_LE(db.NumFilesAtLevel(strict_cf, 0), 4U);
+        }
+        EXPECT_GT(db.GetWriteStallStats().stopped_writes_by_cause[l0], 0U);
+        EXPECT_GT(db.NumFilesAtLevel(strict_cf, 1), 0U);
+    }
+    fs::remove_all(db_dir);
+}
+
+TEST(WriteControllerDBTest, LargeL1_OnlyOverlappingFilesCountAsPending) {
+    const std::string db_dir = "test_write_controller_db_dir";
+    fs::remove_all(db_dir);
+    {
+        DBOptions options;
+        options.disable_auto_compactions = true;
+        options.max_subcompactions = 1;
+        options.target_file_size = 1024;
+        options.soft_pending_compaction_bytes_limit = 8 * 1024;
+        options.hard_pending_compaction_bytes_limit = 16 * 1024;
+        options.delayed_write_rate = 64 * 1024 * 1024;
+        DB db(db_dir, 1024, options);
+        ASSERT_TRUE(db.Init().ok());
+
+        // Incompressible values, so L1 ends up well past both limits.
+        Arena arena;
+        std::mt19937 rng(7);
+        auto put = [&](const std::string& key) {
+            std::string value(64, '\0');
+            for (char& c : value) {
+                c = static_cast<char>('a' + rng() % 26);
+            }
+            ASSERT_TRUE(db.Put(StringToSlice(arena, key), StringToSlice(arena, value)).ok());
+        };
+        for (int i = 0; i < 1000; ++i) {
+            put(KeyFor(i));
+        }
+        ASSERT_TRUE(db.CompactLevel0().ok());
+        ASSERT_GT(db.NumFilesAtLevel(1), 10U);
+
+        // Keys past the end of L1. The flushed file also holds the memtable's
+        // leftover keys, so it overlaps at most the last L1 file.
+        for (int i = 0; db.NumFilesAtLevel(0) == 0; ++i) {
+            put("later_" + KeyFor(i));
+        }
+        EXPECT_LT(db.EstimatePendingCompactionBytes(), options.soft_pending_compaction_bytes_limit);
+
+        WriteStallStats before = db.GetWriteStallStats();
+        for (int i = 0; i < 5; ++i) {
+            put("later_" + KeyFor(i));
+        }
+        ASSERT_EQ(db.NumFilesAtLevel(0), 1U);
+        WriteStallStats after = db.GetWriteStallStats();
+        size_t pending = static_cast<size_t>(WriteStallCause::kPendingCompactionBytes);
+        EXPECT_EQ(after.delayed_writes_by_cause[pending], before.delayed_writes_by_cause[pending]);
+        EXPECT_EQ(after.stopped_writes_by_cause[pending], before.stopped_writes_by_cause[pending]);
+    }
+    fs::remove_all(db_dir);
+}
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include "zstd_context.hpp"
+#include "table_builder.hpp"
+#include "sstable_reader.hpp"
+#include "arena.hpp"
+#include "test_utils.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class ZstdContextTest : public TempDirTest {
+protected:
+    ZstdContextTest() : TempDirTest("test_zstd_context_temp_dir") {}
+
+    // Points at `s` without copying, so reader threads share no arena.
+    static Slice AsSlice(const std::string& s) {
+        return Slice(reinterpret_cast<const std::byte*>(s.data()), s.size());
+    }
+
+    std::string WriteCompressedTable(const std::string& name, int entries) {
+        std::string path = (fs::path(test_dir_) / name).string();
+        TableBuilder builder(true, 1, 256);
+        EXPECT_TRUE(builder.Open(path).ok());
+        for (int i = 0; i < entries; ++i) {
+            std::string key = KeyFor(i);
+            std::string value(100, static_cast<char>('a' + i % 26));
+            EXPECT_TRUE(builder.Add(AsSlice(key), ValueEntry(AsSlice(value))).ok());
+        }
+        EXPECT_TRUE(builder.Finish().ok());
+        return path;
+    }
+};
+
+TEST_F(ZstdContextTest, ContextsAreReusedWithinAThreadOnly) {
+    ZSTD_DCtx* dctx = ThreadLocalZstdDCtx();
+    ZSTD_CCtx* cctx = ThreadLocalZstdCCtx();
+    ASSERT_NE(dctx, nullptr);
+    ASSERT_NE(cctx, nullptr);
+    EXPECT_EQ(ThreadLocalZstdDCtx(), dctx);
+    EXPECT_EQ(ThreadLocalZstdCCtx(), cctx);
+
+    ZSTD_DCtx* other_dctx = nullptr;
+    std::thread([&] { other_dctx = ThreadLocalZstdDCtx(); }).join();
+    EXPECT_NE(other_dctx, nullptr);
+    EXPECT_NE(other_dctx, dctx);
+}
+
+TEST_F(ZstdContextTest, InterleavedReadersAndThreadsShareContexts) {
+    // Several readers of compressed tables are open at once on each thread,
+    // their block loads interleaved, while a builder compresses on the same
+    // thread between them.
+    std::vector<std::string> paths;
+    for (int t = 0; t < 3; ++t) {
+        paths.push_back(WriteCompressedTable("t" + std::to_string(t) + ".sst", 200));
+    }
+
+    auto read_all = [&](int thread_index, bool* ok) {
+        *ok = true;
+        std::vector<std::unique_ptr<SSTableReader>> readers;
+        for (const std::string& path : paths) {
+            readers.push_back(std::make_unique<SSTableReader>(path));
+            *ok = *ok && readers.back()->Init().ok();
+        }
+        for (int i = 0; i < 200 && *ok; i += 7) {
+            for (auto& reader : readers) {
+                std::string value;
+                *ok = *ok && reader->Get(AsSlice(KeyFor(i)), &value).ok() &&
+                      value == std::string(100, static_cast<char>('a' + i % 26));
+            }
+            if (i % 49 == 0) {
+                WriteCompressedTable("w" + std::to_string(thread_index) + "_" + std::to_string(i) + ".sst", 20);
+            }
+        }
+    };
+
+    bool ok[4];
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back(read_all, t, &ok[t]);
+    }
+    read_all(3, &ok[3]);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (bool thread_ok : ok) {
+        EXPECT_TRUE(thread_ok);
+    }
+}
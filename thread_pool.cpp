@@ -0,0 +1,137 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+ThreadPool::ThreadPool(ThreadPoolOptions options) : shutting_down_(false) {
+  Queue& high = queues_[static_cast<size_t>(ThreadPriority::kHigh)];
+  high.num_threads = std::max(options.high_priority_threads, 1);
+  high.cpus = std::move(options.high_priority_cpus);
+  Queue& low = queues_[static_cast<size_t>(ThreadPriority::kLow)];
+  low.num_threads = std::max(options.low_priority_threads, 1);
+  low.cpus = std::move(options.low_priority_cpus);
+  Queue& user = queues_[static_cast<size_t>(ThreadPriority::kUser)];
+  user.num_threads = std::max(options.user_priority_threads, 1);
+  user.cpus = std::move(options.user_priority_cpus);
+  for (Queue& queue : queues_) {
+    queue.stats.num_threads = queue.num_threads;
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    shutting_down_ = true;
+  }
+  for (Queue& queue : queues_) {
+    queue.cv.notify_all();
+  }
+  for (Queue& queue : queues_) {
+    for (std::thread& t : queue.threads) {
+      t.join();
+    }
+  }
+}
+
+std::future<void> ThreadPool::Schedule(std::function<void()> job, ThreadPriority priority) {
+  std::promise<void> done;
+  std::future<void> result = done.get_future();
+  Queue& queue = queues_[static_cast<size_t>(priority)];
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (queue.threads.empty()) {
+      StartThreadsLocked(priority);
+    }
+    queue.jobs.push_back(Job{std::move(job), std::move(done), Clock::now()});
+    queue.stats.jobs_scheduled++;
+    queue.stats.queue_depth = queue.jobs.size();
+    queue.stats.max_queue_depth = std::max(queue.stats.max_queue_depth, queue.jobs.size());
+  }
+  queue.cv.notify_one();
+  return result;
+}
+
+int ThreadPool::NumThreads(ThreadPriority priority) const {
+  return queues_[static_cast<size_t>(priority)].num_threads;
+}
+
+ThreadPoolStats ThreadPool::GetStats(ThreadPriority priority) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return queues_[static_cast<size_t>(priority)].stats;
+}
+
+void ThreadPool::StartThreadsLocked(ThreadPriority priority) {
+  Queue& queue = queues_[static_cast<size_t>(priority)];
+  std::cout << "[ThreadPool::StartThreadsLocked] Starting " << queue.num_threads
+            << " threads for priority " << static_cast<int>(priority) << "." << std::endl;
+  queue.threads.reserve(static_cast<size_t>(queue.num_threads));
+  for (int i = 0; i < queue.num_threads; ++i) {
+    queue.threads.emplace_back(&ThreadPool::WorkerLoop, this, priority);
+  }
+}
+
+void ThreadPool::PinToCpus(const std::vector<int>& cpus) {
+  if (cpus.empty()) {
+    return;
+  }
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(static_cast<size_t>(cpu), &set);
+    }
+  }
+  int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (rc != 0) {
+    std::cout << "[ThreadPool::PinToCpus] pthread_setaffinity_np failed with error " << rc
+              << "; thread left unpinned." << std::endl;
+  }
+#endif
+}
+
+void ThreadPool::WorkerLoop(ThreadPriority priority) {
+  Queue& queue = queues_[static_cast<size_t>(priority)];
+  PinToCpus(queue.cpus);
+
+  std::unique_lock<std::mutex> lock(mu_);
+  while (true) {
+    queue.cv.wait(lock, [&] { return shutting_down_ || !queue.jobs.empty(); });
+    if (queue.jobs.empty()) {
+      return; // Shutting down and nothing left to run
+    }
+    Job job = std::move(queue.jobs.front());
+    queue.jobs.pop_front();
+    queue.stats.queue_depth = queue.jobs.size();
+    Clock::time_point start = Clock::now();
+    queue.stats.total_queue_micros += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(start - job.enqueued).count());
+
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      job.fn();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    Clock::time_point end = Clock::now();
+    lock.lock();
+
+    // Stats are updated before the future is ready, so a caller that waited
+    // for its job sees the job counted.
+    queue.stats.jobs_completed++;
+    queue.stats.total_run_micros += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    if (error) {
+      job.done.set_exception(error);
+    } else {
+      job.done.set_value();
+    }
+  }
+}
@@ -0,0 +1,98 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Which queue a job goes to. Each priority has its own threads, so a long
+// compaction can never keep a memtable flush or a user read waiting for a thread.
+enum class ThreadPriority : int {
+  kHigh = 0, // Memtable flush
+  kLow = 1,  // Compaction
+  kUser = 2, // SSTable reads of DB::AsyncGet
+};
+constexpr size_t kNumThreadPriorities = 3;
+
+struct ThreadPoolOptions {
+  // Threads serving each queue. Values below 1 are raised to 1.
+  int high_priority_threads = 1;
+  int low_priority_threads = 3;
+  // Bounds the SSTable reads of DB::AsyncGet that are in progress at once;
+  // further lookups queue up without holding a thread.
+  int user_priority_threads = 4;
+
+  // CPUs the threads of each queue are pinned to. Empty leaves them to the
+  // scheduler. Only honoured on Linux.
+  std::vector<int> high_priority_cpus;
+  std::vector<int> low_priority_cpus;
+  std::vector<int> user_priority_cpus;
+};
+
+struct ThreadPoolStats {
+  int num_threads = 0;
+  size_t queue_depth = 0;     // Jobs waiting for a thread right now
+  size_t max_queue_depth = 0; // Deepest the queue has been
+  uint64_t jobs_scheduled = 0;
+  uint64_t jobs_completed = 0;
+  uint64_t total_queue_micros = 0; // Time jobs spent waiting for a thread
+  uint64_t total_run_micros = 0;
+};
+
+// Background threads for flushes, compactions and asynchronous reads. One pool may be shared by
+// every DB in the process (DBOptions::thread_pool), which bounds the number of
+// background threads no matter how many DBs are open. Jobs of one priority
+// run in FIFO order. Threads are started on the first job of their priority.
+class ThreadPool {
+ public:
+  explicit ThreadPool(ThreadPoolOptions options = ThreadPoolOptions());
+  // Runs the jobs still queued, then joins every thread.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Queues `job`. The future becomes ready once it has run and rethrows
+  // anything the job threw.
+  std::future<void> Schedule(std::function<void()> job, ThreadPriority priority);
+
+  int NumThreads(ThreadPriority priority) const;
+  ThreadPoolStats GetStats(ThreadPriority priority) const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Job {
+    std::function<void()> fn;
+    std::promise<void> done;
+    Clock::time_point enqueued;
+  };
+
+  struct Queue {
+    int num_threads = 1;
+    std::vector<int> cpus;
+    std::deque<Job> jobs;
+    std::vector<std::thread> threads;
+    std::condition_variable cv;
+    ThreadPoolStats stats;
+  };
+
+  void WorkerLoop(ThreadPriority priority);
+  // Expects mu_ to be held.
+  void StartThreadsLocked(ThreadPriority priority);
+  static void PinToCpus(const std::vector<int>& cpus);
+
+  mutable std::mutex mu_;
+  bool shutting_down_;
+  std::array<Queue, kNumThreadPriorities> queues_;
+};
+
+#endif // THREAD_POOL_HPP
@@ -7,6 +7,7 @@
 enum class ValueTag {
   kData,
   kTombstone,
+  kBlobIndex, // The value is an encoded BlobIndex pointing into a blob file
 };
 
 struct ValueEntry {
@@ -32,6 +33,7 @@ struct ValueEntry {
 
   bool IsTombstone() const { return type == ValueTag::kTombstone; }
   bool IsValue() const { return type == ValueTag::kData; }
+  bool IsBlobIndex() const { return type == ValueTag::kBlobIndex; }
 
   // For std::map comparison if ValueEntry was a key (not the case here)
   // or if std::optional<ValueEntry> needs comparison (it doesn't directly if we compare underlying Slice)
@@ -0,0 +1,228 @@
+#include "vector_table.hpp"
+#include "key_compare.hpp"
+#include "value.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+
+// A write: the value, then the key bytes right after the header.
+struct VectorTable::Entry {
+	ValueEntry value;
+	uint32_t key_size;
+
+	std::byte* key_data() { return reinterpret_cast<std::byte*>(this + 1); }
+	const std::byte* key_data() const { return reinterpret_cast<const std::byte*>(this + 1); }
+	Slice key() const { return Slice(key_data(), key_size); }
+};
+
+namespace {
+
+// What the radix passes move around: 16 bytes instead of chasing a pointer
+// to the key for every comparison.
+struct SortRecord {
+	uint64_t prefix; // KeyPrefix of the key
+	uint32_t index;  // Position in arrival order
+};
+
+// Stable LSD radix sort by prefix, one byte per pass, least significant
+// first. Passes where every record has the same byte are skipped, so short
+// or similar prefixes cost fewer passes.
+void RadixSortByPrefix(std::vector<SortRecord>* records) {
+	std::vector<SortRecord> scratch(records->size());
+	for (int shift = 0; shift < 64; shift += 8) {
+		size_t counts[256] = {};
+		for (const SortRecord& r : *records) {
+			counts[(r.prefix >> shift) & 0xff]++;
+		}
+		if (counts[((*records)[0].prefix >> shift) & 0xff] == records->size()) {
+			continue;
+		}
+		size_t offset = 0;
+		for (size_t& count : counts) {
+			size_t bucket_size = count;
+			count = offset;
+			offset += bucket_size;
+		}
+		for (const SortRecord& r : *records) {
+			scratch[counts[(r.prefix >> shift) & 0xff]++] = r;
+		}
+		records->swap(scratch);
+	}
+}
+
+} // namespace
+
+
+VectorTable::VectorTable(Arena& arena, const Comparator* comparator)
+	: arena_(arena), comparator_(comparator), sorted_count_(0) {
+}
+
+VectorTable::~VectorTable() {
+	// Entries, keys and values are in arena_, managed externally.
+}
+
+Result VectorTable::Append(const Slice& key, const ValueEntry& entry) {
+	void* mem = arena_.Allocate(sizeof(Entry) + key.size(), alignof(Entry));
+	if (mem == nullptr) {
+		return Result::ArenaAllocationFail("Failed to allocate vector table entry.");
+	}
+	Entry* e = new (mem) Entry{entry, static_cast<uint32_t>(key.size())};
+	std::memcpy(e->key_data(), key.data(), key.size());
+	entries_.push_back(e);
+	return Result::OK();
+}
+
+Result VectorTable::Put(const Slice& key_input, const Slice& value_input) {
+	if (key_input.empty()) {
+		return Result::InvalidArgument("Key cannot be empty for Put.");
+	}
+
+	// The key is copied into its entry; the value gets its own arena copy.
+	std::byte* value_arena_ptr = nullptr;
+	if (value_input.size() > 0) {
+		void* value_mem_raw = arena_.Allocate(value_input.size(), alignof(std::byte));
+		if (!value_mem_raw) {
+			return Result::ArenaAllocationFail("Failed to allocate for value in Put.");
+		}
+		value_arena_ptr = static_cast<std::byte*>(value_mem_raw);
+		std::memcpy(value_arena_ptr, value_input.data(), value_input.size());
+	}
+	Slice arena_value_slice(value_arena_ptr, value_input.size());
+
+	return Append(key_input, ValueEntry(arena_value_slice, ValueTag::kData));
+}
+
+Result VectorTable::Get(const Slice& key, Slice* value_out) const {
+	// Slow path by design: the newest write of the key is the first found.
+	for (size_t i = entries_.size(); i > 0; --i) {
+		const Entry* e = entries_[i - 1];
+		if (comparator_.IsBytewise() ? e->key() != key : comparator_.Compare(e->key(), key) != 0) {
+			continue;
+		}
+		if (e->value.IsTombstone()) {
+			return Result::FoundTombstone();
+		}
+		*value_out = e->value.value_slice;
+		return Result::OK();
+	}
+	return Result::NotFound();
+}
+
+Result VectorTable::Delete(const Slice& key_input) {
+	if (key_input.empty()) {
+		return Result::InvalidArgument("Key cannot be empty for Delete.");
+	}
+	// The key stays, marked by a tombstone, so the delete reaches SSTables.
+	return Append(key_input, ValueEntry(ValueTag::kTombstone));
+}
+
+void VectorTable::SortEntries(SortedEntries* entries) const {
+	const size_t n = entries->size();
+	if (comparator_.IsBytewise() && n > 1) {
+		std::vector<SortRecord> records(n);
+		for (size_t i = 0; i < n; ++i) {
+			const Entry* e = (*entries)[i];
+			records[i] = {KeyPrefix(e->key_data(), e->key_size), static_cast<uint32_t>(i)};
+		}
+		RadixSortByPrefix(&records);
+
+		SortedEntries by_prefix(n);
+		for (size_t i = 0; i < n; ++i) {
+			by_prefix[i] = (*entries)[records[i].index];
+		}
+		// Keys sharing a prefix are still in arrival order; order each such
+		// run by the whole key, keeping arrival order among equal keys.
+		for (size_t begin = 0; begin < n;) {
+			size_t end = begin + 1;
+			while (end < n && records[end].prefix == records[begin].prefix) {
+				end++;
+			}
+			if (end - begin > 1) {
+				std::stable_sort(by_prefix.begin() + static_cast<std::ptrdiff_t>(begin),
+				                 by_prefix.begin() + static_cast<std::ptrdiff_t>(end),
+				                 [](const Entry* a, const Entry* b) { return a->key().compare(b->key()) < 0; });
+			}
+			begin = end;
+		}
+		entries->swap(by_prefix);
+	} else {
+		std::stable_sort(entries->begin(), entries->end(), [this](const Entry* a, const Entry* b) {
+			return comparator_.Compare(a->key(), b->key()) < 0;
+		});
+	}
+
+	// Equal keys are adjacent, oldest first; keep the last of each.
+	size_t out = 0;
+	for (size_t i = 0; i < n; ++i) {
+		if (out > 0 && comparator_.Compare((*entries)[out - 1]->key(), (*entries)[i]->key()) == 0) {
+			(*entries)[out - 1] = (*entries)[i];
+		} else {
+			(*entries)[out++] = (*entries)[i];
+		}
+	}
+	entries->resize(out);
+}
+
+std::shared_ptr<const VectorTable::SortedEntries> VectorTable::Sorted() const {
+	std::lock_guard<std::mutex> lock(sort_mutex_);
+	if (!sorted_ || sorted_count_ != entries_.size()) {
+		auto sorted = std::make_shared<SortedEntries>(entries_);
+		SortEntries(sorted.get());
+		sorted_ = std::move(sorted);
+		sorted_count_ = entries_.size();
+	}
+	return sorted_;
+}
+
+
+SortedTableIterator* VectorTable::NewIterator() const {
+	return new VectorTableIterator(this, Sorted()); // Caller owns this for now
+}
+
+size_t VectorTable::ApproximateMemoryUsage() const {
+	return arena_.GetTotalBytesUsed() + entries_.capacity() * sizeof(const Entry*) + sizeof(*this);
+}
+
+VectorTableIterator::VectorTableIterator(const VectorTable* table,
+                                         std::shared_ptr<const VectorTable::SortedEntries> entries)
+	: table_(table), entries_(std::move(entries)), index_(entries_->size()) {}
+
+bool VectorTableIterator::Valid() const {
+	return index_ < entries_->size();
+}
+
+void VectorTableIterator::SeekToFirst() {
+	index_ = 0;
+}
+
+void VectorTableIterator::Seek(const Slice& target) {
+	auto it = std::lower_bound(entries_->begin(), entries_->end(), target,
+	                           [this](const VectorTable::Entry* e, const Slice& key) {
+		                           return table_->comparator_.Compare(e->key(), key) < 0;
+	                           });
+	index_ = static_cast<size_t>(it - entries_->begin());
+}
+
+void VectorTableIterator::Next() {
+	if (Valid()) {
+		index_++;
+	}
+}
+
+Slice VectorTableIterator::key() const {
+	if (!Valid()) return Slice();
+	return (*entries_)[index_]->key();
+}
+
+ValueEntry VectorTableIterator::value() const {
+	if (!Valid()) {
+		return ValueEntry(ValueTag::kTombstone);
+	}
+	return (*entries_)[index_]->value;
+}
+
+Result VectorTableIterator::status() const {
+	return Result::OK();
+}
@@ -0,0 +1,92 @@
+#ifndef VECTOR_TABLE_HPP
+#define VECTOR_TABLE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "sorted_table.hpp"
+#include "arena.hpp"
+#include "comparator.hpp"
+#include "result.hpp"
+#include "value.hpp"
+
+
+class VectorTableIterator; // Forward declaration
+
+// Memtable table for bulk loads, where nothing is read until the flush.
+// Put and Delete append the entry to the arena and its pointer to a vector,
+// in O(1) with no key comparisons. The entries are sorted only when an
+// iterator is created: under the bytewise comparator by an LSD radix sort
+// on the keys' 8-byte prefixes, with prefix ties settled by comparing whole
+// keys; otherwise by a stable comparison sort. The last write of a key wins.
+//
+// Get is a slow path: a scan of every entry, newest first. Use this table
+// only where point reads of unflushed data are rare.
+//
+// Writes must not overlap reads. Iterators may be created from several
+// threads at once, and each keeps the sorted snapshot it was created from,
+// so writes after it do not disturb it.
+class VectorTable : public SortedTable {
+ public:
+  explicit VectorTable(Arena& arena, const Comparator* comparator = BytewiseComparator());
+  ~VectorTable() override;
+
+  VectorTable(const VectorTable&) = delete;
+  VectorTable& operator=(const VectorTable&) = delete;
+
+  // --- SortedTable Interface Implementation ---
+  Result Put(const Slice& key, const Slice& value) override;
+  Result Get(const Slice& key, Slice* value_out) const override;
+  Result Delete(const Slice& key) override;
+  SortedTableIterator* NewIterator() const override;
+  size_t ApproximateMemoryUsage() const override;
+
+ private:
+  friend class VectorTableIterator;
+
+  struct Entry;
+  using SortedEntries = std::vector<const Entry*>;
+
+  Result Append(const Slice& key, const ValueEntry& entry);
+
+  // The latest entry of every key, in key order. Sorts on first use after a
+  // write and caches the result until the next one.
+  std::shared_ptr<const SortedEntries> Sorted() const;
+  void SortEntries(SortedEntries* entries) const;
+
+  Arena& arena_; // Holds entries, keys and values
+  KeyComparator comparator_;
+  // Every write, in arrival order.
+  std::vector<const Entry*> entries_;
+
+  mutable std::mutex sort_mutex_;
+  mutable std::shared_ptr<const SortedEntries> sorted_; // Guarded by sort_mutex_
+  mutable size_t sorted_count_;                         // entries_ covered by sorted_
+};
+
+
+// Walks the sorted snapshot taken when it was created.
+class VectorTableIterator : public SortedTableIterator {
+ public:
+  VectorTableIterator(const VectorTable* table, std::shared_ptr<const VectorTable::SortedEntries> entries);
+  ~VectorTableIterator() override = default;
+
+  bool Valid() const override;
+  void SeekToFirst() override;
+  void Seek(const Slice& target) override;
+  void Next() override;
+
+  Slice key() const override;
+  ValueEntry value() const override;
+  Result status() const override;
+
+ private:
+  const VectorTable* table_;
+  std::shared_ptr<const VectorTable::SortedEntries> entries_;
+  size_t index_;
+};
+
+
+#endif // VECTOR_TABLE_HPP
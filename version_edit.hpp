@@ -0,0 +1,85 @@
+#ifndef VERSION_EDIT_HPP
+#define VERSION_EDIT_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Number of levels in the tree. L0 holds flushed memtables (overlapping,
+// newest first); L1 and below hold non-overlapping files in key order.
+constexpr int kNumLevels = 7;
+
+// Every DB has this column family; writes that name no family go to it.
+constexpr uint32_t kDefaultColumnFamilyId = 0;
+inline constexpr char kDefaultColumnFamilyName[] = "default";
+
+struct FileMetaData {
+  uint64_t number = 0;
+  uint64_t file_size = 0;
+  std::string path;
+  // Smallest and largest key in the file. Files from manifests written before
+  // ranges were recorded may lack them until the DB reads them back from the
+  // table; readers must then assume the file may hold any key.
+  bool has_key_range = false;
+  std::string smallest_key;
+  std::string largest_key;
+};
+
+// An append-only file of large values referenced from SSTables by BlobIndex.
+// Garbage counts the blobs no longer referenced by any live SSTable; once
+// every blob in the file is garbage, the file is deleted.
+struct BlobFileMetaData {
+  uint64_t number = 0;
+  std::string path;
+  uint64_t total_blob_count = 0;
+  uint64_t total_blob_bytes = 0;
+  uint64_t garbage_blob_count = 0;
+  uint64_t garbage_blob_bytes = 0;
+
+  bool IsObsolete() const { return garbage_blob_count >= total_blob_count; }
+};
+
+// A set of file additions and removals that is applied to the DB's level
+// structure in one step, so readers never observe a half-installed compaction.
+struct VersionEdit {
+  void AddFile(int level, FileMetaData file) {
+    new_files_.emplace_back(level, std::move(file));
+  }
+
+  void DeleteFile(int level, uint64_t file_number) {
+    deleted_files_.emplace_back(level, file_number);
+  }
+
+  void AddBlobFile(BlobFileMetaData blob_file) {
+    new_blob_files_.push_back(std::move(blob_file));
+  }
+
+  // Records that `count` blobs totalling `bytes` in blob file `blob_file_number`
+  // are no longer referenced.
+  void AddBlobGarbage(uint64_t blob_file_number, uint64_t count, uint64_t bytes) {
+    blob_garbage_.push_back(BlobGarbage{blob_file_number, count, bytes});
+  }
+
+  // Records that the column family's writes in logs older than `log_number`
+  // are all in SSTables now.
+  void SetLogNumber(uint64_t log_number) {
+    has_log_number_ = true;
+    log_number_ = log_number;
+  }
+
+  struct BlobGarbage {
+    uint64_t blob_file_number;
+    uint64_t count;
+    uint64_t bytes;
+  };
+
+  std::vector<std::pair<int, uint64_t>> deleted_files_;
+  std::vector<std::pair<int, FileMetaData>> new_files_; // Per level, in key order for L1+
+  std::vector<BlobFileMetaData> new_blob_files_;
+  std::vector<BlobGarbage> blob_garbage_;
+  bool has_log_number_ = false;
+  uint64_t log_number_ = 0;
+};
+
+#endif // VERSION_EDIT_HPP
@@ -1,4 +1,65 @@
 #include "wal_reader.hpp"
 
-WALReader::WALReader(std::string filename) : filename_(filename), is_open_(false) {};
+#include "coding.hpp"
+#include "crc32.hpp"
+#include "wal_writer.hpp" // For kWALRecordHeaderSize
 
+WALReader::WALReader(std::string filename)
+    : filename_(std::move(filename)), is_open_(false), last_read_status_(Result::OK()), file_size_(0) {}
+
+Result WALReader::Open() {
+  file_stream_.open(filename_, std::ios::binary);
+  if (!file_stream_.is_open()) {
+    return Result::IOError("WALReader: Failed to open log file: " + filename_);
+  }
+  file_stream_.seekg(0, std::ios::end);
+  file_size_ = static_cast<uint64_t>(file_stream_.tellg());
+  file_stream_.seekg(0, std::ios::beg);
+  is_open_ = true;
+  last_read_status_ = Result::OK();
+  return Result::OK();
+}
+
+bool WALReader::ReadRecord(Slice* payload, WALRecordType* type) {
+  if (!is_open_ || !last_read_status_.ok()) {
+    return false;
+  }
+  char header[kWALRecordHeaderSize];
+  file_stream_.read(header, kWALRecordHeaderSize);
+  std::streamsize header_bytes = file_stream_.gcount();
+  if (header_bytes == 0) {
+    return false; // Clean end of log.
+  }
+  if (header_bytes != static_cast<std::streamsize>(kWALRecordHeaderSize)) {
+    last_read_status_ = Result::Corruption("Truncated record header at the end of " + filename_);
+    return false;
+  }
+
+  uint32_t expected_crc = ReadLittleEndian32(header);
+  uint32_t length = ReadLittleEndian32(header + 4);
+  // A torn header can claim any length; never size the buffer past the file.
+  uint64_t bytes_left = file_size_ - static_cast<uint64_t>(file_stream_.tellg());
+  if (length > bytes_left) {
+    last_read_status_ = Result::Corruption("Record length " + std::to_string(length) + " runs past the end of " +
+                                           filename_);
+    return false;
+  }
+  buf_.resize(length);
+  if (length > 0) {
+    file_stream_.read(buf_.data(), length);
+    if (static_cast<uint32_t>(file_stream_.gcount()) != length) {
+      last_read_status_ = Result::Corruption("Truncated record at the end of " + filename_);
+      return false;
+    }
+  }
+
+  Slice type_slice(reinterpret_cast<const std::byte*>(header + 8), 1);
+  Slice record(reinterpret_cast<const std::byte*>(buf_.data()), length);
+  if (CalculateCRC32(type_slice, record) != expected_crc) {
+    last_read_status_ = Result::Corruption("Checksum mismatch in " + filename_);
+    return false;
+  }
+  *type = static_cast<WALRecordType>(header[8]);
+  *payload = record;
+  return true;
+}
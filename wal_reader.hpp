@@ -1,28 +1,31 @@
+#ifndef WAL_READER_HPP
+#define WAL_READER_HPP
+
+#include "wal_record_type.hpp"
+
 #include "result.hpp"
 #include "slice.hpp"
 
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <vector>
 
-enum class WALRecordType : uint8_t {
-    kInvalid = 0,     // Or kZeroType, for padding or uninitialized
-    kFullRecord = 1,  // A complete Put or Delete operation
-    kWriteOp = 2,     // Specific type for a Put
-    kDeleteOp = 3,    // Specific type for a Delete
-    // Potentially kFirstFragment, kMiddleFragment, kLastFragment for larger records later
-};
-
-
-
+// Reads back the records written by WALWriter, in order.
 struct WALReader {
  public:
   explicit WALReader(std::string filename);
-  ~WALReader();
+  ~WALReader() = default;
 
   Result Open();
-  bool ReadRecord(Slice* key, Slice* value, WALRecordType type);
-  Result Sync();
+
+  // Reads the next record. `payload` stays valid until the next call.
+  // Returns false at the end of the log, or at the first damaged record
+  // (bad checksum or cut short by a crash); status() tells the two apart.
+  bool ReadRecord(Slice* payload, WALRecordType* type);
+
+  // OK after a clean end of log; Corruption if reading stopped at a damaged record.
+  const Result& status() const { return last_read_status_; }
   bool IsOpen() const { return is_open_; }
 
  private:
@@ -30,5 +33,8 @@ struct WALReader {
   std::string filename_;
   bool is_open_;
   Result last_read_status_;
+  uint64_t file_size_;
   std::vector<char> buf_;
-};
\ No newline at end of file
+};
+
+#endif // WAL_READER_HPP
@@ -1,9 +1,14 @@
+#ifndef WAL_RECORD_TYPE_HPP
+#define WAL_RECORD_TYPE_HPP
+
 #include <cstdint>
 
 enum class WALRecordType : uint8_t {
     kInvalid = 0,     // Or kZeroType, for padding or uninitialized
-    kFullRecord = 1,  // A complete Put or Delete operation
-    kWriteOp = 2,     // Specific type for a Put
-    kDeleteOp = 3,    // Specific type for a Delete
+    kFullRecord = 1,  // A complete WriteBatch
+    kWriteOp = 2,     // A Put inside a WriteBatch
+    kDeleteOp = 3,    // A Delete inside a WriteBatch
     // Potentially kFirstFragment, kMiddleFragment, kLastFragment for larger records later
-};
\ No newline at end of file
+};
+
+#endif // WAL_RECORD_TYPE_HPP
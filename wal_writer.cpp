@@ -1,7 +1,75 @@
 #include "wal_writer.hpp"
 
-WALWriter::WALWriter(std::string filename) : filename_(filename), is_open_(false) {};
+#include <iostream>
+
+#include <unistd.h> // For fsync
+
+#include "coding.hpp"
+#include "crc32.hpp"
+
+WALWriter::WALWriter(std::string filename)
+    : file_(nullptr), filename_(std::move(filename)), is_open_(false), file_size_(0) {}
+
+WALWriter::~WALWriter() {
+  if (is_open_) {
+    Close();
+  }
+}
 
 Result WALWriter::Open() {
-  
-}
\ No newline at end of file
+  file_ = std::fopen(filename_.c_str(), "wb");
+  if (file_ == nullptr) {
+    return Result::IOError("WALWriter: Failed to open log file for writing: " + filename_);
+  }
+  is_open_ = true;
+  file_size_ = 0;
+  std::cout << "[WALWriter::Open] Writing log " << filename_ << std::endl;
+  return Result::OK();
+}
+
+Result WALWriter::AddRecord(const Slice& payload, WALRecordType type) {
+  if (!is_open_) {
+    return Result::IOError("WALWriter: AddRecord on a log that is not open: " + filename_);
+  }
+  const char type_byte = static_cast<char>(type);
+  Slice type_slice(reinterpret_cast<const std::byte*>(&type_byte), 1);
+
+  header_.clear();
+  PutFixed32(&header_, CalculateCRC32(type_slice, payload));
+  PutFixed32(&header_, static_cast<uint32_t>(payload.size()));
+  header_.push_back(type_byte);
+
+  if (std::fwrite(header_.data(), 1, header_.size(), file_) != header_.size() ||
+      (payload.size() > 0 && std::fwrite(payload.data(), 1, payload.size(), file_) != payload.size())) {
+    return Result::IOError("WALWriter: Failed to append record to " + filename_);
+  }
+  // Out of the stdio buffer, so a write that returned OK outlives the process.
+  if (std::fflush(file_) != 0) {
+    return Result::IOError("WALWriter: Failed to flush record to " + filename_);
+  }
+  file_size_ += header_.size() + payload.size();
+  return Result::OK();
+}
+
+Result WALWriter::Sync() {
+  if (!is_open_) {
+    return Result::IOError("WALWriter: Sync on a log that is not open: " + filename_);
+  }
+  if (std::fflush(file_) != 0 || ::fsync(::fileno(file_)) != 0) {
+    return Result::IOError("WALWriter: Failed to sync " + filename_);
+  }
+  return Result::OK();
+}
+
+Result WALWriter::Close() {
+  if (!is_open_) {
+    return Result::OK();
+  }
+  is_open_ = false;
+  int close_res = std::fclose(file_);
+  file_ = nullptr;
+  if (close_res != 0) {
+    return Result::IOError("WALWriter: Error reported when closing " + filename_);
+  }
+  return Result::OK();
+}
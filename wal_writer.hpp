@@ -1,28 +1,46 @@
+#ifndef WAL_WRITER_HPP
+#define WAL_WRITER_HPP
+
 #include "wal_record_type.hpp"
 
 #include "result.hpp"
 #include "slice.hpp"
 
-#include <fstream>
+#include <cstdint>
+#include <cstdio>
 #include <string>
-#include <vector>
-
 
+// Each record in a log file is
+//   checksum (LE32) | length (LE32) | type (1 byte) | payload
+// where the checksum is the CRC32 of the type byte and the payload.
+inline constexpr size_t kWALRecordHeaderSize = 4 + 4 + 1;
 
+// Appends records to a write-ahead log file. Each record is handed to the OS
+// before AddRecord returns, so it survives a crash of the process; Sync()
+// also forces it to stable storage, so it survives a crash of the machine.
 struct WALWriter {
  public:
   explicit WALWriter(std::string filename);
   ~WALWriter();
 
+  WALWriter(const WALWriter&) = delete;
+  WALWriter& operator=(const WALWriter&) = delete;
+
+  // Creates the log file, truncating any existing file of the same name.
   Result Open();
-  Result AddRecord(const Slice& key, const Slice& value, WALRecordType type);
+  Result AddRecord(const Slice& payload, WALRecordType type = WALRecordType::kFullRecord);
   Result Sync();
+  Result Close();
   bool IsOpen() const { return is_open_; }
+  uint64_t FileSize() const { return file_size_; }
+  const std::string& filename() const { return filename_; }
 
  private:
-  std::ofstream file_stream_;
+  std::FILE* file_;
   std::string filename_;
   bool is_open_;
-  Result last_read_status_;
-  std::vector<char> buf_;
-};
\ No newline at end of file
+  uint64_t file_size_;
+  std::string header_;
+};
+
+#endif // WAL_WRITER_HPP
@@ -0,0 +1,120 @@
+#include "write_batch.hpp"
+
+#include <algorithm>
+
+#include "coding.hpp"
+#include "column_family.hpp"
+
+namespace {
+
+constexpr size_t kWriteBatchHeaderSize = 4; // count
+
+Slice BytesAsSlice(const char* data, size_t size) {
+  return Slice(reinterpret_cast<const std::byte*>(data), size);
+}
+
+} // namespace
+
+WriteBatch::WriteBatch() {
+  Clear();
+}
+
+WriteBatch::WriteBatch(std::string rep) : rep_(std::move(rep)) {}
+
+void WriteBatch::Clear() {
+  rep_.assign(kWriteBatchHeaderSize, '\0');
+}
+
+uint32_t WriteBatch::Count() const {
+  if (rep_.size() < kWriteBatchHeaderSize) {
+    return 0;
+  }
+  return ReadLittleEndian32(rep_.data());
+}
+
+void WriteBatch::Put(const Slice& key, const Slice& value) {
+  AppendOp(WALRecordType::kWriteOp, kDefaultColumnFamilyId, key, &value);
+}
+
+void WriteBatch::Put(ColumnFamilyHandle* column_family, const Slice& key, const Slice& value) {
+  AppendOp(WALRecordType::kWriteOp, column_family->GetID(), key, &value);
+}
+
+void WriteBatch::Delete(const Slice& key) {
+  AppendOp(WALRecordType::kDeleteOp, kDefaultColumnFamilyId, key, nullptr);
+}
+
+void WriteBatch::Delete(ColumnFamilyHandle* column_family, const Slice& key) {
+  AppendOp(WALRecordType::kDeleteOp, column_family->GetID(), key, nullptr);
+}
+
+void WriteBatch::AppendOp(WALRecordType type, uint32_t column_family_id, const Slice& key, const Slice* value) {
+  uint32_t count = Count();
+  rep_.resize(std::max(rep_.size(), kWriteBatchHeaderSize));
+  rep_.push_back(static_cast<char>(type));
+  PutFixed32(&rep_, column_family_id);
+  PutFixed32(&rep_, static_cast<uint32_t>(key.size()));
+  rep_.append(reinterpret_cast<const char*>(key.data()), key.size());
+  if (value != nullptr) {
+    PutFixed32(&rep_, static_cast<uint32_t>(value->size()));
+    rep_.append(reinterpret_cast<const char*>(value->data()), value->size());
+  }
+  std::string count_bytes;
+  PutFixed32(&count_bytes, count + 1);
+  rep_.replace(0, kWriteBatchHeaderSize, count_bytes);
+}
+
+Result WriteBatch::Iterate(const Handler& op) const {
+  if (rep_.size() < kWriteBatchHeaderSize) {
+    return Result::Corruption("WriteBatch is smaller than its header.");
+  }
+  const uint32_t expected_count = Count();
+  const char* p = rep_.data() + kWriteBatchHeaderSize;
+  const char* limit = rep_.data() + rep_.size();
+  uint32_t found = 0;
+
+  auto get_length_prefixed = [&p, limit](Slice* out) {
+    if (limit - p < 4) {
+      return false;
+    }
+    uint32_t length = ReadLittleEndian32(p);
+    p += 4;
+    if (static_cast<size_t>(limit - p) < length) {
+      return false;
+    }
+    *out = BytesAsSlice(p, length);
+    p += length;
+    return true;
+  };
+
+  while (p < limit) {
+    if (limit - p < 5) {
+      return Result::Corruption("WriteBatch operation header is truncated.");
+    }
+    WALRecordType type = static_cast<WALRecordType>(*p);
+    uint32_t column_family_id = ReadLittleEndian32(p + 1);
+    p += 5;
+    Slice key;
+    Slice value;
+    if (!get_length_prefixed(&key)) {
+      return Result::Corruption("WriteBatch key is truncated.");
+    }
+    if (type == WALRecordType::kWriteOp) {
+      if (!get_length_prefixed(&value)) {
+        return Result::Corruption("WriteBatch value is truncated.");
+      }
+    } else if (type != WALRecordType::kDeleteOp) {
+      return Result::Corruption("Unknown WriteBatch operation type " + std::to_string(static_cast<int>(type)));
+    }
+    Result op_res = op(type, column_family_id, key, value);
+    if (!op_res.ok()) {
+      return op_res;
+    }
+    found++;
+  }
+  if (found != expected_count) {
+    return Result::Corruption("WriteBatch has " + std::to_string(found) + " operations, header says " +
+                              std::to_string(expected_count));
+  }
+  return Result::OK();
+}
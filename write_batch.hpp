@@ -0,0 +1,53 @@
+#ifndef WRITE_BATCH_HPP
+#define WRITE_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "result.hpp"
+#include "slice.hpp"
+#include "wal_record_type.hpp"
+
+struct ColumnFamilyHandle;
+
+// A group of Puts and Deletes, possibly across several column families, that
+// DB::Write applies atomically: it is logged as one WAL record, so after a
+// crash either every operation in the batch is recovered or none is.
+//
+// The batch is kept in its serialized form, which is also the WAL payload:
+//   count (LE32) | op...
+//   op := type (1 byte, WALRecordType::kWriteOp or kDeleteOp) | column family id (LE32)
+//         | key_len (LE32) | key | [value_len (LE32) | value]   (value only for kWriteOp)
+struct WriteBatch {
+ public:
+  WriteBatch();
+  // Wraps a serialized batch, e.g. one read back from the WAL.
+  explicit WriteBatch(std::string rep);
+
+  // The default column family is used when no handle is given.
+  void Put(const Slice& key, const Slice& value);
+  void Put(ColumnFamilyHandle* column_family, const Slice& key, const Slice& value);
+  void Delete(const Slice& key);
+  void Delete(ColumnFamilyHandle* column_family, const Slice& key);
+
+  void Clear();
+  uint32_t Count() const;
+  size_t ApproximateSize() const { return rep_.size(); }
+  const std::string& Data() const { return rep_; }
+
+  // Calls `op` for every operation in insertion order. `value` is empty for
+  // deletes. Stops at, and returns, the first non-OK result from `op`;
+  // returns Corruption if the serialized batch is malformed.
+  using Handler = std::function<Result(WALRecordType type, uint32_t column_family_id,
+                                       const Slice& key, const Slice& value)>;
+  Result Iterate(const Handler& op) const;
+
+ private:
+  void AppendOp(WALRecordType type, uint32_t column_family_id, const Slice& key, const Slice* value);
+
+  std::string rep_;
+};
+
+#endif // WRITE_BATCH_HPP
@@ -0,0 +1,98 @@
+#include "write_controller.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Position of `value` between the slowdown and stop thresholds, in [0, 1).
+double Severity(double value, double slowdown, double stop) {
+  if (stop <= slowdown) {
+    return 0.0;
+  }
+  return std::clamp((value - slowdown) / (stop - slowdown), 0.0, 0.999);
+}
+
+} // namespace
+
+WriteController::WriteController(const DBOptions& options)
+    : options_(options), owed_delay_micros_(0) {}
+
+WriteController::Decision WriteController::Evaluate(const DBOptions& options, size_t l0_files,
+                                                    uint64_t pending_compaction_bytes) {
+  Decision decision;
+
+  // Any stop condition wins over every slowdown condition.
+  if (options.level0_stop_writes_trigger > 0 &&
+      l0_files >= static_cast<size_t>(options.level0_stop_writes_trigger)) {
+    decision.condition = WriteStallCondition::kStopped;
+    decision.cause = WriteStallCause::kL0FileCount;
+    return decision;
+  }
+  if (options.hard_pending_compaction_bytes_limit > 0 &&
+      pending_compaction_bytes >= options.hard_pending_compaction_bytes_limit) {
+    decision.condition = WriteStallCondition::kStopped;
+    decision.cause = WriteStallCause::kPendingCompactionBytes;
+    return decision;
+  }
+
+  auto consider_delay = [&decision](WriteStallCause cause, double severity) {
+    if (decision.condition != WriteStallCondition::kDelayed || severity > decision.severity) {
+      decision.condition = WriteStallCondition::kDelayed;
+      decision.cause = cause;
+      decision.severity = severity;
+    }
+  };
+  if (options.level0_slowdown_writes_trigger > 0 &&
+      l0_files >= static_cast<size_t>(options.level0_slowdown_writes_trigger)) {
+    consider_delay(WriteStallCause::kL0FileCount,
+                   Severity(static_cast<double>(l0_files), options.level0_slowdown_writes_trigger,
+                            options.level0_stop_writes_trigger));
+  }
+  if (options.soft_pending_compaction_bytes_limit > 0 &&
+      pending_compaction_bytes >= options.soft_pending_compaction_bytes_limit) {
+    consider_delay(WriteStallCause::kPendingCompactionBytes,
+                   Severity(static_cast<double>(pending_compaction_bytes),
+                            static_cast<double>(options.soft_pending_compaction_bytes_limit),
+                            static_cast<double>(options.hard_pending_compaction_bytes_limit)));
+  }
+  return decision;
+}
+
+uint64_t WriteController::GetDelayMicros(uint64_t write_bytes, double severity) {
+  double base_rate = static_cast<double>(std::max<uint64_t>(options_.delayed_write_rate, 1));
+  double min_rate = base_rate / static_cast<double>(kMaxDelaySlowdown);
+  double rate = std::max(base_rate * (1.0 - severity), min_rate);
+  uint64_t micros = static_cast<uint64_t>(static_cast<double>(write_bytes) * 1000000.0 / rate);
+
+  std::lock_guard<std::mutex> lock(mu_);
+  owed_delay_micros_ += micros;
+  if (owed_delay_micros_ < kMinSleepMicros) {
+    return 0;
+  }
+  uint64_t sleep_micros = owed_delay_micros_;
+  owed_delay_micros_ = 0;
+  return sleep_micros;
+}
+
+void WriteController::RecordDelay(WriteStallCause cause, uint64_t micros) {
+  std::lock_guard<std::mutex> lock(mu_);
+  size_t idx = static_cast<size_t>(cause);
+  stats_.delayed_writes++;
+  stats_.total_delay_micros += micros;
+  stats_.delayed_writes_by_cause[idx]++;
+  stats_.stall_micros_by_cause[idx] += micros;
+}
+
+void WriteController::RecordStop(WriteStallCause cause, uint64_t micros) {
+  std::lock_guard<std::mutex> lock(mu_);
+  size_t idx = static_cast<size_t>(cause);
+  stats_.stopped_writes++;
+  stats_.total_stop_micros += micros;
+  stats_.stopped_writes_by_cause[idx]++;
+  stats_.stall_micros_by_cause[idx] += micros;
+}
+
+WriteStallStats WriteController::GetStats() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return stats_;
+}
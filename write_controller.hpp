@@ -0,0 +1,89 @@
+#ifndef WRITE_CONTROLLER_HPP
+#define WRITE_CONTROLLER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "options.hpp"
+
+enum class WriteStallCondition {
+  kNormal,
+  kDelayed, // Writes are paced at a reduced rate
+  kStopped, // Writes wait until the backlog is worked off
+};
+
+enum class WriteStallCause : int {
+  kNone = 0,
+  kL0FileCount = 1,
+  kPendingCompactionBytes = 2,
+};
+constexpr size_t kNumWriteStallCauses = 3;
+
+struct WriteStallStats {
+  uint64_t delayed_writes = 0;
+  uint64_t stopped_writes = 0;
+  uint64_t total_delay_micros = 0;
+  uint64_t total_stop_micros = 0;
+  // Indexed by WriteStallCause.
+  std::array<uint64_t, kNumWriteStallCauses> delayed_writes_by_cause{};
+  std::array<uint64_t, kNumWriteStallCauses> stopped_writes_by_cause{};
+  std::array<uint64_t, kNumWriteStallCauses> stall_micros_by_cause{};
+};
+
+// Decides whether an incoming write may proceed, must be slowed down or must
+// wait, from the L0 file count and the estimated pending compaction bytes.
+// Each signal has a slowdown and a stop threshold in DBOptions, taken from the
+// column family being written. While delayed, the allowed write rate shrinks
+// from the DB-wide DBOptions::delayed_write_rate towards
+// 1/kMaxDelaySlowdown of it as the signal approaches its stop threshold, so
+// latency degrades gradually.
+//
+// The immutable memtable count is not a signal: flushes are synchronous, so a
+// writer never finds an immutable memtable waiting to be written.
+class WriteController {
+ public:
+  static constexpr uint64_t kMaxDelaySlowdown = 16;
+  // Owed delay is accumulated and only slept off once it reaches this much,
+  // so small writes are not each put to sleep for a few microseconds.
+  static constexpr uint64_t kMinSleepMicros = 1000;
+
+  struct Decision {
+    WriteStallCondition condition = WriteStallCondition::kNormal;
+    WriteStallCause cause = WriteStallCause::kNone;
+    // For kDelayed: how far the worst signal is between its slowdown (0.0)
+    // and stop (1.0) thresholds.
+    double severity = 0.0;
+  };
+
+  explicit WriteController(const DBOptions& options);
+
+  WriteController(const WriteController&) = delete;
+  WriteController& operator=(const WriteController&) = delete;
+
+  // Evaluates the signals against the thresholds in `options`, so each column
+  // family can be held to its own.
+  static Decision Evaluate(const DBOptions& options, size_t l0_files, uint64_t pending_compaction_bytes);
+  // Evaluates against the thresholds the controller was built with.
+  Decision Evaluate(size_t l0_files, uint64_t pending_compaction_bytes) const {
+    return Evaluate(options_, l0_files, pending_compaction_bytes);
+  }
+
+  // Microseconds the caller should sleep now for a delayed write of
+  // `write_bytes`. Usually 0 until enough owed delay has accumulated.
+  uint64_t GetDelayMicros(uint64_t write_bytes, double severity);
+
+  void RecordDelay(WriteStallCause cause, uint64_t micros);
+  void RecordStop(WriteStallCause cause, uint64_t micros);
+  WriteStallStats GetStats() const;
+
+ private:
+  const DBOptions options_;
+
+  mutable std::mutex mu_;
+  uint64_t owed_delay_micros_;
+  WriteStallStats stats_;
+};
+
+#endif // WRITE_CONTROLLER_HPP
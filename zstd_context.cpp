@@ -0,0 +1,32 @@
+#include "zstd_context.hpp"
+
+namespace {
+
+struct ThreadZstdContexts {
+  ZSTD_DCtx* dctx = nullptr;
+  ZSTD_CCtx* cctx = nullptr;
+
+  ~ThreadZstdContexts() {
+    // Both accept nullptr.
+    ZSTD_freeDCtx(dctx);
+    ZSTD_freeCCtx(cctx);
+  }
+};
+
+thread_local ThreadZstdContexts thread_contexts;
+
+} // namespace
+
+ZSTD_DCtx* ThreadLocalZstdDCtx() {
+  if (thread_contexts.dctx == nullptr) {
+    thread_contexts.dctx = ZSTD_createDCtx();
+  }
+  return thread_contexts.dctx;
+}
+
+ZSTD_CCtx* ThreadLocalZstdCCtx() {
+  if (thread_contexts.cctx == nullptr) {
+    thread_contexts.cctx = ZSTD_createCCtx();
+  }
+  return thread_contexts.cctx;
+}
@@ -0,0 +1,22 @@
+#ifndef ZSTD_CONTEXT_HPP
+#define ZSTD_CONTEXT_HPP
+
+#include "zstd.h"
+
+// One zstd decompression and one compression context per thread, shared by
+// every SSTableReader and TableBuilder running on it. A context owns several
+// hundred KiB of working memory. Creating one per table opened would cost an
+// allocation, and a cold context, for each table a lookup touches.
+//
+// Each context is created on first use and freed when its thread exits.
+// They are only used for one-shot calls (ZSTD_decompressDCtx,
+// ZSTD_compressCCtx), which carry no state from one call to the next, so
+// any number of readers or builders on a thread can share them. Fetch the
+// context at the call site rather than keeping it: an object may be used
+// from more than one thread over its life.
+//
+// Both return nullptr if the context could not be created.
+ZSTD_DCtx* ThreadLocalZstdDCtx();
+ZSTD_CCtx* ThreadLocalZstdCCtx();
+
+#endif // ZSTD_CONTEXT_HPP